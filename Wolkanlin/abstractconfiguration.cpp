@@ -3,8 +3,9 @@
  * SPDX-License-Identifier: LGPL-3.0-or-later
  */
 
-#include "abstractconfiguration.h"
+#include "abstractconfiguration_p.h"
 #include "logging.h"
+#include "getapppasswordjob.h"
 #include <QJsonDocument>
 #include <QJsonObject>
 #include <QJsonParseError>
@@ -12,7 +13,69 @@
 
 using namespace Wolkanlin;
 
-AbstractConfiguration::AbstractConfiguration(QObject *parent) : QObject(parent)
+AbstractConfigurationPrivate::AbstractConfigurationPrivate(AbstractConfiguration *q)
+    : q_ptr(q)
+{
+
+}
+
+AbstractConfigurationPrivate::~AbstractConfigurationPrivate() = default;
+
+void AbstractConfigurationPrivate::invalidate()
+{
+    snapshot = ConfigurationSnapshot();
+    ++generation;
+}
+
+void AbstractConfigurationPrivate::convertToAppPassword(const ConfigurationSnapshot &used, QNetworkAccessManager *nam)
+{
+    // only convert the password that is currently configured and only once
+    if (!autoConvertAppPassword || appPasswordState != AppPasswordState::Unknown || used.generation() != generation) {
+        return;
+    }
+
+    // the credentials of a provider can not be replaced by setApplicationPassword()
+    if (credentialProvider) {
+        return;
+    }
+
+    Q_Q(AbstractConfiguration);
+    qCDebug(wlCore) << "Requesting application password to replace the login password.";
+    appPasswordState = AppPasswordState::Converting;
+    const quint64 startGeneration = generation;
+
+    auto job = new GetAppPasswordJob(q);
+    job->setConfiguration(q);
+    job->setNetworkAccessManager(nam);
+    QObject::connect(job, &Job::succeeded, q, [this, q, startGeneration](const QJsonDocument &json){
+        if (generation != startGeneration) {
+            qCDebug(wlCore) << "Credentials have been changed while requesting the application password, discarding it.";
+            return;
+        }
+        if (q->setApplicationPassword(json)) {
+            appPasswordState = AppPasswordState::AppPassword;
+            Q_EMIT q->appPasswordConverted();
+        } else {
+            appPasswordState = AppPasswordState::Failed;
+        }
+    });
+    QObject::connect(job, &Job::failed, q, [this, startGeneration](int errorCode, const QString &errorString){
+        if (generation != startGeneration) {
+            return;
+        }
+        if (errorCode == AlreadyAppPassword) {
+            qCDebug(wlCore) << "The password already is an application password.";
+            appPasswordState = AppPasswordState::AppPassword;
+        } else {
+            qCWarning(wlCore) << "Failed to convert the login password into an application password:" << errorString;
+            appPasswordState = AppPasswordState::Failed;
+        }
+    });
+    job->start();
+}
+
+AbstractConfiguration::AbstractConfiguration(QObject *parent)
+    : QObject(parent), wl_ptr(new AbstractConfigurationPrivate(this))
 {
 
 }
@@ -79,6 +142,158 @@ QString AbstractConfiguration::loginFlowUserAgent() const
     return userAgent();
 }
 
+ConfigurationSnapshot AbstractConfiguration::snapshot() const
+{
+    Q_D(const AbstractConfiguration);
+    if (!d->snapshotCaching) {
+        return ConfigurationSnapshot(this);
+    }
+    if (d->snapshot.isNull()) {
+        d->snapshot = ConfigurationSnapshot(this);
+    }
+    return d->snapshot;
+}
+
+quint64 AbstractConfiguration::generation() const
+{
+    Q_D(const AbstractConfiguration);
+    return d->generation;
+}
+
+AbstractCredentialProvider *AbstractConfiguration::credentialProvider() const
+{
+    Q_D(const AbstractConfiguration);
+    return d->credentialProvider;
+}
+
+void AbstractConfiguration::setCredentialProvider(AbstractCredentialProvider *provider)
+{
+    Q_D(AbstractConfiguration);
+    if (d->credentialProvider != provider) {
+        qCDebug(wlCore) << "Changing credential provider from" << d->credentialProvider.data() << "to" << provider;
+        if (d->credentialProvider) {
+            disconnect(d->credentialProvider.data(), &AbstractCredentialProvider::credentialsChanged, this, nullptr);
+        }
+        d->credentialProvider = provider;
+        if (provider) {
+            // the snapshot contains the credentials of the provider
+            connect(provider, &AbstractCredentialProvider::credentialsChanged, this, [d](){
+                d->invalidate();
+            });
+        }
+        d->invalidate();
+    }
+}
+
+bool AbstractConfiguration::useSessionCookies() const
+{
+    Q_D(const AbstractConfiguration);
+    return d->sessionCookieJar != nullptr;
+}
+
+void AbstractConfiguration::setUseSessionCookies(bool useSessionCookies)
+{
+    Q_D(AbstractConfiguration);
+    if (useSessionCookies != (d->sessionCookieJar != nullptr)) {
+        qCDebug(wlCore) << "Changing useSessionCookies from" << !useSessionCookies << "to" << useSessionCookies;
+        if (useSessionCookies) {
+            d->sessionCookieJar = new SessionCookieJar(this);
+            d->sessionCookieJar->setFileName(d->sessionFile);
+        } else {
+            delete d->sessionCookieJar;
+            d->sessionCookieJar = nullptr;
+        }
+    }
+}
+
+QString AbstractConfiguration::sessionFile() const
+{
+    Q_D(const AbstractConfiguration);
+    return d->sessionFile;
+}
+
+void AbstractConfiguration::setSessionFile(const QString &fileName)
+{
+    Q_D(AbstractConfiguration);
+    if (d->sessionFile != fileName) {
+        qCDebug(wlCore) << "Changing sessionFile from" << d->sessionFile << "to" << fileName;
+        d->sessionFile = fileName;
+        if (d->sessionCookieJar) {
+            d->sessionCookieJar->setFileName(fileName);
+        }
+    }
+}
+
+void AbstractConfiguration::clearSession()
+{
+    Q_D(AbstractConfiguration);
+    if (d->sessionCookieJar) {
+        d->sessionCookieJar->clear();
+    }
+}
+
+bool AbstractConfiguration::autoConvertAppPassword() const
+{
+    Q_D(const AbstractConfiguration);
+    return d->autoConvertAppPassword;
+}
+
+void AbstractConfiguration::setAutoConvertAppPassword(bool autoConvert)
+{
+    Q_D(AbstractConfiguration);
+    if (d->autoConvertAppPassword != autoConvert) {
+        qCDebug(wlCore) << "Changing autoConvertAppPassword from" << d->autoConvertAppPassword << "to" << autoConvert;
+        d->autoConvertAppPassword = autoConvert;
+    }
+}
+
+bool AbstractConfiguration::isSnapshotCachingEnabled() const
+{
+    Q_D(const AbstractConfiguration);
+    return d->snapshotCaching;
+}
+
+void AbstractConfiguration::setSnapshotCachingEnabled(bool enabled)
+{
+    Q_D(AbstractConfiguration);
+    if (d->snapshotCaching != enabled) {
+        qCDebug(wlCore) << "Changing snapshotCaching from" << d->snapshotCaching << "to" << enabled;
+        d->snapshotCaching = enabled;
+        d->snapshot = ConfigurationSnapshot();
+    }
+}
+
+void AbstractConfiguration::invalidateSnapshot()
+{
+    Q_D(AbstractConfiguration);
+    d->invalidate();
+}
+
+void AbstractConfiguration::notifyCredentialsChanged()
+{
+    Q_D(AbstractConfiguration);
+    if (d->credentialProvider) {
+        d->credentialProvider->clear();
+    }
+    // the session belongs to the old credentials
+    clearSession();
+    d->appPasswordState = AbstractConfigurationPrivate::AppPasswordState::Unknown;
+    d->invalidate();
+    if (d->blockNotifications == 0) {
+        Q_EMIT credentialsChanged();
+    }
+}
+
+void AbstractConfiguration::notifyEndpointChanged()
+{
+    Q_D(AbstractConfiguration);
+    clearSession();
+    d->invalidate();
+    if (d->blockNotifications == 0) {
+        Q_EMIT endpointChanged();
+    }
+}
+
 bool AbstractConfiguration::setLoginFlowCredentials(const QUrl &credentialUrl)
 {
     Q_UNUSED(credentialUrl);
@@ -142,8 +357,12 @@ bool AbstractConfiguration::setLoginFlowCredentials(const QJsonObject &credentia
         return false;
     }
 
+    Q_D(AbstractConfiguration);
+    ++d->blockNotifications;
     setUsername(loginName);
     setPassword(appPassword);
+    --d->blockNotifications;
+    notifyCredentialsChanged();
 
     return false;
 }
@@ -178,10 +397,14 @@ bool AbstractConfiguration::setServerUrl(const QUrl &url)
         path.chop(1);
     }
 
+    Q_D(AbstractConfiguration);
+    ++d->blockNotifications;
     setUseSsl(ssl);
     setHost(host);
     setPort(port);
     setInstallPath(path);
+    --d->blockNotifications;
+    notifyEndpointChanged();
 
     return true;
 }
@@ -236,7 +459,11 @@ bool AbstractConfiguration::setApplicationPassword(const QJsonObject &json)
         return false;
     }
 
+    Q_D(AbstractConfiguration);
+    ++d->blockNotifications;
     setPassword(appPass);
+    --d->blockNotifications;
+    notifyCredentialsChanged();
 
     return true;
 }
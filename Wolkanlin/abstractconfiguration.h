@@ -8,6 +8,8 @@
 
 #include <QObject>
 #include "wolkanlin_export.h"
+#include "configurationsnapshot.h"
+#include <memory>
 
 class QUrl;
 class QJsonDocument;
@@ -15,6 +17,9 @@ class QJsonObject;
 
 namespace Wolkanlin {
 
+class AbstractConfigurationPrivate;
+class AbstractCredentialProvider;
+
 /*!
  * \brief Stores configuration for API requests.
  *
@@ -28,6 +33,44 @@ namespace Wolkanlin {
  *
  * The complete remote URL will be build from useSsl(), host(), port() and installPath().
  *
+ * \par Snapshots
+ * The API requests do not call the virtual getters directly but read the values from the
+ * ConfigurationSnapshot returned by snapshot(). By default a new snapshot is taken for every
+ * request. Subclasses that notify all changes as described below can call
+ * setSnapshotCachingEnabled() to take the snapshot only on first use and reuse it for all
+ * following requests until it is invalidated.
+ *
+ * \par Change notification
+ * Every change increases the generation() counter, so caches can store the generation their
+ * data belongs to and compare it later. Changes of the username or password emit
+ * credentialsChanged(), changes of the host, port, installation path or SSL usage emit
+ * endpointChanged(). Subclasses have to call notifyCredentialsChanged() or notifyEndpointChanged()
+ * at the end of the respective setter functions, and invalidateSnapshot() if any other value
+ * returned by the getters changes. setServerUrl(), setLoginFlowCredentials() and
+ * setApplicationPassword() emit each signal only once, even if they call multiple setters.
+ *
+ * \par Asynchronous credentials
+ * If reading the credentials is slow, set an AbstractCredentialProvider via
+ * setCredentialProvider(). The jobs will then wait for the provider without blocking the
+ * event loop and take the credentials from it instead of calling username() and password().
+ *
+ * \par Session cookies
+ * By default every request sends the username and password via HTTP Basic authentication and
+ * the server has to verify them for every request. If setUseSessionCookies() is enabled, the
+ * session cookies sent by the server are stored per configuration and the following requests
+ * authenticate with the session instead of the credentials. If the session has expired, the
+ * request will be repeated with the credentials. Set a sessionFile() to keep the session
+ * across restarts of the application.
+ *
+ * \par Application passwords
+ * Nextcloud recommends to use application specific passwords instead of the login password.
+ * If setAutoConvertAppPassword() is enabled, the first successful request that has been
+ * authenticated with the login password will start a GetAppPasswordJob in the background
+ * and the returned application password will be set via setApplicationPassword(), so all
+ * following requests will use it. If the password already is an application password, the
+ * configuration will be left untouched. While a credential provider is set, the password is
+ * not converted, because the configuration does not own the credentials of the provider.
+ *
  * \headerfile "" <Wolkanlin/AbstractConfiguration>
  */
 class WOLKANLIN_EXPORT AbstractConfiguration : public QObject
@@ -202,6 +245,113 @@ public:
      */
     Q_INVOKABLE virtual QString loginFlowUserAgent() const;
 
+    /*!
+     * \brief Returns an immutable snapshot of the current connection data.
+     *
+     * The snapshot will be taken from the getter functions on every call. If snapshot caching
+     * has been enabled by the subclass, it will be taken on the first call and will then be
+     * returned unchanged until invalidateSnapshot() has been called.
+     *
+     * \sa invalidateSnapshot(), setSnapshotCachingEnabled()
+     */
+    ConfigurationSnapshot snapshot() const;
+
+    /*!
+     * \brief Returns the generation of the configuration data.
+     *
+     * The generation starts at \c 0 and is increased every time the configuration data
+     * changes. Caches that depend on the configuration data can store the generation and
+     * compare it to the current one to find out if their data is stale.
+     *
+     * \sa ConfigurationSnapshot::generation()
+     */
+    quint64 generation() const;
+
+    /*!
+     * \brief Returns the provider for asynchronous credentials, if any.
+     * \sa setCredentialProvider()
+     */
+    AbstractCredentialProvider *credentialProvider() const;
+
+    /*!
+     * \brief Sets the \a provider for asynchronous credentials.
+     *
+     * If a provider is set, username() and password() will not be used by the jobs anymore,
+     * the credentials will be fetched from the \a provider instead. The cached credentials of
+     * the \a provider will be cleared if this configuration emits credentialsChanged().
+     * Set a \c nullptr to remove the provider. The configuration does not take ownership
+     * of the \a provider.
+     *
+     * \sa credentialProvider()
+     */
+    void setCredentialProvider(AbstractCredentialProvider *provider);
+
+    /*!
+     * \brief Returns \c true if session cookies are used for authentication.
+     *
+     * The default value is \c false.
+     *
+     * \sa setUseSessionCookies()
+     */
+    bool useSessionCookies() const;
+
+    /*!
+     * \brief Set \a useSessionCookies to \c true to use session cookies for authentication.
+     *
+     * Disabling the session cookies drops the current session.
+     *
+     * \sa useSessionCookies(), clearSession()
+     */
+    void setUseSessionCookies(bool useSessionCookies);
+
+    /*!
+     * \brief Returns the path to the file the session cookies are stored in.
+     * \sa setSessionFile()
+     */
+    QString sessionFile() const;
+
+    /*!
+     * \brief Sets the path to the file the session cookies are stored in to \a fileName.
+     *
+     * If the file exists, the stored session will be loaded from it. Changes to the session
+     * are written to the file. Set an empty string to keep the session only in memory, what
+     * is the default. As changed credentials or endpoints drop the session, set the file after
+     * the configuration has been set up.
+     *
+     * \warning The session cookies grant access to the account, the file will only be
+     * readable by the owner.
+     *
+     * \sa sessionFile(), setUseSessionCookies()
+     */
+    void setSessionFile(const QString &fileName);
+
+    /*!
+     * \brief Returns \c true if the login password will be converted into an application password.
+     *
+     * The default value is \c false.
+     *
+     * \sa setAutoConvertAppPassword()
+     */
+    bool autoConvertAppPassword() const;
+
+    /*!
+     * \brief Set \a autoConvert to \c true to automatically convert the login password into an application password.
+     *
+     * If enabled, the first request that succeeds with the current credentials will
+     * request an application password via GetAppPasswordJob using the same network access
+     * manager. On success, the new password will be set via setApplicationPassword() and
+     * appPasswordConverted() will be emitted. Subclasses should store the password
+     * persistently in their implementation of setPassword(). If the password already is an
+     * application password or the conversion fails, it will not be tried again until the
+     * credentials change.
+     *
+     * While a credentialProvider() is set, no conversion will be performed, because the
+     * requests use the credentials of the provider and not the ones set via setPassword().
+     *
+     * \sa autoConvertAppPassword()
+     */
+    void setAutoConvertAppPassword(bool autoConvert);
+
 public Q_SLOTS:
     /*!
      * \brief Sets login credentials requested from the login flow API and returns \c true on success.
@@ -256,7 +406,89 @@ public Q_SLOTS:
 
     bool setApplicationPassword(const QJsonObject &json);
 
+    /*!
+     * \brief Drops the current session, the next request will authenticate with the credentials.
+     *
+     * This is called automatically when credentialsChanged() or endpointChanged() is emitted.
+     *
+     * \sa setUseSessionCookies()
+     */
+    void clearSession();
+
+Q_SIGNALS:
+    /*!
+     * \brief This signal is emitted when the username or the password have been changed.
+     * \sa notifyCredentialsChanged(), generation()
+     */
+    void credentialsChanged();
+
+    /*!
+     * \brief This signal is emitted when the host, port, installation path or SSL usage have been changed.
+     * \sa notifyEndpointChanged(), generation()
+     */
+    void endpointChanged();
+
+    /*!
+     * \brief This signal is emitted when the login password has been automatically replaced by an application password.
+     * \sa setAutoConvertAppPassword()
+     */
+    void appPasswordConverted();
+
+protected:
+    /*!
+     * \brief Returns \c true if the snapshot is cached until it is invalidated.
+     * \sa setSnapshotCachingEnabled()
+     */
+    bool isSnapshotCachingEnabled() const;
+
+    /*!
+     * \brief Set \a enabled to \c true to cache the snapshot until it is invalidated.
+     *
+     * Only enable this in subclasses that call notifyCredentialsChanged(), notifyEndpointChanged()
+     * or invalidateSnapshot() whenever a value returned by the getter functions changes,
+     * otherwise the requests will keep using outdated values. By default this is disabled
+     * and snapshot() calls the getter functions for every request.
+     *
+     * \sa snapshot(), invalidateSnapshot()
+     */
+    void setSnapshotCachingEnabled(bool enabled);
+
+    /*!
+     * \brief Drops the current snapshot and increases the generation().
+     *
+     * Call this in subclasses after a value returned by one of the getter functions has been
+     * changed that is neither part of the credentials nor of the endpoint, like
+     * ignoreSslErrors(). The next call to snapshot() will take a new snapshot.
+     *
+     * \sa snapshot(), notifyCredentialsChanged(), notifyEndpointChanged()
+     */
+    void invalidateSnapshot();
+
+    /*!
+     * \brief Invalidates the snapshot and emits credentialsChanged().
+     *
+     * Call this in subclasses after the username or the password have been changed.
+     *
+     * \sa invalidateSnapshot(), notifyEndpointChanged()
+     */
+    void notifyCredentialsChanged();
+
+    /*!
+     * \brief Invalidates the snapshot and emits endpointChanged().
+     *
+     * Call this in subclasses after the host, the port, the installation path or the SSL
+     * usage have been changed.
+     *
+     * \sa invalidateSnapshot(), notifyCredentialsChanged()
+     */
+    void notifyEndpointChanged();
+
 private:
+    const std::unique_ptr<AbstractConfigurationPrivate> wl_ptr;
+
+    friend class JobPrivate;
+
+    Q_DECLARE_PRIVATE_D(wl_ptr, AbstractConfiguration)
     Q_DISABLE_COPY(AbstractConfiguration)
 };
 
@@ -0,0 +1,56 @@
+/*
+ * SPDX-FileCopyrightText: (C) 2021 Matthias Fehring / www.huessenbergnetz.de
+ * SPDX-License-Identifier: LGPL-3.0-or-later
+ */
+
+#ifndef WOLKANLIN_ABSTRACTCONFIGURATION_P_H
+#define WOLKANLIN_ABSTRACTCONFIGURATION_P_H
+
+#include "abstractconfiguration.h"
+#include "abstractcredentialprovider.h"
+#include "sessioncookiejar_p.h"
+#include <QPointer>
+
+class QNetworkAccessManager;
+
+namespace Wolkanlin {
+
+class AbstractConfigurationPrivate
+{
+public:
+    enum class AppPasswordState : quint8 {
+        Unknown,
+        Converting,
+        AppPassword,
+        Failed
+    };
+
+    explicit AbstractConfigurationPrivate(AbstractConfiguration *q);
+    ~AbstractConfigurationPrivate();
+
+    void invalidate();
+    void convertToAppPassword(const ConfigurationSnapshot &used, QNetworkAccessManager *nam);
+
+    // only used if snapshot caching is enabled, taken on first use and dropped by invalidate()
+    mutable ConfigurationSnapshot snapshot;
+    QPointer<AbstractCredentialProvider> credentialProvider;
+    QString sessionFile;
+    // only available if session cookies are enabled
+    SessionCookieJar *sessionCookieJar = nullptr;
+    AbstractConfiguration *q_ptr = nullptr;
+    quint64 generation = 0;
+    // while greater than 0, changes are only collected and the signals are emitted once afterwards
+    int blockNotifications = 0;
+    // reset to Unknown when the credentials change
+    AppPasswordState appPasswordState = AppPasswordState::Unknown;
+    bool autoConvertAppPassword = false;
+    bool snapshotCaching = false;
+
+private:
+    Q_DECLARE_PUBLIC(AbstractConfiguration)
+    Q_DISABLE_COPY(AbstractConfigurationPrivate)
+};
+
+}
+
+#endif // WOLKANLIN_ABSTRACTCONFIGURATION_P_H
@@ -0,0 +1,95 @@
+/*
+ * SPDX-FileCopyrightText: (C) 2021 Matthias Fehring / www.huessenbergnetz.de
+ * SPDX-License-Identifier: LGPL-3.0-or-later
+ */
+
+#include "abstractcredentialprovider_p.h"
+#include "logging.h"
+
+using namespace Wolkanlin;
+
+AbstractCredentialProviderPrivate::AbstractCredentialProviderPrivate(AbstractCredentialProvider *q)
+    : q_ptr(q)
+{
+
+}
+
+AbstractCredentialProviderPrivate::~AbstractCredentialProviderPrivate() = default;
+
+AbstractCredentialProvider::AbstractCredentialProvider(QObject *parent)
+    : QObject(parent), wl_ptr(new AbstractCredentialProviderPrivate(this))
+{
+
+}
+
+AbstractCredentialProvider::~AbstractCredentialProvider() = default;
+
+bool AbstractCredentialProvider::hasCredentials() const
+{
+    Q_D(const AbstractCredentialProvider);
+    return d->hasCredentials;
+}
+
+bool AbstractCredentialProvider::isFetching() const
+{
+    Q_D(const AbstractCredentialProvider);
+    return d->isFetching;
+}
+
+QString AbstractCredentialProvider::username() const
+{
+    Q_D(const AbstractCredentialProvider);
+    return d->username;
+}
+
+QString AbstractCredentialProvider::password() const
+{
+    Q_D(const AbstractCredentialProvider);
+    return d->password;
+}
+
+void AbstractCredentialProvider::fetch()
+{
+    Q_D(AbstractCredentialProvider);
+    if (d->isFetching) {
+        return;
+    }
+
+    qCDebug(wlCore) << "Fetching credentials from" << this;
+    d->isFetching = true;
+    doFetch();
+}
+
+void AbstractCredentialProvider::clear()
+{
+    Q_D(AbstractCredentialProvider);
+    if (!d->hasCredentials) {
+        return;
+    }
+
+    qCDebug(wlCore) << "Clearing cached credentials of" << this;
+    d->hasCredentials = false;
+    d->username.clear();
+    d->password.clear();
+    Q_EMIT credentialsChanged();
+}
+
+void AbstractCredentialProvider::setCredentials(const QString &username, const QString &password)
+{
+    Q_D(AbstractCredentialProvider);
+    d->isFetching = false;
+    d->hasCredentials = true;
+    d->username = username;
+    d->password = password;
+    Q_EMIT credentialsChanged();
+}
+
+void AbstractCredentialProvider::setFetchFailed(const QString &errorString)
+{
+    Q_D(AbstractCredentialProvider);
+    qCWarning(wlCore) << "Failed to fetch credentials from" << this << ":" << errorString;
+    d->isFetching = false;
+    Q_EMIT fetchFailed(errorString);
+}
+
+#include "moc_abstractcredentialprovider.cpp"
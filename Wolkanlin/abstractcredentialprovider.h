@@ -0,0 +1,128 @@
+/*
+ * SPDX-FileCopyrightText: (C) 2021 Matthias Fehring / www.huessenbergnetz.de
+ * SPDX-License-Identifier: LGPL-3.0-or-later
+ */
+
+#ifndef WOLKANLIN_ABSTRACTCREDENTIALPROVIDER_H
+#define WOLKANLIN_ABSTRACTCREDENTIALPROVIDER_H
+
+#include "wolkanlin_export.h"
+#include <QObject>
+#include <memory>
+
+namespace Wolkanlin {
+
+class AbstractCredentialProviderPrivate;
+
+/*!
+ * \brief Provides login credentials asynchronously.
+ *
+ * AbstractConfiguration::username() and AbstractConfiguration::password() are synchronous.
+ * If the credentials are stored in a place that is slow to access, like a secret service
+ * that is queried via D-Bus, the event loop would be blocked while the credentials are read.
+ * Reimplement this class and set it via AbstractConfiguration::setCredentialProvider() to
+ * fetch the credentials without blocking.
+ *
+ * A job that requires authentication calls fetch() if hasCredentials() returns \c false and
+ * waits until credentialsChanged() or fetchFailed() is emitted. All jobs that start while a
+ * fetch is running wait for the same fetch, so a burst of requests results in only one
+ * request to the credential store. The received credentials are cached until clear() is
+ * called, the configuration emits AbstractConfiguration::credentialsChanged() or the
+ * remote server rejects them.
+ *
+ * Reimplement doFetch() and call setCredentials() or setFetchFailed() when the request to
+ * the credential store has been finished.
+ *
+ * \headerfile "" <Wolkanlin/AbstractCredentialProvider>
+ */
+class WOLKANLIN_EXPORT AbstractCredentialProvider : public QObject
+{
+    Q_OBJECT
+public:
+    /*!
+     * \brief Constructs a new %AbstractCredentialProvider object with the given \a parent.
+     */
+    explicit AbstractCredentialProvider(QObject *parent = nullptr);
+
+    /*!
+     * \brief Destroys the %AbstractCredentialProvider object.
+     */
+    ~AbstractCredentialProvider() override;
+
+    /*!
+     * \brief Returns \c true if credentials have been fetched and are cached.
+     * \sa fetch(), clear()
+     */
+    bool hasCredentials() const;
+
+    /*!
+     * \brief Returns \c true while a fetch is running.
+     */
+    bool isFetching() const;
+
+    /*!
+     * \brief Returns the cached username.
+     */
+    QString username() const;
+
+    /*!
+     * \brief Returns the cached password.
+     */
+    QString password() const;
+
+public Q_SLOTS:
+    /*!
+     * \brief Starts fetching the credentials.
+     *
+     * Does nothing if a fetch is already running. Otherwise doFetch() will be called.
+     */
+    void fetch();
+
+    /*!
+     * \brief Drops the cached credentials.
+     *
+     * The next job that requires authentication will fetch them again. A running fetch
+     * is not aborted.
+     */
+    void clear();
+
+Q_SIGNALS:
+    /*!
+     * \brief This signal is emitted when new credentials are available or the cached credentials have been cleared.
+     */
+    void credentialsChanged();
+
+    /*!
+     * \brief This signal is emitted if fetching the credentials failed with \a errorString.
+     */
+    void fetchFailed(const QString &errorString);
+
+protected:
+    /*!
+     * \brief Reimplement this to start fetching the credentials.
+     *
+     * This function must not block. When the credentials are available, call setCredentials(),
+     * on failure call setFetchFailed().
+     */
+    virtual void doFetch() = 0;
+
+    /*!
+     * \brief Sets the fetched \a username and \a password and finishes the running fetch.
+     */
+    void setCredentials(const QString &username, const QString &password);
+
+    /*!
+     * \brief Finishes the running fetch with \a errorString.
+     */
+    void setFetchFailed(const QString &errorString);
+
+private:
+    const std::unique_ptr<AbstractCredentialProviderPrivate> wl_ptr;
+
+    Q_DECLARE_PRIVATE_D(wl_ptr, AbstractCredentialProvider)
+    Q_DISABLE_COPY(AbstractCredentialProvider)
+};
+
+}
+
+#endif // WOLKANLIN_ABSTRACTCREDENTIALPROVIDER_H
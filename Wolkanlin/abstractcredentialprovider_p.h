@@ -0,0 +1,32 @@
+/*
+ * SPDX-FileCopyrightText: (C) 2021 Matthias Fehring / www.huessenbergnetz.de
+ * SPDX-License-Identifier: LGPL-3.0-or-later
+ */
+
+#ifndef WOLKANLIN_ABSTRACTCREDENTIALPROVIDER_P_H
+#define WOLKANLIN_ABSTRACTCREDENTIALPROVIDER_P_H
+
+#include "abstractcredentialprovider.h"
+
+namespace Wolkanlin {
+
+class AbstractCredentialProviderPrivate
+{
+public:
+    explicit AbstractCredentialProviderPrivate(AbstractCredentialProvider *q);
+    ~AbstractCredentialProviderPrivate();
+
+    QString username;
+    QString password;
+    AbstractCredentialProvider *q_ptr = nullptr;
+    bool hasCredentials = false;
+    bool isFetching = false;
+
+private:
+    Q_DECLARE_PUBLIC(AbstractCredentialProvider)
+    Q_DISABLE_COPY(AbstractCredentialProviderPrivate)
+};
+
+}
+
+#endif // WOLKANLIN_ABSTRACTCREDENTIALPROVIDER_P_H
@@ -0,0 +1,408 @@
+/*
+ * SPDX-FileCopyrightText: (C) 2021 Matthias Fehring / www.huessenbergnetz.de
+ * SPDX-License-Identifier: LGPL-3.0-or-later
+ */
+
+#include "bulkuserfetcher_p.h"
+#include "getuserjob.h"
+#include "global.h"
+#include "logging.h"
+#include "metricsregistry.h"
+#include "stringpool.h"
+#include <QTimer>
+#include <QNetworkAccessManager>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QSet>
+#include <algorithm>
+#include <limits>
+
+using namespace Wolkanlin;
+
+BulkUserFetcherPrivate::BulkUserFetcherPrivate(BulkUserFetcher *q)
+    : q_ptr(q)
+{
+
+}
+
+BulkUserFetcherPrivate::~BulkUserFetcherPrivate() = default;
+
+void BulkUserFetcherPrivate::dispatch()
+{
+    Q_Q(BulkUserFetcher);
+
+    if (q->isFinished()) {
+        return;
+    }
+
+    // retries are preferred to not delay already started users any further
+    while (runningJobs.size() < maxConcurrentRequests && !retryQueue.empty()) {
+        startRequest(retryQueue.takeFirst());
+    }
+
+    while (runningJobs.size() < maxConcurrentRequests && nextIndex < requestIds.size()) {
+        startRequest(nextIndex++);
+    }
+
+    if (runningJobs.empty() && retryQueue.empty() && waitingRetries == 0 && nextIndex >= requestIds.size()) {
+        finish();
+    }
+}
+
+void BulkUserFetcherPrivate::startRequest(int index)
+{
+    Q_Q(BulkUserFetcher);
+
+    auto job = new GetUserJob(requestIds.at(index), q);
+    if (configuration) {
+        job->setConfiguration(configuration);
+    }
+    job->setNetworkAccessManager(networkAccessManager());
+
+    QObject::connect(job, &GetUserJob::succeeded, q, [this, index, job](const QJsonDocument &json){
+        onUserReceived(index, job, json);
+    });
+    QObject::connect(job, &GetUserJob::failed, q, [this, index, job](int errorCode, const QString &errorString){
+        onUserFailed(index, job, errorCode, errorString);
+    });
+
+    runningJobs.insert(index, job);
+    requestStarts.insert(index, elapsedTimer.elapsed());
+    job->start();
+}
+
+void BulkUserFetcherPrivate::onUserReceived(int index, GetUserJob *job, const QJsonDocument &json)
+{
+    if (runningJobs.value(index) != job) {
+        return;
+    }
+
+    Q_Q(BulkUserFetcher);
+
+    runningJobs.remove(index);
+    latencies.append(elapsedTimer.elapsed() - requestStarts.take(index));
+
+    const UserData user = UserData::fromJson(json.object(), StringPool::global());
+    if (Q_LIKELY(!user.isEmpty())) {
+        users.append(user);
+        Q_EMIT q->userReceived(user);
+    } else {
+        onUserFailed(index, nullptr, EmptyJson, QString());
+        return;
+    }
+
+    q->emitPercent(static_cast<qulonglong>(users.size() + failedIds.size()), static_cast<qulonglong>(requestIds.size()));
+
+    dispatch();
+}
+
+void BulkUserFetcherPrivate::onUserFailed(int index, GetUserJob *job, int errorCode, const QString &errorString)
+{
+    if (job) {
+        if (runningJobs.value(index) != job) {
+            return;
+        }
+        runningJobs.remove(index);
+        requestStarts.remove(index);
+    }
+
+    Q_Q(BulkUserFetcher);
+
+    const QString id = requestIds.at(index);
+    const int attempt = attempts.value(index, 0);
+
+    if (isTransientError(errorCode) && attempt < maxRetries) {
+        attempts.insert(index, attempt + 1);
+        statistics.retries++;
+        AbstractConfiguration *config = configuration ? configuration : Wolkanlin::defaultConfiguration();
+        MetricsRegistry::global()->recordRetry(QStringLiteral("GetUserJob"), config ? config->host() : QString());
+        qCWarning(wlCore) << "Request for user" << id << "failed with error" << errorCode << "- retrying," << (attempt + 1) << "of" << maxRetries;
+        scheduleRetry(index);
+        dispatch();
+        return;
+    }
+
+    qCWarning(wlCore) << "Failed to request details for user" << id << ":" << errorString;
+
+    attempts.remove(index);
+    failedIds.append(id);
+    if (firstErrorCode == 0) {
+        firstErrorCode = errorCode;
+        firstErrorText = errorString;
+    }
+
+    Q_EMIT q->userFailed(id, errorCode, errorString);
+
+    q->emitPercent(static_cast<qulonglong>(users.size() + failedIds.size()), static_cast<qulonglong>(requestIds.size()));
+
+    dispatch();
+}
+
+void BulkUserFetcherPrivate::scheduleRetry(int index)
+{
+    Q_Q(BulkUserFetcher);
+
+    const int attempt = attempts.value(index, 1);
+    const qint64 delay = qMin<qint64>(static_cast<qint64>(retryDelay) << qMin(attempt - 1, 10), std::numeric_limits<int>::max());
+
+    waitingRetries++;
+    QTimer::singleShot(static_cast<int>(delay), q, [this, index](){
+        waitingRetries--;
+        retryQueue.append(index);
+        dispatch();
+    });
+}
+
+void BulkUserFetcherPrivate::killAll()
+{
+    if (!runningJobs.empty()) {
+        qCDebug(wlCore) << "Canceling" << runningJobs.size() << "running requests";
+        const QList<GetUserJob*> jobs = runningJobs.values();
+        for (GetUserJob *job : jobs) {
+            job->kill(WJob::Quietly);
+        }
+        runningJobs.clear();
+    }
+    requestStarts.clear();
+    retryQueue.clear();
+}
+
+void BulkUserFetcherPrivate::finish()
+{
+    Q_Q(BulkUserFetcher);
+
+    statistics.requested = requestIds.size();
+    statistics.received = users.size();
+    statistics.failed = failedIds.size();
+    statistics.elapsed = elapsedTimer.isValid() ? elapsedTimer.elapsed() : 0;
+    statistics.usersPerSecond = statistics.elapsed > 0 ? (static_cast<double>(statistics.received) * 1000.0 / static_cast<double>(statistics.elapsed)) : 0.0;
+
+    QVector<qint64> sorted = latencies;
+    std::sort(sorted.begin(), sorted.end());
+    statistics.latencyP50 = percentile(sorted, 50);
+    statistics.latencyP95 = percentile(sorted, 95);
+    statistics.latencyP99 = percentile(sorted, 99);
+
+    qCDebug(wlCore) << "Received" << statistics.received << "of" << statistics.requested << "users in" << statistics.elapsed << "ms ("
+                    << statistics.usersPerSecond << "users/s, p50:" << statistics.latencyP50 << "ms, p95:" << statistics.latencyP95
+                    << "ms, p99:" << statistics.latencyP99 << "ms," << statistics.retries << "retries)";
+
+    if (users.empty() && !failedIds.empty()) {
+        q->setError(firstErrorCode);
+        q->setErrorText(firstErrorText);
+    }
+
+    q->emitResult();
+}
+
+QNetworkAccessManager *BulkUserFetcherPrivate::networkAccessManager()
+{
+    if (nam) {
+        return nam;
+    }
+
+    QNetworkAccessManager *defNam = Wolkanlin::defaultNetworkAccessManager();
+    if (defNam) {
+        return defNam;
+    }
+
+    if (!ownNam) {
+        Q_Q(BulkUserFetcher);
+        ownNam = new QNetworkAccessManager(q);
+        qCDebug(wlCore) << "Using default created" << ownNam;
+    }
+
+    return ownNam;
+}
+
+bool BulkUserFetcherPrivate::isTransientError(int errorCode)
+{
+    return errorCode == NetworkError || errorCode == RequestTimedOut || errorCode == UnknownError;
+}
+
+qint64 BulkUserFetcherPrivate::percentile(const QVector<qint64> &sorted, int p)
+{
+    if (sorted.empty()) {
+        return 0;
+    }
+
+    // nearest-rank method
+    const int rank = (p * sorted.size() + 99) / 100;
+    return sorted.at(qBound(0, rank - 1, sorted.size() - 1));
+}
+
+BulkUserFetcher::BulkUserFetcher(QObject *parent)
+    : WJob(parent), wl_ptr(new BulkUserFetcherPrivate(this))
+{
+    setCapabilities(Killable);
+}
+
+BulkUserFetcher::BulkUserFetcher(const QStringList &ids, QObject *parent)
+    : WJob(parent), wl_ptr(new BulkUserFetcherPrivate(this))
+{
+    Q_D(BulkUserFetcher);
+    d->ids = ids;
+    setCapabilities(Killable);
+}
+
+BulkUserFetcher::~BulkUserFetcher() = default;
+
+void BulkUserFetcher::start()
+{
+    QTimer::singleShot(0, this, [this](){
+        Q_D(BulkUserFetcher);
+
+        if (Q_UNLIKELY(isFinished())) {
+            return;
+        }
+
+        // every user is only requested once
+        d->requestIds.clear();
+        d->requestIds.reserve(d->ids.size());
+        QSet<QString> seen;
+        seen.reserve(d->ids.size());
+        for (const QString &id : d->ids) {
+            if (!id.isEmpty() && !seen.contains(id)) {
+                seen.insert(id);
+                d->requestIds.append(id);
+            }
+        }
+
+        if (Q_UNLIKELY(d->requestIds.empty())) {
+            qCCritical(wlCore) << "Can not request user details for an empty list of user ids.";
+            setError(EmptyUser);
+            emitResult();
+            return;
+        }
+
+        qCDebug(wlCore) << "Requesting details for" << d->requestIds.size() << "users with up to" << d->maxConcurrentRequests << "concurrent requests.";
+
+        d->users.reserve(d->requestIds.size());
+        d->latencies.reserve(d->requestIds.size());
+        setTotalAmount(WJob::Items, static_cast<qulonglong>(d->requestIds.size()));
+        d->elapsedTimer.start();
+        d->dispatch();
+    });
+}
+
+bool BulkUserFetcher::doKill()
+{
+    Q_D(BulkUserFetcher);
+    d->killAll();
+    return true;
+}
+
+AbstractConfiguration *BulkUserFetcher::configuration() const
+{
+    Q_D(const BulkUserFetcher);
+    return d->configuration;
+}
+
+void BulkUserFetcher::setConfiguration(AbstractConfiguration *configuration)
+{
+    Q_D(BulkUserFetcher);
+    if (d->configuration != configuration) {
+        qCDebug(wlCore) << "Changing configuration from" << d->configuration << "to" << configuration;
+        d->configuration = configuration;
+        Q_EMIT configurationChanged(d->configuration);
+    }
+}
+
+QStringList BulkUserFetcher::ids() const
+{
+    Q_D(const BulkUserFetcher);
+    return d->ids;
+}
+
+void BulkUserFetcher::setIds(const QStringList &ids)
+{
+    Q_D(BulkUserFetcher);
+    if (d->ids != ids) {
+        qCDebug(wlCore) << "Changing ids to" << ids.size() << "user ids";
+        d->ids = ids;
+        Q_EMIT idsChanged(d->ids);
+    }
+}
+
+int BulkUserFetcher::maxConcurrentRequests() const
+{
+    Q_D(const BulkUserFetcher);
+    return d->maxConcurrentRequests;
+}
+
+void BulkUserFetcher::setMaxConcurrentRequests(int maxConcurrentRequests)
+{
+    Q_D(BulkUserFetcher);
+    maxConcurrentRequests = qMax(maxConcurrentRequests, 1);
+    if (d->maxConcurrentRequests != maxConcurrentRequests) {
+        qCDebug(wlCore) << "Changing maxConcurrentRequests from" << d->maxConcurrentRequests << "to" << maxConcurrentRequests;
+        d->maxConcurrentRequests = maxConcurrentRequests;
+        Q_EMIT maxConcurrentRequestsChanged(d->maxConcurrentRequests);
+    }
+}
+
+int BulkUserFetcher::maxRetries() const
+{
+    Q_D(const BulkUserFetcher);
+    return d->maxRetries;
+}
+
+void BulkUserFetcher::setMaxRetries(int maxRetries)
+{
+    Q_D(BulkUserFetcher);
+    maxRetries = qMax(maxRetries, 0);
+    if (d->maxRetries != maxRetries) {
+        qCDebug(wlCore) << "Changing maxRetries from" << d->maxRetries << "to" << maxRetries;
+        d->maxRetries = maxRetries;
+        Q_EMIT maxRetriesChanged(d->maxRetries);
+    }
+}
+
+int BulkUserFetcher::retryDelay() const
+{
+    Q_D(const BulkUserFetcher);
+    return d->retryDelay;
+}
+
+void BulkUserFetcher::setRetryDelay(int retryDelay)
+{
+    Q_D(BulkUserFetcher);
+    retryDelay = qMax(retryDelay, 0);
+    if (d->retryDelay != retryDelay) {
+        qCDebug(wlCore) << "Changing retryDelay from" << d->retryDelay << "to" << retryDelay;
+        d->retryDelay = retryDelay;
+        Q_EMIT retryDelayChanged(d->retryDelay);
+    }
+}
+
+QNetworkAccessManager *BulkUserFetcher::networkAccessManager() const
+{
+    Q_D(const BulkUserFetcher);
+    return d->nam ? d->nam : d->ownNam;
+}
+
+void BulkUserFetcher::setNetworkAccessManager(QNetworkAccessManager *nam)
+{
+    Q_D(BulkUserFetcher);
+    d->nam = nam;
+}
+
+QVector<UserData> BulkUserFetcher::users() const
+{
+    Q_D(const BulkUserFetcher);
+    return d->users;
+}
+
+QStringList BulkUserFetcher::failedIds() const
+{
+    Q_D(const BulkUserFetcher);
+    return d->failedIds;
+}
+
+BulkUserFetcher::Statistics BulkUserFetcher::statistics() const
+{
+    Q_D(const BulkUserFetcher);
+    return d->statistics;
+}
+
+#include "moc_bulkuserfetcher.cpp"
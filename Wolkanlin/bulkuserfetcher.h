@@ -0,0 +1,314 @@
+/*
+ * SPDX-FileCopyrightText: (C) 2021 Matthias Fehring / www.huessenbergnetz.de
+ * SPDX-License-Identifier: LGPL-3.0-or-later
+ */
+
+#ifndef WOLKANLIN_BULKUSERFETCHER_H
+#define WOLKANLIN_BULKUSERFETCHER_H
+
+#include "wolkanlin_export.h"
+#include "job.h"
+#include "userdata.h"
+#include <QObject>
+#include <QStringList>
+#include <QVector>
+#include <memory>
+
+class QNetworkAccessManager;
+
+namespace Wolkanlin {
+
+class BulkUserFetcherPrivate;
+
+/*!
+ * \brief Requests the details of an arbitrary list of users with bounded concurrency.
+ *
+ * %BulkUserFetcher takes a list of user \link BulkUserFetcher::ids ids\endlink, for example
+ * from GetUserListJob, and requests the details for every user via GetUserJob. Not more than
+ * \link BulkUserFetcher::maxConcurrentRequests maxConcurrentRequests\endlink requests are
+ * performed at the same time, all of them using the same network access manager, so that
+ * the connections to the remote host are reused. Use this if the user details endpoint used
+ * by GetUserDetailsListJob is not available.
+ *
+ * Every user is decoded with UserData::fromJson() using the global StringPool and emitted
+ * via userReceived() as soon as it has been received. Requests that failed because of network
+ * errors or timeouts are retried up to \link BulkUserFetcher::maxRetries maxRetries\endlink
+ * times with an exponentially growing delay, starting at
+ * \link BulkUserFetcher::retryDelay retryDelay\endlink. Other errors, like not existing users,
+ * are reported via userFailed() without retrying.
+ *
+ * The fetcher finishes without an error if at least one user has been received or if no user
+ * failed. Failed users can be queried via failedIds(). If all users failed, error() returns
+ * the error code of the first failure. After WJob::result() has been emitted, statistics()
+ * returns throughput and latency information.
+ *
+ * \par Mandatory properties
+ * \li BulkUserFetcher::ids
+ *
+ * <H3 id="bulkuserfetcher-usage-examples">Usage examples</H3>
+ * \include bulk-user-fetcher-async.cpp
+ *
+ * \headerfile "" <Wolkanlin/BulkUserFetcher>
+ */
+class WOLKANLIN_EXPORT BulkUserFetcher : public WJob
+{
+    Q_OBJECT
+    /*!
+     * \brief Pointer to an object providing configuration data.
+     *
+     * The configuration will be set on all requests. If it is a \c nullptr, the global
+     * default configuration will be used. See Job::configuration.
+     *
+     * \par Access methods
+     * \li AbstractConfiguration *configuration() const
+     * \li void setConfiguration(AbstractConfiguration *configuration)
+     *
+     * \par Notifier signal
+     * \li void configurationChanged(Wolkanlin::AbstractConfiguration *configuration)
+     */
+    Q_PROPERTY(Wolkanlin::AbstractConfiguration *configuration READ configuration WRITE setConfiguration NOTIFY configurationChanged)
+    /*!
+     * \brief List of user IDs to request the details for.
+     *
+     * Duplicate IDs will only be requested once.
+     *
+     * \par Access methods
+     * \li QStringList ids() const
+     * \li void setIds(const QStringList &ids)
+     *
+     * \par Notifier signal
+     * \li void idsChanged(const QStringList &ids)
+     */
+    Q_PROPERTY(QStringList ids READ ids WRITE setIds NOTIFY idsChanged)
+    /*!
+     * \brief Maximum number of concurrently running requests.
+     *
+     * Values lower than \c 1 will be set to \c 1. Default value: \c 6
+     *
+     * \par Access methods
+     * \li int maxConcurrentRequests() const
+     * \li void setMaxConcurrentRequests(int maxConcurrentRequests)
+     *
+     * \par Notifier signal
+     * \li void maxConcurrentRequestsChanged(int maxConcurrentRequests)
+     */
+    Q_PROPERTY(int maxConcurrentRequests READ maxConcurrentRequests WRITE setMaxConcurrentRequests NOTIFY maxConcurrentRequestsChanged)
+    /*!
+     * \brief Maximum number of retries for a request that failed with a transient error.
+     *
+     * Set this to \c 0 to disable retries. Default value: \c 2
+     *
+     * \par Access methods
+     * \li int maxRetries() const
+     * \li void setMaxRetries(int maxRetries)
+     *
+     * \par Notifier signal
+     * \li void maxRetriesChanged(int maxRetries)
+     */
+    Q_PROPERTY(int maxRetries READ maxRetries WRITE setMaxRetries NOTIFY maxRetriesChanged)
+    /*!
+     * \brief Delay in milliseconds before the first retry of a failed request.
+     *
+     * The delay is doubled for every further retry of the same request. Default value: \c 500
+     *
+     * \par Access methods
+     * \li int retryDelay() const
+     * \li void setRetryDelay(int retryDelay)
+     *
+     * \par Notifier signal
+     * \li void retryDelayChanged(int retryDelay)
+     */
+    Q_PROPERTY(int retryDelay READ retryDelay WRITE setRetryDelay NOTIFY retryDelayChanged)
+public:
+    /*!
+     * \brief Aggregated statistics of a finished %BulkUserFetcher.
+     */
+    struct Statistics {
+        int requested = 0;              /**< Number of distinct users that have been requested. */
+        int received = 0;               /**< Number of users that have been received. */
+        int failed = 0;                 /**< Number of users that could not be received. */
+        int retries = 0;                /**< Number of retried requests. */
+        qint64 elapsed = 0;             /**< Time in milliseconds from start to finish. */
+        double usersPerSecond = 0.0;    /**< Number of received users per second. */
+        qint64 latencyP50 = 0;          /**< Median latency of successful requests in milliseconds. */
+        qint64 latencyP95 = 0;          /**< 95th percentile latency of successful requests in milliseconds. */
+        qint64 latencyP99 = 0;          /**< 99th percentile latency of successful requests in milliseconds. */
+    };
+
+    /*!
+     * \brief Constructs a new %BulkUserFetcher object with the given \a parent.
+     */
+    explicit BulkUserFetcher(QObject *parent = nullptr);
+
+    /*!
+     * \brief Constructs a new %BulkUserFetcher object with the given parameters.
+     * \param ids       list of user IDs to request the details for
+     * \param parent    pointer to a parent object
+     */
+    explicit BulkUserFetcher(const QStringList &ids, QObject *parent = nullptr);
+
+    /*!
+     * \brief Destroys the %BulkUserFetcher object.
+     */
+    ~BulkUserFetcher() override;
+
+    /*!
+     * \brief Starts the requests asynchronously.
+     */
+    void start() override;
+
+    /*!
+     * \brief Getter function for the \link BulkUserFetcher::configuration configuration\endlink property.
+     * \sa setConfiguration(), configurationChanged()
+     */
+    AbstractConfiguration *configuration() const;
+
+    /*!
+     * \brief Setter function for the \link BulkUserFetcher::configuration configuration\endlink property.
+     * \sa configuration(), configurationChanged()
+     */
+    void setConfiguration(AbstractConfiguration *configuration);
+
+    /*!
+     * \brief Getter function for the \link BulkUserFetcher::ids ids\endlink property.
+     * \sa setIds(), idsChanged()
+     */
+    QStringList ids() const;
+
+    /*!
+     * \brief Setter function for the \link BulkUserFetcher::ids ids\endlink property.
+     * \sa ids(), idsChanged()
+     */
+    void setIds(const QStringList &ids);
+
+    /*!
+     * \brief Getter function for the \link BulkUserFetcher::maxConcurrentRequests maxConcurrentRequests\endlink property.
+     * \sa setMaxConcurrentRequests(), maxConcurrentRequestsChanged()
+     */
+    int maxConcurrentRequests() const;
+
+    /*!
+     * \brief Setter function for the \link BulkUserFetcher::maxConcurrentRequests maxConcurrentRequests\endlink property.
+     * \sa maxConcurrentRequests(), maxConcurrentRequestsChanged()
+     */
+    void setMaxConcurrentRequests(int maxConcurrentRequests);
+
+    /*!
+     * \brief Getter function for the \link BulkUserFetcher::maxRetries maxRetries\endlink property.
+     * \sa setMaxRetries(), maxRetriesChanged()
+     */
+    int maxRetries() const;
+
+    /*!
+     * \brief Setter function for the \link BulkUserFetcher::maxRetries maxRetries\endlink property.
+     * \sa maxRetries(), maxRetriesChanged()
+     */
+    void setMaxRetries(int maxRetries);
+
+    /*!
+     * \brief Getter function for the \link BulkUserFetcher::retryDelay retryDelay\endlink property.
+     * \sa setRetryDelay(), retryDelayChanged()
+     */
+    int retryDelay() const;
+
+    /*!
+     * \brief Setter function for the \link BulkUserFetcher::retryDelay retryDelay\endlink property.
+     * \sa retryDelay(), retryDelayChanged()
+     */
+    void setRetryDelay(int retryDelay);
+
+    /*!
+     * \brief Returns the network access manager used for all requests.
+     * \sa setNetworkAccessManager()
+     */
+    QNetworkAccessManager *networkAccessManager() const;
+
+    /*!
+     * \brief Sets the network access manager \a nam used for all requests.
+     *
+     * If no network access manager is set, Wolkanlin::defaultNetworkAccessManager() will be
+     * used. If that is also not available, the fetcher will create its own one. The fetcher
+     * does not take ownership of \a nam.
+     *
+     * \sa networkAccessManager()
+     */
+    void setNetworkAccessManager(QNetworkAccessManager *nam);
+
+    /*!
+     * \brief Returns the received users in the order they have been received.
+     */
+    QVector<UserData> users() const;
+
+    /*!
+     * \brief Returns the IDs of the users that could not be received.
+     */
+    QStringList failedIds() const;
+
+    /*!
+     * \brief Returns the statistics of the fetcher.
+     *
+     * The values are complete after WJob::result() has been emitted.
+     */
+    Statistics statistics() const;
+
+protected:
+    /*!
+     * \brief Aborts all running and pending requests.
+     *
+     * Reimplemented from WJob::doKill().
+     */
+    bool doKill() override;
+
+Q_SIGNALS:
+    /*!
+     * \brief Notifier signal for the \link BulkUserFetcher::configuration configuration\endlink property.
+     * \sa setConfiguration(), configuration()
+     */
+    void configurationChanged(Wolkanlin::AbstractConfiguration *configuration);
+
+    /*!
+     * \brief Notifier signal for the \link BulkUserFetcher::ids ids\endlink property.
+     * \sa setIds(), ids()
+     */
+    void idsChanged(const QStringList &ids);
+
+    /*!
+     * \brief Notifier signal for the \link BulkUserFetcher::maxConcurrentRequests maxConcurrentRequests\endlink property.
+     * \sa setMaxConcurrentRequests(), maxConcurrentRequests()
+     */
+    void maxConcurrentRequestsChanged(int maxConcurrentRequests);
+
+    /*!
+     * \brief Notifier signal for the \link BulkUserFetcher::maxRetries maxRetries\endlink property.
+     * \sa setMaxRetries(), maxRetries()
+     */
+    void maxRetriesChanged(int maxRetries);
+
+    /*!
+     * \brief Notifier signal for the \link BulkUserFetcher::retryDelay retryDelay\endlink property.
+     * \sa setRetryDelay(), retryDelay()
+     */
+    void retryDelayChanged(int retryDelay);
+
+    /*!
+     * \brief Emitted for every \a user as soon as it has been received.
+     */
+    void userReceived(const Wolkanlin::UserData &user);
+
+    /*!
+     * \brief Emitted if the user with \a id could not be received.
+     *
+     * \a errorCode and \a errorString are the error of the last failed request.
+     */
+    void userFailed(const QString &id, int errorCode, const QString &errorString);
+
+private:
+    const std::unique_ptr<BulkUserFetcherPrivate> wl_ptr;
+
+    Q_DECLARE_PRIVATE_D(wl_ptr, BulkUserFetcher)
+    Q_DISABLE_COPY(BulkUserFetcher)
+};
+
+}
+
+#endif // WOLKANLIN_BULKUSERFETCHER_H
@@ -0,0 +1,65 @@
+/*
+ * SPDX-FileCopyrightText: (C) 2021 Matthias Fehring / www.huessenbergnetz.de
+ * SPDX-License-Identifier: LGPL-3.0-or-later
+ */
+
+#ifndef WOLKANLIN_BULKUSERFETCHER_P_H
+#define WOLKANLIN_BULKUSERFETCHER_P_H
+
+#include "bulkuserfetcher.h"
+#include <QHash>
+#include <QElapsedTimer>
+
+namespace Wolkanlin {
+
+class GetUserJob;
+
+class BulkUserFetcherPrivate
+{
+public:
+    explicit BulkUserFetcherPrivate(BulkUserFetcher *q);
+    ~BulkUserFetcherPrivate();
+
+    void dispatch();
+    void startRequest(int index);
+    void onUserReceived(int index, GetUserJob *job, const QJsonDocument &json);
+    void onUserFailed(int index, GetUserJob *job, int errorCode, const QString &errorString);
+    void scheduleRetry(int index);
+    void killAll();
+    void finish();
+    QNetworkAccessManager *networkAccessManager();
+
+    static bool isTransientError(int errorCode);
+    static qint64 percentile(const QVector<qint64> &sorted, int p);
+
+    QStringList ids;
+    QStringList requestIds;
+    QStringList failedIds;
+    QVector<UserData> users;
+    QVector<qint64> latencies;
+    QVector<int> retryQueue;
+    QHash<int, int> attempts;
+    QHash<int, qint64> requestStarts;
+    QHash<int, GetUserJob*> runningJobs;
+    QElapsedTimer elapsedTimer;
+    BulkUserFetcher::Statistics statistics;
+    QNetworkAccessManager *nam = nullptr;
+    QNetworkAccessManager *ownNam = nullptr;
+    AbstractConfiguration *configuration = nullptr;
+    BulkUserFetcher *q_ptr = nullptr;
+    QString firstErrorText;
+    int nextIndex = 0;
+    int waitingRetries = 0;
+    int firstErrorCode = 0;
+    int maxConcurrentRequests = 6;
+    int maxRetries = 2;
+    int retryDelay = 500;
+
+private:
+    Q_DECLARE_PUBLIC(BulkUserFetcher)
+    Q_DISABLE_COPY(BulkUserFetcherPrivate)
+};
+
+}
+
+#endif // WOLKANLIN_BULKUSERFETCHER_P_H
@@ -0,0 +1,198 @@
+/*
+ * SPDX-FileCopyrightText: (C) 2021 Matthias Fehring / www.huessenbergnetz.de
+ * SPDX-License-Identifier: LGPL-3.0-or-later
+ */
+
+#ifndef WOLKANLIN_CBOR_P_H
+#define WOLKANLIN_CBOR_P_H
+
+#include <QtGlobal>
+
+#if QT_VERSION >= QT_VERSION_CHECK(5, 12, 0)
+
+#include <QCborStreamReader>
+#include <QCborStreamWriter>
+#include <QString>
+#include <QStringList>
+
+namespace Wolkanlin {
+
+/*
+ * Helpers for the CBOR encoding of the model types.
+ *
+ * Every model type is encoded as a map with unsigned integer keys. The maps are written
+ * with indefinite length, so they can be streamed, and optional values that equal the
+ * default value of a field are omitted. Readers skip keys they do not know, so new fields
+ * can be added with new keys without breaking older readers. Existing keys must never be
+ * changed or reused.
+ */
+namespace Cbor {
+
+enum QuotaKey : quint8 {
+    QuotaFree       = 0,
+    QuotaUsed       = 1,
+    QuotaQuota      = 2,
+    QuotaTotal      = 3,
+    QuotaRelative   = 4
+};
+
+enum UserKey : quint8 {
+    UserId                  = 0,
+    UserEnabled             = 1,
+    UserStorageLocation     = 2,
+    UserLastLogin           = 3,
+    UserBackend             = 4,
+    UserSubadmin            = 5,
+    UserQuota               = 6,
+    UserEmail               = 7,
+    UserDisplayname         = 8,
+    UserPhone               = 9,
+    UserAddress             = 10,
+    UserWebsite             = 11,
+    UserTwitter             = 12,
+    UserGroups              = 13,
+    UserLanguage            = 14,
+    UserLocale              = 15,
+    UserBackendCapabilities = 16
+};
+
+enum ServerStatusKey : quint8 {
+    ServerStatusInstalled       = 0,
+    ServerStatusMaintenance     = 1,
+    ServerStatusNeedsDbUpgrade  = 2,
+    ServerStatusVersion         = 3,
+    ServerStatusVersionstring   = 4,
+    ServerStatusEdition         = 5,
+    ServerStatusProductname     = 6,
+    ServerStatusExtendedSupport = 7
+};
+
+inline void writeKey(QCborStreamWriter &writer, quint8 key)
+{
+    writer.append(static_cast<quint64>(key));
+}
+
+inline void writeString(QCborStreamWriter &writer, quint8 key, const QString &value)
+{
+    if (!value.isEmpty()) {
+        writeKey(writer, key);
+        writer.append(value);
+    }
+}
+
+inline void writeStringList(QCborStreamWriter &writer, quint8 key, const QStringList &value)
+{
+    if (!value.empty()) {
+        writeKey(writer, key);
+        writer.startArray(static_cast<quint64>(value.size()));
+        for (const QString &str : value) {
+            writer.append(str);
+        }
+        writer.endArray();
+    }
+}
+
+inline void writeInteger(QCborStreamWriter &writer, quint8 key, qint64 value)
+{
+    if (value != 0) {
+        writeKey(writer, key);
+        writer.append(value);
+    }
+}
+
+inline void writeBool(QCborStreamWriter &writer, quint8 key, bool value)
+{
+    if (value) {
+        writeKey(writer, key);
+        writer.append(true);
+    }
+}
+
+/*
+ * Reads the key at the current position and advances to the value. Returns -1 if the key
+ * is not an unsigned integer, the value should be skipped with QCborStreamReader::next() then.
+ */
+inline qint64 readKey(QCborStreamReader &reader)
+{
+    const qint64 key = reader.isUnsignedInteger() ? static_cast<qint64>(reader.toUnsignedInteger()) : -1;
+    reader.next();
+    return key;
+}
+
+inline QString readString(QCborStreamReader &reader)
+{
+    if (!reader.isString()) {
+        reader.next();
+        return QString();
+    }
+
+    QString str;
+    auto result = reader.readString();
+    while (result.status == QCborStreamReader::Ok) {
+        str += result.data;
+        result = reader.readString();
+    }
+    return result.status == QCborStreamReader::EndOfString ? str : QString();
+}
+
+inline QStringList readStringList(QCborStreamReader &reader)
+{
+    QStringList list;
+    if (!reader.isArray()) {
+        reader.next();
+        return list;
+    }
+
+    if (reader.isLengthKnown()) {
+        list.reserve(static_cast<int>(qMin<quint64>(reader.length(), 1024)));
+    }
+
+    if (reader.enterContainer()) {
+        while (reader.lastError() == QCborError::NoError && reader.hasNext()) {
+            list.append(readString(reader));
+        }
+        reader.leaveContainer();
+    }
+    return list;
+}
+
+inline qint64 readInteger(QCborStreamReader &reader)
+{
+    qint64 value = 0;
+    if (reader.isInteger()) {
+        value = reader.toInteger();
+    } else if (reader.isDouble()) {
+        value = static_cast<qint64>(reader.toDouble());
+    }
+    reader.next();
+    return value;
+}
+
+inline double readDouble(QCborStreamReader &reader)
+{
+    double value = 0.0;
+    if (reader.isDouble()) {
+        value = reader.toDouble();
+    } else if (reader.isFloat()) {
+        value = static_cast<double>(reader.toFloat());
+    } else if (reader.isInteger()) {
+        value = static_cast<double>(reader.toInteger());
+    }
+    reader.next();
+    return value;
+}
+
+inline bool readBool(QCborStreamReader &reader)
+{
+    const bool value = reader.isBool() && reader.toBool();
+    reader.next();
+    return value;
+}
+
+}
+
+}
+
+#endif // QT_VERSION >= QT_VERSION_CHECK(5, 12, 0)
+
+#endif // WOLKANLIN_CBOR_P_H
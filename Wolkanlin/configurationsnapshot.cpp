@@ -0,0 +1,117 @@
+/*
+ * SPDX-FileCopyrightText: (C) 2021 Matthias Fehring / www.huessenbergnetz.de
+ * SPDX-License-Identifier: LGPL-3.0-or-later
+ */
+
+#include "configurationsnapshot_p.h"
+#include "abstractconfiguration.h"
+#include "abstractcredentialprovider.h"
+#include <QUrl>
+
+using namespace Wolkanlin;
+
+ConfigurationSnapshot::ConfigurationSnapshot()
+{
+
+}
+
+ConfigurationSnapshot::ConfigurationSnapshot(const AbstractConfiguration *configuration)
+{
+    if (configuration) {
+        d = new ConfigurationSnapshotPrivate;
+        const AbstractCredentialProvider *provider = configuration->credentialProvider();
+        if (provider) {
+            d->username = provider->username();
+            d->password = provider->password();
+        } else {
+            d->username = configuration->username();
+            d->password = configuration->password();
+        }
+        d->host = configuration->host();
+        d->port = configuration->port();
+        d->installPath = configuration->installPath();
+        d->useSsl = configuration->useSsl();
+        d->ignoreSslErrors = configuration->ignoreSslErrors();
+        d->userAgent = configuration->userAgent();
+        d->generation = configuration->generation();
+        if (!d->username.isEmpty()) {
+            const QString auth = d->username + QLatin1Char(':') + d->password;
+            d->authorizationHeader = QByteArrayLiteral("Basic ") + auth.toUtf8().toBase64();
+        }
+    }
+}
+
+ConfigurationSnapshot::ConfigurationSnapshot(const ConfigurationSnapshot &other) = default;
+ConfigurationSnapshot::ConfigurationSnapshot(ConfigurationSnapshot &&other) noexcept = default;
+ConfigurationSnapshot& ConfigurationSnapshot::operator=(const ConfigurationSnapshot &other) = default;
+ConfigurationSnapshot& ConfigurationSnapshot::operator=(ConfigurationSnapshot &&other) noexcept = default;
+ConfigurationSnapshot::~ConfigurationSnapshot() = default;
+
+bool ConfigurationSnapshot::isNull() const
+{
+    return d == nullptr;
+}
+
+QString ConfigurationSnapshot::username() const
+{
+    return d ? d->username : QString();
+}
+
+QString ConfigurationSnapshot::password() const
+{
+    return d ? d->password : QString();
+}
+
+QString ConfigurationSnapshot::host() const
+{
+    return d ? d->host : QString();
+}
+
+int ConfigurationSnapshot::port() const
+{
+    return d ? d->port : 0;
+}
+
+QString ConfigurationSnapshot::installPath() const
+{
+    return d ? d->installPath : QString();
+}
+
+bool ConfigurationSnapshot::useSsl() const
+{
+    return d ? d->useSsl : true;
+}
+
+bool ConfigurationSnapshot::ignoreSslErrors() const
+{
+    return d ? d->ignoreSslErrors : false;
+}
+
+QString ConfigurationSnapshot::userAgent() const
+{
+    return d ? d->userAgent : QString();
+}
+
+quint64 ConfigurationSnapshot::generation() const
+{
+    return d ? d->generation : 0;
+}
+
+QUrl ConfigurationSnapshot::serverUrl() const
+{
+    QUrl url;
+    if (d) {
+        url.setScheme(d->useSsl ? QStringLiteral("https") : QStringLiteral("http"));
+        url.setHost(d->host);
+        if (d->port != 0) {
+            url.setPort(d->port);
+        }
+        url.setPath(d->installPath);
+    }
+    return url;
+}
+
+QByteArray ConfigurationSnapshot::authorizationHeader() const
+{
+    return d ? d->authorizationHeader : QByteArray();
+}
@@ -0,0 +1,149 @@
+/*
+ * SPDX-FileCopyrightText: (C) 2021 Matthias Fehring / www.huessenbergnetz.de
+ * SPDX-License-Identifier: LGPL-3.0-or-later
+ */
+
+#ifndef WOLKANLIN_CONFIGURATIONSNAPSHOT_H
+#define WOLKANLIN_CONFIGURATIONSNAPSHOT_H
+
+#include "wolkanlin_export.h"
+#include <QSharedDataPointer>
+#include <QString>
+#include <QByteArray>
+
+class QUrl;
+
+namespace Wolkanlin {
+
+class AbstractConfiguration;
+class ConfigurationSnapshotPrivate;
+
+/*!
+ * \brief Immutable copy of the connection data of an AbstractConfiguration.
+ *
+ * A %ConfigurationSnapshot calls every getter of an AbstractConfiguration exactly once
+ * when it is constructed and stores the returned values. It is implicitly shared, so
+ * copying it is cheap. The jobs read the connection data from the snapshot returned by
+ * AbstractConfiguration::snapshot() instead of calling the virtual getters of the
+ * configuration for every request, what is especially useful if the getters are
+ * expensive, like reading the password from a keychain.
+ *
+ * \headerfile "" <Wolkanlin/ConfigurationSnapshot>
+ */
+class WOLKANLIN_EXPORT ConfigurationSnapshot
+{
+public:
+    /*!
+     * \brief Constructs a null %ConfigurationSnapshot.
+     * \sa isNull()
+     */
+    ConfigurationSnapshot();
+    /*!
+     * \brief Constructs a new %ConfigurationSnapshot from the current values of \a configuration.
+     *
+     * If \a configuration is a \c nullptr, a null snapshot will be constructed.
+     */
+    explicit ConfigurationSnapshot(const AbstractConfiguration *configuration);
+    /*!
+     * \brief Constructs a copy of \a other.
+     */
+    ConfigurationSnapshot(const ConfigurationSnapshot &other);
+    /*!
+     * \brief Move-constructs a %ConfigurationSnapshot instance, making it point at the same object that \a other was pointing to.
+     */
+    ConfigurationSnapshot(ConfigurationSnapshot &&other) noexcept;
+
+    /*!
+     * \brief Destroys the %ConfigurationSnapshot object.
+     */
+    ~ConfigurationSnapshot();
+
+    /*!
+     * \brief Assigns \a other to this %ConfigurationSnapshot and returns a reference to this instance.
+     */
+    ConfigurationSnapshot &operator=(const ConfigurationSnapshot &other);
+    /*!
+     * \brief Move-assigns \a other to this %ConfigurationSnapshot instance.
+     */
+    ConfigurationSnapshot &operator=(ConfigurationSnapshot &&other) noexcept;
+
+    /*!
+     * \brief Returns \c true if this %ConfigurationSnapshot is null; otherwise returns \c false.
+     *
+     * A null %ConfigurationSnapshot has not been taken from a configuration.
+     */
+    bool isNull() const;
+
+    /*!
+     * \brief Returns the \link AbstractConfiguration::username() username\endlink.
+     *
+     * If the configuration has a \link AbstractConfiguration::credentialProvider() credential provider\endlink,
+     * this is the username cached by the provider, the same applies to password().
+     */
+    QString username() const;
+
+    /*!
+     * \brief Returns the \link AbstractConfiguration::password() password\endlink.
+     */
+    QString password() const;
+
+    /*!
+     * \brief Returns the remote \link AbstractConfiguration::host() host\endlink name.
+     */
+    QString host() const;
+
+    /*!
+     * \brief Returns the remote \link AbstractConfiguration::port() port\endlink.
+     */
+    int port() const;
+
+    /*!
+     * \brief Returns the \link AbstractConfiguration::installPath() installation path\endlink.
+     */
+    QString installPath() const;
+
+    /*!
+     * \brief Returns \c true if HTTPS should be \link AbstractConfiguration::useSsl() used\endlink.
+     *
+     * A null snapshot returns \c true.
+     */
+    bool useSsl() const;
+
+    /*!
+     * \brief Returns \c true if SSL errors should be \link AbstractConfiguration::ignoreSslErrors() ignored\endlink.
+     */
+    bool ignoreSslErrors() const;
+
+    /*!
+     * \brief Returns the \link AbstractConfiguration::userAgent() user agent\endlink string.
+     */
+    QString userAgent() const;
+
+    /*!
+     * \brief Returns the \link AbstractConfiguration::generation() generation\endlink of the configuration data.
+     *
+     * If the generation of the snapshot is lower than the current generation of the
+     * configuration it has been taken from, the snapshot is outdated.
+     */
+    quint64 generation() const;
+
+    /*!
+     * \brief Returns the URL of the remote server build from useSsl(), host(), port() and installPath().
+     */
+    QUrl serverUrl() const;
+
+    /*!
+     * \brief Returns the value for the HTTP Basic \c Authorization header.
+     *
+     * The value is build once from username() and password() when the snapshot is taken.
+     * Returns an empty byte array if the username is empty.
+     */
+    QByteArray authorizationHeader() const;
+
+private:
+    QSharedDataPointer<ConfigurationSnapshotPrivate> d;
+};
+
+}
+
+#endif // WOLKANLIN_CONFIGURATIONSNAPSHOT_H
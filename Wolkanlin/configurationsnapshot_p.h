@@ -0,0 +1,31 @@
+/*
+ * SPDX-FileCopyrightText: (C) 2021 Matthias Fehring / www.huessenbergnetz.de
+ * SPDX-License-Identifier: LGPL-3.0-or-later
+ */
+
+#ifndef WOLKANLIN_CONFIGURATIONSNAPSHOT_P_H
+#define WOLKANLIN_CONFIGURATIONSNAPSHOT_P_H
+
+#include "configurationsnapshot.h"
+#include <QSharedData>
+
+namespace Wolkanlin {
+
+class ConfigurationSnapshotPrivate : public QSharedData
+{
+public:
+    QString username;
+    QString password;
+    QString host;
+    QString installPath;
+    QString userAgent;
+    QByteArray authorizationHeader;
+    quint64 generation = 0;
+    int port = 0;
+    bool useSsl = true;
+    bool ignoreSslErrors = false;
+};
+
+}
+
+#endif // WOLKANLIN_CONFIGURATIONSNAPSHOT_P_H
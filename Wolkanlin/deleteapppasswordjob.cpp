@@ -5,7 +5,6 @@
 
 #include "deleteapppasswordjob_p.h"
 #include "logging.h"
-#include <QTimer>
 
 using namespace Wolkanlin;
 
@@ -14,6 +13,7 @@ DeleteAppPasswordJobPrivate::DeleteAppPasswordJobPrivate(DeleteAppPasswordJob *q
 {
     namOperation = NetworkOperation::Delete;
     expectedContentType = ExpectedContentType::JsonObject;
+    handlesAppPassword = true;
 }
 
 DeleteAppPasswordJobPrivate::~DeleteAppPasswordJobPrivate() = default;
@@ -42,7 +42,7 @@ DeleteAppPasswordJob::~DeleteAppPasswordJob() = default;
 
 void DeleteAppPasswordJob::start()
 {
-    QTimer::singleShot(0, this, &DeleteAppPasswordJob::sendRequest);
+    queueRequest();
 }
 
 QString DeleteAppPasswordJob::errorString() const
@@ -0,0 +1,458 @@
+/*
+ * SPDX-FileCopyrightText: (C) 2021 Matthias Fehring / www.huessenbergnetz.de
+ * SPDX-License-Identifier: LGPL-3.0-or-later
+ */
+
+#include "fleetprobe_p.h"
+#include "getserverstatusjob.h"
+#include "global.h"
+#include "logging.h"
+#include <QTimer>
+#include <QNetworkAccessManager>
+#include <QJsonDocument>
+#include <QJsonObject>
+
+using namespace Wolkanlin;
+
+FleetProbeConfiguration::FleetProbeConfiguration(QObject *parent)
+    : AbstractConfiguration(parent)
+{
+    // all setters notify their changes
+    setSnapshotCachingEnabled(true);
+}
+
+FleetProbeConfiguration::~FleetProbeConfiguration() = default;
+
+QString FleetProbeConfiguration::username() const
+{
+    return QString();
+}
+
+QString FleetProbeConfiguration::password() const
+{
+    return QString();
+}
+
+QString FleetProbeConfiguration::host() const
+{
+    return m_host;
+}
+
+void FleetProbeConfiguration::setHost(const QString &host)
+{
+    m_host = host;
+    notifyEndpointChanged();
+}
+
+int FleetProbeConfiguration::port() const
+{
+    return m_port;
+}
+
+void FleetProbeConfiguration::setPort(int port)
+{
+    m_port = port;
+    notifyEndpointChanged();
+}
+
+QString FleetProbeConfiguration::installPath() const
+{
+    return m_installPath;
+}
+
+void FleetProbeConfiguration::setInstallPath(const QString &installPath)
+{
+    m_installPath = installPath;
+    notifyEndpointChanged();
+}
+
+bool FleetProbeConfiguration::useSsl() const
+{
+    return m_useSsl;
+}
+
+void FleetProbeConfiguration::setUseSsl(bool useSsl)
+{
+    m_useSsl = useSsl;
+    notifyEndpointChanged();
+}
+
+bool FleetProbeConfiguration::ignoreSslErrors() const
+{
+    return m_ignoreSslErrors;
+}
+
+void FleetProbeConfiguration::setIgnoreSslErrors(bool ignoreSslErrors)
+{
+    m_ignoreSslErrors = ignoreSslErrors;
+    invalidateSnapshot();
+}
+
+QString FleetProbeConfiguration::userAgent() const
+{
+    return m_userAgent.isEmpty() ? AbstractConfiguration::userAgent() : m_userAgent;
+}
+
+void FleetProbeConfiguration::setUserAgent(const QString &userAgent)
+{
+    m_userAgent = userAgent;
+    invalidateSnapshot();
+}
+
+FleetProbePrivate::FleetProbePrivate(FleetProbe *q)
+    : q_ptr(q)
+{
+
+}
+
+FleetProbePrivate::~FleetProbePrivate() = default;
+
+void FleetProbePrivate::dispatch()
+{
+    Q_Q(FleetProbe);
+
+    if (q->isFinished()) {
+        return;
+    }
+
+    while (runningJobs.size() < maxConcurrentRequests && nextRequest < requestIndexes.size()) {
+        startRequest(requestIndexes.at(nextRequest++));
+    }
+
+    if (runningJobs.empty() && nextRequest >= requestIndexes.size()) {
+        finish();
+    }
+}
+
+void FleetProbePrivate::startRequest(int index)
+{
+    Q_Q(FleetProbe);
+
+    // validate the URL first, no job is created for invalid URLs
+    auto config = new FleetProbeConfiguration;
+    if (Q_UNLIKELY(!config->setServerUrl(urls.at(index)))) {
+        delete config;
+        FleetProbe::Result &r = results[index];
+        r.error = InvalidRequestUrl;
+        r.errorString = urls.at(index);
+        complete(index);
+        return;
+    }
+
+    auto job = new GetServerStatusJob(q);
+
+    // the configuration is owned by the job, so it lives exactly as long as the request
+    config->setParent(job);
+
+    AbstractConfiguration *base = configuration ? configuration : Wolkanlin::defaultConfiguration();
+    if (base) {
+        config->setUserAgent(base->userAgent());
+        config->setIgnoreSslErrors(base->ignoreSslErrors());
+    }
+
+    results[index].host = config->host();
+
+    job->setConfiguration(config);
+    job->setNetworkAccessManager(networkAccessManager());
+
+    QObject::connect(job, &GetServerStatusJob::succeeded, q, [this, index, job](const QJsonDocument &json){
+        onStatusReceived(index, job, json);
+    });
+    QObject::connect(job, &GetServerStatusJob::failed, q, [this, index, job](int errorCode, const QString &errorString){
+        onStatusFailed(index, job, errorCode, errorString);
+    });
+    // the timer is bound to the job, it will not fire if the job has already been finished and deleted
+    QTimer::singleShot(timeout, job, [this, index, job](){
+        onTimeout(index, job);
+    });
+
+    runningJobs.insert(index, job);
+    requestStarts.insert(index, elapsedTimer.elapsed());
+    job->start();
+}
+
+void FleetProbePrivate::onStatusReceived(int index, GetServerStatusJob *job, const QJsonDocument &json)
+{
+    if (runningJobs.value(index) != job) {
+        return;
+    }
+    runningJobs.remove(index);
+
+    const QJsonObject status = json.object();
+    FleetProbe::Result &r = results[index];
+    r.latency = elapsedTimer.elapsed() - requestStarts.take(index);
+    r.installed = status.value(QStringLiteral("installed")).toBool();
+    r.maintenance = status.value(QStringLiteral("maintenance")).toBool();
+    r.needsDbUpgrade = status.value(QStringLiteral("needsDbUpgrade")).toBool();
+    r.version = status.value(QStringLiteral("version")).toString();
+    r.versionstring = status.value(QStringLiteral("versionstring")).toString();
+
+    complete(index);
+    dispatch();
+}
+
+void FleetProbePrivate::onStatusFailed(int index, GetServerStatusJob *job, int errorCode, const QString &errorString)
+{
+    if (runningJobs.value(index) != job) {
+        return;
+    }
+    runningJobs.remove(index);
+
+    qCWarning(wlCore) << "Failed to request status of" << urls.at(index) << ":" << errorString;
+
+    FleetProbe::Result &r = results[index];
+    r.latency = elapsedTimer.elapsed() - requestStarts.take(index);
+    r.error = errorCode;
+    r.errorString = errorString;
+
+    complete(index);
+    dispatch();
+}
+
+void FleetProbePrivate::onTimeout(int index, GetServerStatusJob *job)
+{
+    if (runningJobs.value(index) != job) {
+        return;
+    }
+    runningJobs.remove(index);
+
+    qCWarning(wlCore) << "Request for status of" << urls.at(index) << "timed out after" << timeout << "ms";
+
+    job->kill(WJob::Quietly);
+
+    FleetProbe::Result &r = results[index];
+    r.latency = elapsedTimer.elapsed() - requestStarts.take(index);
+    r.error = RequestTimedOut;
+    r.errorString = QString::number(timeout);
+
+    complete(index);
+    dispatch();
+}
+
+void FleetProbePrivate::complete(int index)
+{
+    Q_Q(FleetProbe);
+
+    const FleetProbe::Result result = results.at(index);
+    finished++;
+    Q_EMIT q->probed(result);
+
+    const QVector<int> dups = duplicates.value(index);
+    for (int dup : dups) {
+        FleetProbe::Result &r = results[dup];
+        const QString url = r.url;
+        r = result;
+        r.url = url;
+        finished++;
+        Q_EMIT q->probed(r);
+    }
+
+    q->emitPercent(static_cast<qulonglong>(finished), static_cast<qulonglong>(results.size()));
+}
+
+void FleetProbePrivate::killAll()
+{
+    if (!runningJobs.empty()) {
+        qCDebug(wlCore) << "Canceling" << runningJobs.size() << "running status requests";
+        const QList<GetServerStatusJob*> jobs = runningJobs.values();
+        for (GetServerStatusJob *job : jobs) {
+            job->kill(WJob::Quietly);
+        }
+        runningJobs.clear();
+    }
+    requestStarts.clear();
+    nextRequest = requestIndexes.size();
+}
+
+void FleetProbePrivate::finish()
+{
+    Q_Q(FleetProbe);
+
+    int failed = 0;
+    const QVector<FleetProbe::Result> &res = results;
+    for (const FleetProbe::Result &r : res) {
+        if (!r.isValid()) {
+            failed++;
+        }
+    }
+
+    qCDebug(wlCore) << "Probed" << results.size() << "servers in" << elapsedTimer.elapsed() << "ms," << failed << "failed";
+
+    q->emitResult();
+}
+
+QNetworkAccessManager *FleetProbePrivate::networkAccessManager()
+{
+    if (nam) {
+        return nam;
+    }
+
+    QNetworkAccessManager *defNam = Wolkanlin::defaultNetworkAccessManager();
+    if (defNam) {
+        return defNam;
+    }
+
+    if (!ownNam) {
+        Q_Q(FleetProbe);
+        ownNam = new QNetworkAccessManager(q);
+        qCDebug(wlCore) << "Using default created" << ownNam;
+    }
+
+    return ownNam;
+}
+
+FleetProbe::FleetProbe(QObject *parent)
+    : WJob(parent), wl_ptr(new FleetProbePrivate(this))
+{
+    setCapabilities(Killable);
+}
+
+FleetProbe::FleetProbe(const QStringList &urls, QObject *parent)
+    : WJob(parent), wl_ptr(new FleetProbePrivate(this))
+{
+    Q_D(FleetProbe);
+    d->urls = urls;
+    setCapabilities(Killable);
+}
+
+FleetProbe::~FleetProbe() = default;
+
+void FleetProbe::start()
+{
+    QTimer::singleShot(0, this, [this](){
+        Q_D(FleetProbe);
+
+        if (Q_UNLIKELY(isFinished())) {
+            return;
+        }
+
+        if (Q_UNLIKELY(d->urls.empty())) {
+            qCCritical(wlCore) << "Can not probe an empty list of servers.";
+            setError(MissingHost);
+            emitResult();
+            return;
+        }
+
+        d->results.clear();
+        d->results.resize(d->urls.size());
+        d->requestIndexes.clear();
+        d->requestIndexes.reserve(d->urls.size());
+        d->duplicates.clear();
+
+        // every server is only requested once
+        QHash<QString, int> seen;
+        seen.reserve(d->urls.size());
+        for (int i = 0; i < d->urls.size(); ++i) {
+            const QString url = d->urls.at(i).trimmed();
+            d->results[i].url = d->urls.at(i);
+            const auto it = seen.constFind(url);
+            if (it != seen.constEnd()) {
+                d->duplicates[it.value()].append(i);
+            } else {
+                seen.insert(url, i);
+                d->requestIndexes.append(i);
+            }
+        }
+
+        qCDebug(wlCore) << "Probing" << d->requestIndexes.size() << "servers with up to" << d->maxConcurrentRequests << "concurrent requests.";
+
+        setTotalAmount(WJob::Items, static_cast<qulonglong>(d->urls.size()));
+        d->nextRequest = 0;
+        d->finished = 0;
+        d->elapsedTimer.start();
+        d->dispatch();
+    });
+}
+
+bool FleetProbe::doKill()
+{
+    Q_D(FleetProbe);
+    d->killAll();
+    return true;
+}
+
+AbstractConfiguration *FleetProbe::configuration() const
+{
+    Q_D(const FleetProbe);
+    return d->configuration;
+}
+
+void FleetProbe::setConfiguration(AbstractConfiguration *configuration)
+{
+    Q_D(FleetProbe);
+    if (d->configuration != configuration) {
+        qCDebug(wlCore) << "Changing configuration from" << d->configuration << "to" << configuration;
+        d->configuration = configuration;
+        Q_EMIT configurationChanged(d->configuration);
+    }
+}
+
+QStringList FleetProbe::urls() const
+{
+    Q_D(const FleetProbe);
+    return d->urls;
+}
+
+void FleetProbe::setUrls(const QStringList &urls)
+{
+    Q_D(FleetProbe);
+    if (d->urls != urls) {
+        qCDebug(wlCore) << "Changing urls to" << urls.size() << "server urls";
+        d->urls = urls;
+        Q_EMIT urlsChanged(d->urls);
+    }
+}
+
+int FleetProbe::maxConcurrentRequests() const
+{
+    Q_D(const FleetProbe);
+    return d->maxConcurrentRequests;
+}
+
+void FleetProbe::setMaxConcurrentRequests(int maxConcurrentRequests)
+{
+    Q_D(FleetProbe);
+    maxConcurrentRequests = qMax(maxConcurrentRequests, 1);
+    if (d->maxConcurrentRequests != maxConcurrentRequests) {
+        qCDebug(wlCore) << "Changing maxConcurrentRequests from" << d->maxConcurrentRequests << "to" << maxConcurrentRequests;
+        d->maxConcurrentRequests = maxConcurrentRequests;
+        Q_EMIT maxConcurrentRequestsChanged(d->maxConcurrentRequests);
+    }
+}
+
+int FleetProbe::timeout() const
+{
+    Q_D(const FleetProbe);
+    return d->timeout;
+}
+
+void FleetProbe::setTimeout(int timeout)
+{
+    Q_D(FleetProbe);
+    timeout = qMax(timeout, 1);
+    if (d->timeout != timeout) {
+        qCDebug(wlCore) << "Changing timeout from" << d->timeout << "to" << timeout;
+        d->timeout = timeout;
+        Q_EMIT timeoutChanged(d->timeout);
+    }
+}
+
+QNetworkAccessManager *FleetProbe::networkAccessManager() const
+{
+    Q_D(const FleetProbe);
+    return d->nam ? d->nam : d->ownNam;
+}
+
+void FleetProbe::setNetworkAccessManager(QNetworkAccessManager *nam)
+{
+    Q_D(FleetProbe);
+    d->nam = nam;
+}
+
+QVector<FleetProbe::Result> FleetProbe::results() const
+{
+    Q_D(const FleetProbe);
+    return d->results;
+}
+
+#include "moc_fleetprobe.cpp"
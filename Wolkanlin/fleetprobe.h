@@ -0,0 +1,279 @@
+/*
+ * SPDX-FileCopyrightText: (C) 2021 Matthias Fehring / www.huessenbergnetz.de
+ * SPDX-License-Identifier: LGPL-3.0-or-later
+ */
+
+#ifndef WOLKANLIN_FLEETPROBE_H
+#define WOLKANLIN_FLEETPROBE_H
+
+#include "wolkanlin_export.h"
+#include "job.h"
+#include <QObject>
+#include <QStringList>
+#include <QVector>
+#include <memory>
+
+class QNetworkAccessManager;
+
+namespace Wolkanlin {
+
+class FleetProbePrivate;
+
+/*!
+ * \brief Requests the status of many servers concurrently.
+ *
+ * %FleetProbe takes a list of server \link FleetProbe::urls URLs\endlink and requests the status
+ * of every server via GetServerStatusJob. The URLs are parsed like
+ * AbstractConfiguration::setServerUrl() does. Not more than
+ * \link FleetProbe::maxConcurrentRequests maxConcurrentRequests\endlink requests are performed
+ * at the same time, all of them using the same network access manager, so that connections
+ * are reused if the same servers are probed again. A request that takes longer than
+ * \link FleetProbe::timeout timeout\endlink is aborted, so unreachable servers do not stall
+ * the probe.
+ *
+ * Every finished server is emitted via probed(). After WJob::result() has been emitted,
+ * results() returns one Result per URL in the order of the \link FleetProbe::urls urls\endlink.
+ * Servers that could not be reached are part of the results with an error code, the probe
+ * itself only fails if the list of URLs is empty.
+ *
+ * \par Mandatory properties
+ * \li FleetProbe::urls
+ *
+ * \code{.cpp}
+ * auto probe = new FleetProbe(urls, this);
+ * connect(probe, &WJob::result, this, [probe](){
+ *     const auto results = probe->results();
+ *     for (const FleetProbe::Result &r : results) {
+ *         qDebug() << r.url << r.version << r.maintenance << r.needsDbUpgrade << r.latency << r.error;
+ *     }
+ * });
+ * probe->start();
+ * \endcode
+ *
+ * \headerfile "" <Wolkanlin/FleetProbe>
+ */
+class WOLKANLIN_EXPORT FleetProbe : public WJob
+{
+    Q_OBJECT
+    /*!
+     * \brief Pointer to an object providing additional configuration data.
+     *
+     * The servers are taken from the \link FleetProbe::urls urls\endlink, only the
+     * \link AbstractConfiguration::userAgent() user agent\endlink and the
+     * \link AbstractConfiguration::ignoreSslErrors() ignoreSslErrors\endlink setting of this
+     * configuration are used. If it is a \c nullptr, the global default configuration will be
+     * used for these values if available.
+     *
+     * \par Access methods
+     * \li AbstractConfiguration *configuration() const
+     * \li void setConfiguration(AbstractConfiguration *configuration)
+     *
+     * \par Notifier signal
+     * \li void configurationChanged(Wolkanlin::AbstractConfiguration *configuration)
+     */
+    Q_PROPERTY(Wolkanlin::AbstractConfiguration *configuration READ configuration WRITE setConfiguration NOTIFY configurationChanged)
+    /*!
+     * \brief List of server URLs to probe.
+     *
+     * Duplicate URLs are only requested once, but get an entry in the results for every occurrence.
+     *
+     * \par Access methods
+     * \li QStringList urls() const
+     * \li void setUrls(const QStringList &urls)
+     *
+     * \par Notifier signal
+     * \li void urlsChanged(const QStringList &urls)
+     */
+    Q_PROPERTY(QStringList urls READ urls WRITE setUrls NOTIFY urlsChanged)
+    /*!
+     * \brief Maximum number of concurrently running requests.
+     *
+     * Values lower than \c 1 will be set to \c 1. Default value: \c 32
+     *
+     * \par Access methods
+     * \li int maxConcurrentRequests() const
+     * \li void setMaxConcurrentRequests(int maxConcurrentRequests)
+     *
+     * \par Notifier signal
+     * \li void maxConcurrentRequestsChanged(int maxConcurrentRequests)
+     */
+    Q_PROPERTY(int maxConcurrentRequests READ maxConcurrentRequests WRITE setMaxConcurrentRequests NOTIFY maxConcurrentRequestsChanged)
+    /*!
+     * \brief Timeout in milliseconds for the request to a single server.
+     *
+     * Values lower than \c 1 will be set to \c 1. Default value: \c 5000
+     *
+     * \par Access methods
+     * \li int timeout() const
+     * \li void setTimeout(int timeout)
+     *
+     * \par Notifier signal
+     * \li void timeoutChanged(int timeout)
+     */
+    Q_PROPERTY(int timeout READ timeout WRITE setTimeout NOTIFY timeoutChanged)
+public:
+    /*!
+     * \brief Status of a single probed server.
+     */
+    struct Result {
+        QString url;                    /**< The URL as set in the \link FleetProbe::urls urls\endlink. */
+        QString host;                   /**< The host name parsed from the URL. */
+        QString version;                /**< The \link ServerStatus::version version\endlink of the server. */
+        QString versionstring;          /**< The \link ServerStatus::versionstring versionstring\endlink of the server. */
+        QString errorString;            /**< Error message if the request failed. */
+        qint64 latency = -1;            /**< Time in milliseconds from starting the request to receiving the reply, \c -1 if not requested. */
+        int error = 0;                  /**< Error code if the request failed, \c 0 on success. */
+        bool installed = false;         /**< \c true if Nextcloud is \link ServerStatus::installed installed\endlink. */
+        bool maintenance = false;       /**< \c true if the server is in \link ServerStatus::maintenance maintenance\endlink mode. */
+        bool needsDbUpgrade = false;    /**< \c true if the server \link ServerStatus::needsDbUpgrade needs a database upgrade\endlink. */
+
+        /*!
+         * \brief Returns \c true if the status of the server has been received.
+         */
+        bool isValid() const { return error == 0 && latency >= 0; }
+    };
+
+    /*!
+     * \brief Constructs a new %FleetProbe object with the given \a parent.
+     */
+    explicit FleetProbe(QObject *parent = nullptr);
+
+    /*!
+     * \brief Constructs a new %FleetProbe object with the given parameters.
+     * \param urls      list of server URLs to probe
+     * \param parent    pointer to a parent object
+     */
+    explicit FleetProbe(const QStringList &urls, QObject *parent = nullptr);
+
+    /*!
+     * \brief Destroys the %FleetProbe object.
+     */
+    ~FleetProbe() override;
+
+    /*!
+     * \brief Starts the requests asynchronously.
+     */
+    void start() override;
+
+    /*!
+     * \brief Getter function for the \link FleetProbe::configuration configuration\endlink property.
+     * \sa setConfiguration(), configurationChanged()
+     */
+    AbstractConfiguration *configuration() const;
+
+    /*!
+     * \brief Setter function for the \link FleetProbe::configuration configuration\endlink property.
+     * \sa configuration(), configurationChanged()
+     */
+    void setConfiguration(AbstractConfiguration *configuration);
+
+    /*!
+     * \brief Getter function for the \link FleetProbe::urls urls\endlink property.
+     * \sa setUrls(), urlsChanged()
+     */
+    QStringList urls() const;
+
+    /*!
+     * \brief Setter function for the \link FleetProbe::urls urls\endlink property.
+     * \sa urls(), urlsChanged()
+     */
+    void setUrls(const QStringList &urls);
+
+    /*!
+     * \brief Getter function for the \link FleetProbe::maxConcurrentRequests maxConcurrentRequests\endlink property.
+     * \sa setMaxConcurrentRequests(), maxConcurrentRequestsChanged()
+     */
+    int maxConcurrentRequests() const;
+
+    /*!
+     * \brief Setter function for the \link FleetProbe::maxConcurrentRequests maxConcurrentRequests\endlink property.
+     * \sa maxConcurrentRequests(), maxConcurrentRequestsChanged()
+     */
+    void setMaxConcurrentRequests(int maxConcurrentRequests);
+
+    /*!
+     * \brief Getter function for the \link FleetProbe::timeout timeout\endlink property.
+     * \sa setTimeout(), timeoutChanged()
+     */
+    int timeout() const;
+
+    /*!
+     * \brief Setter function for the \link FleetProbe::timeout timeout\endlink property.
+     * \sa timeout(), timeoutChanged()
+     */
+    void setTimeout(int timeout);
+
+    /*!
+     * \brief Returns the network access manager used for all requests.
+     * \sa setNetworkAccessManager()
+     */
+    QNetworkAccessManager *networkAccessManager() const;
+
+    /*!
+     * \brief Sets the network access manager \a nam used for all requests.
+     *
+     * If no network access manager is set, Wolkanlin::defaultNetworkAccessManager() will be
+     * used. If that is also not available, the probe will create its own one. The probe
+     * does not take ownership of \a nam.
+     *
+     * \sa networkAccessManager()
+     */
+    void setNetworkAccessManager(QNetworkAccessManager *nam);
+
+    /*!
+     * \brief Returns the results in the order of the \link FleetProbe::urls urls\endlink.
+     *
+     * The results are complete after WJob::result() has been emitted.
+     */
+    QVector<Result> results() const;
+
+protected:
+    /*!
+     * \brief Aborts all running and pending requests.
+     *
+     * Reimplemented from WJob::doKill().
+     */
+    bool doKill() override;
+
+Q_SIGNALS:
+    /*!
+     * \brief Notifier signal for the \link FleetProbe::configuration configuration\endlink property.
+     * \sa setConfiguration(), configuration()
+     */
+    void configurationChanged(Wolkanlin::AbstractConfiguration *configuration);
+
+    /*!
+     * \brief Notifier signal for the \link FleetProbe::urls urls\endlink property.
+     * \sa setUrls(), urls()
+     */
+    void urlsChanged(const QStringList &urls);
+
+    /*!
+     * \brief Notifier signal for the \link FleetProbe::maxConcurrentRequests maxConcurrentRequests\endlink property.
+     * \sa setMaxConcurrentRequests(), maxConcurrentRequests()
+     */
+    void maxConcurrentRequestsChanged(int maxConcurrentRequests);
+
+    /*!
+     * \brief Notifier signal for the \link FleetProbe::timeout timeout\endlink property.
+     * \sa setTimeout(), timeout()
+     */
+    void timeoutChanged(int timeout);
+
+    /*!
+     * \brief Emitted for every server as soon as its \a result is available.
+     */
+    void probed(const Wolkanlin::FleetProbe::Result &result);
+
+private:
+    const std::unique_ptr<FleetProbePrivate> wl_ptr;
+
+    Q_DECLARE_PRIVATE_D(wl_ptr, FleetProbe)
+    Q_DISABLE_COPY(FleetProbe)
+};
+
+}
+
+Q_DECLARE_METATYPE(Wolkanlin::FleetProbe::Result)
+
+#endif // WOLKANLIN_FLEETPROBE_H
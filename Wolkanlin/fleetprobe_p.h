@@ -0,0 +1,91 @@
+/*
+ * SPDX-FileCopyrightText: (C) 2021 Matthias Fehring / www.huessenbergnetz.de
+ * SPDX-License-Identifier: LGPL-3.0-or-later
+ */
+
+#ifndef WOLKANLIN_FLEETPROBE_P_H
+#define WOLKANLIN_FLEETPROBE_P_H
+
+#include "fleetprobe.h"
+#include "abstractconfiguration.h"
+#include <QHash>
+#include <QElapsedTimer>
+
+namespace Wolkanlin {
+
+class GetServerStatusJob;
+
+// connection data of a single probed server, created from the server URL
+class FleetProbeConfiguration : public AbstractConfiguration
+{
+public:
+    explicit FleetProbeConfiguration(QObject *parent = nullptr);
+    ~FleetProbeConfiguration() override;
+
+    QString username() const override;
+    QString password() const override;
+    QString host() const override;
+    void setHost(const QString &host) override;
+    int port() const override;
+    void setPort(int port) override;
+    QString installPath() const override;
+    void setInstallPath(const QString &installPath) override;
+    bool useSsl() const override;
+    void setUseSsl(bool useSsl) override;
+    bool ignoreSslErrors() const override;
+    void setIgnoreSslErrors(bool ignoreSslErrors) override;
+    QString userAgent() const override;
+    void setUserAgent(const QString &userAgent);
+
+private:
+    QString m_host;
+    QString m_installPath;
+    QString m_userAgent;
+    int m_port = 0;
+    bool m_useSsl = true;
+    bool m_ignoreSslErrors = false;
+
+    Q_DISABLE_COPY(FleetProbeConfiguration)
+};
+
+class FleetProbePrivate
+{
+public:
+    explicit FleetProbePrivate(FleetProbe *q);
+    ~FleetProbePrivate();
+
+    void dispatch();
+    void startRequest(int index);
+    void onStatusReceived(int index, GetServerStatusJob *job, const QJsonDocument &json);
+    void onStatusFailed(int index, GetServerStatusJob *job, int errorCode, const QString &errorString);
+    void onTimeout(int index, GetServerStatusJob *job);
+    void complete(int index);
+    void killAll();
+    void finish();
+    QNetworkAccessManager *networkAccessManager();
+
+    QStringList urls;
+    QVector<FleetProbe::Result> results;
+    // indexes of the distinct URLs to request and the result indexes of their duplicates
+    QVector<int> requestIndexes;
+    QHash<int, QVector<int>> duplicates;
+    QHash<int, qint64> requestStarts;
+    QHash<int, GetServerStatusJob*> runningJobs;
+    QElapsedTimer elapsedTimer;
+    QNetworkAccessManager *nam = nullptr;
+    QNetworkAccessManager *ownNam = nullptr;
+    AbstractConfiguration *configuration = nullptr;
+    FleetProbe *q_ptr = nullptr;
+    int nextRequest = 0;
+    int finished = 0;
+    int maxConcurrentRequests = 32;
+    int timeout = 5000;
+
+private:
+    Q_DECLARE_PUBLIC(FleetProbe)
+    Q_DISABLE_COPY(FleetProbePrivate)
+};
+
+}
+
+#endif // WOLKANLIN_FLEETPROBE_P_H
@@ -5,7 +5,6 @@
 
 #include "getapppasswordjob_p.h"
 #include "logging.h"
-#include <QTimer>
 #include <QNetworkReply>
 
 using namespace Wolkanlin;
@@ -15,6 +14,7 @@ GetAppPasswordJobPrivate::GetAppPasswordJobPrivate(GetAppPasswordJob *q)
 {
     namOperation = NetworkOperation::Get;
     expectedContentType = ExpectedContentType::JsonObject;
+    handlesAppPassword = true;
 }
 
 GetAppPasswordJobPrivate::~GetAppPasswordJobPrivate() = default;
@@ -57,7 +57,7 @@ GetAppPasswordJob::~GetAppPasswordJob() = default;
 
 void GetAppPasswordJob::start()
 {
-    QTimer::singleShot(0, this, &GetAppPasswordJob::sendRequest);
+    queueRequest();
 }
 
 QString GetAppPasswordJob::errorString() const
@@ -5,7 +5,7 @@
 
 #include "getserverstatusjob_p.h"
 #include "logging.h"
-#include <QTimer>
+#include <QNetworkReply>
 
 using namespace Wolkanlin;
 
@@ -42,9 +42,27 @@ QMap<QByteArray, QByteArray> GetServerStatusJobPrivate::buildRequestHeaders() co
 {
     auto map = JobPrivate::buildRequestHeaders();
     map.remove(QByteArrayLiteral("OCS-APIRequest"));
+    if (!entityTag.isEmpty()) {
+        map.insert(QByteArrayLiteral("If-None-Match"), entityTag);
+    }
     return map;
 }
 
+bool GetServerStatusJobPrivate::checkOutput(const QByteArray &data)
+{
+    if (reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt() == 304) {
+        qCDebug(wlCore) << "Server status has not been modified since entity tag" << entityTag;
+        notModified = true;
+        jsonResult = QJsonDocument();
+        return true;
+    }
+
+    notModified = false;
+    entityTag = reply->rawHeader(QByteArrayLiteral("ETag"));
+
+    return JobPrivate::checkOutput(data);
+}
+
 GetServerStatusJob::GetServerStatusJob(QObject *parent)
     : Job(* new GetServerStatusJobPrivate(this), parent)
 {
@@ -55,5 +73,23 @@ GetServerStatusJob::~GetServerStatusJob() = default;
 
 void GetServerStatusJob::start()
 {
-    QTimer::singleShot(0, this, &GetServerStatusJob::sendRequest);
+    queueRequest();
+}
+
+QByteArray GetServerStatusJob::entityTag() const
+{
+    Q_D(const GetServerStatusJob);
+    return d->entityTag;
+}
+
+void GetServerStatusJob::setEntityTag(const QByteArray &entityTag)
+{
+    Q_D(GetServerStatusJob);
+    d->entityTag = entityTag;
+}
+
+bool GetServerStatusJob::isNotModified() const
+{
+    Q_D(const GetServerStatusJob);
+    return d->notModified;
 }
@@ -40,6 +40,14 @@ class GetServerStatusJobPrivate;
  * \include get-server-status-sync.cpp
  * Another way is to use ServerStatus::get() function.
  *
+ * <H3 id="getserverstatusjob-conditional-requests">Conditional requests</H3>
+ * If an \link setEntityTag() entity tag\endlink from a previous reply is set, the request is sent
+ * with an \c If-None-Match header. If the server supports it and the status has not been
+ * changed, it answers with <TT>304 Not Modified</TT> without transmitting the status again.
+ * In that case isNotModified() returns \c true and Job::succeeded() is emitted with an empty
+ * JSON document. Servers without entity tag support simply send the full status. ServerStatusWatcher
+ * uses this to poll the status with minimal traffic.
+ *
  * \headerfile "" <Wolkanlin/GetServerStatusJob>
  */
 class WOLKANLIN_EXPORT GetServerStatusJob : public Job
@@ -60,6 +68,34 @@ public:
      */
     void start() override;
 
+    /*!
+     * \brief Returns the entity tag of the server status.
+     *
+     * Before the request has been finished, this is the value set via setEntityTag().
+     * Afterwards it is the value of the \c ETag header of the reply, or the previous value
+     * if isNotModified() returns \c true. Is empty if the server does not send entity tags.
+     *
+     * \sa setEntityTag()
+     */
+    QByteArray entityTag() const;
+
+    /*!
+     * \brief Sets the \a entityTag of a previously received server status.
+     *
+     * If not empty, it will be sent in the \c If-None-Match header of the request.
+     *
+     * \sa entityTag(), isNotModified()
+     */
+    void setEntityTag(const QByteArray &entityTag);
+
+    /*!
+     * \brief Returns \c true if the server answered that the status has not been modified.
+     *
+     * This can only be the case if an entity tag has been set via setEntityTag().
+     * Job::succeeded() will be emitted with an empty JSON document then.
+     */
+    bool isNotModified() const;
+
 private:
     Q_DECLARE_PRIVATE_D(wl_ptr, GetServerStatusJob)
     Q_DISABLE_COPY(GetServerStatusJob)
@@ -25,6 +25,11 @@ public:
 
     QMap<QByteArray, QByteArray> buildRequestHeaders() const override;
 
+    bool checkOutput(const QByteArray &data) override;
+
+    QByteArray entityTag;
+    bool notModified = false;
+
 private:
     Q_DISABLE_COPY(GetServerStatusJobPrivate)
     Q_DECLARE_PUBLIC(GetServerStatusJob)
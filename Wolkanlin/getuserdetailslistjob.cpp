@@ -0,0 +1,140 @@
+/*
+ * SPDX-FileCopyrightText: (C) 2021 Matthias Fehring / www.huessenbergnetz.de
+ * SPDX-License-Identifier: LGPL-3.0-or-later
+ */
+
+#include "getuserdetailslistjob_p.h"
+#include "stringpool.h"
+#include "logging.h"
+#include <QJsonObject>
+#include <QJsonValue>
+
+using namespace Wolkanlin;
+
+GetUserDetailsListJobPrivate::GetUserDetailsListJobPrivate(GetUserDetailsListJob *q)
+    : PagedJobPrivate(q)
+{
+    namOperation = NetworkOperation::Get;
+    expectedContentType = ExpectedContentType::JsonObject;
+    pageSize = 100;
+}
+
+GetUserDetailsListJobPrivate::~GetUserDetailsListJobPrivate() = default;
+
+QString GetUserDetailsListJobPrivate::buildUrlPath() const
+{
+    const QString path = JobPrivate::buildUrlPath() + QLatin1String("/ocs/v2.php/cloud/users/details");
+    return path;
+}
+
+void GetUserDetailsListJobPrivate::emitDescription()
+{
+    Q_Q(GetUserDetailsListJob);
+
+    //: Job title
+    //% "Requesting user details"
+    const QString _title = qtTrId("libwolkanlin-job-desc-get-users-details-title");
+
+    Q_EMIT q->description(q, _title);
+}
+
+Job *GetUserDetailsListJobPrivate::createPageJob(int pageOffset)
+{
+    Q_Q(GetUserDetailsListJob);
+
+    auto page = new GetUserDetailsListJob(q);
+    page->setSearch(search);
+    page->setLimit(pageLimit(pageOffset));
+    page->setOffset(pageOffset);
+
+    // users are decoded and emitted by the page job
+    QObject::connect(page, &GetUserDetailsListJob::userReceived, q, &GetUserDetailsListJob::userReceived);
+
+    return page;
+}
+
+int GetUserDetailsListJobPrivate::processPage(const QJsonDocument &json, int pageOffset)
+{
+    Q_Q(GetUserDetailsListJob);
+
+    // an empty list of users is returned as empty array
+    const QJsonObject usersObject = json.object().value(QStringLiteral("ocs")).toObject().value(QStringLiteral("data")).toObject().value(QStringLiteral("users")).toObject();
+
+    QVector<UserData> pageUsers;
+    pageUsers.reserve(usersObject.size());
+
+    StringPool *pool = StringPool::global();
+
+    for (auto it = usersObject.constBegin(); it != usersObject.constEnd(); ++it) {
+        QJsonObject o = it.value().toObject();
+        if (!o.contains(QStringLiteral("id"))) {
+            o.insert(QStringLiteral("id"), it.key());
+        }
+        const UserData user = UserData::fromJson(o, pool);
+        if (Q_LIKELY(!user.isEmpty())) {
+            pageUsers.append(user);
+            Q_EMIT q->userReceived(user);
+        }
+    }
+
+    pages.insert(pageOffset, pageUsers);
+    receivedCount = usersObject.size();
+
+    return receivedCount;
+}
+
+int GetUserDetailsListJobPrivate::takePage(Job *page, int pageOffset)
+{
+    // the page job has already decoded its users, they only have to be collected
+    const GetUserDetailsListJobPrivate *pd = static_cast<GetUserDetailsListJob*>(page)->d_func();
+    pages.insert(pageOffset, pd->users);
+    return pd->receivedCount;
+}
+
+void GetUserDetailsListJobPrivate::mergePages()
+{
+    if (pages.size() < 2) {
+        users = pages.value(offset);
+        pages.clear();
+        return;
+    }
+
+    int count = 0;
+    for (auto it = pages.cbegin(); it != pages.cend(); ++it) {
+        if (it.key() < endOffset) {
+            count += it.value().size();
+        }
+    }
+
+    users.clear();
+    users.reserve(count);
+    for (auto it = pages.cbegin(); it != pages.cend(); ++it) {
+        if (it.key() < endOffset) {
+            users.append(it.value());
+        }
+    }
+    pages.clear();
+
+    qCDebug(wlCore) << "Received details for" << users.size() << "users.";
+}
+
+GetUserDetailsListJob::GetUserDetailsListJob(QObject *parent)
+    : PagedJob(* new GetUserDetailsListJobPrivate(this), parent)
+{
+
+}
+
+GetUserDetailsListJob::~GetUserDetailsListJob() = default;
+
+void GetUserDetailsListJob::start()
+{
+    queueRequest();
+}
+
+QVector<UserData> GetUserDetailsListJob::users() const
+{
+    Q_D(const GetUserDetailsListJob);
+    return d->users;
+}
+
+#include "moc_getuserdetailslistjob.cpp"
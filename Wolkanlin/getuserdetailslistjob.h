@@ -0,0 +1,95 @@
+/*
+ * SPDX-FileCopyrightText: (C) 2021 Matthias Fehring / www.huessenbergnetz.de
+ * SPDX-License-Identifier: LGPL-3.0-or-later
+ */
+
+#ifndef WOLKANLIN_GETUSERDETAILSLISTJOB_H
+#define WOLKANLIN_GETUSERDETAILSLISTJOB_H
+
+#include "wolkanlin_export.h"
+#include "pagedjob.h"
+#include "userdata.h"
+#include <QObject>
+#include <QVector>
+
+namespace Wolkanlin {
+
+class GetUserDetailsListJobPrivate;
+
+/*!
+ * \brief Requests the details of many users from the remote server in bulk.
+ *
+ * Other than using GetUserListJob together with one GetUserJob per user, this requests the
+ * full user information for many users with a single request. The request has to be performed
+ * with the authorization of an admin user ID.
+ *
+ * Every received user will be decoded into a UserData object and emitted by userReceived()
+ * as soon as its page has been received. Repeated values like group names are interned in
+ * StringPool::global(). After the job has finished successfully, all received users can be
+ * get via users().
+ *
+ * Use \link PagedJob::limit limit\endlink and \link PagedJob::offset offset\endlink
+ * to request a single page of the list and \link PagedJob::search search\endlink to filter it.
+ * If \link PagedJob::fetchAllPages fetchAllPages\endlink is enabled, the list is requested
+ * in pages of \link PagedJob::pageSize pageSize\endlink users, \c 100 by default. If the first page is full, up
+ * to \link PagedJob::maxConcurrentPages maxConcurrentPages\endlink further pages will be
+ * requested concurrently until a page is not full or \link PagedJob::limit limit\endlink
+ * users have been received. In that case Job::replyData() only contains the
+ * data of the first page, use users() to get all users.
+ *
+ * \par Mandatory properties
+ * \li Job::configuration
+ *
+ * \par API method
+ * GET
+ *
+ * \par API route
+ * /ocs/v2.php/cloud/users/details?search={\link PagedJob::search search\endlink}&limit={\link PagedJob::limit limit\endlink}&offset={\link PagedJob::offset offset\endlink}
+ *
+ * <H3 id="getuserdetailslistjob-usage-examples">Usage examples</H3>
+ * Fetch the details of all users from the Nextcloud server asynchronously.
+ * \include get-user-details-list-async.cpp
+ *
+ * \headerfile "" <Wolkanlin/GetUserDetailsListJob>
+ */
+class WOLKANLIN_EXPORT GetUserDetailsListJob : public PagedJob
+{
+    Q_OBJECT
+public:
+    /*!
+     * \brief Constructs a new %GetUserDetailsListJob object with the given \a parent.
+     */
+    explicit GetUserDetailsListJob(QObject *parent = nullptr);
+
+    /*!
+     * \brief Destroys the %GetUserDetailsListJob object.
+     */
+    ~GetUserDetailsListJob() override;
+
+    /*!
+     * \brief Starts the job asynchronously.
+     */
+    void start() override;
+
+    /*!
+     * \brief Returns the received users after the job has been finished successfully.
+     */
+    QVector<UserData> users() const;
+
+Q_SIGNALS:
+    /*!
+     * \brief Emitted for every received \a user.
+     *
+     * If \link PagedJob::fetchAllPages fetchAllPages\endlink is enabled,
+     * the users might not be emitted in the order of the complete list.
+     */
+    void userReceived(const Wolkanlin::UserData &user);
+
+private:
+    Q_DECLARE_PRIVATE_D(wl_ptr, GetUserDetailsListJob)
+    Q_DISABLE_COPY(GetUserDetailsListJob)
+};
+
+}
+
+#endif // WOLKANLIN_GETUSERDETAILSLISTJOB_H
@@ -0,0 +1,44 @@
+/*
+ * SPDX-FileCopyrightText: (C) 2021 Matthias Fehring / www.huessenbergnetz.de
+ * SPDX-License-Identifier: LGPL-3.0-or-later
+ */
+
+#ifndef WOLKANLIN_GETUSERDETAILSLISTJOB_P_H
+#define WOLKANLIN_GETUSERDETAILSLISTJOB_P_H
+
+#include "getuserdetailslistjob.h"
+#include "pagedjob_p.h"
+#include <QMap>
+
+namespace Wolkanlin {
+
+class GetUserDetailsListJobPrivate : public PagedJobPrivate
+{
+public:
+    explicit GetUserDetailsListJobPrivate(GetUserDetailsListJob *q);
+    ~GetUserDetailsListJobPrivate() override;
+
+    QString buildUrlPath() const override;
+
+    void emitDescription() override;
+
+    Job *createPageJob(int pageOffset) override;
+
+    int processPage(const QJsonDocument &json, int pageOffset) override;
+
+    int takePage(Job *page, int pageOffset) override;
+
+    void mergePages() override;
+
+    QVector<UserData> users;
+    QMap<int, QVector<UserData>> pages;
+    int receivedCount = 0;
+
+private:
+    Q_DECLARE_PUBLIC(GetUserDetailsListJob)
+    Q_DISABLE_COPY(GetUserDetailsListJobPrivate)
+};
+
+}
+
+#endif // WOLKANLIN_GETUSERDETAILSLISTJOB_P_H
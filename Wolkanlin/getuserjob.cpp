@@ -5,7 +5,6 @@
 
 #include "getuserjob_p.h"
 #include "logging.h"
-#include <QTimer>
 
 using namespace Wolkanlin;
 
@@ -92,7 +91,7 @@ GetUserJob::~GetUserJob() = default;
 
 void GetUserJob::start()
 {
-    QTimer::singleShot(0, this, &GetUserJob::sendRequest);
+    queueRequest();
 }
 
 QString GetUserJob::errorString() const
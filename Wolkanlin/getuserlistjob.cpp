@@ -4,12 +4,15 @@
  */
 
 #include "getuserlistjob_p.h"
-#include <QTimer>
+#include "logging.h"
+#include <QJsonObject>
+#include <QJsonArray>
+#include <QJsonValue>
 
 using namespace Wolkanlin;
 
 GetUserListJobPrivate::GetUserListJobPrivate(GetUserListJob *q)
-    : JobPrivate(q)
+    : PagedJobPrivate(q)
 {
     namOperation= NetworkOperation::Get;
     expectedContentType = ExpectedContentType::JsonObject;
@@ -34,8 +37,90 @@ void GetUserListJobPrivate::emitDescription()
     Q_EMIT q->description(q, _title);
 }
 
+Job *GetUserListJobPrivate::createPageJob(int pageOffset)
+{
+    Q_Q(GetUserListJob);
+
+    auto page = new GetUserListJob(q);
+    page->setSearch(search);
+    page->setLimit(pageLimit(pageOffset));
+    page->setOffset(pageOffset);
+
+    return page;
+}
+
+int GetUserListJobPrivate::processPage(const QJsonDocument &json, int pageOffset)
+{
+    Q_Q(GetUserListJob);
+
+    const QStringList pageIds = idsFromJson(json);
+
+    if (!pageIds.empty()) {
+        pages.insert(pageOffset, pageIds);
+        Q_EMIT q->idsReceived(pageIds, pageOffset);
+    }
+
+    return pageIds.size();
+}
+
+int GetUserListJobPrivate::takePage(Job *page, int pageOffset)
+{
+    Q_Q(GetUserListJob);
+
+    const QStringList pageIds = static_cast<GetUserListJob*>(page)->ids();
+
+    if (!pageIds.empty()) {
+        pages.insert(pageOffset, pageIds);
+        Q_EMIT q->idsReceived(pageIds, pageOffset);
+    }
+
+    return pageIds.size();
+}
+
+void GetUserListJobPrivate::mergePages()
+{
+    if (pages.size() < 2) {
+        ids = pages.value(offset);
+        pages.clear();
+        return;
+    }
+
+    ids.clear();
+    int pageCount = 0;
+    for (auto it = pages.cbegin(); it != pages.cend(); ++it) {
+        if (it.key() < endOffset) {
+            ids.append(it.value());
+            pageCount++;
+        }
+    }
+    pages.clear();
+
+    qCDebug(wlCore) << "Received" << ids.size() << "user IDs in" << pageCount << "pages.";
+
+    QJsonObject root = jsonResult.object();
+    QJsonObject ocs = root.value(QStringLiteral("ocs")).toObject();
+    QJsonObject data = ocs.value(QStringLiteral("data")).toObject();
+    data.insert(QStringLiteral("users"), QJsonArray::fromStringList(ids));
+    ocs.insert(QStringLiteral("data"), data);
+    root.insert(QStringLiteral("ocs"), ocs);
+    jsonResult.setObject(root);
+}
+
+QStringList GetUserListJobPrivate::idsFromJson(const QJsonDocument &json)
+{
+    const QJsonArray users = json.object().value(QStringLiteral("ocs")).toObject().value(QStringLiteral("data")).toObject().value(QStringLiteral("users")).toArray();
+
+    QStringList list;
+    list.reserve(users.size());
+    for (const QJsonValue &v : users) {
+        list << v.toString();
+    }
+
+    return list;
+}
+
 GetUserListJob::GetUserListJob(QObject *parent)
-    : Job(* new GetUserListJobPrivate(this), parent)
+    : PagedJob(* new GetUserListJobPrivate(this), parent)
 {
 
 }
@@ -44,7 +129,13 @@ GetUserListJob::~GetUserListJob() = default;
 
 void GetUserListJob::start()
 {
-    QTimer::singleShot(0, this, &GetUserListJob::sendRequest);
+    queueRequest();
+}
+
+QStringList GetUserListJob::ids() const
+{
+    Q_D(const GetUserListJob);
+    return d->ids;
 }
 
 #include "moc_getuserlistjob.cpp"
@@ -7,8 +7,9 @@
 #define WOLKANLIN_GETUSERLISTJOB_H
 
 #include "wolkanlin_export.h"
-#include "job.h"
+#include "pagedjob.h"
 #include <QObject>
+#include <QStringList>
 
 namespace Wolkanlin {
 
@@ -19,6 +20,15 @@ class GetUserListJobPrivate;
  *
  * The request has to be performed with the authorization of an admin user ID.
  *
+ * Use \link PagedJob::limit limit\endlink and \link PagedJob::offset offset\endlink
+ * to request a single page of the list and \link PagedJob::search search\endlink to filter it.
+ * If \link PagedJob::fetchAllPages fetchAllPages\endlink is enabled, the list is requested
+ * in pages of \link PagedJob::pageSize pageSize\endlink IDs, \c 500 by default. If the first page is full, up
+ * to \link PagedJob::maxConcurrentPages maxConcurrentPages\endlink further pages will be
+ * requested concurrently until a page is not full or \link PagedJob::limit limit\endlink IDs
+ * have been received. Every received page is emitted by idsReceived(),
+ * the complete list will be part of the reply data like it would have been returned by a single request.
+ *
  * \par Mandatory properties
  * \li Job::configuration
  *
@@ -26,7 +36,7 @@ class GetUserListJobPrivate;
  * GET
  *
  * \par API route
- * /ocs/v1.php/cloud/users
+ * /ocs/v1.php/cloud/users?search={\link PagedJob::search search\endlink}&limit={\link PagedJob::limit limit\endlink}&offset={\link PagedJob::offset offset\endlink}
  *
  * \par API docs
  * https://docs.nextcloud.com/server/latest/developer_manual/client_apis/OCS/ocs-api-overview.html#user-metadata-list-user-ids
@@ -46,7 +56,7 @@ class GetUserListJobPrivate;
  *
  * \headerfile "" <Wolkanlin/GetUserListJob>
  */
-class WOLKANLIN_EXPORT GetUserListJob : public Job
+class WOLKANLIN_EXPORT GetUserListJob : public PagedJob
 {
     Q_OBJECT
 public:
@@ -65,6 +75,21 @@ public:
      */
     void start() override;
 
+    /*!
+     * \brief Returns the received user IDs after the job has been finished successfully.
+     */
+    QStringList ids() const;
+
+Q_SIGNALS:
+    /*!
+     * \brief Emitted for every received page of user \a ids.
+     *
+     * \a offset is the position of the first ID of this page in the complete list. If
+     * \link PagedJob::fetchAllPages fetchAllPages\endlink is enabled, the pages
+     * might not be emitted in the order of their offsets.
+     */
+    void idsReceived(const QStringList &ids, int offset);
+
 private:
     Q_DECLARE_PRIVATE_D(wl_ptr, GetUserListJob)
     Q_DISABLE_COPY(GetUserListJob)
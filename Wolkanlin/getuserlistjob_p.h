@@ -7,11 +7,12 @@
 #define WOLKANLIN_GETUSERLISTJOB_P_H
 
 #include "getuserlistjob.h"
-#include "job_p.h"
+#include "pagedjob_p.h"
+#include <QMap>
 
 namespace Wolkanlin {
 
-class GetUserListJobPrivate : public JobPrivate
+class GetUserListJobPrivate : public PagedJobPrivate
 {
 public:
     explicit GetUserListJobPrivate(GetUserListJob *q);
@@ -21,6 +22,19 @@ public:
 
     void emitDescription() override;
 
+    Job *createPageJob(int pageOffset) override;
+
+    int processPage(const QJsonDocument &json, int pageOffset) override;
+
+    int takePage(Job *page, int pageOffset) override;
+
+    void mergePages() override;
+
+    static QStringList idsFromJson(const QJsonDocument &json);
+
+    QStringList ids;
+    QMap<int, QStringList> pages;
+
 private:
     Q_DECLARE_PUBLIC(GetUserListJob)
     Q_DISABLE_COPY(GetUserListJobPrivate)
@@ -5,7 +5,6 @@
 
 #include "getwipestatusjob_p.h"
 #include "logging.h"
-#include <QTimer>
 #include <QNetworkReply>
 
 using namespace Wolkanlin;
@@ -48,7 +47,7 @@ QMap<QByteArray, QByteArray> GetWipeStatusJobPrivate::buildRequestHeaders() cons
 
 std::pair<QByteArray, QByteArray> GetWipeStatusJobPrivate::buildPayload() const
 {
-    const QByteArray _token = !token.isEmpty() ? token.toUtf8() : configuration->password().toUtf8();
+    const QByteArray _token = !token.isEmpty() ? token.toUtf8() : snapshot.password().toUtf8();
     const QByteArray tokenKey = QByteArrayLiteral("token=")  + _token;
     return std::make_pair(tokenKey, QByteArrayLiteral("application/x-www-form-urlencoded"));
 }
@@ -59,7 +58,7 @@ bool GetWipeStatusJobPrivate::checkInput()
         return false;
     }
 
-    if (Q_UNLIKELY(token.isEmpty() && configuration->password().isEmpty())) {
+    if (Q_UNLIKELY(token.isEmpty() && snapshot.password().isEmpty())) {
         emitError(MissingPassword);
         qCCritical(wlCore) << "Can not get wipe status with empty application password/token.";
         return false;
@@ -96,7 +95,7 @@ GetWipeStatusJob::~GetWipeStatusJob() = default;
 
 void GetWipeStatusJob::start()
 {
-    QTimer::singleShot(0, this, &GetWipeStatusJob::sendRequest);
+    queueRequest();
 }
 
 QString GetWipeStatusJob::errorString() const
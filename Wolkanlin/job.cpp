@@ -6,14 +6,21 @@
 #include "global.h"
 #include "job_p.h"
 #include "logging.h"
+#include "metricsregistry.h"
+#include "abstractcredentialprovider.h"
+#include "abstractconfiguration_p.h"
+#include "sessioncookiejar_p.h"
 #include <QNetworkAccessManager>
 #include <QNetworkReply>
 #include <QNetworkRequest>
+#include <QNetworkCookie>
 #include <QReadWriteLock>
 #include <QGlobalStatic>
 #include <QJsonParseError>
 #include <QJsonObject>
 #include <QJsonValue>
+#include <QMetaMethod>
+#include <QTimer>
 
 using namespace Wolkanlin;
 
@@ -27,7 +34,7 @@ JobPrivate::~JobPrivate() = default;
 
 void JobPrivate::handleSslErrors(QNetworkReply *reply, const QList<QSslError> &errors)
 {
-    if (configuration->ignoreSslErrors()) {
+    if (snapshot.ignoreSslErrors()) {
         if (wlCore().isWarningEnabled()) {
             for (const QSslError &e : errors) {
                 qCWarning(wlCore) << "Ignoring SSL error:" << e.errorString();
@@ -67,6 +74,11 @@ void JobPrivate::requestFinished()
 {
     Q_Q(Job);
 
+    timings.lastByte = timestamp();
+    if (timings.firstByte < 0) {
+        timings.firstByte = timings.lastByte;
+    }
+
     //: Job info message to display state information
     //% "Checking reply"
     Q_EMIT q->infoMessage(q, qtTrId("libwolkanlin-info-msg-req-checking"));
@@ -74,6 +86,7 @@ void JobPrivate::requestFinished()
     qCDebug(wlCore) << "HTTP status code:" << reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
 
     const QByteArray replyData = reply->readAll();
+    bytesReceived += replyData.size();
 
     qCDebug(wlCore) << "Reply data:" << replyData;
 
@@ -84,9 +97,28 @@ void JobPrivate::requestFinished()
     }
 #endif
 
+    if (Q_UNLIKELY(sessionExpired())) {
+        qCDebug(wlCore) << "Session has expired, repeating request with credentials.";
+        reply->deleteLater();
+        reply = nullptr;
+        q->sendRequest();
+        return;
+    }
+
+    bool finished = true;
+
     if (Q_LIKELY(reply->error() == QNetworkReply::NoError)) {
-        if (checkOutput(replyData)) {
-            Q_EMIT q->succeeded(jsonResult);
+        const bool outputOk = checkOutput(replyData);
+        timings.parsed = timestamp();
+        if (outputOk) {
+            if (requiresAuth && !usedSession && !handlesAppPassword) {
+                // the used credentials are valid, the job might have created the network access manager itself
+                configuration->d_func()->convertToAppPassword(snapshot, nam->parent() != q ? nam : nullptr);
+            }
+            finished = !continueRequest();
+            if (finished) {
+                Q_EMIT q->succeeded(jsonResult);
+            }
         } else {
             qCDebug(wlCore) << "Error code:" << q->error();
             Q_EMIT q->failed(q->error(), q->errorString());
@@ -104,7 +136,11 @@ void JobPrivate::requestFinished()
     reply->deleteLater();
     reply = nullptr;
 
-    q->emitResult();
+    if (finished) {
+        q->emitResult();
+    } else {
+        qCDebug(wlCore) << "Job continues with further requests.";
+    }
 }
 
 void JobPrivate::extractError()
@@ -116,6 +152,10 @@ void JobPrivate::extractError()
         if (httpStatusCode == 401) {
             qCCritical(wlCore) << "Authentication failed, please check your user name and password.";
             q->setError(AuthNFailed);
+            // the cached credentials are outdated
+            if (configuration && configuration->credentialProvider()) {
+                configuration->credentialProvider()->clear();
+            }
         } else if (httpStatusCode == 403) {
             qCCritical(wlCore) << "Authorization failed, you are not allowed to perform this request.";
             q->setError(AuthZFailed);
@@ -127,6 +167,86 @@ void JobPrivate::extractError()
     }
 }
 
+void JobPrivate::waitForCredentials(AbstractCredentialProvider *provider)
+{
+    Q_Q(Job);
+
+    //: Job info message to display state information
+    //% "Waiting for credentials"
+    Q_EMIT q->infoMessage(q, qtTrId("libwolkanlin-info-msg-req-wait-credentials"));
+    qCDebug(wlCore) << "Waiting for credentials from" << provider;
+
+    // all jobs waiting at the same time share the fetch of the provider
+    credentialsConnection = QObject::connect(provider, &AbstractCredentialProvider::credentialsChanged, q, [this](){
+        stopWaitingForCredentials();
+        Q_Q(Job);
+        q->sendRequest();
+    });
+    credentialsFailedConnection = QObject::connect(provider, &AbstractCredentialProvider::fetchFailed, q, [this](const QString &errorString){
+        stopWaitingForCredentials();
+        qCCritical(wlCore) << "Can not send request: failed to fetch credentials:" << errorString;
+        emitError(MissingPassword, errorString);
+    });
+
+    provider->fetch();
+}
+
+void JobPrivate::stopWaitingForCredentials()
+{
+    QObject::disconnect(credentialsConnection);
+    QObject::disconnect(credentialsFailedConnection);
+}
+
+SessionCookieJar *JobPrivate::sessionCookieJar() const
+{
+    return configuration ? configuration->d_func()->sessionCookieJar : nullptr;
+}
+
+bool JobPrivate::addSessionCookies(QNetworkRequest &request)
+{
+    SessionCookieJar *jar = sessionCookieJar();
+    if (!jar) {
+        return false;
+    }
+
+    // the cookies of the session are kept per configuration, not in the cookie jar of the network access manager
+    request.setAttribute(QNetworkRequest::CookieLoadControlAttribute, QNetworkRequest::Manual);
+    request.setAttribute(QNetworkRequest::CookieSaveControlAttribute, QNetworkRequest::Manual);
+
+    if (handlesAppPassword) {
+        return false;
+    }
+
+    const QList<QNetworkCookie> cookies = jar->cookiesForUrl(request.url());
+    if (cookies.empty()) {
+        return false;
+    }
+
+    request.setHeader(QNetworkRequest::CookieHeader, QVariant::fromValue(cookies));
+    return true;
+}
+
+bool JobPrivate::sessionExpired()
+{
+    SessionCookieJar *jar = sessionCookieJar();
+    if (!jar) {
+        return false;
+    }
+
+    const QList<QNetworkCookie> cookies = reply->header(QNetworkRequest::SetCookieHeader).value<QList<QNetworkCookie>>();
+    if (!cookies.empty()) {
+        jar->setCookiesFromUrl(cookies, reply->url());
+    }
+
+    if (usedSession && !sessionRetried && reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt() == 401) {
+        sessionRetried = true;
+        jar->expire(reply->url());
+        return true;
+    }
+
+    return false;
+}
+
 void JobPrivate::emitError(int errorCode, const QString &errorText)
 {
     Q_Q(Job);
@@ -136,9 +256,63 @@ void JobPrivate::emitError(int errorCode, const QString &errorText)
     Q_EMIT q->failed(errorCode, q->errorString());
 }
 
+void JobPrivate::emitSucceeded()
+{
+    Q_Q(Job);
+    Q_EMIT q->succeeded(jsonResult);
+    q->emitResult();
+}
+
+qint64 JobPrivate::timestamp()
+{
+    if (Q_UNLIKELY(!timingsTimer.isValid())) {
+        // the job has not been queued via Job::queueRequest()
+        timingsTimer.start();
+        timings.queued = 0;
+    }
+    return timingsTimer.nsecsElapsed();
+}
+
+void JobPrivate::finishTimings()
+{
+    Q_Q(Job);
+
+    if (timingsTimer.isValid()) {
+        timings.finished = timingsTimer.nsecsElapsed();
+    }
+
+    static const QMetaMethod timingsSignal = QMetaMethod::fromSignal(&Job::timingsAvailable);
+    if (q->isSignalConnected(timingsSignal)) {
+        Q_EMIT q->timingsAvailable(timings);
+    }
+
+    recordMetrics();
+}
+
+void JobPrivate::recordMetrics()
+{
+    Q_Q(Job);
+
+    MetricsRegistry *registry = MetricsRegistry::global();
+    if (!registry->isEnabled()) {
+        return;
+    }
+
+    // strip the namespace from the class name to get the endpoint name, like GetUserJob
+    QString endpoint = QString::fromLatin1(q->metaObject()->className());
+    const int nsEnd = endpoint.lastIndexOf(QLatin1Char(':'));
+    if (nsEnd > -1) {
+        endpoint.remove(0, nsEnd + 1);
+    }
+
+    const QString host = snapshot.host();
+
+    registry->recordRequest(endpoint, host, q->error(), timings.totalDuration(), bytesSent, bytesReceived);
+}
+
 QString JobPrivate::buildUrlPath() const
 {
-    return configuration->installPath();
+    return snapshot.installPath();
 }
 
 QUrlQuery JobPrivate::buildUrlQuery() const
@@ -152,7 +326,7 @@ QMap<QByteArray, QByteArray> JobPrivate::buildRequestHeaders() const
 {
     QMap<QByteArray, QByteArray> headers;
     headers.insert(QByteArrayLiteral("OCS-APIRequest"), QByteArrayLiteral("true"));
-    headers.insert(QByteArrayLiteral("User-Agent"), configuration->userAgent().toLatin1());
+    headers.insert(QByteArrayLiteral("User-Agent"), snapshot.userAgent().toLatin1());
     return headers;
 }
 
@@ -163,19 +337,19 @@ std::pair<QByteArray, QByteArray> JobPrivate::buildPayload() const
 
 bool JobPrivate::checkInput()
 {
-    if (Q_UNLIKELY(configuration->host().isEmpty())) {
+    if (Q_UNLIKELY(snapshot.host().isEmpty())) {
         emitError(MissingHost);
         qCCritical(wlCore) << "Can not send request: missing host.";
         return false;
     }
 
-    if (Q_UNLIKELY(requiresAuth && configuration->username().isEmpty())) {
+    if (Q_UNLIKELY(requiresAuth && snapshot.username().isEmpty())) {
         emitError(MissingUser);
         qCCritical(wlCore) << "Can not send request: missing username.";
         return false;
     }
 
-    if (Q_UNLIKELY(requiresAuth && configuration->password().isEmpty())) {
+    if (Q_UNLIKELY(requiresAuth && snapshot.password().isEmpty())) {
         emitError(MissingPassword);
         qCCritical(wlCore) << "Can not send request: missing password.";
         return false;
@@ -256,24 +430,59 @@ void JobPrivate::emitDescription()
 
 }
 
+bool JobPrivate::continueRequest()
+{
+    // reimplement and return true if the job performs further requests
+    // and emits the result itself later
+    return false;
+}
+
 Job::Job(QObject *parent)
     : WJob(parent), wl_ptr(new JobPrivate(this))
 {
-
+    setCapabilities(Killable);
+    connect(this, &WJob::finished, this, [this](){
+        wl_ptr->finishTimings();
+    });
 }
 
 Job::Job(JobPrivate &dd, QObject *parent)
     : WJob(parent), wl_ptr(&dd)
 {
+    setCapabilities(Killable);
+    connect(this, &WJob::finished, this, [this](){
+        wl_ptr->finishTimings();
+    });
+}
 
+void Job::queueRequest()
+{
+    Q_D(Job);
+    d->timings = JobTimings();
+    d->bytesSent = 0;
+    d->bytesReceived = 0;
+    d->timingsTimer.start();
+    d->timings.queued = 0;
+    QTimer::singleShot(0, this, &Job::sendRequest);
 }
 
-Job::~Job() = default;
+Job::~Job()
+{
+    // WJob emits finished() for unfinished jobs in its destructor, when the private data is already gone
+    disconnect(this, &WJob::finished, this, nullptr);
+}
 
 void Job::sendRequest()
 {
     Q_D(Job);
 
+    if (Q_UNLIKELY(isFinished())) {
+        qCDebug(wlCore) << "Job has already been finished or killed, not sending request.";
+        return;
+    }
+
+    d->timings.setupStarted = d->timestamp();
+
     d->emitDescription();
 
     //: Job info message to display state information
@@ -293,22 +502,21 @@ void Job::sendRequest()
         }
     }
 
-    if (Q_UNLIKELY(!d->checkInput())) {
-        return;
+    if (d->requiresAuth) {
+        AbstractCredentialProvider *provider = d->configuration->credentialProvider();
+        if (provider && !provider->hasCredentials()) {
+            d->waitForCredentials(provider);
+            return;
+        }
     }
 
-    QUrl url;
-    if (d->configuration->useSsl()) {
-        url.setScheme(QStringLiteral("https"));
-    } else {
-        url.setScheme(QStringLiteral("http"));
-    }
+    d->snapshot = d->configuration->snapshot();
 
-    if (d->configuration->port() != 0) {
-        url.setPort(d->configuration->port());
+    if (Q_UNLIKELY(!d->checkInput())) {
+        return;
     }
 
-    url.setHost(d->configuration->host());
+    QUrl url = d->snapshot.serverUrl();
     url.setPath(d->buildUrlPath());
     url.setQuery(d->buildUrlQuery());
 
@@ -323,10 +531,6 @@ void Job::sendRequest()
             d->nam = new QNetworkAccessManager(this);
             qCDebug(wlCore) << "Using default created" << d->nam;
         }
-
-        connect(d->nam, &QNetworkAccessManager::sslErrors, this, [d](QNetworkReply *reply, const QList<QSslError> &errors){
-            d->handleSslErrors(reply, errors);
-        });
     }
 
     QNetworkRequest nr(url);
@@ -369,10 +573,10 @@ void Job::sendRequest()
         nr.setRawHeader(QByteArrayLiteral("Content-Type"), payload.second);
     }
 
-    if (d->requiresAuth) {
-        const QString auth = d->configuration->username() + QLatin1Char(':') + d->configuration->password();
-        const QByteArray authHeader = QByteArrayLiteral("Basic ") + auth.toUtf8().toBase64();
-        nr.setRawHeader(QByteArrayLiteral("Authorization"), authHeader);
+    d->usedSession = d->addSessionCookies(nr);
+
+    if (d->requiresAuth && !d->usedSession) {
+        nr.setRawHeader(QByteArrayLiteral("Authorization"), d->snapshot.authorizationHeader());
     }
 
     if (wlCore().isDebugEnabled()) {
@@ -401,7 +605,7 @@ void Job::sendRequest()
         qCDebug(wlCore) << "API URL:" << url;
         const auto rhl = nr.rawHeaderList();
         for (const QByteArray &h : rhl) {
-            if (h == QByteArrayLiteral("Authorization")) {
+            if (h == QByteArrayLiteral("Authorization") || h == QByteArrayLiteral("Cookie")) {
                 qCDebug(wlCore, "%s: **************", h.constData());
             } else {
                 qCDebug(wlCore, "%s: %s", h.constData(), nr.rawHeader(h).constData());
@@ -453,11 +657,71 @@ void Job::sendRequest()
         break;
     }
 
+    d->timings.requestSent = d->timestamp();
+    d->bytesSent += payload.first.size();
+
+    connect(d->reply, &QNetworkReply::sslErrors, this, [d](const QList<QSslError> &errors){
+        d->handleSslErrors(d->reply, errors);
+    });
+
+    connect(d->reply, &QNetworkReply::encrypted, this, [d](){
+        d->timings.encrypted = d->timestamp();
+    });
+
+    connect(d->reply, &QNetworkReply::metaDataChanged, this, [d](){
+        if (d->timings.firstByte < 0) {
+            d->timings.firstByte = d->timestamp();
+        }
+    });
+
     connect(d->reply, &QNetworkReply::finished, this, [d](){
         d->requestFinished();
     });
 }
 
+bool Job::doKill()
+{
+    Q_D(Job);
+
+    // a killed job must not be resumed by the credential provider
+    d->stopWaitingForCredentials();
+
+#if (QT_VERSION < QT_VERSION_CHECK(5, 15, 0))
+    if (d->timeoutTimer) {
+        d->timeoutTimer->stop();
+    }
+#endif
+
+    if (d->reply) {
+        qCDebug(wlCore) << "Aborting network request.";
+        QNetworkReply *nr = d->reply;
+        d->reply = nullptr;
+        nr->disconnect(this);
+        nr->abort();
+        nr->deleteLater();
+    }
+
+    return true;
+}
+
+JobTimings Job::timings() const
+{
+    Q_D(const Job);
+    return d->timings;
+}
+
+QNetworkAccessManager *Job::networkAccessManager() const
+{
+    Q_D(const Job);
+    return d->nam;
+}
+
+void Job::setNetworkAccessManager(QNetworkAccessManager *nam)
+{
+    Q_D(Job);
+    d->nam = nam;
+}
+
 AbstractConfiguration* Job::configuration() const
 {
     Q_D(const Job);
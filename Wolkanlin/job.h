@@ -13,10 +13,13 @@
 #include "wjob.h"
 #endif
 #include "abstractconfiguration.h"
+#include "jobtimings.h"
 #include <QObject>
 #include <QJsonDocument>
 #include <memory>
 
+class QNetworkAccessManager;
+
 namespace Wolkanlin {
 
 #if defined(WOLKANLIN_WITH_KDE)
@@ -48,7 +51,8 @@ enum {
     EmptyUser,              /**< No user defined to get data for. */
     NotFound,               /**< The requested data could not be found. */
     AlreadyAppPassword,     /**< The password in use is already an application password. */
-    UnknownError            /**< An unknown error. */
+    UnknownError,           /**< An unknown error. */
+    WriteError              /**< Failed to write data to a local file. */
 };
 
 /*!
@@ -115,6 +119,37 @@ public:
      */
     QJsonDocument replyData() const;
 
+    /*!
+     * \brief Returns the network access manager used to perform the request.
+     *
+     * Returns a \c nullptr if no network access manager has been set and the job
+     * has not been started yet.
+     *
+     * \sa setNetworkAccessManager()
+     */
+    QNetworkAccessManager *networkAccessManager() const;
+
+    /*!
+     * \brief Sets the network access manager \a nam used to perform the request.
+     *
+     * If no network access manager is set, Wolkanlin::defaultNetworkAccessManager() will be
+     * used. If that is also not available, the job will create its own network access manager.
+     * Set a shared network access manager when performing many requests, so that the
+     * connections to the remote host can be reused. The job does not take ownership of \a nam.
+     *
+     * \sa networkAccessManager()
+     */
+    void setNetworkAccessManager(QNetworkAccessManager *nam);
+
+    /*!
+     * \brief Returns the timestamps of the request phases recorded so far.
+     *
+     * The timings are complete after WJob::result() has been emitted.
+     *
+     * \sa timingsAvailable()
+     */
+    JobTimings timings() const;
+
 protected:
     const std::unique_ptr<JobPrivate> wl_ptr;
 
@@ -126,13 +161,27 @@ protected:
     explicit Job(JobPrivate &dd, QObject *parent = nullptr);
 
     /*!
-     * \brief Performs basic checks and sets up and sends the request.
+     * \brief Queues the request to be sent by sendRequest() when control returns to the event loop.
      *
      * This will be called in the reimplementation of WJob::start() by
-     * class that are derived from %Job.
+     * classes that are derived from %Job.
+     */
+    void queueRequest();
+
+    /*!
+     * \brief Performs basic checks and sets up and sends the request.
+     *
+     * This will be called by queueRequest().
      */
     void sendRequest();
 
+    /*!
+     * \brief Aborts a running request.
+     *
+     * Reimplemented from WJob::doKill(). %Job objects are always killable.
+     */
+    bool doKill() override;
+
 Q_SIGNALS:
     /*!
      * \brief Notifier signal for the \link Job::configuration configuration\endlink property.
@@ -162,6 +211,15 @@ Q_SIGNALS:
      */
     void failed(int errorCode, const QString &errorString);
 
+    /*!
+     * \brief Emitted together with WJob::finished() with the recorded \a timings of the request phases.
+     *
+     * The timings are only collected into this signal if it is connected.
+     *
+     * \sa timings()
+     */
+    void timingsAvailable(const Wolkanlin::JobTimings &timings);
+
 private:
     Q_DECLARE_PRIVATE_D(wl_ptr, Job)
     Q_DISABLE_COPY(Job)
@@ -7,7 +7,10 @@
 #define WOLKANLIN_JOB_P_H
 
 #include "job.h"
+#include "jobtimings.h"
+#include "configurationsnapshot.h"
 #include <QMap>
+#include <QElapsedTimer>
 #if (QT_VERSION < QT_VERSION_CHECK(5, 15, 0))
 #include <QTimer>
 #endif
@@ -17,12 +20,16 @@
 
 class QNetworkReply;
 class QNetworkAccessManager;
+class QNetworkRequest;
 #if (QT_VERSION < QT_VERSION_CHECK(5, 15, 0))
 class QTimer;
 #endif
 
 namespace Wolkanlin {
 
+class AbstractCredentialProvider;
+class SessionCookieJar;
+
 enum class ExpectedContentType : qint8 {
     Invalid     = -1,
     Empty       = 0,
@@ -49,18 +56,30 @@ public:
     virtual ~JobPrivate();
 
     QJsonDocument jsonResult;
+    QElapsedTimer timingsTimer;
+    JobTimings timings;
     QNetworkAccessManager *nam = nullptr;
+    qint64 bytesSent = 0;
+    qint64 bytesReceived = 0;
 #if (QT_VERSION < QT_VERSION_CHECK(5, 15, 0))
     QTimer *timeoutTimer = nullptr;
 #endif
     QNetworkReply *reply = nullptr;
     AbstractConfiguration *configuration = nullptr;
+    // connection data taken from the configuration when the request is set up
+    ConfigurationSnapshot snapshot;
+    QMetaObject::Connection credentialsConnection;
+    QMetaObject::Connection credentialsFailedConnection;
     NetworkOperation namOperation = NetworkOperation::Invalid;
     ExpectedContentType expectedContentType = ExpectedContentType::Invalid;
     int statusCode = 0;
     quint16 requestTimeout = 300;
     quint8 retryCount = 0;
     bool requiresAuth = true;
+    bool usedSession = false;
+    bool sessionRetried = false;
+    // jobs working on the application password always authenticate with the credentials
+    bool handlesAppPassword = false;
 
     void handleSslErrors(QNetworkReply *reply, const QList<QSslError> &errors);
 
@@ -70,8 +89,26 @@ public:
 
     void requestFinished();
 
+    void waitForCredentials(AbstractCredentialProvider *provider);
+
+    void stopWaitingForCredentials();
+
+    SessionCookieJar *sessionCookieJar() const;
+
+    bool addSessionCookies(QNetworkRequest &request);
+
+    bool sessionExpired();
+
     void emitError(int errorCode, const QString &errorText = QString());
 
+    void emitSucceeded();
+
+    qint64 timestamp();
+
+    void finishTimings();
+
+    void recordMetrics();
+
     virtual QString buildUrlPath() const;
 
     virtual QUrlQuery buildUrlQuery() const;
@@ -88,6 +125,8 @@ public:
 
     virtual void emitDescription();
 
+    virtual bool continueRequest();
+
 protected:
     Job *q_ptr = nullptr;
 
@@ -0,0 +1,88 @@
+/*
+ * SPDX-FileCopyrightText: (C) 2021 Matthias Fehring / www.huessenbergnetz.de
+ * SPDX-License-Identifier: LGPL-3.0-or-later
+ */
+
+#ifndef WOLKANLIN_JOBTIMINGS_H
+#define WOLKANLIN_JOBTIMINGS_H
+
+#include <QtGlobal>
+#include <QMetaType>
+
+namespace Wolkanlin {
+
+/*!
+ * \brief Timestamps of the phases of a single Job.
+ *
+ * All timestamps are measured with a monotonic clock in nanoseconds relative to the moment
+ * the job has been queued by WJob::start(). Phases that have not been reached, for example
+ * because the job failed early or the connection was reused and no TLS handshake was performed,
+ * have a value of \c -1.
+ *
+ * The network stack does not report DNS lookup and connection setup separately, they are part
+ * of waitDuration() together with the processing time on the server. On new encrypted connections
+ * \link JobTimings::encrypted encrypted\endlink can be used to split the time before and after
+ * the TLS handshake.
+ *
+ * \sa Job::timings(), Job::timingsAvailable()
+ * \headerfile "" <Wolkanlin/JobTimings>
+ */
+struct JobTimings
+{
+    qint64 queued = -1;         /**< The job has been queued by WJob::start(), always \c 0 if started. */
+    qint64 setupStarted = -1;   /**< Setting up the request has been started in Job::sendRequest(). */
+    qint64 requestSent = -1;    /**< The request has been handed over to the network access manager. */
+    qint64 encrypted = -1;      /**< The TLS handshake of a new connection has been finished. */
+    qint64 firstByte = -1;      /**< The reply headers have been received. */
+    qint64 lastByte = -1;       /**< The reply has been received completely. */
+    qint64 parsed = -1;         /**< The reply data has been checked and parsed. */
+    qint64 finished = -1;       /**< The result has been emitted. */
+
+    /*!
+     * \brief Returns \c true if no phase has been recorded yet.
+     */
+    bool isEmpty() const { return queued < 0 && setupStarted < 0; }
+
+    /*!
+     * \brief Returns the nanoseconds between queueing and starting the request setup.
+     */
+    qint64 queueDuration() const { return duration(queued, setupStarted); }
+
+    /*!
+     * \brief Returns the nanoseconds used to set up the request.
+     */
+    qint64 setupDuration() const { return duration(setupStarted, requestSent); }
+
+    /*!
+     * \brief Returns the nanoseconds between sending the request and receiving the reply headers.
+     *
+     * This contains name resolution, connection setup, TLS handshake and the processing
+     * time on the server.
+     */
+    qint64 waitDuration() const { return duration(requestSent, firstByte); }
+
+    /*!
+     * \brief Returns the nanoseconds used to receive the reply body.
+     */
+    qint64 transferDuration() const { return duration(firstByte, lastByte); }
+
+    /*!
+     * \brief Returns the nanoseconds used to check and parse the reply data.
+     */
+    qint64 parseDuration() const { return duration(lastByte, parsed); }
+
+    /*!
+     * \brief Returns the nanoseconds from queueing the job until the result has been emitted.
+     */
+    qint64 totalDuration() const { return duration(queued, finished); }
+
+private:
+    static qint64 duration(qint64 from, qint64 to) { return (from < 0 || to < 0) ? -1 : to - from; }
+};
+
+}
+
+Q_DECLARE_METATYPE(Wolkanlin::JobTimings)
+Q_DECLARE_TYPEINFO(Wolkanlin::JobTimings, Q_PRIMITIVE_TYPE);
+
+#endif // WOLKANLIN_JOBTIMINGS_H
@@ -0,0 +1,249 @@
+/*
+ * SPDX-FileCopyrightText: (C) 2021 Matthias Fehring / www.huessenbergnetz.de
+ * SPDX-License-Identifier: LGPL-3.0-or-later
+ */
+
+#include "metricsregistry.h"
+#include "logging.h"
+#include <QMutex>
+#include <QMutexLocker>
+#include <QGlobalStatic>
+#include <QAtomicInt>
+#include <QPair>
+#include <algorithm>
+
+using namespace Wolkanlin;
+
+namespace Wolkanlin {
+
+class MetricsRegistryPrivate
+{
+public:
+    using Key = QPair<QString,QString>;
+
+    MetricsRegistry::EndpointMetrics &entry(const QString &endpoint, const QString &host)
+    {
+        auto it = metrics.find(qMakePair(endpoint, host));
+        if (it == metrics.end()) {
+            MetricsRegistry::EndpointMetrics m;
+            m.endpoint = endpoint;
+            m.host = host;
+            m.latencyCounts.fill(0, buckets.size() + 1);
+            it = metrics.insert(qMakePair(endpoint, host), m);
+        }
+        return *it;
+    }
+
+    static QByteArray labels(const MetricsRegistry::EndpointMetrics &m)
+    {
+        return QByteArrayLiteral("endpoint=\"") + escape(m.endpoint) + QByteArrayLiteral("\",host=\"") + escape(m.host) + '"';
+    }
+
+    static QByteArray escape(const QString &value)
+    {
+        QByteArray escaped = value.toUtf8();
+        escaped.replace('\\', QByteArrayLiteral("\\\\"));
+        escaped.replace('"', QByteArrayLiteral("\\\""));
+        escaped.replace('\n', QByteArrayLiteral("\\n"));
+        return escaped;
+    }
+
+    static QByteArray number(double value)
+    {
+        return QByteArray::number(value, 'g', 12);
+    }
+
+    static void writeHeader(QByteArray &out, const char *name, const char *type, const char *help)
+    {
+        out += QByteArrayLiteral("# HELP ") + name + ' ' + help + '\n';
+        out += QByteArrayLiteral("# TYPE ") + name + ' ' + type + '\n';
+    }
+
+    mutable QMutex lock;
+    QMap<Key,MetricsRegistry::EndpointMetrics> metrics;
+    QAtomicInt enabled{1};
+    const QVector<double> buckets = MetricsRegistry::latencyBuckets();
+};
+
+}
+
+Q_GLOBAL_STATIC(MetricsRegistry, globalRegistry)
+
+MetricsRegistry::MetricsRegistry() : wl_ptr(new MetricsRegistryPrivate)
+{
+
+}
+
+MetricsRegistry::~MetricsRegistry() = default;
+
+bool MetricsRegistry::isEnabled() const
+{
+    Q_D(const MetricsRegistry);
+    return d->enabled.loadAcquire() != 0;
+}
+
+void MetricsRegistry::setEnabled(bool enabled)
+{
+    Q_D(MetricsRegistry);
+    qCDebug(wlCore) << "Changing metrics recording from" << isEnabled() << "to" << enabled;
+    d->enabled.storeRelease(enabled ? 1 : 0);
+}
+
+void MetricsRegistry::recordRequest(const QString &endpoint, const QString &host, int errorCode, qint64 latency, qint64 bytesSent, qint64 bytesReceived)
+{
+    Q_D(MetricsRegistry);
+    if (!isEnabled()) {
+        return;
+    }
+
+    QMutexLocker locker(&d->lock);
+    EndpointMetrics &m = d->entry(endpoint, host);
+    m.requests++;
+    if (errorCode != 0) {
+        m.failures++;
+        m.errors[errorCode]++;
+    }
+    m.bytesSent += std::max<qint64>(bytesSent, 0);
+    m.bytesReceived += std::max<qint64>(bytesReceived, 0);
+
+    if (latency >= 0) {
+        const double seconds = static_cast<double>(latency) / 1e9;
+        const auto bucket = std::lower_bound(d->buckets.cbegin(), d->buckets.cend(), seconds);
+        m.latencyCounts[static_cast<int>(bucket - d->buckets.cbegin())]++;
+        m.latencySum += seconds;
+        m.latencyCount++;
+    }
+}
+
+void MetricsRegistry::recordRetry(const QString &endpoint, const QString &host, int count)
+{
+    Q_D(MetricsRegistry);
+    if (!isEnabled() || count <= 0) {
+        return;
+    }
+
+    QMutexLocker locker(&d->lock);
+    d->entry(endpoint, host).retries += count;
+}
+
+void MetricsRegistry::recordCacheHit(const QString &endpoint, const QString &host, int count)
+{
+    Q_D(MetricsRegistry);
+    if (!isEnabled() || count <= 0) {
+        return;
+    }
+
+    QMutexLocker locker(&d->lock);
+    d->entry(endpoint, host).cacheHits += count;
+}
+
+QVector<MetricsRegistry::EndpointMetrics> MetricsRegistry::metrics() const
+{
+    Q_D(const MetricsRegistry);
+    QMutexLocker locker(&d->lock);
+    QVector<EndpointMetrics> list;
+    list.reserve(d->metrics.size());
+    for (auto it = d->metrics.cbegin(); it != d->metrics.cend(); ++it) {
+        list.append(it.value());
+    }
+    return list;
+}
+
+MetricsRegistry::EndpointMetrics MetricsRegistry::metrics(const QString &endpoint, const QString &host) const
+{
+    Q_D(const MetricsRegistry);
+    QMutexLocker locker(&d->lock);
+    const auto it = d->metrics.constFind(qMakePair(endpoint, host));
+    if (it != d->metrics.cend()) {
+        return it.value();
+    }
+    EndpointMetrics m;
+    m.endpoint = endpoint;
+    m.host = host;
+    m.latencyCounts.fill(0, d->buckets.size() + 1);
+    return m;
+}
+
+QByteArray MetricsRegistry::toPrometheus() const
+{
+    Q_D(const MetricsRegistry);
+
+    const QVector<EndpointMetrics> list = metrics();
+
+    QByteArray out;
+    if (list.empty()) {
+        return out;
+    }
+
+    QVector<QByteArray> labels;
+    labels.reserve(list.size());
+    for (const EndpointMetrics &m : list) {
+        labels.append(MetricsRegistryPrivate::labels(m));
+    }
+
+    MetricsRegistryPrivate::writeHeader(out, "wolkanlin_requests_total", "counter", "Number of finished requests.");
+    for (int i = 0; i < list.size(); ++i) {
+        out += QByteArrayLiteral("wolkanlin_requests_total{") + labels.at(i) + QByteArrayLiteral("} ") + QByteArray::number(list.at(i).requests) + '\n';
+    }
+
+    MetricsRegistryPrivate::writeHeader(out, "wolkanlin_request_errors_total", "counter", "Number of failed requests by error code.");
+    for (int i = 0; i < list.size(); ++i) {
+        const QMap<int, qint64> &errors = list.at(i).errors;
+        for (auto it = errors.cbegin(); it != errors.cend(); ++it) {
+            out += QByteArrayLiteral("wolkanlin_request_errors_total{") + labels.at(i) + QByteArrayLiteral(",code=\"") + QByteArray::number(it.key()) + QByteArrayLiteral("\"} ") + QByteArray::number(it.value()) + '\n';
+        }
+    }
+
+    MetricsRegistryPrivate::writeHeader(out, "wolkanlin_bytes_sent_total", "counter", "Number of sent payload bytes.");
+    for (int i = 0; i < list.size(); ++i) {
+        out += QByteArrayLiteral("wolkanlin_bytes_sent_total{") + labels.at(i) + QByteArrayLiteral("} ") + QByteArray::number(list.at(i).bytesSent) + '\n';
+    }
+
+    MetricsRegistryPrivate::writeHeader(out, "wolkanlin_bytes_received_total", "counter", "Number of received reply bytes.");
+    for (int i = 0; i < list.size(); ++i) {
+        out += QByteArrayLiteral("wolkanlin_bytes_received_total{") + labels.at(i) + QByteArrayLiteral("} ") + QByteArray::number(list.at(i).bytesReceived) + '\n';
+    }
+
+    MetricsRegistryPrivate::writeHeader(out, "wolkanlin_retries_total", "counter", "Number of retried requests.");
+    for (int i = 0; i < list.size(); ++i) {
+        out += QByteArrayLiteral("wolkanlin_retries_total{") + labels.at(i) + QByteArrayLiteral("} ") + QByteArray::number(list.at(i).retries) + '\n';
+    }
+
+    MetricsRegistryPrivate::writeHeader(out, "wolkanlin_cache_hits_total", "counter", "Number of requests answered from a cache.");
+    for (int i = 0; i < list.size(); ++i) {
+        out += QByteArrayLiteral("wolkanlin_cache_hits_total{") + labels.at(i) + QByteArrayLiteral("} ") + QByteArray::number(list.at(i).cacheHits) + '\n';
+    }
+
+    MetricsRegistryPrivate::writeHeader(out, "wolkanlin_request_duration_seconds", "histogram", "Duration of finished requests in seconds.");
+    for (int i = 0; i < list.size(); ++i) {
+        const EndpointMetrics &m = list.at(i);
+        qint64 cumulated = 0;
+        for (int b = 0; b < m.latencyCounts.size(); ++b) {
+            cumulated += m.latencyCounts.at(b);
+            const QByteArray le = b < d->buckets.size() ? MetricsRegistryPrivate::number(d->buckets.at(b)) : QByteArrayLiteral("+Inf");
+            out += QByteArrayLiteral("wolkanlin_request_duration_seconds_bucket{") + labels.at(i) + QByteArrayLiteral(",le=\"") + le + QByteArrayLiteral("\"} ") + QByteArray::number(cumulated) + '\n';
+        }
+        out += QByteArrayLiteral("wolkanlin_request_duration_seconds_sum{") + labels.at(i) + QByteArrayLiteral("} ") + MetricsRegistryPrivate::number(m.latencySum) + '\n';
+        out += QByteArrayLiteral("wolkanlin_request_duration_seconds_count{") + labels.at(i) + QByteArrayLiteral("} ") + QByteArray::number(m.latencyCount) + '\n';
+    }
+
+    return out;
+}
+
+void MetricsRegistry::clear()
+{
+    Q_D(MetricsRegistry);
+    QMutexLocker locker(&d->lock);
+    qCDebug(wlCore) << "Clearing metrics registry with" << d->metrics.size() << "entries";
+    d->metrics.clear();
+}
+
+QVector<double> MetricsRegistry::latencyBuckets()
+{
+    return {0.005, 0.01, 0.025, 0.05, 0.1, 0.25, 0.5, 1.0, 2.5, 5.0, 10.0};
+}
+
+MetricsRegistry *MetricsRegistry::global()
+{
+    return globalRegistry();
+}
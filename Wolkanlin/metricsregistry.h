@@ -0,0 +1,144 @@
+/*
+ * SPDX-FileCopyrightText: (C) 2021 Matthias Fehring / www.huessenbergnetz.de
+ * SPDX-License-Identifier: LGPL-3.0-or-later
+ */
+
+#ifndef WOLKANLIN_METRICSREGISTRY_H
+#define WOLKANLIN_METRICSREGISTRY_H
+
+#include "wolkanlin_export.h"
+#include <QString>
+#include <QMap>
+#include <QVector>
+#include <memory>
+
+namespace Wolkanlin {
+
+class MetricsRegistryPrivate;
+
+/*!
+ * \brief Collects request metrics per endpoint and host.
+ *
+ * Every Job reports its result to the global() registry when it has been finished. The metrics
+ * are keyed by the endpoint, that is the class name of the job like \c GetUserJob, and the remote
+ * host. For every key the registry counts the requests, the errors by error code, the transferred
+ * bytes, retries and cache hits and collects the request latencies in a histogram with fixed
+ * buckets, see latencyBuckets().
+ *
+ * The metrics can be read via metrics() or can be exported in the Prometheus text exposition
+ * format via toPrometheus(). Recording can be disabled via setEnabled().
+ *
+ * All functions of this class are thread-safe.
+ *
+ * \headerfile "" <Wolkanlin/MetricsRegistry>
+ */
+class WOLKANLIN_EXPORT MetricsRegistry
+{
+public:
+    /*!
+     * \brief Metrics of a single endpoint and host combination.
+     */
+    struct EndpointMetrics {
+        QString endpoint;               /**< The endpoint, the class name of the job. */
+        QString host;                   /**< The remote host. */
+        qint64 requests = 0;            /**< Number of finished requests. */
+        qint64 failures = 0;            /**< Number of failed requests. */
+        QMap<int, qint64> errors;       /**< Number of failed requests by error code. */
+        qint64 bytesSent = 0;           /**< Number of sent payload bytes. */
+        qint64 bytesReceived = 0;       /**< Number of received reply bytes. */
+        qint64 retries = 0;             /**< Number of retried requests. */
+        qint64 cacheHits = 0;           /**< Number of requests answered from a cache. */
+        QVector<qint64> latencyCounts;  /**< Number of latencies per bucket of latencyBuckets(), the last one is for larger values. */
+        double latencySum = 0.0;        /**< Sum of all latencies in seconds. */
+        qint64 latencyCount = 0;        /**< Number of recorded latencies. */
+    };
+
+    /*!
+     * \brief Constructs a new empty %MetricsRegistry.
+     */
+    MetricsRegistry();
+
+    /*!
+     * \brief Destroys the %MetricsRegistry.
+     */
+    ~MetricsRegistry();
+
+    /*!
+     * \brief Returns \c true if recording is enabled.
+     *
+     * Recording is enabled by default.
+     */
+    bool isEnabled() const;
+
+    /*!
+     * \brief Enables or disables recording.
+     */
+    void setEnabled(bool enabled);
+
+    /*!
+     * \brief Records a finished request.
+     *
+     * \param endpoint      the requested endpoint, normally the job class name
+     * \param host          the remote host
+     * \param errorCode     the error code of the request, \c 0 on success
+     * \param latency       the duration of the request in nanoseconds, negative values will not be recorded
+     * \param bytesSent     the number of sent payload bytes
+     * \param bytesReceived the number of received reply bytes
+     */
+    void recordRequest(const QString &endpoint, const QString &host, int errorCode, qint64 latency, qint64 bytesSent, qint64 bytesReceived);
+
+    /*!
+     * \brief Records \a count retries of requests to \a endpoint on \a host.
+     */
+    void recordRetry(const QString &endpoint, const QString &host, int count = 1);
+
+    /*!
+     * \brief Records \a count requests to \a endpoint on \a host that have been answered from a cache.
+     */
+    void recordCacheHit(const QString &endpoint, const QString &host, int count = 1);
+
+    /*!
+     * \brief Returns the metrics of all endpoint and host combinations sorted by endpoint and host.
+     */
+    QVector<EndpointMetrics> metrics() const;
+
+    /*!
+     * \brief Returns the metrics for \a endpoint and \a host.
+     *
+     * If nothing has been recorded for the combination, the returned metrics are empty.
+     */
+    EndpointMetrics metrics(const QString &endpoint, const QString &host) const;
+
+    /*!
+     * \brief Returns all metrics in the Prometheus text exposition format.
+     *
+     * Metric names are prefixed with \c wolkanlin_, the endpoint and host are exported as
+     * labels. Latencies are exported as histogram in seconds.
+     */
+    QByteArray toPrometheus() const;
+
+    /*!
+     * \brief Removes all recorded metrics.
+     */
+    void clear();
+
+    /*!
+     * \brief Returns the upper bounds of the latency histogram buckets in seconds.
+     */
+    static QVector<double> latencyBuckets();
+
+    /*!
+     * \brief Returns a pointer to the global registry used by the jobs.
+     */
+    static MetricsRegistry *global();
+
+private:
+    const std::unique_ptr<MetricsRegistryPrivate> wl_ptr;
+
+    Q_DECLARE_PRIVATE_D(wl_ptr, MetricsRegistry)
+    Q_DISABLE_COPY(MetricsRegistry)
+};
+
+}
+
+#endif // WOLKANLIN_METRICSREGISTRY_H
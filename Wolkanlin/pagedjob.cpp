@@ -0,0 +1,280 @@
+/*
+ * SPDX-FileCopyrightText: (C) 2021 Matthias Fehring / www.huessenbergnetz.de
+ * SPDX-License-Identifier: LGPL-3.0-or-later
+ */
+
+#include "pagedjob_p.h"
+#include "logging.h"
+
+using namespace Wolkanlin;
+
+PagedJobPrivate::PagedJobPrivate(PagedJob *q)
+    : JobPrivate(q)
+{
+
+}
+
+PagedJobPrivate::~PagedJobPrivate() = default;
+
+QUrlQuery PagedJobPrivate::buildUrlQuery() const
+{
+    QUrlQuery query = JobPrivate::buildUrlQuery();
+
+    if (!search.isEmpty()) {
+        query.addQueryItem(QStringLiteral("search"), search);
+    }
+
+    const int _limit = fetchAllPages ? pageLimit(offset) : limit;
+    if (_limit > 0) {
+        query.addQueryItem(QStringLiteral("limit"), QString::number(_limit));
+    }
+
+    if (offset > 0) {
+        query.addQueryItem(QStringLiteral("offset"), QString::number(offset));
+    }
+
+    return query;
+}
+
+bool PagedJobPrivate::checkOutput(const QByteArray &data)
+{
+    if (Q_UNLIKELY(!JobPrivate::checkOutput(data))) {
+        return false;
+    }
+
+    const int count = processPage(jsonResult, offset);
+    qCDebug(wlCore) << "Received" << count << "items at offset" << offset;
+
+    const int _limitOffset = limitOffset();
+    const bool morePages = fetchAllPages && count >= pageSize && (_limitOffset < 0 || offset + count < _limitOffset);
+    endOffset = morePages ? -1 : offset + count;
+
+    return true;
+}
+
+bool PagedJobPrivate::continueRequest()
+{
+    if (endOffset > -1) {
+        mergePages();
+        return false;
+    }
+
+    qCDebug(wlCore) << "First page is full, requesting further pages with up to" << maxConcurrentPages << "concurrent requests.";
+
+    nextPageOffset = offset + pageSize;
+    startPages();
+
+    return true;
+}
+
+int PagedJobPrivate::limitOffset() const
+{
+    return (fetchAllPages && limit > 0) ? offset + limit : -1;
+}
+
+int PagedJobPrivate::pageLimit(int pageOffset) const
+{
+    const int _limitOffset = limitOffset();
+    return _limitOffset < 0 ? pageSize : qMin(pageSize, _limitOffset - pageOffset);
+}
+
+void PagedJobPrivate::startPages()
+{
+    const int _limitOffset = limitOffset();
+    while (runningPages.size() < maxConcurrentPages && (endOffset < 0 || nextPageOffset < endOffset) && (_limitOffset < 0 || nextPageOffset < _limitOffset)) {
+        startPage(nextPageOffset);
+        nextPageOffset += pageSize;
+    }
+}
+
+void PagedJobPrivate::startPage(int pageOffset)
+{
+    Q_Q(PagedJob);
+
+    Job *page = createPageJob(pageOffset);
+    page->setConfiguration(configuration);
+    page->setNetworkAccessManager(nam);
+
+    QObject::connect(page, &Job::succeeded, q, [this, pageOffset, page](){
+        onPageSucceeded(pageOffset, page);
+    });
+    QObject::connect(page, &Job::failed, q, [this, pageOffset, page](int errorCode){
+        onPageFailed(pageOffset, errorCode, page->errorText());
+    });
+
+    runningPages.insert(pageOffset, page);
+    page->start();
+}
+
+void PagedJobPrivate::onPageSucceeded(int pageOffset, Job *page)
+{
+    runningPages.remove(pageOffset);
+
+    if (endOffset < 0 || pageOffset < endOffset) {
+        const int count = takePage(page, pageOffset);
+        const int _limitOffset = limitOffset();
+        if (count < pageSize || (_limitOffset > -1 && pageOffset + count >= _limitOffset)) {
+            const int end = pageOffset + count;
+            endOffset = endOffset < 0 ? end : qMin(endOffset, end);
+            qCDebug(wlCore) << "Reached the end of the list at offset" << endOffset;
+        }
+    }
+
+    if (endOffset > -1) {
+        const QList<int> runningOffsets = runningPages.keys();
+        for (int o : runningOffsets) {
+            if (o >= endOffset) {
+                runningPages.take(o)->kill(WJob::Quietly);
+            }
+        }
+    }
+
+    startPages();
+
+    if (runningPages.empty()) {
+        finishPages();
+    }
+}
+
+void PagedJobPrivate::onPageFailed(int pageOffset, int errorCode, const QString &errorText)
+{
+    qCCritical(wlCore) << "Failed to request page at offset" << pageOffset;
+
+    runningPages.remove(pageOffset);
+    killPages();
+
+    emitError(errorCode, errorText);
+}
+
+void PagedJobPrivate::killPages()
+{
+    if (!runningPages.empty()) {
+        const QList<Job*> pages = runningPages.values();
+        for (Job *page : pages) {
+            page->kill(WJob::Quietly);
+        }
+        runningPages.clear();
+    }
+}
+
+void PagedJobPrivate::finishPages()
+{
+    mergePages();
+    emitSucceeded();
+}
+
+PagedJob::PagedJob(PagedJobPrivate &dd, QObject *parent)
+    : Job(dd, parent)
+{
+
+}
+
+PagedJob::~PagedJob() = default;
+
+bool PagedJob::doKill()
+{
+    Q_D(PagedJob);
+    d->killPages();
+    return Job::doKill();
+}
+
+QString PagedJob::search() const
+{
+    Q_D(const PagedJob);
+    return d->search;
+}
+
+void PagedJob::setSearch(const QString &search)
+{
+    Q_D(PagedJob);
+    if (d->search != search) {
+        qCDebug(wlCore) << "Changing search from" << d->search << "to" << search;
+        d->search = search;
+        Q_EMIT searchChanged(d->search);
+    }
+}
+
+int PagedJob::limit() const
+{
+    Q_D(const PagedJob);
+    return d->limit;
+}
+
+void PagedJob::setLimit(int limit)
+{
+    Q_D(PagedJob);
+    if (d->limit != limit) {
+        qCDebug(wlCore) << "Changing limit from" << d->limit << "to" << limit;
+        d->limit = limit;
+        Q_EMIT limitChanged(d->limit);
+    }
+}
+
+int PagedJob::offset() const
+{
+    Q_D(const PagedJob);
+    return d->offset;
+}
+
+void PagedJob::setOffset(int offset)
+{
+    Q_D(PagedJob);
+    offset = qMax(offset, 0);
+    if (d->offset != offset) {
+        qCDebug(wlCore) << "Changing offset from" << d->offset << "to" << offset;
+        d->offset = offset;
+        Q_EMIT offsetChanged(d->offset);
+    }
+}
+
+bool PagedJob::fetchAllPages() const
+{
+    Q_D(const PagedJob);
+    return d->fetchAllPages;
+}
+
+void PagedJob::setFetchAllPages(bool fetchAllPages)
+{
+    Q_D(PagedJob);
+    if (d->fetchAllPages != fetchAllPages) {
+        qCDebug(wlCore) << "Changing fetchAllPages from" << d->fetchAllPages << "to" << fetchAllPages;
+        d->fetchAllPages = fetchAllPages;
+        Q_EMIT fetchAllPagesChanged(d->fetchAllPages);
+    }
+}
+
+int PagedJob::pageSize() const
+{
+    Q_D(const PagedJob);
+    return d->pageSize;
+}
+
+void PagedJob::setPageSize(int pageSize)
+{
+    Q_D(PagedJob);
+    pageSize = qMax(pageSize, 1);
+    if (d->pageSize != pageSize) {
+        qCDebug(wlCore) << "Changing pageSize from" << d->pageSize << "to" << pageSize;
+        d->pageSize = pageSize;
+        Q_EMIT pageSizeChanged(d->pageSize);
+    }
+}
+
+int PagedJob::maxConcurrentPages() const
+{
+    Q_D(const PagedJob);
+    return d->maxConcurrentPages;
+}
+
+void PagedJob::setMaxConcurrentPages(int maxConcurrentPages)
+{
+    Q_D(PagedJob);
+    maxConcurrentPages = qMax(maxConcurrentPages, 1);
+    if (d->maxConcurrentPages != maxConcurrentPages) {
+        qCDebug(wlCore) << "Changing maxConcurrentPages from" << d->maxConcurrentPages << "to" << maxConcurrentPages;
+        d->maxConcurrentPages = maxConcurrentPages;
+        Q_EMIT maxConcurrentPagesChanged(d->maxConcurrentPages);
+    }
+}
+
+#include "moc_pagedjob.cpp"
@@ -0,0 +1,246 @@
+/*
+ * SPDX-FileCopyrightText: (C) 2021 Matthias Fehring / www.huessenbergnetz.de
+ * SPDX-License-Identifier: LGPL-3.0-or-later
+ */
+
+#ifndef WOLKANLIN_PAGEDJOB_H
+#define WOLKANLIN_PAGEDJOB_H
+
+#include "wolkanlin_export.h"
+#include "job.h"
+#include <QObject>
+#include <QString>
+
+namespace Wolkanlin {
+
+class PagedJobPrivate;
+
+/*!
+ * \brief Base class for jobs requesting lists that can be paginated and filtered.
+ *
+ * Use \link PagedJob::limit limit\endlink and \link PagedJob::offset offset\endlink
+ * to request a single page of the list and \link PagedJob::search search\endlink to filter it.
+ * If \link PagedJob::fetchAllPages fetchAllPages\endlink is enabled, the list is requested
+ * in pages of \link PagedJob::pageSize pageSize\endlink items. If the first page is full, up
+ * to \link PagedJob::maxConcurrentPages maxConcurrentPages\endlink further pages will be
+ * requested concurrently until a page is not full or \link PagedJob::limit limit\endlink items
+ * have been received.
+ *
+ * \headerfile "" <Wolkanlin/PagedJob>
+ */
+class WOLKANLIN_EXPORT PagedJob : public Job
+{
+    Q_OBJECT
+    /*!
+     * \brief This property holds a search string to filter the list.
+     *
+     * If empty, the list will not be filtered. Default: empty
+     *
+     * \par Access methods
+     * \li QString search() const
+     * \li void setSearch(const QString &search)
+     *
+     * \par Notifier signal
+     * \li void searchChanged(const QString &search)
+     */
+    Q_PROPERTY(QString search READ search WRITE setSearch NOTIFY searchChanged)
+    /*!
+     * \brief This property holds the maximum number of items to request.
+     *
+     * Values lower than \c 1 will request all items. If \link PagedJob::fetchAllPages fetchAllPages\endlink
+     * is enabled, pages will only be requested until \a limit items have been received. Default: \c -1
+     *
+     * \par Access methods
+     * \li int limit() const
+     * \li void setLimit(int limit)
+     *
+     * \par Notifier signal
+     * \li void limitChanged(int limit)
+     */
+    Q_PROPERTY(int limit READ limit WRITE setLimit NOTIFY limitChanged)
+    /*!
+     * \brief This property holds the number of items to skip at the beginning of the list.
+     *
+     * Default: \c 0
+     *
+     * \par Access methods
+     * \li int offset() const
+     * \li void setOffset(int offset)
+     *
+     * \par Notifier signal
+     * \li void offsetChanged(int offset)
+     */
+    Q_PROPERTY(int offset READ offset WRITE setOffset NOTIFY offsetChanged)
+    /*!
+     * \brief Set this to \c true to request the complete list in concurrently fetched pages.
+     *
+     * Default: \c false
+     *
+     * \par Access methods
+     * \li bool fetchAllPages() const
+     * \li void setFetchAllPages(bool fetchAllPages)
+     *
+     * \par Notifier signal
+     * \li void fetchAllPagesChanged(bool fetchAllPages)
+     */
+    Q_PROPERTY(bool fetchAllPages READ fetchAllPages WRITE setFetchAllPages NOTIFY fetchAllPagesChanged)
+    /*!
+     * \brief This property holds the number of items requested per page if \link PagedJob::fetchAllPages fetchAllPages\endlink is enabled.
+     *
+     * The default value depends on the subclass.
+     *
+     * \par Access methods
+     * \li int pageSize() const
+     * \li void setPageSize(int pageSize)
+     *
+     * \par Notifier signal
+     * \li void pageSizeChanged(int pageSize)
+     */
+    Q_PROPERTY(int pageSize READ pageSize WRITE setPageSize NOTIFY pageSizeChanged)
+    /*!
+     * \brief This property holds the maximum number of pages requested at the same time if \link PagedJob::fetchAllPages fetchAllPages\endlink is enabled.
+     *
+     * Default: \c 4
+     *
+     * \par Access methods
+     * \li int maxConcurrentPages() const
+     * \li void setMaxConcurrentPages(int maxConcurrentPages)
+     *
+     * \par Notifier signal
+     * \li void maxConcurrentPagesChanged(int maxConcurrentPages)
+     */
+    Q_PROPERTY(int maxConcurrentPages READ maxConcurrentPages WRITE setMaxConcurrentPages NOTIFY maxConcurrentPagesChanged)
+public:
+    /*!
+     * \brief Destroys the %PagedJob object.
+     */
+    ~PagedJob() override;
+
+    /*!
+     * \brief Getter function for the \link PagedJob::search search\endlink property.
+     * \sa setSearch(), searchChanged()
+     */
+    QString search() const;
+
+    /*!
+     * \brief Setter function for the \link PagedJob::search search\endlink property.
+     * \sa search(), searchChanged()
+     */
+    void setSearch(const QString &search);
+
+    /*!
+     * \brief Getter function for the \link PagedJob::limit limit\endlink property.
+     * \sa setLimit(), limitChanged()
+     */
+    int limit() const;
+
+    /*!
+     * \brief Setter function for the \link PagedJob::limit limit\endlink property.
+     * \sa limit(), limitChanged()
+     */
+    void setLimit(int limit);
+
+    /*!
+     * \brief Getter function for the \link PagedJob::offset offset\endlink property.
+     * \sa setOffset(), offsetChanged()
+     */
+    int offset() const;
+
+    /*!
+     * \brief Setter function for the \link PagedJob::offset offset\endlink property.
+     * \sa offset(), offsetChanged()
+     */
+    void setOffset(int offset);
+
+    /*!
+     * \brief Getter function for the \link PagedJob::fetchAllPages fetchAllPages\endlink property.
+     * \sa setFetchAllPages(), fetchAllPagesChanged()
+     */
+    bool fetchAllPages() const;
+
+    /*!
+     * \brief Setter function for the \link PagedJob::fetchAllPages fetchAllPages\endlink property.
+     * \sa fetchAllPages(), fetchAllPagesChanged()
+     */
+    void setFetchAllPages(bool fetchAllPages);
+
+    /*!
+     * \brief Getter function for the \link PagedJob::pageSize pageSize\endlink property.
+     * \sa setPageSize(), pageSizeChanged()
+     */
+    int pageSize() const;
+
+    /*!
+     * \brief Setter function for the \link PagedJob::pageSize pageSize\endlink property.
+     * \sa pageSize(), pageSizeChanged()
+     */
+    void setPageSize(int pageSize);
+
+    /*!
+     * \brief Getter function for the \link PagedJob::maxConcurrentPages maxConcurrentPages\endlink property.
+     * \sa setMaxConcurrentPages(), maxConcurrentPagesChanged()
+     */
+    int maxConcurrentPages() const;
+
+    /*!
+     * \brief Setter function for the \link PagedJob::maxConcurrentPages maxConcurrentPages\endlink property.
+     * \sa maxConcurrentPages(), maxConcurrentPagesChanged()
+     */
+    void setMaxConcurrentPages(int maxConcurrentPages);
+
+Q_SIGNALS:
+    /*!
+     * \brief Notifier signal for the \link PagedJob::search search\endlink property.
+     * \sa search(), setSearch()
+     */
+    void searchChanged(const QString &search);
+
+    /*!
+     * \brief Notifier signal for the \link PagedJob::limit limit\endlink property.
+     * \sa limit(), setLimit()
+     */
+    void limitChanged(int limit);
+
+    /*!
+     * \brief Notifier signal for the \link PagedJob::offset offset\endlink property.
+     * \sa offset(), setOffset()
+     */
+    void offsetChanged(int offset);
+
+    /*!
+     * \brief Notifier signal for the \link PagedJob::fetchAllPages fetchAllPages\endlink property.
+     * \sa fetchAllPages(), setFetchAllPages()
+     */
+    void fetchAllPagesChanged(bool fetchAllPages);
+
+    /*!
+     * \brief Notifier signal for the \link PagedJob::pageSize pageSize\endlink property.
+     * \sa pageSize(), setPageSize()
+     */
+    void pageSizeChanged(int pageSize);
+
+    /*!
+     * \brief Notifier signal for the \link PagedJob::maxConcurrentPages maxConcurrentPages\endlink property.
+     * \sa maxConcurrentPages(), setMaxConcurrentPages()
+     */
+    void maxConcurrentPagesChanged(int maxConcurrentPages);
+
+protected:
+    /*!
+     * \brief Constructs a new %PagedJob object with the given private implementation \a dd and \a parent.
+     */
+    explicit PagedJob(PagedJobPrivate &dd, QObject *parent = nullptr);
+
+    /*!
+     * \brief Aborts the running request and all concurrently running page requests.
+     */
+    bool doKill() override;
+
+private:
+    Q_DECLARE_PRIVATE_D(wl_ptr, PagedJob)
+    Q_DISABLE_COPY(PagedJob)
+};
+
+}
+
+#endif // WOLKANLIN_PAGEDJOB_H
@@ -0,0 +1,75 @@
+/*
+ * SPDX-FileCopyrightText: (C) 2021 Matthias Fehring / www.huessenbergnetz.de
+ * SPDX-License-Identifier: LGPL-3.0-or-later
+ */
+
+#ifndef WOLKANLIN_PAGEDJOB_P_H
+#define WOLKANLIN_PAGEDJOB_P_H
+
+#include "pagedjob.h"
+#include "job_p.h"
+#include <QHash>
+
+namespace Wolkanlin {
+
+/*
+ * Common base for jobs requesting OCS lists that support the search, limit and
+ * offset query parameters. If fetchAllPages is enabled and the first page is full,
+ * the following pages are requested concurrently by child jobs created via
+ * createPageJob() until a page is not full anymore or until limit items have
+ * been received.
+ */
+class PagedJobPrivate : public JobPrivate
+{
+public:
+    explicit PagedJobPrivate(PagedJob *q);
+    ~PagedJobPrivate() override;
+
+    QUrlQuery buildUrlQuery() const override;
+
+    bool checkOutput(const QByteArray &data) override;
+
+    bool continueRequest() override;
+
+    // returns a new job for the page at pageOffset with search, limit and offset set
+    virtual Job *createPageJob(int pageOffset) = 0;
+
+    // processes the page received by this job and returns the number of received items
+    virtual int processPage(const QJsonDocument &json, int pageOffset) = 0;
+
+    // takes the items received by the finished page job and returns their number
+    virtual int takePage(Job *page, int pageOffset) = 0;
+
+    // merges all processed pages up to endOffset into the final result
+    virtual void mergePages() = 0;
+
+    // offset after the last item to request if a limit is set in fetchAllPages mode, otherwise -1
+    int limitOffset() const;
+    // number of items to request for the page at pageOffset
+    int pageLimit(int pageOffset) const;
+
+    void startPages();
+    void startPage(int pageOffset);
+    void onPageSucceeded(int pageOffset, Job *page);
+    void onPageFailed(int pageOffset, int errorCode, const QString &errorText);
+    void killPages();
+    void finishPages();
+
+    QString search;
+    QHash<int, Job*> runningPages;
+    int limit = -1;
+    int offset = 0;
+    int pageSize = 500;
+    int maxConcurrentPages = 4;
+    int nextPageOffset = 0;
+    int endOffset = -1;
+    bool fetchAllPages = false;
+
+private:
+    Q_DECLARE_PUBLIC(PagedJob)
+    Q_DISABLE_COPY(PagedJobPrivate)
+};
+
+}
+
+#endif // WOLKANLIN_PAGEDJOB_P_H
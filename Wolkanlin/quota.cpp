@@ -5,6 +5,7 @@
 
 #include "quota_p.h"
 #include "logging.h"
+#include "cbor_p.h"
 #include <QDebug>
 #include <QDataStream>
 
@@ -113,6 +114,92 @@ Quota Quota::fromJson(const QJsonObject &json)
     }
 }
 
+#if QT_VERSION >= QT_VERSION_CHECK(5, 12, 0)
+void Quota::toCbor(QCborStreamWriter &writer) const
+{
+    writer.startMap();
+    if (Q_LIKELY(!isNull())) {
+        // all values are written, an empty map is a null quota
+        Cbor::writeKey(writer, Cbor::QuotaFree);
+        writer.append(d->free);
+        Cbor::writeKey(writer, Cbor::QuotaUsed);
+        writer.append(d->used);
+        Cbor::writeKey(writer, Cbor::QuotaQuota);
+        writer.append(d->quota);
+        Cbor::writeKey(writer, Cbor::QuotaTotal);
+        writer.append(d->total);
+        Cbor::writeKey(writer, Cbor::QuotaRelative);
+        writer.append(d->relative);
+    }
+    writer.endMap();
+}
+
+QByteArray Quota::toCbor() const
+{
+    QByteArray cbor;
+    QCborStreamWriter writer(&cbor);
+    toCbor(writer);
+    return cbor;
+}
+
+Quota Quota::fromCbor(QCborStreamReader &reader)
+{
+    if (Q_UNLIKELY(!reader.isMap() || !reader.enterContainer())) {
+        qCWarning(wlCore) << "CBOR data does not contain a map, creating null Wolkanlin::Quota.";
+        if (reader.lastError() == QCborError::NoError) {
+            reader.next();
+        }
+        return Quota();
+    }
+
+    qint64 free = 0;
+    qint64 used = 0;
+    qint64 quota = 0;
+    qint64 total = 0;
+    double relative = 0.0;
+    bool hasValues = false;
+
+    while (reader.lastError() == QCborError::NoError && reader.hasNext()) {
+        hasValues = true;
+        switch (Cbor::readKey(reader)) {
+        case Cbor::QuotaFree:
+            free = Cbor::readInteger(reader);
+            break;
+        case Cbor::QuotaUsed:
+            used = Cbor::readInteger(reader);
+            break;
+        case Cbor::QuotaQuota:
+            quota = Cbor::readInteger(reader);
+            break;
+        case Cbor::QuotaTotal:
+            total = Cbor::readInteger(reader);
+            break;
+        case Cbor::QuotaRelative:
+            relative = Cbor::readDouble(reader);
+            break;
+        default:
+            reader.next();
+            break;
+        }
+    }
+
+    if (Q_UNLIKELY(reader.lastError() != QCborError::NoError)) {
+        qCWarning(wlCore) << "Failed to read CBOR data, creating null Wolkanlin::Quota:" << reader.lastError().toString();
+        return Quota();
+    }
+
+    reader.leaveContainer();
+
+    return hasValues ? Quota(free, used, quota, total, relative) : Quota();
+}
+
+Quota Quota::fromCbor(const QByteArray &cbor)
+{
+    QCborStreamReader reader(cbor);
+    return Quota::fromCbor(reader);
+}
+#endif
+
 QDebug operator<<(QDebug dbg, const Wolkanlin::Quota &quota)
 {
     QDebugStateSaver saver(dbg);
@@ -11,6 +11,11 @@
 #include <QSharedDataPointer>
 #include <QJsonObject>
 
+#if QT_VERSION >= QT_VERSION_CHECK(5, 12, 0)
+class QCborStreamWriter;
+class QCborStreamReader;
+#endif
+
 namespace Wolkanlin {
 
 class QuotaPrivate;
@@ -182,6 +187,48 @@ public:
      */
     static Quota fromJson(const QJsonObject &json);
 
+#if QT_VERSION >= QT_VERSION_CHECK(5, 12, 0) || defined(W_DOXYGEN)
+    /*!
+     * \brief Writes the content of the %Quota as CBOR map to \a writer.
+     *
+     * The map uses small integer keys instead of the property names, so the encoding is
+     * much more compact and faster to process than the JSON representation.
+     * If isNull() returns \c true, an empty map will be written.
+     *
+     * Available since Qt 5.12.
+     *
+     * \sa fromCbor()
+     */
+    void toCbor(QCborStreamWriter &writer) const;
+
+    /*!
+     * \brief Returns the content of the %Quota encoded as CBOR.
+     *
+     * \overload
+     */
+    QByteArray toCbor() const;
+
+    /*!
+     * \brief Reads a %Quota from the CBOR map at the current position of \a reader.
+     *
+     * The \a reader will be advanced to the element following the map. Unknown keys
+     * are skipped. If the map is empty or can not be read, a \link isNull() null\endlink
+     * %Quota will be returned.
+     *
+     * Available since Qt 5.12.
+     *
+     * \sa toCbor()
+     */
+    static Quota fromCbor(QCborStreamReader &reader);
+
+    /*!
+     * \brief Creates a %Quota object from the \a cbor encoded data.
+     *
+     * \overload
+     */
+    static Quota fromCbor(const QByteArray &cbor);
+#endif
+
 private:
     QSharedDataPointer<QuotaPrivate> d;
 
@@ -0,0 +1,461 @@
+/*
+ * SPDX-FileCopyrightText: (C) 2021 Matthias Fehring / www.huessenbergnetz.de
+ * SPDX-License-Identifier: LGPL-3.0-or-later
+ */
+
+#include "quotamonitor_p.h"
+#include "getuserjob.h"
+#include "logging.h"
+#include <QNetworkAccessManager>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QSet>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+using namespace Wolkanlin;
+
+QuotaMonitorPrivate::QuotaMonitorPrivate(QuotaMonitor *q)
+    : q_ptr(q)
+{
+    clock.start();
+    timer.setSingleShot(true);
+    QObject::connect(&timer, &QTimer::timeout, q, [this](){
+        dispatch();
+    });
+}
+
+QuotaMonitorPrivate::~QuotaMonitorPrivate() = default;
+
+void QuotaMonitorPrivate::schedule(const QString &id, qint64 due)
+{
+    unschedule(id);
+    UserState &state = states[id];
+    state.queueKey = QueueKey(due, sequence++);
+    queue.insert(state.queueKey, id);
+}
+
+void QuotaMonitorPrivate::unschedule(const QString &id)
+{
+    auto it = states.find(id);
+    if (it != states.end() && it->queueKey.first >= 0) {
+        queue.remove(it->queueKey);
+        it->queueKey = QueueKey(-1, 0);
+    }
+}
+
+void QuotaMonitorPrivate::scheduleTimer()
+{
+    if (!isRunning || queue.empty() || runningJobs.size() >= maxConcurrentRequests) {
+        timer.stop();
+        return;
+    }
+
+    qint64 next = queue.firstKey().first;
+    if (lastDispatch >= 0) {
+        next = qMax(next, lastDispatch + spacing());
+    }
+
+    const qint64 delay = qMax<qint64>(next - clock.elapsed(), 0);
+    timer.start(static_cast<int>(qMin<qint64>(delay, std::numeric_limits<int>::max())));
+}
+
+void QuotaMonitorPrivate::dispatch()
+{
+    if (!isRunning) {
+        return;
+    }
+
+    const qint64 now = clock.elapsed();
+
+    // only one request per tick, the timer spaces the requests according to the budget
+    if (!queue.empty() && runningJobs.size() < maxConcurrentRequests && queue.firstKey().first <= now && (lastDispatch < 0 || now - lastDispatch >= spacing())) {
+        const QString id = queue.first();
+        unschedule(id);
+        lastDispatch = now;
+        startRequest(id);
+    }
+
+    scheduleTimer();
+}
+
+void QuotaMonitorPrivate::startRequest(const QString &id)
+{
+    Q_Q(QuotaMonitor);
+
+    auto job = new GetUserJob(id, q);
+    if (configuration) {
+        job->setConfiguration(configuration);
+    }
+    if (nam) {
+        job->setNetworkAccessManager(nam);
+    }
+
+    QObject::connect(job, &GetUserJob::succeeded, q, [this, id, job](const QJsonDocument &json){
+        onUserReceived(id, job, json);
+    });
+    QObject::connect(job, &GetUserJob::failed, q, [this, id, job](int errorCode, const QString &errorString){
+        onUserFailed(id, job, errorCode, errorString);
+    });
+
+    runningJobs.insert(id, job);
+    job->start();
+}
+
+void QuotaMonitorPrivate::onUserReceived(const QString &id, GetUserJob *job, const QJsonDocument &json)
+{
+    if (runningJobs.value(id) != job) {
+        return;
+    }
+    runningJobs.remove(id);
+
+    // only the quota is needed, so the rest of the user data is not decoded
+    QJsonObject data = json.object();
+    if (data.contains(QStringLiteral("ocs"))) {
+        data = data.value(QStringLiteral("ocs")).toObject().value(QStringLiteral("data")).toObject();
+    }
+    const Quota quota = Quota::fromJson(data.value(QStringLiteral("quota")).toObject());
+
+    if (Q_UNLIKELY(quota.isNull())) {
+        onUserFailed(id, nullptr, EmptyJson, QString());
+        return;
+    }
+
+    update(id, quota);
+    scheduleTimer();
+}
+
+void QuotaMonitorPrivate::onUserFailed(const QString &id, GetUserJob *job, int errorCode, const QString &errorString)
+{
+    if (job) {
+        if (runningJobs.value(id) != job) {
+            return;
+        }
+        runningJobs.remove(id);
+    }
+
+    Q_Q(QuotaMonitor);
+
+    UserState &state = states[id];
+    state.failures++;
+    state.interval = qMin<qint64>(static_cast<qint64>(minInterval) << qMin(state.failures - 1, 10), maxInterval);
+
+    qCWarning(wlCore) << "Failed to request quota for user" << id << ":" << errorString << "- retrying in" << state.interval << "ms";
+
+    schedule(id, clock.elapsed() + state.interval);
+
+    Q_EMIT q->requestFailed(id, errorCode, errorString);
+
+    scheduleTimer();
+}
+
+void QuotaMonitorPrivate::update(const QString &id, const Quota &quota)
+{
+    Q_Q(QuotaMonitor);
+
+    const qint64 now = clock.elapsed();
+    UserState &state = states[id];
+
+    const double previousRelative = state.quota.isNull() ? 0.0 : state.quota.relative();
+
+    if (!state.quota.isNull() && state.lastUpdate >= 0 && now > state.lastUpdate) {
+        const double currentRate = static_cast<double>(quota.used() - state.quota.used()) / static_cast<double>(now - state.lastUpdate);
+        state.rate = state.hasRate ? (0.5 * currentRate + 0.5 * state.rate) : currentRate;
+        state.hasRate = true;
+    }
+
+    state.quota = quota;
+    state.lastUpdate = now;
+    state.failures = 0;
+    state.interval = computeInterval(state);
+
+    qCDebug(wlCore) << "Received quota for user" << id << "with" << quota.relative() << "% usage, next request in" << state.interval << "ms";
+
+    schedule(id, now + state.interval);
+
+    Q_EMIT q->quotaUpdated(id, quota);
+
+    const double currentRelative = quota.relative();
+    for (double threshold : thresholds) {
+        if (previousRelative < threshold && currentRelative >= threshold) {
+            Q_EMIT q->thresholdCrossed(id, threshold, true, quota);
+        } else if (previousRelative >= threshold && currentRelative < threshold) {
+            Q_EMIT q->thresholdCrossed(id, threshold, false, quota);
+        }
+    }
+}
+
+qint64 QuotaMonitorPrivate::computeInterval(const UserState &state) const
+{
+    if (state.quota.isNull()) {
+        return maxInterval;
+    }
+
+    const double r = qBound(0.0, state.quota.relative() / 100.0, 1.0);
+    double interval = static_cast<double>(maxInterval) * (1.0 - r) * (1.0 - r);
+
+    const double total = static_cast<double>(state.quota.total());
+    if (state.hasRate && state.rate != 0.0 && total > 0.0) {
+        // do not let the usage change by more than one percent between two requests
+        interval = qMin(interval, 0.01 * total / std::abs(state.rate));
+
+        if (state.rate > 0.0) {
+            // request at least four times until the storage is estimated to be full
+            const double headroom = qMax(total - static_cast<double>(state.quota.used()), 0.0);
+            interval = qMin(interval, headroom / state.rate / 4.0);
+        }
+    }
+
+    return static_cast<qint64>(qBound(static_cast<double>(minInterval), interval, static_cast<double>(maxInterval)));
+}
+
+qint64 QuotaMonitorPrivate::spacing() const
+{
+    return 60000 / requestsPerMinute;
+}
+
+void QuotaMonitorPrivate::killAll()
+{
+    if (!runningJobs.empty()) {
+        qCDebug(wlCore) << "Canceling" << runningJobs.size() << "running quota requests";
+        const QList<GetUserJob*> jobs = runningJobs.values();
+        for (GetUserJob *job : jobs) {
+            job->kill(WJob::Quietly);
+        }
+        runningJobs.clear();
+    }
+}
+
+QuotaMonitor::QuotaMonitor(QObject *parent)
+    : QObject(parent), wl_ptr(new QuotaMonitorPrivate(this))
+{
+
+}
+
+QuotaMonitor::~QuotaMonitor()
+{
+    Q_D(QuotaMonitor);
+    d->isRunning = false;
+    d->timer.stop();
+    d->killAll();
+}
+
+AbstractConfiguration *QuotaMonitor::configuration() const
+{
+    Q_D(const QuotaMonitor);
+    return d->configuration;
+}
+
+void QuotaMonitor::setConfiguration(AbstractConfiguration *configuration)
+{
+    Q_D(QuotaMonitor);
+    if (d->configuration != configuration) {
+        qCDebug(wlCore) << "Changing configuration from" << d->configuration << "to" << configuration;
+        d->configuration = configuration;
+        Q_EMIT configurationChanged(d->configuration);
+    }
+}
+
+QStringList QuotaMonitor::ids() const
+{
+    Q_D(const QuotaMonitor);
+    return d->ids;
+}
+
+void QuotaMonitor::setIds(const QStringList &ids)
+{
+    Q_D(QuotaMonitor);
+    if (d->ids == ids) {
+        return;
+    }
+
+    qCDebug(wlCore) << "Changing ids to" << ids.size() << "user ids";
+
+    QSet<QString> newIds;
+    newIds.reserve(ids.size());
+    for (const QString &id : ids) {
+        if (!id.isEmpty()) {
+            newIds.insert(id);
+        }
+    }
+
+    const QStringList oldIds = d->states.keys();
+    for (const QString &id : oldIds) {
+        if (!newIds.contains(id)) {
+            d->unschedule(id);
+            GetUserJob *job = d->runningJobs.take(id);
+            if (job) {
+                job->kill(WJob::Quietly);
+            }
+            d->states.remove(id);
+        }
+    }
+
+    // new users are requested first, in the order of the list
+    const qint64 now = d->clock.elapsed();
+    for (const QString &id : ids) {
+        if (!id.isEmpty() && !d->states.contains(id)) {
+            d->schedule(id, now);
+        }
+    }
+
+    d->ids = ids;
+    Q_EMIT idsChanged(d->ids);
+
+    d->scheduleTimer();
+}
+
+int QuotaMonitor::requestsPerMinute() const
+{
+    Q_D(const QuotaMonitor);
+    return d->requestsPerMinute;
+}
+
+void QuotaMonitor::setRequestsPerMinute(int requestsPerMinute)
+{
+    Q_D(QuotaMonitor);
+    requestsPerMinute = qMax(requestsPerMinute, 1);
+    if (d->requestsPerMinute != requestsPerMinute) {
+        qCDebug(wlCore) << "Changing requestsPerMinute from" << d->requestsPerMinute << "to" << requestsPerMinute;
+        d->requestsPerMinute = requestsPerMinute;
+        Q_EMIT requestsPerMinuteChanged(d->requestsPerMinute);
+        d->scheduleTimer();
+    }
+}
+
+int QuotaMonitor::minInterval() const
+{
+    Q_D(const QuotaMonitor);
+    return d->minInterval;
+}
+
+void QuotaMonitor::setMinInterval(int minInterval)
+{
+    Q_D(QuotaMonitor);
+    minInterval = qMax(minInterval, 1);
+    if (d->minInterval != minInterval) {
+        qCDebug(wlCore) << "Changing minInterval from" << d->minInterval << "to" << minInterval;
+        d->minInterval = minInterval;
+        Q_EMIT minIntervalChanged(d->minInterval);
+        if (d->maxInterval < minInterval) {
+            setMaxInterval(minInterval);
+        }
+    }
+}
+
+int QuotaMonitor::maxInterval() const
+{
+    Q_D(const QuotaMonitor);
+    return d->maxInterval;
+}
+
+void QuotaMonitor::setMaxInterval(int maxInterval)
+{
+    Q_D(QuotaMonitor);
+    maxInterval = qMax(maxInterval, d->minInterval);
+    if (d->maxInterval != maxInterval) {
+        qCDebug(wlCore) << "Changing maxInterval from" << d->maxInterval << "to" << maxInterval;
+        d->maxInterval = maxInterval;
+        Q_EMIT maxIntervalChanged(d->maxInterval);
+    }
+}
+
+bool QuotaMonitor::isRunning() const
+{
+    Q_D(const QuotaMonitor);
+    return d->isRunning;
+}
+
+QList<double> QuotaMonitor::thresholds() const
+{
+    Q_D(const QuotaMonitor);
+    return d->thresholds;
+}
+
+void QuotaMonitor::setThresholds(const QList<double> &thresholds)
+{
+    Q_D(QuotaMonitor);
+    QList<double> sorted = thresholds;
+    std::sort(sorted.begin(), sorted.end());
+    sorted.erase(std::unique(sorted.begin(), sorted.end()), sorted.end());
+    qCDebug(wlCore) << "Changing thresholds from" << d->thresholds << "to" << sorted;
+    d->thresholds = sorted;
+}
+
+QNetworkAccessManager *QuotaMonitor::networkAccessManager() const
+{
+    Q_D(const QuotaMonitor);
+    return d->nam;
+}
+
+void QuotaMonitor::setNetworkAccessManager(QNetworkAccessManager *nam)
+{
+    Q_D(QuotaMonitor);
+    d->nam = nam;
+}
+
+Quota QuotaMonitor::quota(const QString &id) const
+{
+    Q_D(const QuotaMonitor);
+    return d->states.value(id).quota;
+}
+
+qint64 QuotaMonitor::interval(const QString &id) const
+{
+    Q_D(const QuotaMonitor);
+    return d->states.value(id).interval;
+}
+
+void QuotaMonitor::start()
+{
+    Q_D(QuotaMonitor);
+    if (d->isRunning) {
+        return;
+    }
+
+    qCDebug(wlCore) << "Starting quota monitor for" << d->states.size() << "users with up to" << d->requestsPerMinute << "requests per minute";
+
+    d->isRunning = true;
+    Q_EMIT isRunningChanged(true);
+
+    d->scheduleTimer();
+}
+
+void QuotaMonitor::stop()
+{
+    Q_D(QuotaMonitor);
+    if (!d->isRunning) {
+        return;
+    }
+
+    qCDebug(wlCore) << "Stopping quota monitor";
+
+    d->isRunning = false;
+    d->timer.stop();
+
+    // aborted requests are repeated as soon as the monitor is started again
+    const QStringList running = d->runningJobs.keys();
+    d->killAll();
+    const qint64 now = d->clock.elapsed();
+    for (const QString &id : running) {
+        d->schedule(id, now);
+    }
+
+    Q_EMIT isRunningChanged(false);
+}
+
+void QuotaMonitor::refresh(const QString &id)
+{
+    Q_D(QuotaMonitor);
+    if (!d->states.contains(id) || d->runningJobs.contains(id)) {
+        return;
+    }
+
+    qCDebug(wlCore) << "Refreshing quota of user" << id;
+
+    d->schedule(id, d->clock.elapsed());
+    d->scheduleTimer();
+}
+
+#include "moc_quotamonitor.cpp"
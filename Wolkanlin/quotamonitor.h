@@ -0,0 +1,356 @@
+/*
+ * SPDX-FileCopyrightText: (C) 2021 Matthias Fehring / www.huessenbergnetz.de
+ * SPDX-License-Identifier: LGPL-3.0-or-later
+ */
+
+#ifndef WOLKANLIN_QUOTAMONITOR_H
+#define WOLKANLIN_QUOTAMONITOR_H
+
+#include "wolkanlin_export.h"
+#include "quota.h"
+#include <QObject>
+#include <QStringList>
+#include <QList>
+#include <memory>
+
+class QNetworkAccessManager;
+
+namespace Wolkanlin {
+
+class AbstractConfiguration;
+class QuotaMonitorPrivate;
+
+/*!
+ * \brief Refreshes the quota of many users in the background with adaptive intervals.
+ *
+ * Refreshing the quota of every user on a fixed schedule spends most requests on users that
+ * are far away from their limit and whose usage does not change. %QuotaMonitor requests the
+ * data of every monitored user via GetUserJob and computes an individual interval for the
+ * next request of every user after each response:
+ *
+ * \li The interval shrinks quadratically with the \link Quota::relative relative\endlink usage,
+ *     from \link QuotaMonitor::maxInterval maxInterval\endlink for an empty storage down to
+ *     \link QuotaMonitor::minInterval minInterval\endlink for a full one.
+ * \li The rate of change of the used space is tracked as moving average. The interval will not
+ *     be longer than the time in which the usage changes by one percent of the total space and
+ *     not longer than a quarter of the estimated time until the storage is full.
+ * \li Failed requests are retried with an exponentially growing interval, starting at
+ *     \link QuotaMonitor::minInterval minInterval\endlink.
+ *
+ * All requests share a global budget of \link QuotaMonitor::requestsPerMinute requestsPerMinute\endlink.
+ * The requests are evenly spaced and the users whose next request is due first are requested first.
+ * If the budget is not sufficient, the requests of all users are delayed, but users near their limit
+ * still get requested more often, because their intervals are shorter.
+ *
+ * quotaUpdated() is emitted after every successful request. If the relative usage of a user crosses
+ * one of the \link QuotaMonitor::thresholds() thresholds\endlink, thresholdCrossed() is emitted.
+ *
+ * \code{.cpp}
+ * auto monitor = new QuotaMonitor(this);
+ * monitor->setIds(userIds);
+ * monitor->setThresholds({90.0, 100.0});
+ * connect(monitor, &QuotaMonitor::thresholdCrossed, this, [](const QString &id, double threshold, bool exceeded) {
+ *     if (exceeded) {
+ *         qWarning() << id << "uses more than" << threshold << "percent of the available storage";
+ *     }
+ * });
+ * monitor->start();
+ * \endcode
+ *
+ * \headerfile "" <Wolkanlin/QuotaMonitor>
+ */
+class WOLKANLIN_EXPORT QuotaMonitor : public QObject
+{
+    Q_OBJECT
+    /*!
+     * \brief Pointer to an object providing configuration data.
+     *
+     * The configuration will be set on all requests. If it is a \c nullptr, the global
+     * default configuration will be used. See Job::configuration.
+     *
+     * \par Access methods
+     * \li AbstractConfiguration *configuration() const
+     * \li void setConfiguration(AbstractConfiguration *configuration)
+     *
+     * \par Notifier signal
+     * \li void configurationChanged(Wolkanlin::AbstractConfiguration *configuration)
+     */
+    Q_PROPERTY(Wolkanlin::AbstractConfiguration *configuration READ configuration WRITE setConfiguration NOTIFY configurationChanged)
+    /*!
+     * \brief List of IDs of the monitored users.
+     *
+     * Added users will be requested as soon as possible, the data of removed users is dropped.
+     * Duplicate IDs are monitored only once.
+     *
+     * \par Access methods
+     * \li QStringList ids() const
+     * \li void setIds(const QStringList &ids)
+     *
+     * \par Notifier signal
+     * \li void idsChanged(const QStringList &ids)
+     */
+    Q_PROPERTY(QStringList ids READ ids WRITE setIds NOTIFY idsChanged)
+    /*!
+     * \brief Maximum number of requests per minute for all users together.
+     *
+     * Values lower than \c 1 will be set to \c 1. Default value: \c 60
+     *
+     * \par Access methods
+     * \li int requestsPerMinute() const
+     * \li void setRequestsPerMinute(int requestsPerMinute)
+     *
+     * \par Notifier signal
+     * \li void requestsPerMinuteChanged(int requestsPerMinute)
+     */
+    Q_PROPERTY(int requestsPerMinute READ requestsPerMinute WRITE setRequestsPerMinute NOTIFY requestsPerMinuteChanged)
+    /*!
+     * \brief Shortest interval in milliseconds between two requests for the same user.
+     *
+     * Values lower than \c 1 will be set to \c 1. Default value: \c 60000 (1 minute)
+     *
+     * \par Access methods
+     * \li int minInterval() const
+     * \li void setMinInterval(int minInterval)
+     *
+     * \par Notifier signal
+     * \li void minIntervalChanged(int minInterval)
+     */
+    Q_PROPERTY(int minInterval READ minInterval WRITE setMinInterval NOTIFY minIntervalChanged)
+    /*!
+     * \brief Longest interval in milliseconds between two requests for the same user.
+     *
+     * Values lower than \link QuotaMonitor::minInterval minInterval\endlink will be set to
+     * minInterval. Default value: \c 86400000 (24 hours)
+     *
+     * \par Access methods
+     * \li int maxInterval() const
+     * \li void setMaxInterval(int maxInterval)
+     *
+     * \par Notifier signal
+     * \li void maxIntervalChanged(int maxInterval)
+     */
+    Q_PROPERTY(int maxInterval READ maxInterval WRITE setMaxInterval NOTIFY maxIntervalChanged)
+    /*!
+     * \brief Returns \c true while the monitor is running.
+     *
+     * \par Access methods
+     * \li bool isRunning() const
+     *
+     * \par Notifier signal
+     * \li void isRunningChanged(bool isRunning)
+     */
+    Q_PROPERTY(bool isRunning READ isRunning NOTIFY isRunningChanged)
+public:
+    /*!
+     * \brief Constructs a new %QuotaMonitor object with the given \a parent.
+     */
+    explicit QuotaMonitor(QObject *parent = nullptr);
+
+    /*!
+     * \brief Stops the monitor and destroys the %QuotaMonitor object.
+     */
+    ~QuotaMonitor() override;
+
+    /*!
+     * \brief Getter function for the \link QuotaMonitor::configuration configuration\endlink property.
+     * \sa setConfiguration(), configurationChanged()
+     */
+    AbstractConfiguration *configuration() const;
+
+    /*!
+     * \brief Setter function for the \link QuotaMonitor::configuration configuration\endlink property.
+     * \sa configuration(), configurationChanged()
+     */
+    void setConfiguration(AbstractConfiguration *configuration);
+
+    /*!
+     * \brief Getter function for the \link QuotaMonitor::ids ids\endlink property.
+     * \sa setIds(), idsChanged()
+     */
+    QStringList ids() const;
+
+    /*!
+     * \brief Setter function for the \link QuotaMonitor::ids ids\endlink property.
+     * \sa ids(), idsChanged()
+     */
+    void setIds(const QStringList &ids);
+
+    /*!
+     * \brief Getter function for the \link QuotaMonitor::requestsPerMinute requestsPerMinute\endlink property.
+     * \sa setRequestsPerMinute(), requestsPerMinuteChanged()
+     */
+    int requestsPerMinute() const;
+
+    /*!
+     * \brief Setter function for the \link QuotaMonitor::requestsPerMinute requestsPerMinute\endlink property.
+     * \sa requestsPerMinute(), requestsPerMinuteChanged()
+     */
+    void setRequestsPerMinute(int requestsPerMinute);
+
+    /*!
+     * \brief Getter function for the \link QuotaMonitor::minInterval minInterval\endlink property.
+     * \sa setMinInterval(), minIntervalChanged()
+     */
+    int minInterval() const;
+
+    /*!
+     * \brief Setter function for the \link QuotaMonitor::minInterval minInterval\endlink property.
+     * \sa minInterval(), minIntervalChanged()
+     */
+    void setMinInterval(int minInterval);
+
+    /*!
+     * \brief Getter function for the \link QuotaMonitor::maxInterval maxInterval\endlink property.
+     * \sa setMaxInterval(), maxIntervalChanged()
+     */
+    int maxInterval() const;
+
+    /*!
+     * \brief Setter function for the \link QuotaMonitor::maxInterval maxInterval\endlink property.
+     * \sa maxInterval(), maxIntervalChanged()
+     */
+    void setMaxInterval(int maxInterval);
+
+    /*!
+     * \brief Getter function for the \link QuotaMonitor::isRunning isRunning\endlink property.
+     * \sa start(), stop(), isRunningChanged()
+     */
+    bool isRunning() const;
+
+    /*!
+     * \brief Returns the thresholds of the relative usage in percent.
+     *
+     * Default value: \c 80.0, \c 90.0 and \c 100.0
+     *
+     * \sa setThresholds(), thresholdCrossed()
+     */
+    QList<double> thresholds() const;
+
+    /*!
+     * \brief Sets the \a thresholds of the relative usage in percent.
+     *
+     * thresholdCrossed() will be emitted if the \link Quota::relative relative\endlink usage
+     * of a user reaches or falls below one of these values.
+     *
+     * \sa thresholds(), thresholdCrossed()
+     */
+    void setThresholds(const QList<double> &thresholds);
+
+    /*!
+     * \brief Returns the network access manager used for all requests.
+     * \sa setNetworkAccessManager()
+     */
+    QNetworkAccessManager *networkAccessManager() const;
+
+    /*!
+     * \brief Sets the network access manager \a nam used for all requests.
+     *
+     * If no network access manager is set, the requests use the default of Job. The monitor
+     * does not take ownership of \a nam.
+     *
+     * \sa networkAccessManager()
+     */
+    void setNetworkAccessManager(QNetworkAccessManager *nam);
+
+    /*!
+     * \brief Returns the last received quota of the user with \a id.
+     *
+     * Returns a \link Quota::isNull() null\endlink %Quota if the user is not monitored or
+     * has not been requested successfully yet.
+     */
+    Quota quota(const QString &id) const;
+
+    /*!
+     * \brief Returns the current interval in milliseconds for the user with \a id.
+     *
+     * Returns \c 0 if the user is not monitored or has not been requested yet.
+     */
+    qint64 interval(const QString &id) const;
+
+    /*!
+     * \brief Starts the monitor.
+     *
+     * Users that have not been requested yet will be requested first.
+     */
+    Q_INVOKABLE void start();
+
+    /*!
+     * \brief Stops the monitor and aborts all running requests.
+     *
+     * The collected data is kept, calling start() again continues the monitoring.
+     */
+    Q_INVOKABLE void stop();
+
+    /*!
+     * \brief Requests the data of the user with \a id as soon as the request budget allows it.
+     *
+     * Does nothing if the user is not monitored or a request for the user is currently running.
+     */
+    Q_INVOKABLE void refresh(const QString &id);
+
+Q_SIGNALS:
+    /*!
+     * \brief Notifier signal for the \link QuotaMonitor::configuration configuration\endlink property.
+     * \sa setConfiguration(), configuration()
+     */
+    void configurationChanged(Wolkanlin::AbstractConfiguration *configuration);
+
+    /*!
+     * \brief Notifier signal for the \link QuotaMonitor::ids ids\endlink property.
+     * \sa setIds(), ids()
+     */
+    void idsChanged(const QStringList &ids);
+
+    /*!
+     * \brief Notifier signal for the \link QuotaMonitor::requestsPerMinute requestsPerMinute\endlink property.
+     * \sa setRequestsPerMinute(), requestsPerMinute()
+     */
+    void requestsPerMinuteChanged(int requestsPerMinute);
+
+    /*!
+     * \brief Notifier signal for the \link QuotaMonitor::minInterval minInterval\endlink property.
+     * \sa setMinInterval(), minInterval()
+     */
+    void minIntervalChanged(int minInterval);
+
+    /*!
+     * \brief Notifier signal for the \link QuotaMonitor::maxInterval maxInterval\endlink property.
+     * \sa setMaxInterval(), maxInterval()
+     */
+    void maxIntervalChanged(int maxInterval);
+
+    /*!
+     * \brief Notifier signal for the \link QuotaMonitor::isRunning isRunning\endlink property.
+     * \sa isRunning()
+     */
+    void isRunningChanged(bool isRunning);
+
+    /*!
+     * \brief Emitted after the \a quota of the user with \a id has been received.
+     */
+    void quotaUpdated(const QString &id, const Wolkanlin::Quota &quota);
+
+    /*!
+     * \brief Emitted if the relative usage of the user with \a id has crossed the \a threshold.
+     *
+     * \a exceeded is \c true if the usage has reached or exceeded the threshold and \c false if it
+     * has fallen below it. The first received quota of a user is compared against \c 0, so users
+     * that are already above a threshold are reported once after they have been requested the first time.
+     */
+    void thresholdCrossed(const QString &id, double threshold, bool exceeded, const Wolkanlin::Quota &quota);
+
+    /*!
+     * \brief Emitted if requesting the data of the user with \a id has been failed.
+     */
+    void requestFailed(const QString &id, int errorCode, const QString &errorString);
+
+private:
+    const std::unique_ptr<QuotaMonitorPrivate> wl_ptr;
+
+    Q_DECLARE_PRIVATE_D(wl_ptr, QuotaMonitor)
+    Q_DISABLE_COPY(QuotaMonitor)
+};
+
+}
+
+#endif // WOLKANLIN_QUOTAMONITOR_H
@@ -0,0 +1,76 @@
+/*
+ * SPDX-FileCopyrightText: (C) 2021 Matthias Fehring / www.huessenbergnetz.de
+ * SPDX-License-Identifier: LGPL-3.0-or-later
+ */
+
+#ifndef WOLKANLIN_QUOTAMONITOR_P_H
+#define WOLKANLIN_QUOTAMONITOR_P_H
+
+#include "quotamonitor.h"
+#include <QHash>
+#include <QMap>
+#include <QPair>
+#include <QElapsedTimer>
+#include <QTimer>
+
+namespace Wolkanlin {
+
+class GetUserJob;
+
+class QuotaMonitorPrivate
+{
+public:
+    // due time and insertion sequence, so that users with the same due time are requested in FIFO order
+    typedef QPair<qint64, quint64> QueueKey;
+
+    struct UserState {
+        Quota quota;
+        QueueKey queueKey = QueueKey(-1, 0);
+        qint64 lastUpdate = -1;
+        qint64 interval = 0;
+        double rate = 0.0;
+        int failures = 0;
+        bool hasRate = false;
+    };
+
+    explicit QuotaMonitorPrivate(QuotaMonitor *q);
+    ~QuotaMonitorPrivate();
+
+    void schedule(const QString &id, qint64 due);
+    void unschedule(const QString &id);
+    void scheduleTimer();
+    void dispatch();
+    void startRequest(const QString &id);
+    void onUserReceived(const QString &id, GetUserJob *job, const QJsonDocument &json);
+    void onUserFailed(const QString &id, GetUserJob *job, int errorCode, const QString &errorString);
+    void update(const QString &id, const Quota &quota);
+    qint64 computeInterval(const UserState &state) const;
+    qint64 spacing() const;
+    void killAll();
+
+    QHash<QString, UserState> states;
+    QMap<QueueKey, QString> queue;
+    QHash<QString, GetUserJob*> runningJobs;
+    QStringList ids;
+    QList<double> thresholds = {80.0, 90.0, 100.0};
+    QElapsedTimer clock;
+    QTimer timer;
+    QNetworkAccessManager *nam = nullptr;
+    AbstractConfiguration *configuration = nullptr;
+    QuotaMonitor *q_ptr = nullptr;
+    qint64 lastDispatch = -1;
+    quint64 sequence = 0;
+    int requestsPerMinute = 60;
+    int minInterval = 60000;
+    int maxInterval = 86400000;
+    int maxConcurrentRequests = 4;
+    bool isRunning = false;
+
+private:
+    Q_DECLARE_PUBLIC(QuotaMonitor)
+    Q_DISABLE_COPY(QuotaMonitorPrivate)
+};
+
+}
+
+#endif // WOLKANLIN_QUOTAMONITOR_P_H
@@ -0,0 +1,302 @@
+/*
+ * SPDX-FileCopyrightText: (C) 2021 Matthias Fehring / www.huessenbergnetz.de
+ * SPDX-License-Identifier: LGPL-3.0-or-later
+ */
+
+#include "quotatable.h"
+#include "quota.h"
+#include "userdata.h"
+#include "logging.h"
+#include <algorithm>
+#include <numeric>
+#include <cmath>
+
+using namespace Wolkanlin;
+
+namespace Wolkanlin {
+
+class QuotaTablePrivate
+{
+public:
+    const QVector<qint64> &column(QuotaTable::Column c) const
+    {
+        switch (c) {
+        case QuotaTable::FreeColumn:
+            return free;
+        case QuotaTable::UsedColumn:
+            return used;
+        case QuotaTable::QuotaColumn:
+            return quota;
+        case QuotaTable::TotalColumn:
+            return total;
+        }
+        return used;
+    }
+
+    // the kernels work on plain arrays without branches in the loop bodies, so that they can be vectorised
+
+    static qint64 sum(const qint64 *data, int size)
+    {
+        qint64 s = 0;
+        for (int i = 0; i < size; ++i) {
+            s += data[i];
+        }
+        return s;
+    }
+
+    static qint64 sumPositive(const qint64 *data, int size)
+    {
+        qint64 s = 0;
+        for (int i = 0; i < size; ++i) {
+            s += data[i] > 0 ? data[i] : 0;
+        }
+        return s;
+    }
+
+    static double sum(const double *data, int size)
+    {
+        // floating point addition is not associative, independent accumulators allow the compiler to vectorise anyway
+        double s0 = 0.0;
+        double s1 = 0.0;
+        double s2 = 0.0;
+        double s3 = 0.0;
+        int i = 0;
+        for (; i + 4 <= size; i += 4) {
+            s0 += data[i];
+            s1 += data[i + 1];
+            s2 += data[i + 2];
+            s3 += data[i + 3];
+        }
+        for (; i < size; ++i) {
+            s0 += data[i];
+        }
+        return (s0 + s1) + (s2 + s3);
+    }
+
+    template<typename T>
+    static T percentile(QVector<T> values, double percentile)
+    {
+        if (values.empty()) {
+            return T(0);
+        }
+        const double p = qBound(0.0, percentile, 100.0);
+        const int rank = static_cast<int>(std::ceil(p / 100.0 * static_cast<double>(values.size()))) - 1;
+        const auto nth = values.begin() + qBound(0, rank, values.size() - 1);
+        std::nth_element(values.begin(), nth, values.end());
+        return *nth;
+    }
+
+    template<typename T>
+    static QVector<int> top(const T *values, QVector<int> rows, int count)
+    {
+        const int n = qMin(count, rows.size());
+        if (n <= 0) {
+            return QVector<int>();
+        }
+        std::partial_sort(rows.begin(), rows.begin() + n, rows.end(), [values](int a, int b) {
+            return values[a] > values[b] || (values[a] == values[b] && a < b);
+        });
+        rows.resize(n);
+        return rows;
+    }
+
+    QStringList ids;
+    QVector<qint64> free;
+    QVector<qint64> used;
+    QVector<qint64> quota;
+    QVector<qint64> total;
+    QVector<double> relative;
+};
+
+}
+
+QuotaTable::QuotaTable() : wl_ptr(new QuotaTablePrivate)
+{
+
+}
+
+QuotaTable::~QuotaTable() = default;
+
+void QuotaTable::reserve(int size)
+{
+    Q_D(QuotaTable);
+    d->ids.reserve(size);
+    d->free.reserve(size);
+    d->used.reserve(size);
+    d->quota.reserve(size);
+    d->total.reserve(size);
+    d->relative.reserve(size);
+}
+
+int QuotaTable::append(const QString &id, const Quota &quota)
+{
+    if (quota.isNull()) {
+        return -1;
+    }
+
+    Q_D(QuotaTable);
+    d->ids.append(id);
+    d->free.append(quota.free());
+    d->used.append(quota.used());
+    d->quota.append(quota.quota());
+    d->total.append(quota.total());
+    d->relative.append(quota.relative());
+    return d->ids.size() - 1;
+}
+
+int QuotaTable::append(const UserData &user)
+{
+    return append(user.id(), user.quota());
+}
+
+void QuotaTable::append(const QVector<UserData> &users)
+{
+    reserve(size() + users.size());
+    for (const UserData &user : users) {
+        append(user.id(), user.quota());
+    }
+}
+
+void QuotaTable::clear()
+{
+    Q_D(QuotaTable);
+    qCDebug(wlCore) << "Clearing quota table with" << d->ids.size() << "rows";
+    d->ids.clear();
+    d->free.clear();
+    d->used.clear();
+    d->quota.clear();
+    d->total.clear();
+    d->relative.clear();
+}
+
+int QuotaTable::size() const
+{
+    Q_D(const QuotaTable);
+    return d->ids.size();
+}
+
+bool QuotaTable::isEmpty() const
+{
+    Q_D(const QuotaTable);
+    return d->ids.empty();
+}
+
+QString QuotaTable::id(int row) const
+{
+    Q_D(const QuotaTable);
+    return (row >= 0 && row < d->ids.size()) ? d->ids.at(row) : QString();
+}
+
+QStringList QuotaTable::ids() const
+{
+    Q_D(const QuotaTable);
+    return d->ids;
+}
+
+Quota QuotaTable::quota(int row) const
+{
+    Q_D(const QuotaTable);
+    if (row < 0 || row >= d->ids.size()) {
+        return Quota();
+    }
+    return Quota(d->free.at(row), d->used.at(row), d->quota.at(row), d->total.at(row), d->relative.at(row));
+}
+
+QVector<qint64> QuotaTable::column(Column column) const
+{
+    Q_D(const QuotaTable);
+    return d->column(column);
+}
+
+QVector<double> QuotaTable::relativeColumn() const
+{
+    Q_D(const QuotaTable);
+    return d->relative;
+}
+
+qint64 QuotaTable::sum(Column column) const
+{
+    Q_D(const QuotaTable);
+    const QVector<qint64> &values = d->column(column);
+    if (column == QuotaColumn) {
+        return QuotaTablePrivate::sumPositive(values.constData(), values.size());
+    }
+    return QuotaTablePrivate::sum(values.constData(), values.size());
+}
+
+double QuotaTable::average(Column column) const
+{
+    const int cnt = size();
+    return cnt > 0 ? static_cast<double>(sum(column)) / static_cast<double>(cnt) : 0.0;
+}
+
+double QuotaTable::averageRelative() const
+{
+    Q_D(const QuotaTable);
+    const int cnt = d->relative.size();
+    return cnt > 0 ? QuotaTablePrivate::sum(d->relative.constData(), cnt) / static_cast<double>(cnt) : 0.0;
+}
+
+qint64 QuotaTable::percentile(Column column, double percentile) const
+{
+    Q_D(const QuotaTable);
+    return QuotaTablePrivate::percentile(d->column(column), percentile);
+}
+
+double QuotaTable::relativePercentile(double percentile) const
+{
+    Q_D(const QuotaTable);
+    return QuotaTablePrivate::percentile(d->relative, percentile);
+}
+
+QVector<int> QuotaTable::relativeHistogram(int bins) const
+{
+    if (bins < 1) {
+        return QVector<int>();
+    }
+
+    Q_D(const QuotaTable);
+    QVector<int> histogram(bins, 0);
+    const int cnt = d->relative.size();
+    const double *relative = d->relative.constData();
+    const double scale = static_cast<double>(bins) / 100.0;
+    int *h = histogram.data();
+    for (int i = 0; i < cnt; ++i) {
+        const int bin = static_cast<int>(relative[i] * scale);
+        h[qBound(0, bin, bins - 1)]++;
+    }
+    return histogram;
+}
+
+QVector<int> QuotaTable::topByUsage(int count, Column column) const
+{
+    Q_D(const QuotaTable);
+    const QVector<qint64> &values = d->column(column);
+    QVector<int> rows(values.size());
+    std::iota(rows.begin(), rows.end(), 0);
+    return QuotaTablePrivate::top(values.constData(), rows, count);
+}
+
+QVector<int> QuotaTable::topByQuotaUsage(int count) const
+{
+    Q_D(const QuotaTable);
+    const int cnt = d->used.size();
+    const qint64 *used = d->used.constData();
+    const qint64 *quota = d->quota.constData();
+
+    QVector<double> ratios(cnt);
+    double *r = ratios.data();
+    for (int i = 0; i < cnt; ++i) {
+        r[i] = quota[i] > 0 ? static_cast<double>(used[i]) / static_cast<double>(quota[i]) : -1.0;
+    }
+
+    QVector<int> rows;
+    rows.reserve(cnt);
+    for (int i = 0; i < cnt; ++i) {
+        if (quota[i] > 0) {
+            rows.append(i);
+        }
+    }
+
+    return QuotaTablePrivate::top(ratios.constData(), rows, count);
+}
@@ -0,0 +1,215 @@
+/*
+ * SPDX-FileCopyrightText: (C) 2021 Matthias Fehring / www.huessenbergnetz.de
+ * SPDX-License-Identifier: LGPL-3.0-or-later
+ */
+
+#ifndef WOLKANLIN_QUOTATABLE_H
+#define WOLKANLIN_QUOTATABLE_H
+
+#include "wolkanlin_export.h"
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <memory>
+
+namespace Wolkanlin {
+
+class QuotaTablePrivate;
+class Quota;
+class UserData;
+
+/*!
+ * \brief Column based storage of the quota values of many users for fleet wide analysis.
+ *
+ * Analysing the storage usage of many users by iterating over User or UserData objects
+ * touches a separate allocation for every single value. %QuotaTable stores the values of
+ * the Quota of every user in contiguous arrays, one array per value (structure of arrays).
+ * The aggregation functions only read the arrays they need in a linear pass, so the compiler
+ * can vectorise the loops and aggregating over 100,000 users takes only a few milliseconds.
+ *
+ * Every appended user gets a row. The row numbers are stable until clear() is called and
+ * are returned by the top-N functions like topByUsage().
+ *
+ * \code{.cpp}
+ * QuotaTable table;
+ * table.append(directory->users());
+ * const qint64 used = table.sum(QuotaTable::UsedColumn);
+ * const qint64 p95 = table.percentile(QuotaTable::UsedColumn, 95.0);
+ * for (int row : table.topByQuotaUsage(10)) {
+ *     qDebug() << table.id(row) << table.quota(row).relative();
+ * }
+ * \endcode
+ *
+ * \headerfile "" <Wolkanlin/QuotaTable>
+ */
+class WOLKANLIN_EXPORT QuotaTable
+{
+public:
+    /*!
+     * \brief This enum describes the integer columns of the table.
+     */
+    enum Column : quint8 {
+        FreeColumn  = 0,    /**< the \link Quota::free free\endlink space in bytes */
+        UsedColumn  = 1,    /**< the \link Quota::used used\endlink space in bytes */
+        QuotaColumn = 2,    /**< the set \link Quota::quota quota\endlink in bytes, below \c 0 if unlimited */
+        TotalColumn = 3     /**< the \link Quota::total total\endlink space in bytes */
+    };
+
+    /*!
+     * \brief Constructs a new empty %QuotaTable.
+     */
+    QuotaTable();
+
+    /*!
+     * \brief Destroys the %QuotaTable.
+     */
+    ~QuotaTable();
+
+    /*!
+     * \brief Reserves memory for at least \a size rows.
+     */
+    void reserve(int size);
+
+    /*!
+     * \brief Appends a row for the user identified by \a id with the values of \a quota.
+     *
+     * Returns the row number of the new row. If \a quota is \link Quota::isNull() null\endlink,
+     * no row is appended and \c -1 is returned.
+     */
+    int append(const QString &id, const Quota &quota);
+
+    /*!
+     * \brief Appends a row for \a user.
+     *
+     * Returns the row number of the new row or \c -1 if the user does not contain quota data.
+     */
+    int append(const UserData &user);
+
+    /*!
+     * \brief Appends rows for all \a users that contain quota data.
+     */
+    void append(const QVector<UserData> &users);
+
+    /*!
+     * \brief Removes all rows.
+     */
+    void clear();
+
+    /*!
+     * \brief Returns the number of rows.
+     */
+    int size() const;
+
+    /*!
+     * \brief Returns \c true if the table does not contain any row.
+     */
+    bool isEmpty() const;
+
+    /*!
+     * \brief Returns the ID of the user in \a row.
+     *
+     * Returns an empty string if \a row is out of range.
+     */
+    QString id(int row) const;
+
+    /*!
+     * \brief Returns the IDs of all users in row order.
+     */
+    QStringList ids() const;
+
+    /*!
+     * \brief Returns the quota of the user in \a row.
+     *
+     * Returns a \link Quota::isNull() null\endlink %Quota if \a row is out of range.
+     */
+    Quota quota(int row) const;
+
+    /*!
+     * \brief Returns all values of \a column in row order.
+     *
+     * The data is implicitly shared with the table, so this is a cheap operation.
+     */
+    QVector<qint64> column(Column column) const;
+
+    /*!
+     * \brief Returns all \link Quota::relative relative\endlink values in row order.
+     *
+     * The data is implicitly shared with the table, so this is a cheap operation.
+     */
+    QVector<double> relativeColumn() const;
+
+    /*!
+     * \brief Returns the sum of all values in \a column.
+     *
+     * For the QuotaColumn only limited quotas are summed up, unlimited quotas
+     * that are below \c 0 count as \c 0.
+     */
+    qint64 sum(Column column) const;
+
+    /*!
+     * \brief Returns the arithmetic mean of all values in \a column.
+     *
+     * Returns \c 0.0 if the table is empty. Unlimited quotas are handled like in sum().
+     */
+    double average(Column column) const;
+
+    /*!
+     * \brief Returns the arithmetic mean of all \link Quota::relative relative\endlink values.
+     *
+     * Returns \c 0.0 if the table is empty.
+     */
+    double averageRelative() const;
+
+    /*!
+     * \brief Returns the \a percentile of the values in \a column.
+     *
+     * \a percentile has to be between \c 0.0 and \c 100.0, the nearest rank is used. \c 0.0
+     * returns the smallest value, \c 100.0 the largest value. Returns \c 0 if the table is empty.
+     * The values are selected in linear time without sorting the complete column.
+     */
+    qint64 percentile(Column column, double percentile) const;
+
+    /*!
+     * \brief Returns the \a percentile of the \link Quota::relative relative\endlink values.
+     *
+     * See percentile() for details.
+     */
+    double relativePercentile(double percentile) const;
+
+    /*!
+     * \brief Returns a histogram of the \link Quota::relative relative\endlink values.
+     *
+     * The range from \c 0 to \c 100 percent is divided into \a bins equally sized bins. The
+     * returned list contains the number of users in every bin, a value of exactly \c 100 percent
+     * is counted in the last bin. Returns an empty list if \a bins is lower than \c 1.
+     */
+    QVector<int> relativeHistogram(int bins = 10) const;
+
+    /*!
+     * \brief Returns the rows of the \a count users with the highest values in \a column.
+     *
+     * The rows are sorted by the value in descending order, rows with equal values are
+     * sorted by their row number.
+     */
+    QVector<int> topByUsage(int count, Column column = UsedColumn) const;
+
+    /*!
+     * \brief Returns the rows of the \a count users with the highest ratio of used space to their quota.
+     *
+     * Only users with a limited quota greater than \c 0 are taken into account. Different from
+     * the \link Quota::relative relative\endlink value that is based on the total available space,
+     * the ratio can be greater than \c 1 if the used space exceeds the quota. The rows are sorted
+     * by the ratio in descending order.
+     */
+    QVector<int> topByQuotaUsage(int count) const;
+
+private:
+    const std::unique_ptr<QuotaTablePrivate> wl_ptr;
+
+    Q_DECLARE_PRIVATE_D(wl_ptr, QuotaTable)
+    Q_DISABLE_COPY(QuotaTable)
+};
+
+}
+
+#endif // WOLKANLIN_QUOTATABLE_H
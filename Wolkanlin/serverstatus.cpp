@@ -6,6 +6,7 @@
 #include "serverstatus_p.h"
 #include "logging.h"
 #include "getserverstatusjob.h"
+#include "cbor_p.h"
 #include <QDebug>
 #include <QDataStream>
 #include <QJsonDocument>
@@ -128,6 +129,95 @@ ServerStatus *ServerStatus::fromJson(const QJsonObject &json, QObject *parent)
     return status;
 }
 
+#if QT_VERSION >= QT_VERSION_CHECK(5, 12, 0)
+void ServerStatus::toCbor(QCborStreamWriter &writer) const
+{
+    writer.startMap();
+    if (Q_LIKELY(!isEmpty())) {
+        Q_D(const ServerStatus);
+        Cbor::writeBool(writer, Cbor::ServerStatusInstalled, d->installed);
+        Cbor::writeBool(writer, Cbor::ServerStatusMaintenance, d->maintenance);
+        Cbor::writeBool(writer, Cbor::ServerStatusNeedsDbUpgrade, d->needsDbUpgrade);
+        Cbor::writeString(writer, Cbor::ServerStatusVersion, d->version);
+        Cbor::writeString(writer, Cbor::ServerStatusVersionstring, d->versionstring);
+        Cbor::writeString(writer, Cbor::ServerStatusEdition, d->edition);
+        Cbor::writeString(writer, Cbor::ServerStatusProductname, d->productname);
+        Cbor::writeBool(writer, Cbor::ServerStatusExtendedSupport, d->extendedSupport);
+    }
+    writer.endMap();
+}
+
+QByteArray ServerStatus::toCbor() const
+{
+    QByteArray cbor;
+    QCborStreamWriter writer(&cbor);
+    toCbor(writer);
+    return cbor;
+}
+
+ServerStatus *ServerStatus::fromCbor(QCborStreamReader &reader, QObject *parent)
+{
+    if (Q_UNLIKELY(!reader.isMap() || !reader.enterContainer())) {
+        qCWarning(wlCore) << "CBOR data does not contain a map, creating empty Wolkanlin::ServerStatus object.";
+        if (reader.lastError() == QCborError::NoError) {
+            reader.next();
+        }
+        return new ServerStatus(parent);
+    }
+
+    auto status = new ServerStatus(parent);
+    auto d = status->d_func();
+
+    while (reader.lastError() == QCborError::NoError && reader.hasNext()) {
+        switch (Cbor::readKey(reader)) {
+        case Cbor::ServerStatusInstalled:
+            d->installed = Cbor::readBool(reader);
+            break;
+        case Cbor::ServerStatusMaintenance:
+            d->maintenance = Cbor::readBool(reader);
+            break;
+        case Cbor::ServerStatusNeedsDbUpgrade:
+            d->needsDbUpgrade = Cbor::readBool(reader);
+            break;
+        case Cbor::ServerStatusVersion:
+            d->version = Cbor::readString(reader);
+            break;
+        case Cbor::ServerStatusVersionstring:
+            d->versionstring = Cbor::readString(reader);
+            break;
+        case Cbor::ServerStatusEdition:
+            d->edition = Cbor::readString(reader);
+            break;
+        case Cbor::ServerStatusProductname:
+            d->productname = Cbor::readString(reader);
+            break;
+        case Cbor::ServerStatusExtendedSupport:
+            d->extendedSupport = Cbor::readBool(reader);
+            break;
+        default:
+            reader.next();
+            break;
+        }
+    }
+
+    if (Q_UNLIKELY(reader.lastError() != QCborError::NoError)) {
+        qCWarning(wlCore) << "Failed to read CBOR data, creating empty Wolkanlin::ServerStatus object:" << reader.lastError().toString();
+        delete status;
+        return new ServerStatus(parent);
+    }
+
+    reader.leaveContainer();
+
+    return status;
+}
+
+ServerStatus *ServerStatus::fromCbor(const QByteArray &cbor, QObject *parent)
+{
+    QCborStreamReader reader(cbor);
+    return ServerStatus::fromCbor(reader, parent);
+}
+#endif
+
 bool ServerStatus::get(bool async, AbstractConfiguration *config)
 {
     Q_D(ServerStatus);
@@ -160,80 +250,64 @@ bool ServerStatus::get(bool async, AbstractConfiguration *config)
 void ServerStatusPrivate::setInstalled(bool _installed)
 {
     if (installed != _installed) {
-        qCDebug(wlCore) << "Changing installed from" << installed << "to" << _installed;
         installed = _installed;
-        Q_Q(ServerStatus);
-        Q_EMIT q->installedChanged(installed);
+        changedFields |= ServerStatus::InstalledField;
     }
 }
 
 void ServerStatusPrivate::setMaintenance(bool _maintenance)
 {
     if (maintenance != _maintenance) {
-        qCDebug(wlCore) << "Changing maintenance from" << maintenance << "to" << _maintenance;
         maintenance = _maintenance;
-        Q_Q(ServerStatus);
-        Q_EMIT q->maintenanceChanged(maintenance);
+        changedFields |= ServerStatus::MaintenanceField;
     }
 }
 
 void ServerStatusPrivate::setNeedsDbUpgrade(bool _needsDbUpgrade)
 {
     if (needsDbUpgrade != _needsDbUpgrade) {
-        qCDebug(wlCore) << "Changing needsDbUpgrade from" << needsDbUpgrade << "to" << _needsDbUpgrade;
         needsDbUpgrade = _needsDbUpgrade;
-        Q_Q(ServerStatus);
-        Q_EMIT q->needsDbUpgradeChanged(needsDbUpgrade);
+        changedFields |= ServerStatus::NeedsDbUpgradeField;
     }
 }
 
 void ServerStatusPrivate::setVersion(const QString &_version)
 {
     if (version != _version) {
-        qCDebug(wlCore) << "Changing version from" << version << "to" << _version;
         version = _version;
-        Q_Q(ServerStatus);
-        Q_EMIT q->versionChanged(version);
+        changedFields |= ServerStatus::VersionField;
     }
 }
 
 void ServerStatusPrivate::setVersionstring(const QString &_versionstring)
 {
     if (versionstring != _versionstring) {
-        qCDebug(wlCore) << "Changing versionstring from" << versionstring << "to" << _versionstring;
         versionstring = _versionstring;
-        Q_Q(ServerStatus);
-        Q_EMIT q->versionstringChanged(versionstring);
+        changedFields |= ServerStatus::VersionstringField;
     }
 }
 
 void ServerStatusPrivate::setEdition(const QString &_edition)
 {
     if (edition != _edition) {
-        qCDebug(wlCore) << "Changing edition from" << edition << "to" << _edition;
         edition = _edition;
-        Q_Q(ServerStatus);
-        Q_EMIT q->editionChanged(edition);
+        changedFields |= ServerStatus::EditionField;
     }
 }
 
 void ServerStatusPrivate::setProductname(const QString &_productname)
 {
     if (productname != _productname) {
-        qCDebug(wlCore) << "Changing productname from" << productname << "to" << _productname;
         productname = _productname;
-        Q_Q(ServerStatus);
-        Q_EMIT q->productnameChanged(productname);
+        changedFields |= ServerStatus::ProductnameField;
     }
 }
 
 void ServerStatusPrivate::setExtendedSupport(bool _extendedSupport)
 {
     if (extendedSupport != _extendedSupport) {
-        qCDebug(wlCore) << "Changing extendedSupport from" << extendedSupport << "to" << _extendedSupport;
         extendedSupport = _extendedSupport;
-        Q_Q(ServerStatus);
-        Q_EMIT q->extendedSupportChanged(extendedSupport);
+        changedFields |= ServerStatus::ExtendedSupportField;
     }
 }
 
@@ -247,9 +321,50 @@ void ServerStatusPrivate::setIsLoading(bool _isLoading)
     }
 }
 
-void ServerStatusPrivate::onGetServerStatusSucceeded(const QJsonDocument &json)
+void ServerStatusPrivate::emitChanges()
 {
-    const QJsonObject status = json.object();
+    const ServerStatus::Fields fields = changedFields;
+    changedFields = ServerStatus::NoField;
+
+    if (fields == ServerStatus::NoField) {
+        return;
+    }
+
+    qCDebug(wlCore) << "Changed server status fields:" << fields;
+
+    Q_Q(ServerStatus);
+
+    Q_EMIT q->changed(fields);
+
+    if (fields.testFlag(ServerStatus::InstalledField)) {
+        Q_EMIT q->installedChanged(installed);
+    }
+    if (fields.testFlag(ServerStatus::MaintenanceField)) {
+        Q_EMIT q->maintenanceChanged(maintenance);
+    }
+    if (fields.testFlag(ServerStatus::NeedsDbUpgradeField)) {
+        Q_EMIT q->needsDbUpgradeChanged(needsDbUpgrade);
+    }
+    if (fields.testFlag(ServerStatus::VersionField)) {
+        Q_EMIT q->versionChanged(version);
+    }
+    if (fields.testFlag(ServerStatus::VersionstringField)) {
+        Q_EMIT q->versionstringChanged(versionstring);
+    }
+    if (fields.testFlag(ServerStatus::EditionField)) {
+        Q_EMIT q->editionChanged(edition);
+    }
+    if (fields.testFlag(ServerStatus::ProductnameField)) {
+        Q_EMIT q->productnameChanged(productname);
+    }
+    if (fields.testFlag(ServerStatus::ExtendedSupportField)) {
+        Q_EMIT q->extendedSupportChanged(extendedSupport);
+    }
+}
+
+ServerStatus::Fields ServerStatusPrivate::update(const QJsonObject &status)
+{
+    // the setters only collect the changed fields, the signals are emitted afterwards
 
     setInstalled(status.value(QStringLiteral("installed")).toBool());
     setMaintenance(status.value(QStringLiteral("maintenance")).toBool());
@@ -258,7 +373,16 @@ void ServerStatusPrivate::onGetServerStatusSucceeded(const QJsonDocument &json)
     setVersionstring(status.value(QStringLiteral("versionstring")).toString());
     setEdition(status.value(QStringLiteral("edition")).toString());
     setProductname(status.value(QStringLiteral("productname")).toString());
-    setExtendedSupport(status.value(QStringLiteral("needsDbUpgrade")).toBool());
+    setExtendedSupport(status.value(QStringLiteral("extendedSupport")).toBool());
+
+    const ServerStatus::Fields fields = changedFields;
+    emitChanges();
+    return fields;
+}
+
+void ServerStatusPrivate::onGetServerStatusSucceeded(const QJsonDocument &json)
+{
+    update(json.object());
 
     Q_Q(ServerStatus);
     Q_EMIT q->finished();
@@ -10,6 +10,11 @@
 #include <QObject>
 #include <memory>
 
+#if QT_VERSION >= QT_VERSION_CHECK(5, 12, 0)
+class QCborStreamWriter;
+class QCborStreamReader;
+#endif
+
 namespace Wolkanlin {
 
 class AbstractConfiguration;
@@ -145,6 +150,28 @@ class WOLKANLIN_EXPORT ServerStatus : public QObject
      */
     Q_PROPERTY(bool isLoading READ isLoading NOTIFY isLoadingChanged)
 public:
+    /*!
+     * \brief This enum describes the data fields of the server status.
+     *
+     * They are used in the Fields flags to describe which fields have been changed.
+     *
+     * \sa changed()
+     */
+    enum Field : quint32 {
+        NoField                 = 0x0000,   /**< no field */
+        InstalledField          = 0x0001,   /**< the \link ServerStatus::installed installed\endlink field */
+        MaintenanceField        = 0x0002,   /**< the \link ServerStatus::maintenance maintenance\endlink field */
+        NeedsDbUpgradeField     = 0x0004,   /**< the \link ServerStatus::needsDbUpgrade needsDbUpgrade\endlink field */
+        VersionField            = 0x0008,   /**< the \link ServerStatus::version version\endlink field */
+        VersionstringField      = 0x0010,   /**< the \link ServerStatus::versionstring versionstring\endlink field */
+        EditionField            = 0x0020,   /**< the \link ServerStatus::edition edition\endlink field */
+        ProductnameField        = 0x0040,   /**< the \link ServerStatus::productname productname\endlink field */
+        ExtendedSupportField    = 0x0080,   /**< the \link ServerStatus::extendedSupport extendedSupport\endlink field */
+        AllFields               = 0x00FF    /**< all fields */
+    };
+    Q_DECLARE_FLAGS(Fields, Field)
+    Q_FLAG(Fields)
+
     /*!
      * \brief Constructs a new empty %ServerStatus object with the given \a parent.
      *
@@ -235,6 +262,47 @@ public:
      */
     static ServerStatus *fromJson(const QJsonObject &json, QObject *parent = nullptr);
 
+#if QT_VERSION >= QT_VERSION_CHECK(5, 12, 0) || defined(W_DOXYGEN)
+    /*!
+     * \brief Writes the %ServerStatus object as CBOR map to \a writer.
+     *
+     * The map uses small integer keys instead of the property names and omits empty values,
+     * so the encoding is much smaller and faster to process than the JSON representation.
+     * If isEmpty() returns \c true, an empty map will be written.
+     *
+     * Available since Qt 5.12.
+     *
+     * \sa fromCbor()
+     */
+    void toCbor(QCborStreamWriter &writer) const;
+
+    /*!
+     * \brief Returns the %ServerStatus object encoded as CBOR.
+     *
+     * \overload
+     */
+    QByteArray toCbor() const;
+
+    /*!
+     * \brief Creates a new %ServerStatus object with the given \a parent from the CBOR map at the current position of \a reader.
+     *
+     * The \a reader will be advanced to the element following the map. Unknown keys are skipped.
+     * If the map can not be read, a pointer to an empty %ServerStatus object will be returned.
+     *
+     * Available since Qt 5.12.
+     *
+     * \sa toCbor()
+     */
+    static ServerStatus *fromCbor(QCborStreamReader &reader, QObject *parent = nullptr);
+
+    /*!
+     * \brief Creates a new %ServerStatus object with the given \a parent from the \a cbor encoded data.
+     *
+     * \overload
+     */
+    static ServerStatus *fromCbor(const QByteArray &cbor, QObject *parent = nullptr);
+#endif
+
     /*!
      * \brief Get data from the Nextcloud server configured in \a config.
      *
@@ -301,6 +369,17 @@ Q_SIGNALS:
      */
     void isLoadingChanged(bool isLoading);
 
+    /*!
+     * \brief Emitted once after one or more properties have been changed together.
+     *
+     * \a fields contains all changed fields. This signal is emitted after all values have
+     * been updated and before the notifier signals of the single properties, that are
+     * emitted once per changed property afterwards.
+     *
+     * \sa get()
+     */
+    void changed(Wolkanlin::ServerStatus::Fields fields);
+
     /*!
      * \brief Emitted when getting server status data succeeded.
      *
@@ -323,6 +402,8 @@ private:
     const std::unique_ptr<ServerStatusPrivate> wl_ptr;
 
     friend QDataStream &operator>>(QDataStream &stream, ServerStatus &serverStatus);
+    friend class SnapshotReader;
+    friend class ServerStatusWatcherPrivate;
 
     Q_DECLARE_PRIVATE_D(wl_ptr, ServerStatus)
     Q_DISABLE_COPY(ServerStatus)
@@ -348,4 +429,6 @@ WOLKANLIN_EXPORT QDebug operator<<(QDebug dbg, const Wolkanlin::ServerStatus &se
  */
 WOLKANLIN_EXPORT QDataStream &operator<<(QDataStream &stream, const Wolkanlin::ServerStatus &serverStatus);
 
+Q_DECLARE_OPERATORS_FOR_FLAGS(Wolkanlin::ServerStatus::Fields)
+
 #endif // WOLKANLIN_SERVERSTATUS_H
@@ -22,10 +22,13 @@ public:
     void setProductname(const QString &_productname);
     void setExtendedSupport(bool _extendedSupport);
     void setIsLoading(bool _isLoading);
+    void emitChanges();
+    ServerStatus::Fields update(const QJsonObject &status);
 
     void onGetServerStatusSucceeded(const QJsonDocument &json);
 
     ServerStatus *q_ptr = nullptr;
+    ServerStatus::Fields changedFields;
     QString version;
     QString versionstring;
     QString edition;
@@ -0,0 +1,284 @@
+/*
+ * SPDX-FileCopyrightText: (C) 2021 Matthias Fehring / www.huessenbergnetz.de
+ * SPDX-License-Identifier: LGPL-3.0-or-later
+ */
+
+#include "serverstatuswatcher_p.h"
+#include "serverstatus_p.h"
+#include "getserverstatusjob.h"
+#include "global.h"
+#include "logging.h"
+#include <QNetworkAccessManager>
+#include <QJsonDocument>
+#include <QJsonObject>
+
+using namespace Wolkanlin;
+
+ServerStatusWatcherPrivate::ServerStatusWatcherPrivate(ServerStatusWatcher *q)
+    : status(new ServerStatus(q)), q_ptr(q)
+{
+    timer.setSingleShot(true);
+    QObject::connect(&timer, &QTimer::timeout, q, [this](){
+        startRequest();
+    });
+}
+
+ServerStatusWatcherPrivate::~ServerStatusWatcherPrivate() = default;
+
+void ServerStatusWatcherPrivate::startRequest()
+{
+    if (!isRunning || job) {
+        return;
+    }
+
+    Q_Q(ServerStatusWatcher);
+
+    timer.stop();
+
+    // the entity tag only applies to the configuration data it has been received with
+    const AbstractConfiguration *config = configuration ? configuration : Wolkanlin::defaultConfiguration();
+    requestGeneration = config ? config->generation() : 0;
+    if (requestGeneration != entityTagGeneration) {
+        entityTag.clear();
+    }
+
+    job = new GetServerStatusJob(q);
+    if (configuration) {
+        job->setConfiguration(configuration);
+    }
+    if (nam) {
+        job->setNetworkAccessManager(nam);
+    }
+    job->setEntityTag(entityTag);
+
+    GetServerStatusJob *j = job;
+    QObject::connect(j, &GetServerStatusJob::succeeded, q, [this, j](const QJsonDocument &json){
+        onStatusReceived(j, json);
+    });
+    QObject::connect(j, &GetServerStatusJob::failed, q, [this, j](int errorCode, const QString &errorString){
+        onStatusFailed(j, errorCode, errorString);
+    });
+
+    j->start();
+}
+
+void ServerStatusWatcherPrivate::onStatusReceived(GetServerStatusJob *finishedJob, const QJsonDocument &json)
+{
+    if (job != finishedJob) {
+        return;
+    }
+    job = nullptr;
+
+    bool transition = !reachable;
+    setReachable(true);
+
+    if (!finishedJob->isNotModified()) {
+        entityTag = finishedJob->entityTag();
+        entityTagGeneration = requestGeneration;
+        const ServerStatus::Fields fields = status->wl_ptr->update(json.object());
+        transition = transition || fields != ServerStatus::NoField;
+    }
+
+    scheduleNext(transition);
+}
+
+void ServerStatusWatcherPrivate::onStatusFailed(GetServerStatusJob *finishedJob, int errorCode, const QString &errorString)
+{
+    if (job != finishedJob) {
+        return;
+    }
+    job = nullptr;
+
+    const bool transition = reachable;
+    setReachable(false, errorCode, errorString);
+
+    // the status might be different when the server is reachable again
+    entityTag.clear();
+
+    scheduleNext(transition);
+}
+
+void ServerStatusWatcherPrivate::scheduleNext(bool transition)
+{
+    if (transition) {
+        interval = minInterval;
+    } else {
+        interval = static_cast<int>(qMin(static_cast<qint64>(interval) * 2, static_cast<qint64>(maxInterval)));
+    }
+
+    qCDebug(wlCore) << "Requesting next server status in" << interval << "ms";
+
+    if (isRunning) {
+        timer.start(interval);
+    }
+}
+
+void ServerStatusWatcherPrivate::setReachable(bool _reachable, int errorCode, const QString &errorString)
+{
+    if (reachable != _reachable) {
+        qCDebug(wlCore) << "Changing reachable from" << reachable << "to" << _reachable;
+        reachable = _reachable;
+        Q_Q(ServerStatusWatcher);
+        Q_EMIT q->reachableChanged(reachable);
+        if (!reachable) {
+            qCWarning(wlCore) << "Server is not reachable:" << errorString;
+            Q_EMIT q->failed(errorCode, errorString);
+        }
+    }
+}
+
+void ServerStatusWatcherPrivate::killJob()
+{
+    if (job) {
+        GetServerStatusJob *j = job;
+        job = nullptr;
+        j->kill(WJob::Quietly);
+    }
+}
+
+ServerStatusWatcher::ServerStatusWatcher(QObject *parent)
+    : QObject(parent), wl_ptr(new ServerStatusWatcherPrivate(this))
+{
+
+}
+
+ServerStatusWatcher::~ServerStatusWatcher()
+{
+    Q_D(ServerStatusWatcher);
+    d->isRunning = false;
+    d->timer.stop();
+    d->killJob();
+}
+
+AbstractConfiguration *ServerStatusWatcher::configuration() const
+{
+    Q_D(const ServerStatusWatcher);
+    return d->configuration;
+}
+
+void ServerStatusWatcher::setConfiguration(AbstractConfiguration *configuration)
+{
+    Q_D(ServerStatusWatcher);
+    if (d->configuration != configuration) {
+        qCDebug(wlCore) << "Changing configuration from" << d->configuration << "to" << configuration;
+        d->configuration = configuration;
+        d->entityTag.clear();
+        Q_EMIT configurationChanged(d->configuration);
+    }
+}
+
+int ServerStatusWatcher::minInterval() const
+{
+    Q_D(const ServerStatusWatcher);
+    return d->minInterval;
+}
+
+void ServerStatusWatcher::setMinInterval(int minInterval)
+{
+    Q_D(ServerStatusWatcher);
+    minInterval = qMax(minInterval, 1);
+    if (d->minInterval != minInterval) {
+        qCDebug(wlCore) << "Changing minInterval from" << d->minInterval << "to" << minInterval;
+        d->minInterval = minInterval;
+        Q_EMIT minIntervalChanged(d->minInterval);
+        if (d->maxInterval < minInterval) {
+            setMaxInterval(minInterval);
+        }
+        if (!d->isRunning) {
+            d->interval = minInterval;
+        }
+    }
+}
+
+int ServerStatusWatcher::maxInterval() const
+{
+    Q_D(const ServerStatusWatcher);
+    return d->maxInterval;
+}
+
+void ServerStatusWatcher::setMaxInterval(int maxInterval)
+{
+    Q_D(ServerStatusWatcher);
+    maxInterval = qMax(maxInterval, d->minInterval);
+    if (d->maxInterval != maxInterval) {
+        qCDebug(wlCore) << "Changing maxInterval from" << d->maxInterval << "to" << maxInterval;
+        d->maxInterval = maxInterval;
+        Q_EMIT maxIntervalChanged(d->maxInterval);
+    }
+}
+
+bool ServerStatusWatcher::isReachable() const
+{
+    Q_D(const ServerStatusWatcher);
+    return d->reachable;
+}
+
+bool ServerStatusWatcher::isRunning() const
+{
+    Q_D(const ServerStatusWatcher);
+    return d->isRunning;
+}
+
+ServerStatus *ServerStatusWatcher::status() const
+{
+    Q_D(const ServerStatusWatcher);
+    return d->status;
+}
+
+int ServerStatusWatcher::interval() const
+{
+    Q_D(const ServerStatusWatcher);
+    return d->interval;
+}
+
+QNetworkAccessManager *ServerStatusWatcher::networkAccessManager() const
+{
+    Q_D(const ServerStatusWatcher);
+    return d->nam;
+}
+
+void ServerStatusWatcher::setNetworkAccessManager(QNetworkAccessManager *nam)
+{
+    Q_D(ServerStatusWatcher);
+    d->nam = nam;
+}
+
+void ServerStatusWatcher::start()
+{
+    Q_D(ServerStatusWatcher);
+    if (d->isRunning) {
+        return;
+    }
+
+    qCDebug(wlCore) << "Starting server status watcher";
+
+    d->isRunning = true;
+    d->interval = d->minInterval;
+    Q_EMIT isRunningChanged(true);
+
+    d->startRequest();
+}
+
+void ServerStatusWatcher::stop()
+{
+    Q_D(ServerStatusWatcher);
+    if (!d->isRunning) {
+        return;
+    }
+
+    qCDebug(wlCore) << "Stopping server status watcher";
+
+    d->isRunning = false;
+    d->timer.stop();
+    d->killJob();
+
+    Q_EMIT isRunningChanged(false);
+}
+
+void ServerStatusWatcher::check()
+{
+    Q_D(ServerStatusWatcher);
+    d->startRequest();
+}
+
+#include "moc_serverstatuswatcher.cpp"
@@ -0,0 +1,279 @@
+/*
+ * SPDX-FileCopyrightText: (C) 2021 Matthias Fehring / www.huessenbergnetz.de
+ * SPDX-License-Identifier: LGPL-3.0-or-later
+ */
+
+#ifndef WOLKANLIN_SERVERSTATUSWATCHER_H
+#define WOLKANLIN_SERVERSTATUSWATCHER_H
+
+#include "wolkanlin_export.h"
+#include <QObject>
+#include <memory>
+
+class QNetworkAccessManager;
+
+namespace Wolkanlin {
+
+class AbstractConfiguration;
+class ServerStatus;
+class ServerStatusWatcherPrivate;
+
+/*!
+ * \brief Watches the status of a remote server with adaptive polling intervals.
+ *
+ * While ServerStatus::get() requests the status once, %ServerStatusWatcher requests it
+ * periodically and keeps the \link status() ServerStatus\endlink object up to date. As the
+ * ServerStatus only emits its notifier signals and ServerStatus::changed() if a value has
+ * actually been changed, connected objects only get notified about transitions, like the
+ * server entering or leaving the maintenance mode.
+ *
+ * The polling interval adapts to the stability of the server:
+ * \li Every request that does not reveal a change doubles the interval, up to
+ *     \link ServerStatusWatcher::maxInterval maxInterval\endlink.
+ * \li A change of the status or of the \link ServerStatusWatcher::reachable reachability\endlink
+ *     resets the interval to \link ServerStatusWatcher::minInterval minInterval\endlink, so that
+ *     the following transitions, like the end of a maintenance, are noticed early.
+ *
+ * The requests use the entity tag of the previous reply, so servers that support conditional
+ * requests do not transmit an unchanged status again. See GetServerStatusJob for details.
+ *
+ * \code{.cpp}
+ * auto watcher = new ServerStatusWatcher(this);
+ * connect(watcher->status(), &ServerStatus::maintenanceChanged, this, [](bool maintenance) {
+ *     qDebug() << "Maintenance mode" << (maintenance ? "enabled" : "disabled");
+ * });
+ * connect(watcher, &ServerStatusWatcher::reachableChanged, this, [](bool reachable) {
+ *     qDebug() << "Server is" << (reachable ? "reachable" : "not reachable");
+ * });
+ * watcher->start();
+ * \endcode
+ *
+ * \headerfile "" <Wolkanlin/ServerStatusWatcher>
+ */
+class WOLKANLIN_EXPORT ServerStatusWatcher : public QObject
+{
+    Q_OBJECT
+    /*!
+     * \brief Pointer to an object providing configuration data.
+     *
+     * If it is a \c nullptr, the global default configuration will be used. See Job::configuration.
+     *
+     * \par Access methods
+     * \li AbstractConfiguration *configuration() const
+     * \li void setConfiguration(AbstractConfiguration *configuration)
+     *
+     * \par Notifier signal
+     * \li void configurationChanged(Wolkanlin::AbstractConfiguration *configuration)
+     */
+    Q_PROPERTY(Wolkanlin::AbstractConfiguration *configuration READ configuration WRITE setConfiguration NOTIFY configurationChanged)
+    /*!
+     * \brief Interval in milliseconds used after a transition.
+     *
+     * Values lower than \c 1 will be set to \c 1. Default value: \c 5000 (5 seconds)
+     *
+     * \par Access methods
+     * \li int minInterval() const
+     * \li void setMinInterval(int minInterval)
+     *
+     * \par Notifier signal
+     * \li void minIntervalChanged(int minInterval)
+     */
+    Q_PROPERTY(int minInterval READ minInterval WRITE setMinInterval NOTIFY minIntervalChanged)
+    /*!
+     * \brief Longest interval in milliseconds used for a stable server.
+     *
+     * Values lower than \link ServerStatusWatcher::minInterval minInterval\endlink will be set to
+     * minInterval. Default value: \c 300000 (5 minutes)
+     *
+     * \par Access methods
+     * \li int maxInterval() const
+     * \li void setMaxInterval(int maxInterval)
+     *
+     * \par Notifier signal
+     * \li void maxIntervalChanged(int maxInterval)
+     */
+    Q_PROPERTY(int maxInterval READ maxInterval WRITE setMaxInterval NOTIFY maxIntervalChanged)
+    /*!
+     * \brief Returns \c true if the last request has been successful.
+     *
+     * Is \c false until the first request has been finished successfully.
+     *
+     * \par Access methods
+     * \li bool isReachable() const
+     *
+     * \par Notifier signal
+     * \li void reachableChanged(bool reachable)
+     */
+    Q_PROPERTY(bool reachable READ isReachable NOTIFY reachableChanged)
+    /*!
+     * \brief Returns \c true while the watcher is running.
+     *
+     * \par Access methods
+     * \li bool isRunning() const
+     *
+     * \par Notifier signal
+     * \li void isRunningChanged(bool isRunning)
+     */
+    Q_PROPERTY(bool isRunning READ isRunning NOTIFY isRunningChanged)
+    /*!
+     * \brief Pointer to the watched server status.
+     *
+     * The object is owned by the watcher and stays the same for the lifetime of the watcher.
+     *
+     * \par Access methods
+     * \li ServerStatus *status() const
+     */
+    Q_PROPERTY(Wolkanlin::ServerStatus *status READ status CONSTANT)
+public:
+    /*!
+     * \brief Constructs a new %ServerStatusWatcher object with the given \a parent.
+     */
+    explicit ServerStatusWatcher(QObject *parent = nullptr);
+
+    /*!
+     * \brief Stops the watcher and destroys the %ServerStatusWatcher object.
+     */
+    ~ServerStatusWatcher() override;
+
+    /*!
+     * \brief Getter function for the \link ServerStatusWatcher::configuration configuration\endlink property.
+     * \sa setConfiguration(), configurationChanged()
+     */
+    AbstractConfiguration *configuration() const;
+
+    /*!
+     * \brief Setter function for the \link ServerStatusWatcher::configuration configuration\endlink property.
+     * \sa configuration(), configurationChanged()
+     */
+    void setConfiguration(AbstractConfiguration *configuration);
+
+    /*!
+     * \brief Getter function for the \link ServerStatusWatcher::minInterval minInterval\endlink property.
+     * \sa setMinInterval(), minIntervalChanged()
+     */
+    int minInterval() const;
+
+    /*!
+     * \brief Setter function for the \link ServerStatusWatcher::minInterval minInterval\endlink property.
+     * \sa minInterval(), minIntervalChanged()
+     */
+    void setMinInterval(int minInterval);
+
+    /*!
+     * \brief Getter function for the \link ServerStatusWatcher::maxInterval maxInterval\endlink property.
+     * \sa setMaxInterval(), maxIntervalChanged()
+     */
+    int maxInterval() const;
+
+    /*!
+     * \brief Setter function for the \link ServerStatusWatcher::maxInterval maxInterval\endlink property.
+     * \sa maxInterval(), maxIntervalChanged()
+     */
+    void setMaxInterval(int maxInterval);
+
+    /*!
+     * \brief Getter function for the \link ServerStatusWatcher::reachable reachable\endlink property.
+     * \sa reachableChanged()
+     */
+    bool isReachable() const;
+
+    /*!
+     * \brief Getter function for the \link ServerStatusWatcher::isRunning isRunning\endlink property.
+     * \sa start(), stop(), isRunningChanged()
+     */
+    bool isRunning() const;
+
+    /*!
+     * \brief Getter function for the \link ServerStatusWatcher::status status\endlink property.
+     */
+    ServerStatus *status() const;
+
+    /*!
+     * \brief Returns the interval in milliseconds until the next request.
+     */
+    int interval() const;
+
+    /*!
+     * \brief Returns the network access manager used for the requests.
+     * \sa setNetworkAccessManager()
+     */
+    QNetworkAccessManager *networkAccessManager() const;
+
+    /*!
+     * \brief Sets the network access manager \a nam used for the requests.
+     *
+     * If no network access manager is set, the requests use the default of Job. The watcher
+     * does not take ownership of \a nam.
+     *
+     * \sa networkAccessManager()
+     */
+    void setNetworkAccessManager(QNetworkAccessManager *nam);
+
+    /*!
+     * \brief Starts the watcher and requests the status immediately.
+     */
+    Q_INVOKABLE void start();
+
+    /*!
+     * \brief Stops the watcher and aborts a running request.
+     */
+    Q_INVOKABLE void stop();
+
+    /*!
+     * \brief Requests the status immediately, for example after an own request has been failed.
+     *
+     * Does nothing if the watcher is not running or a request is currently running.
+     */
+    Q_INVOKABLE void check();
+
+Q_SIGNALS:
+    /*!
+     * \brief Notifier signal for the \link ServerStatusWatcher::configuration configuration\endlink property.
+     * \sa setConfiguration(), configuration()
+     */
+    void configurationChanged(Wolkanlin::AbstractConfiguration *configuration);
+
+    /*!
+     * \brief Notifier signal for the \link ServerStatusWatcher::minInterval minInterval\endlink property.
+     * \sa setMinInterval(), minInterval()
+     */
+    void minIntervalChanged(int minInterval);
+
+    /*!
+     * \brief Notifier signal for the \link ServerStatusWatcher::maxInterval maxInterval\endlink property.
+     * \sa setMaxInterval(), maxInterval()
+     */
+    void maxIntervalChanged(int maxInterval);
+
+    /*!
+     * \brief Notifier signal for the \link ServerStatusWatcher::reachable reachable\endlink property.
+     * \sa isReachable(), failed()
+     */
+    void reachableChanged(bool reachable);
+
+    /*!
+     * \brief Emitted if the server is not reachable anymore.
+     *
+     * \a errorCode and \a errorString contain the error of the first failed request. Further
+     * failed requests are not reported until the server has been reachable again.
+     *
+     * \sa reachableChanged()
+     */
+    void failed(int errorCode, const QString &errorString);
+
+    /*!
+     * \brief Notifier signal for the \link ServerStatusWatcher::isRunning isRunning\endlink property.
+     * \sa isRunning()
+     */
+    void isRunningChanged(bool isRunning);
+
+private:
+    const std::unique_ptr<ServerStatusWatcherPrivate> wl_ptr;
+
+    Q_DECLARE_PRIVATE_D(wl_ptr, ServerStatusWatcher)
+    Q_DISABLE_COPY(ServerStatusWatcher)
+};
+
+}
+
+#endif // WOLKANLIN_SERVERSTATUSWATCHER_H
@@ -0,0 +1,53 @@
+/*
+ * SPDX-FileCopyrightText: (C) 2021 Matthias Fehring / www.huessenbergnetz.de
+ * SPDX-License-Identifier: LGPL-3.0-or-later
+ */
+
+#ifndef WOLKANLIN_SERVERSTATUSWATCHER_P_H
+#define WOLKANLIN_SERVERSTATUSWATCHER_P_H
+
+#include "serverstatuswatcher.h"
+#include <QTimer>
+#include <QByteArray>
+
+namespace Wolkanlin {
+
+class GetServerStatusJob;
+
+class ServerStatusWatcherPrivate
+{
+public:
+    explicit ServerStatusWatcherPrivate(ServerStatusWatcher *q);
+    ~ServerStatusWatcherPrivate();
+
+    void startRequest();
+    void onStatusReceived(GetServerStatusJob *job, const QJsonDocument &json);
+    void onStatusFailed(GetServerStatusJob *job, int errorCode, const QString &errorString);
+    void scheduleNext(bool transition);
+    void setReachable(bool reachable, int errorCode = 0, const QString &errorString = QString());
+    void killJob();
+
+    QTimer timer;
+    QByteArray entityTag;
+    // configuration generation the entity tag and the running request belong to
+    quint64 entityTagGeneration = 0;
+    quint64 requestGeneration = 0;
+    ServerStatus *status = nullptr;
+    GetServerStatusJob *job = nullptr;
+    QNetworkAccessManager *nam = nullptr;
+    AbstractConfiguration *configuration = nullptr;
+    ServerStatusWatcher *q_ptr = nullptr;
+    int minInterval = 5000;
+    int maxInterval = 300000;
+    int interval = 5000;
+    bool reachable = false;
+    bool isRunning = false;
+
+private:
+    Q_DECLARE_PUBLIC(ServerStatusWatcher)
+    Q_DISABLE_COPY(ServerStatusWatcherPrivate)
+};
+
+}
+
+#endif // WOLKANLIN_SERVERSTATUSWATCHER_P_H
@@ -0,0 +1,143 @@
+/*
+ * SPDX-FileCopyrightText: (C) 2021 Matthias Fehring / www.huessenbergnetz.de
+ * SPDX-License-Identifier: LGPL-3.0-or-later
+ */
+
+#include "sessioncookiejar_p.h"
+#include "logging.h"
+#include <QNetworkCookie>
+#include <QDateTime>
+#include <QFile>
+#include <QSaveFile>
+#include <QFileInfo>
+#include <QDir>
+
+using namespace Wolkanlin;
+
+SessionCookieJar::SessionCookieJar(QObject *parent) : QNetworkCookieJar(parent)
+{
+
+}
+
+SessionCookieJar::~SessionCookieJar() = default;
+
+QString SessionCookieJar::fileName() const
+{
+    return m_fileName;
+}
+
+void SessionCookieJar::setFileName(const QString &fileName)
+{
+    if (m_fileName != fileName) {
+        m_fileName = fileName;
+        load();
+    }
+}
+
+bool SessionCookieJar::setCookiesFromUrl(const QList<QNetworkCookie> &cookieList, const QUrl &url)
+{
+    const QList<QNetworkCookie> before = allCookies();
+    const bool set = QNetworkCookieJar::setCookiesFromUrl(cookieList, url);
+    // the server might send the same cookies again with every reply
+    if (set && allCookies() != before) {
+        save();
+    }
+    return set;
+}
+
+bool SessionCookieJar::hasSession(const QUrl &url) const
+{
+    return !cookiesForUrl(url).empty();
+}
+
+void SessionCookieJar::expire(const QUrl &url)
+{
+    const QList<QNetworkCookie> cookies = cookiesForUrl(url);
+    if (cookies.empty()) {
+        return;
+    }
+
+    qCDebug(wlCore) << "Removing expired session cookies for" << url.host();
+    for (const QNetworkCookie &cookie : cookies) {
+        deleteCookie(cookie);
+    }
+    save();
+}
+
+void SessionCookieJar::clear()
+{
+    if (allCookies().empty()) {
+        return;
+    }
+
+    qCDebug(wlCore) << "Clearing all session cookies.";
+    setAllCookies(QList<QNetworkCookie>());
+    save();
+}
+
+void SessionCookieJar::load()
+{
+    QList<QNetworkCookie> cookies;
+
+    if (!m_fileName.isEmpty()) {
+        QFile file(m_fileName);
+        if (file.exists()) {
+            if (Q_LIKELY(file.open(QIODevice::ReadOnly))) {
+                const QDateTime now = QDateTime::currentDateTimeUtc();
+                while (!file.atEnd()) {
+                    const QByteArray line = file.readLine().trimmed();
+                    if (line.isEmpty()) {
+                        continue;
+                    }
+                    const QList<QNetworkCookie> parsed = QNetworkCookie::parseCookies(line);
+                    for (const QNetworkCookie &cookie : parsed) {
+                        if (cookie.isSessionCookie() || cookie.expirationDate() > now) {
+                            cookies.append(cookie);
+                        }
+                    }
+                }
+                qCDebug(wlCore) << "Loaded" << cookies.size() << "session cookies from" << m_fileName;
+            } else {
+                qCWarning(wlCore) << "Failed to open session file" << m_fileName << "for reading:" << file.errorString();
+            }
+        }
+    }
+
+    setAllCookies(cookies);
+}
+
+void SessionCookieJar::save() const
+{
+    if (m_fileName.isEmpty()) {
+        return;
+    }
+
+    const QList<QNetworkCookie> cookies = allCookies();
+
+    if (cookies.empty()) {
+        if (QFile::exists(m_fileName) && Q_UNLIKELY(!QFile::remove(m_fileName))) {
+            qCWarning(wlCore) << "Failed to remove session file" << m_fileName;
+        }
+        return;
+    }
+
+    QDir().mkpath(QFileInfo(m_fileName).absolutePath());
+
+    QSaveFile file(m_fileName);
+    if (Q_UNLIKELY(!file.open(QIODevice::WriteOnly))) {
+        qCWarning(wlCore) << "Failed to open session file" << m_fileName << "for writing:" << file.errorString();
+        return;
+    }
+
+    // the session cookies grant access to the account
+    file.setPermissions(QFileDevice::ReadOwner|QFileDevice::WriteOwner);
+
+    for (const QNetworkCookie &cookie : cookies) {
+        file.write(cookie.toRawForm(QNetworkCookie::Full));
+        file.write("\n");
+    }
+
+    if (Q_UNLIKELY(!file.commit())) {
+        qCWarning(wlCore) << "Failed to write session file" << m_fileName << ":" << file.errorString();
+    }
+}
@@ -0,0 +1,41 @@
+/*
+ * SPDX-FileCopyrightText: (C) 2021 Matthias Fehring / www.huessenbergnetz.de
+ * SPDX-License-Identifier: LGPL-3.0-or-later
+ */
+
+#ifndef WOLKANLIN_SESSIONCOOKIEJAR_P_H
+#define WOLKANLIN_SESSIONCOOKIEJAR_P_H
+
+#include <QNetworkCookieJar>
+#include <QString>
+
+namespace Wolkanlin {
+
+// stores the session cookies of a single configuration and optionally persists them to a file
+class SessionCookieJar : public QNetworkCookieJar
+{
+public:
+    explicit SessionCookieJar(QObject *parent = nullptr);
+    ~SessionCookieJar() override;
+
+    QString fileName() const;
+    void setFileName(const QString &fileName);
+
+    bool setCookiesFromUrl(const QList<QNetworkCookie> &cookieList, const QUrl &url) override;
+
+    bool hasSession(const QUrl &url) const;
+    void expire(const QUrl &url);
+    void clear();
+
+private:
+    void load();
+    void save() const;
+
+    QString m_fileName;
+
+    Q_DISABLE_COPY(SessionCookieJar)
+};
+
+}
+
+#endif // WOLKANLIN_SESSIONCOOKIEJAR_P_H
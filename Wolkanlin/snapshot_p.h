@@ -0,0 +1,181 @@
+/*
+ * SPDX-FileCopyrightText: (C) 2021 Matthias Fehring / www.huessenbergnetz.de
+ * SPDX-License-Identifier: LGPL-3.0-or-later
+ */
+
+#ifndef WOLKANLIN_SNAPSHOT_P_H
+#define WOLKANLIN_SNAPSHOT_P_H
+
+#include <QtGlobal>
+#include <QtEndian>
+#include <QByteArray>
+#include <cstring>
+
+/*
+ * Layout of the binary snapshot format
+ *
+ * All integers are stored in little endian byte order, all sections start at
+ * 8 byte aligned offsets.
+ *
+ * Header (HeaderSize bytes)
+ *   0  char[4]  magic "WLSN"
+ *   4  quint16  format version
+ *   6  quint16  header size
+ *   8  quint32  content type, see SnapshotReader::Content
+ *  12  quint32  flags
+ *  16  quint32  record size
+ *  20  quint32  record count
+ *  24  quint32  string count
+ *  28  quint32  list count
+ *  32  quint32  list item count
+ *  36  quint32  string data length in UTF-16 code units
+ *  40  quint64  offset of the records
+ *  48  quint64  offset of the list table, the list items follow directly after the table
+ *  56  quint64  offset of the string table, the string data follows directly after the table
+ *  64  qint64   creation time in milliseconds since the epoch
+ *  72  quint64  offset of the id index, only valid if IdIndexFlag is set
+ *  80  quint64  reserved
+ *  88  quint64  reserved
+ *
+ * Records (record count * record size bytes)
+ *   Fixed width records, see the UserRecord* and ServerStatusRecord* offsets below.
+ *   Strings are referenced by their index in the string table, string lists by
+ *   their index in the list table. Newer writers may append fields to the records,
+ *   readers have to use the record size from the header to iterate the records and
+ *   have to ignore unknown trailing bytes.
+ *
+ * List table (list count * 8 bytes)
+ *   quint32 index of the first item, quint32 number of items
+ * List items (list item count * 4 bytes)
+ *   quint32 string index
+ *
+ * String table (string count * 8 bytes)
+ *   quint32 offset into the string data in code units, quint32 length in code units
+ * String data (string data length * 2 bytes)
+ *   UTF-16LE encoded strings without terminator
+ *
+ * Id index (record count * 4 bytes, optional)
+ *   quint32 record indices of the user records sorted by the user ID, compared
+ *   by their UTF-16 code units like QString::operator<()
+ *
+ * String index 0 is always the empty string and list index 0 is always the empty list.
+ * Every distinct string and every distinct list is stored only once.
+ */
+
+namespace Wolkanlin {
+
+namespace Snapshot {
+
+static const char Magic[4] = {'W', 'L', 'S', 'N'};
+static const quint16 FormatVersion = 1;
+static const int HeaderSize = 96;
+static const int Alignment = 8;
+static const quint32 MaxRecordSize = 65536;
+
+enum HeaderOffset : int {
+    HeaderMagic             = 0,
+    HeaderVersion           = 4,
+    HeaderHeaderSize        = 6,
+    HeaderContent           = 8,
+    HeaderFlags             = 12,
+    HeaderRecordSize        = 16,
+    HeaderRecordCount       = 20,
+    HeaderStringCount       = 24,
+    HeaderListCount         = 28,
+    HeaderListItemCount     = 32,
+    HeaderStringDataLength  = 36,
+    HeaderRecordsOffset     = 40,
+    HeaderListsOffset       = 48,
+    HeaderStringsOffset     = 56,
+    HeaderCreated           = 64,
+    HeaderIndexOffset       = 72
+};
+
+enum HeaderFlag : quint32 {
+    IdIndexFlag             = 0x1
+};
+
+enum UserRecordOffset : int {
+    UserId                  = 0,
+    UserStorageLocation     = 4,
+    UserBackend             = 8,
+    UserEmail               = 12,
+    UserDisplayname         = 16,
+    UserPhone               = 20,
+    UserAddress             = 24,
+    UserWebsite             = 28,
+    UserTwitter             = 32,
+    UserLanguage            = 36,
+    UserLocale              = 40,
+    UserSubadmin            = 44,
+    UserGroups              = 48,
+    UserCapabilities        = 52,
+    UserFlags               = 56,
+    UserLastLogin           = 64,
+    UserQuotaFree           = 72,
+    UserQuotaUsed           = 80,
+    UserQuotaQuota          = 88,
+    UserQuotaTotal          = 96,
+    UserQuotaRelative       = 104,
+    UserRecordSize          = 112
+};
+
+enum UserRecordFlag : quint32 {
+    UserEnabledFlag         = 0x1,
+    UserLastLoginFlag       = 0x2,
+    UserQuotaFlag           = 0x4
+};
+
+enum ServerStatusRecordOffset : int {
+    ServerStatusVersion         = 0,
+    ServerStatusVersionstring   = 4,
+    ServerStatusEdition         = 8,
+    ServerStatusProductname     = 12,
+    ServerStatusFlags           = 16,
+    ServerStatusRecordSize      = 24
+};
+
+enum ServerStatusRecordFlag : quint32 {
+    ServerStatusInstalledFlag       = 0x1,
+    ServerStatusMaintenanceFlag     = 0x2,
+    ServerStatusNeedsDbUpgradeFlag  = 0x4,
+    ServerStatusExtendedSupportFlag = 0x8
+};
+
+inline int padding(qint64 size)
+{
+    return static_cast<int>((Alignment - (size % Alignment)) % Alignment);
+}
+
+template <typename T>
+inline T read(const uchar *data)
+{
+    return qFromLittleEndian<T>(data);
+}
+
+inline double readDouble(const uchar *data)
+{
+    const quint64 bits = qFromLittleEndian<quint64>(data);
+    double d;
+    std::memcpy(&d, &bits, sizeof(d));
+    return d;
+}
+
+template <typename T>
+inline void write(uchar *data, T value)
+{
+    qToLittleEndian<T>(value, data);
+}
+
+inline void writeDouble(uchar *data, double value)
+{
+    quint64 bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    qToLittleEndian<quint64>(bits, data);
+}
+
+}
+
+}
+
+#endif // WOLKANLIN_SNAPSHOT_P_H
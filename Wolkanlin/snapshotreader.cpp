@@ -0,0 +1,434 @@
+/*
+ * SPDX-FileCopyrightText: (C) 2021 Matthias Fehring / www.huessenbergnetz.de
+ * SPDX-License-Identifier: LGPL-3.0-or-later
+ */
+
+#include "snapshotreader.h"
+#include "snapshot_p.h"
+#include "userdata.h"
+#include "serverstatus_p.h"
+#include "logging.h"
+#include <limits>
+
+using namespace Wolkanlin;
+
+namespace Wolkanlin {
+
+class SnapshotReaderPrivate
+{
+public:
+    void validate()
+    {
+        if (size >= 4 && std::memcmp(data, Snapshot::Magic, 4) != 0) {
+            error = SnapshotReader::InvalidMagicError;
+            return;
+        }
+
+        if (size < Snapshot::HeaderSize) {
+            error = SnapshotReader::TruncatedError;
+            return;
+        }
+
+        version = Snapshot::read<quint16>(data + Snapshot::HeaderVersion);
+        if (version == 0) {
+            error = SnapshotReader::CorruptedError;
+            return;
+        }
+        if (version > Snapshot::FormatVersion) {
+            error = SnapshotReader::UnsupportedVersionError;
+            return;
+        }
+
+        const quint16 headerSize = Snapshot::read<quint16>(data + Snapshot::HeaderHeaderSize);
+        const quint32 _content = Snapshot::read<quint32>(data + Snapshot::HeaderContent);
+        const quint32 flags = Snapshot::read<quint32>(data + Snapshot::HeaderFlags);
+        recordSize = Snapshot::read<quint32>(data + Snapshot::HeaderRecordSize);
+        recordCount = Snapshot::read<quint32>(data + Snapshot::HeaderRecordCount);
+        stringCount = Snapshot::read<quint32>(data + Snapshot::HeaderStringCount);
+        listCount = Snapshot::read<quint32>(data + Snapshot::HeaderListCount);
+        listItemCount = Snapshot::read<quint32>(data + Snapshot::HeaderListItemCount);
+        stringDataLength = Snapshot::read<quint32>(data + Snapshot::HeaderStringDataLength);
+        const quint64 recordsOffset = Snapshot::read<quint64>(data + Snapshot::HeaderRecordsOffset);
+        const quint64 listsOffset = Snapshot::read<quint64>(data + Snapshot::HeaderListsOffset);
+        const quint64 stringsOffset = Snapshot::read<quint64>(data + Snapshot::HeaderStringsOffset);
+        const quint64 indexOffset = Snapshot::read<quint64>(data + Snapshot::HeaderIndexOffset);
+        created = Snapshot::read<qint64>(data + Snapshot::HeaderCreated);
+
+        if (headerSize < Snapshot::HeaderSize || recordSize > Snapshot::MaxRecordSize || recordCount > static_cast<quint32>(std::numeric_limits<int>::max())) {
+            error = SnapshotReader::CorruptedError;
+            return;
+        }
+
+        switch (_content) {
+        case SnapshotReader::UserContent:
+            if (recordSize < static_cast<quint32>(Snapshot::UserRecordSize)) {
+                error = SnapshotReader::CorruptedError;
+                return;
+            }
+            break;
+        case SnapshotReader::ServerStatusContent:
+            if (recordSize < static_cast<quint32>(Snapshot::ServerStatusRecordSize) || recordCount != 1) {
+                error = SnapshotReader::CorruptedError;
+                return;
+            }
+            break;
+        default:
+            error = SnapshotReader::CorruptedError;
+            return;
+        }
+
+        // offsets are checked against the size first, all counts are 32 bit values and the record
+        // size is limited, so none of the calculations below can overflow
+        const quint64 fileSize = static_cast<quint64>(size);
+        if (recordsOffset > fileSize || listsOffset > fileSize || stringsOffset > fileSize) {
+            error = SnapshotReader::TruncatedError;
+            return;
+        }
+        if (recordsOffset < headerSize || recordsOffset + static_cast<quint64>(recordCount) * recordSize > fileSize
+                || listsOffset + static_cast<quint64>(listCount) * 8 + static_cast<quint64>(listItemCount) * 4 > fileSize
+                || stringsOffset + static_cast<quint64>(stringCount) * 8 + static_cast<quint64>(stringDataLength) * 2 > fileSize) {
+            error = SnapshotReader::TruncatedError;
+            return;
+        }
+
+        if (flags & Snapshot::IdIndexFlag) {
+            if (_content != SnapshotReader::UserContent) {
+                error = SnapshotReader::CorruptedError;
+                return;
+            }
+            if (indexOffset > fileSize || indexOffset + static_cast<quint64>(recordCount) * 4 > fileSize) {
+                error = SnapshotReader::TruncatedError;
+                return;
+            }
+            idIndex = data + indexOffset;
+        }
+
+        records = data + recordsOffset;
+        listTable = data + listsOffset;
+        listItems = listTable + static_cast<quint64>(listCount) * 8;
+        stringTable = data + stringsOffset;
+        stringData = stringTable + static_cast<quint64>(stringCount) * 8;
+        content = static_cast<SnapshotReader::Content>(_content);
+        error = SnapshotReader::NoError;
+    }
+
+    QString string(quint32 index) const
+    {
+        if (index == 0 || index >= stringCount) {
+            return QString();
+        }
+
+        const uchar *entry = stringTable + static_cast<quint64>(index) * 8;
+        const quint32 offset = Snapshot::read<quint32>(entry);
+        const quint32 length = Snapshot::read<quint32>(entry + 4);
+        if (static_cast<quint64>(offset) + length > stringDataLength || length > static_cast<quint32>(std::numeric_limits<int>::max())) {
+            qCWarning(wlCore) << "Invalid string table entry" << index << "in snapshot";
+            return QString();
+        }
+
+        const uchar *in = stringData + static_cast<quint64>(offset) * 2;
+        QString str(static_cast<int>(length), Qt::Uninitialized);
+#if Q_BYTE_ORDER == Q_LITTLE_ENDIAN
+        std::memcpy(str.data(), in, static_cast<size_t>(length) * 2);
+#else
+        QChar *out = str.data();
+        for (quint32 i = 0; i < length; ++i) {
+            out[i] = QChar(Snapshot::read<quint16>(in + i * 2));
+        }
+#endif
+        return str;
+    }
+
+    // compares the ID of the user record at index with str like QString::compare() does
+    int compareId(quint32 index, const QString &str) const
+    {
+        const quint32 strIdx = Snapshot::read<quint32>(record(static_cast<int>(index)) + Snapshot::UserId);
+        quint32 length = 0;
+        const uchar *in = nullptr;
+        if (strIdx > 0 && strIdx < stringCount) {
+            const uchar *entry = stringTable + static_cast<quint64>(strIdx) * 8;
+            const quint32 offset = Snapshot::read<quint32>(entry);
+            length = Snapshot::read<quint32>(entry + 4);
+            if (static_cast<quint64>(offset) + length > stringDataLength) {
+                length = 0;
+            }
+            in = stringData + static_cast<quint64>(offset) * 2;
+        }
+
+        const quint32 strLength = static_cast<quint32>(str.size());
+        const quint32 len = qMin(length, strLength);
+        const ushort *s = str.utf16();
+        for (quint32 i = 0; i < len; ++i) {
+            const ushort c = Snapshot::read<quint16>(in + i * 2);
+            if (c != s[i]) {
+                return c < s[i] ? -1 : 1;
+            }
+        }
+        return length == strLength ? 0 : (length < strLength ? -1 : 1);
+    }
+
+    template <typename Strings>
+    QStringList list(quint32 index, const Strings &strings) const
+    {
+        QStringList l;
+        if (index == 0 || index >= listCount) {
+            return l;
+        }
+
+        const uchar *entry = listTable + static_cast<quint64>(index) * 8;
+        const quint32 first = Snapshot::read<quint32>(entry);
+        const quint32 count = Snapshot::read<quint32>(entry + 4);
+        if (static_cast<quint64>(first) + count > listItemCount) {
+            qCWarning(wlCore) << "Invalid list table entry" << index << "in snapshot";
+            return l;
+        }
+
+        l.reserve(static_cast<int>(count));
+        const uchar *items = listItems + static_cast<quint64>(first) * 4;
+        for (quint32 i = 0; i < count; ++i) {
+            l.append(strings(Snapshot::read<quint32>(items + i * 4)));
+        }
+        return l;
+    }
+
+    const uchar *record(int index) const
+    {
+        return records + static_cast<quint64>(index) * recordSize;
+    }
+
+    template <typename Strings, typename Lists>
+    UserData decodeUser(const uchar *r, const Strings &strings, const Lists &lists) const
+    {
+        UserData user;
+        user.setId(strings(Snapshot::read<quint32>(r + Snapshot::UserId)));
+        user.setStorageLocation(strings(Snapshot::read<quint32>(r + Snapshot::UserStorageLocation)));
+        user.setBackend(strings(Snapshot::read<quint32>(r + Snapshot::UserBackend)));
+        user.setEmail(strings(Snapshot::read<quint32>(r + Snapshot::UserEmail)));
+        user.setDisplayname(strings(Snapshot::read<quint32>(r + Snapshot::UserDisplayname)));
+        user.setPhone(strings(Snapshot::read<quint32>(r + Snapshot::UserPhone)));
+        user.setAddress(strings(Snapshot::read<quint32>(r + Snapshot::UserAddress)));
+        const QString website = strings(Snapshot::read<quint32>(r + Snapshot::UserWebsite));
+        if (!website.isEmpty()) {
+            user.setWebsite(QUrl(website));
+        }
+        user.setTwitter(strings(Snapshot::read<quint32>(r + Snapshot::UserTwitter)));
+        user.setLanguage(strings(Snapshot::read<quint32>(r + Snapshot::UserLanguage)));
+        user.setLocale(strings(Snapshot::read<quint32>(r + Snapshot::UserLocale)));
+        user.setSubadmin(lists(Snapshot::read<quint32>(r + Snapshot::UserSubadmin)));
+        user.setGroups(lists(Snapshot::read<quint32>(r + Snapshot::UserGroups)));
+        user.setBackendCapabilities(User::Capabilities(Snapshot::read<quint32>(r + Snapshot::UserCapabilities)));
+
+        const quint32 flags = Snapshot::read<quint32>(r + Snapshot::UserFlags);
+        user.setEnabled((flags & Snapshot::UserEnabledFlag) != 0);
+        if (flags & Snapshot::UserLastLoginFlag) {
+            user.setLastLogin(QDateTime::fromMSecsSinceEpoch(Snapshot::read<qint64>(r + Snapshot::UserLastLogin), Qt::UTC));
+        }
+        if (flags & Snapshot::UserQuotaFlag) {
+            user.setQuota(Quota(Snapshot::read<qint64>(r + Snapshot::UserQuotaFree),
+                                Snapshot::read<qint64>(r + Snapshot::UserQuotaUsed),
+                                Snapshot::read<qint64>(r + Snapshot::UserQuotaQuota),
+                                Snapshot::read<qint64>(r + Snapshot::UserQuotaTotal),
+                                Snapshot::readDouble(r + Snapshot::UserQuotaRelative)));
+        }
+
+        return user;
+    }
+
+    QByteArray buffer;
+    const uchar *data = nullptr;
+    const uchar *records = nullptr;
+    const uchar *idIndex = nullptr;
+    const uchar *listTable = nullptr;
+    const uchar *listItems = nullptr;
+    const uchar *stringTable = nullptr;
+    const uchar *stringData = nullptr;
+    qint64 size = 0;
+    qint64 created = 0;
+    SnapshotReader::Error error = SnapshotReader::TruncatedError;
+    SnapshotReader::Content content = SnapshotReader::NoContent;
+    quint32 recordSize = 0;
+    quint32 recordCount = 0;
+    quint32 stringCount = 0;
+    quint32 listCount = 0;
+    quint32 listItemCount = 0;
+    quint32 stringDataLength = 0;
+    quint16 version = 0;
+};
+
+}
+
+SnapshotReader::SnapshotReader(const QByteArray &data) : wl_ptr(new SnapshotReaderPrivate)
+{
+    Q_D(SnapshotReader);
+    d->buffer = data;
+    d->data = reinterpret_cast<const uchar *>(d->buffer.constData());
+    d->size = d->buffer.size();
+    d->validate();
+}
+
+SnapshotReader::SnapshotReader(const uchar *data, qint64 size) : wl_ptr(new SnapshotReaderPrivate)
+{
+    Q_D(SnapshotReader);
+    d->data = data;
+    d->size = data ? size : 0;
+    d->validate();
+}
+
+SnapshotReader::~SnapshotReader() = default;
+
+bool SnapshotReader::isValid() const
+{
+    Q_D(const SnapshotReader);
+    return d->error == NoError;
+}
+
+SnapshotReader::Error SnapshotReader::error() const
+{
+    Q_D(const SnapshotReader);
+    return d->error;
+}
+
+quint16 SnapshotReader::formatVersion() const
+{
+    Q_D(const SnapshotReader);
+    return d->version;
+}
+
+SnapshotReader::Content SnapshotReader::content() const
+{
+    Q_D(const SnapshotReader);
+    return d->content;
+}
+
+QDateTime SnapshotReader::created() const
+{
+    Q_D(const SnapshotReader);
+    return isValid() ? QDateTime::fromMSecsSinceEpoch(d->created, Qt::UTC) : QDateTime();
+}
+
+int SnapshotReader::count() const
+{
+    Q_D(const SnapshotReader);
+    return isValid() ? static_cast<int>(d->recordCount) : 0;
+}
+
+bool SnapshotReader::hasIdIndex() const
+{
+    Q_D(const SnapshotReader);
+    return d->idIndex != nullptr;
+}
+
+int SnapshotReader::indexOf(const QString &id) const
+{
+    Q_D(const SnapshotReader);
+    if (d->content != UserContent || id.isEmpty()) {
+        return -1;
+    }
+
+    if (d->idIndex) {
+        int first = 0;
+        int last = count() - 1;
+        while (first <= last) {
+            const int middle = first + (last - first) / 2;
+            const quint32 idx = Snapshot::read<quint32>(d->idIndex + static_cast<quint64>(middle) * 4);
+            if (Q_UNLIKELY(idx >= d->recordCount)) {
+                qCWarning(wlCore) << "Invalid id index entry" << middle << "in snapshot";
+                return -1;
+            }
+            const int cmp = d->compareId(idx, id);
+            if (cmp == 0) {
+                return static_cast<int>(idx);
+            } else if (cmp < 0) {
+                first = middle + 1;
+            } else {
+                last = middle - 1;
+            }
+        }
+        return -1;
+    }
+
+    const int cnt = count();
+    for (int i = 0; i < cnt; ++i) {
+        if (d->compareId(static_cast<quint32>(i), id) == 0) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+QString SnapshotReader::userId(int index) const
+{
+    Q_D(const SnapshotReader);
+    if (d->content != UserContent || index < 0 || index >= count()) {
+        return QString();
+    }
+    return d->string(Snapshot::read<quint32>(d->record(index) + Snapshot::UserId));
+}
+
+UserData SnapshotReader::user(int index) const
+{
+    Q_D(const SnapshotReader);
+    if (d->content != UserContent || index < 0 || index >= count()) {
+        return UserData();
+    }
+
+    const auto strings = [d](quint32 idx) { return d->string(idx); };
+    const auto lists = [d, &strings](quint32 idx) { return d->list(idx, strings); };
+    return d->decodeUser(d->record(index), strings, lists);
+}
+
+QVector<UserData> SnapshotReader::users() const
+{
+    Q_D(const SnapshotReader);
+    QVector<UserData> users;
+    if (d->content != UserContent) {
+        return users;
+    }
+
+    // decode every distinct string and list only once, the records share them
+    QVector<QString> stringCache(static_cast<int>(d->stringCount));
+    for (quint32 i = 1; i < d->stringCount; ++i) {
+        stringCache[static_cast<int>(i)] = d->string(i);
+    }
+    const auto strings = [&stringCache](quint32 idx) { return idx < static_cast<quint32>(stringCache.size()) ? stringCache.at(static_cast<int>(idx)) : QString(); };
+
+    QVector<QStringList> listCache(static_cast<int>(d->listCount));
+    for (quint32 i = 1; i < d->listCount; ++i) {
+        listCache[static_cast<int>(i)] = d->list(i, strings);
+    }
+    const auto lists = [&listCache](quint32 idx) { return idx < static_cast<quint32>(listCache.size()) ? listCache.at(static_cast<int>(idx)) : QStringList(); };
+
+    const int cnt = count();
+    users.reserve(cnt);
+    for (int i = 0; i < cnt; ++i) {
+        users.append(d->decodeUser(d->record(i), strings, lists));
+    }
+
+    return users;
+}
+
+bool SnapshotReader::readServerStatus(ServerStatus *status) const
+{
+    Q_ASSERT_X(status, "read server status from snapshot", "invalid ServerStatus object");
+
+    Q_D(const SnapshotReader);
+    if (d->content != ServerStatusContent) {
+        return false;
+    }
+
+    const uchar *r = d->record(0);
+    const quint32 flags = Snapshot::read<quint32>(r + Snapshot::ServerStatusFlags);
+
+    ServerStatusPrivate *s = status->wl_ptr.get();
+    s->setVersion(d->string(Snapshot::read<quint32>(r + Snapshot::ServerStatusVersion)));
+    s->setVersionstring(d->string(Snapshot::read<quint32>(r + Snapshot::ServerStatusVersionstring)));
+    s->setEdition(d->string(Snapshot::read<quint32>(r + Snapshot::ServerStatusEdition)));
+    s->setProductname(d->string(Snapshot::read<quint32>(r + Snapshot::ServerStatusProductname)));
+    s->setInstalled((flags & Snapshot::ServerStatusInstalledFlag) != 0);
+    s->setMaintenance((flags & Snapshot::ServerStatusMaintenanceFlag) != 0);
+    s->setNeedsDbUpgrade((flags & Snapshot::ServerStatusNeedsDbUpgradeFlag) != 0);
+    s->setExtendedSupport((flags & Snapshot::ServerStatusExtendedSupportFlag) != 0);
+    s->emitChanges();
+
+    return true;
+}
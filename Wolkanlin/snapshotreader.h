@@ -0,0 +1,162 @@
+/*
+ * SPDX-FileCopyrightText: (C) 2021 Matthias Fehring / www.huessenbergnetz.de
+ * SPDX-License-Identifier: LGPL-3.0-or-later
+ */
+
+#ifndef WOLKANLIN_SNAPSHOTREADER_H
+#define WOLKANLIN_SNAPSHOTREADER_H
+
+#include "wolkanlin_export.h"
+#include <QByteArray>
+#include <QDateTime>
+#include <QVector>
+#include <memory>
+
+namespace Wolkanlin {
+
+class SnapshotReaderPrivate;
+class UserData;
+class ServerStatus;
+
+/*!
+ * \brief Reads users or a server status from a binary snapshot created by SnapshotWriter.
+ *
+ * The reader validates the header and the section bounds on construction, use isValid() and
+ * error() to check the result. The records are decoded on demand: user() decodes a single
+ * record, users() decodes all records at once and converts every distinct string only once,
+ * so equal values of different users share their data.
+ *
+ * Snapshots written with an older format version can be read. Fields that have been added
+ * to the records later are appended at their end, so they get their default values when
+ * reading older snapshots and are ignored by older readers.
+ *
+ * The reader can also operate on external memory, like a file mapped with QFile::map().
+ * The memory has to stay valid as long as the reader is used.
+ *
+ * \headerfile "" <Wolkanlin/SnapshotReader>
+ */
+class WOLKANLIN_EXPORT SnapshotReader
+{
+public:
+    /*!
+     * \brief This enum describes the content of a snapshot.
+     */
+    enum Content : quint32 {
+        NoContent           = 0,    /**< the snapshot is invalid */
+        UserContent         = 1,    /**< the snapshot contains a list of users */
+        ServerStatusContent = 2     /**< the snapshot contains a single server status */
+    };
+
+    /*!
+     * \brief This enum describes errors that can occure when reading a snapshot.
+     */
+    enum Error {
+        NoError = 0,            /**< no error occured */
+        TruncatedError,         /**< the data is shorter than the header or a section described by the header */
+        InvalidMagicError,      /**< the data does not start with the snapshot magic number */
+        UnsupportedVersionError,/**< the snapshot has been written in a newer, incompatible format version */
+        CorruptedError          /**< the header contains invalid values */
+    };
+
+    /*!
+     * \brief Constructs a new %SnapshotReader that reads from \a data.
+     *
+     * The data is implicitly shared with the reader.
+     */
+    explicit SnapshotReader(const QByteArray &data);
+
+    /*!
+     * \brief Constructs a new %SnapshotReader that reads \a size bytes from \a data.
+     *
+     * The data is not copied and has to stay valid as long as the reader is used.
+     */
+    SnapshotReader(const uchar *data, qint64 size);
+
+    /*!
+     * \brief Destroys the %SnapshotReader.
+     */
+    ~SnapshotReader();
+
+    /*!
+     * \brief Returns \c true if the header of the snapshot is valid.
+     */
+    bool isValid() const;
+
+    /*!
+     * \brief Returns the error that occured while validating the snapshot.
+     */
+    Error error() const;
+
+    /*!
+     * \brief Returns the format version the snapshot has been written with.
+     */
+    quint16 formatVersion() const;
+
+    /*!
+     * \brief Returns the content type of the snapshot.
+     */
+    Content content() const;
+
+    /*!
+     * \brief Returns the date and time in UTC the snapshot has been created.
+     */
+    QDateTime created() const;
+
+    /*!
+     * \brief Returns the number of records in the snapshot.
+     */
+    int count() const;
+
+    /*!
+     * \brief Returns \c true if the snapshot contains an index of the user IDs.
+     *
+     * \sa SnapshotWriter::setIdIndexEnabled()
+     */
+    bool hasIdIndex() const;
+
+    /*!
+     * \brief Returns the index of the user record with the given \a id.
+     *
+     * If the snapshot contains an index of the user IDs, a binary search is performed on it,
+     * otherwise all records are searched. Only the IDs of the visited records are compared,
+     * no other data is decoded. Returns \c -1 if no user with \a id has been found.
+     */
+    int indexOf(const QString &id) const;
+
+    /*!
+     * \brief Returns the ID of the user at \a index without decoding the other fields.
+     *
+     * Returns an empty string if the snapshot does not contain users or if \a index is out of range.
+     */
+    QString userId(int index) const;
+
+    /*!
+     * \brief Returns the user at \a index.
+     *
+     * Returns an empty UserData object if the snapshot does not contain users or if \a index is out of range.
+     */
+    UserData user(int index) const;
+
+    /*!
+     * \brief Returns all users stored in the snapshot.
+     */
+    QVector<UserData> users() const;
+
+    /*!
+     * \brief Reads the server status stored in the snapshot into \a status.
+     *
+     * The changed properties of \a status will emit their notifier signals. Returns \c false
+     * if the snapshot does not contain a server status.
+     */
+    bool readServerStatus(ServerStatus *status) const;
+
+private:
+    const std::unique_ptr<SnapshotReaderPrivate> wl_ptr;
+
+    Q_DECLARE_PRIVATE_D(wl_ptr, SnapshotReader)
+    Q_DISABLE_COPY(SnapshotReader)
+};
+
+}
+
+#endif // WOLKANLIN_SNAPSHOTREADER_H
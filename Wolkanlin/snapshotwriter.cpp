@@ -0,0 +1,364 @@
+/*
+ * SPDX-FileCopyrightText: (C) 2021 Matthias Fehring / www.huessenbergnetz.de
+ * SPDX-License-Identifier: LGPL-3.0-or-later
+ */
+
+#include "snapshotwriter.h"
+#include "snapshotreader.h"
+#include "snapshot_p.h"
+#include "userdata.h"
+#include "serverstatus.h"
+#include "logging.h"
+#include <QHash>
+#include <QDateTime>
+#include <QIODevice>
+#include <algorithm>
+
+using namespace Wolkanlin;
+
+namespace Wolkanlin {
+
+class SnapshotWriterPrivate
+{
+public:
+    SnapshotWriterPrivate()
+    {
+        reset(SnapshotReader::NoContent);
+    }
+
+    void reset(SnapshotReader::Content _content)
+    {
+        content = _content;
+        records.clear();
+        recordIds.clear();
+        stringIndex.clear();
+        listIndex.clear();
+        stringTable.clear();
+        stringData.clear();
+        listTable.clear();
+        listItems.clear();
+        stringCount = 0;
+        stringDataLength = 0;
+        listCount = 0;
+        listItemCount = 0;
+        count = 0;
+
+        // index 0 is always the empty string and the empty list
+        appendTableEntry(stringTable, 0, 0);
+        stringCount = 1;
+        appendTableEntry(listTable, 0, 0);
+        listCount = 1;
+    }
+
+    static void appendTableEntry(QByteArray &table, quint32 first, quint32 second)
+    {
+        uchar entry[8];
+        Snapshot::write<quint32>(entry, first);
+        Snapshot::write<quint32>(entry + 4, second);
+        table.append(reinterpret_cast<const char *>(entry), 8);
+    }
+
+    quint32 addString(const QString &str)
+    {
+        if (str.isEmpty()) {
+            return 0;
+        }
+
+        const auto it = stringIndex.constFind(str);
+        if (it != stringIndex.constEnd()) {
+            return it.value();
+        }
+
+        const quint32 idx = stringCount++;
+        const quint32 length = static_cast<quint32>(str.size());
+        appendTableEntry(stringTable, stringDataLength, length);
+        stringDataLength += length;
+
+#if Q_BYTE_ORDER == Q_LITTLE_ENDIAN
+        stringData.append(reinterpret_cast<const char *>(str.utf16()), str.size() * 2);
+#else
+        const int offset = stringData.size();
+        stringData.resize(offset + str.size() * 2);
+        auto out = reinterpret_cast<uchar *>(stringData.data() + offset);
+        const ushort *in = str.utf16();
+        for (int i = 0; i < str.size(); ++i) {
+            Snapshot::write<quint16>(out + i * 2, in[i]);
+        }
+#endif
+
+        stringIndex.insert(str, idx);
+        return idx;
+    }
+
+    quint32 addList(const QStringList &list)
+    {
+        if (list.empty()) {
+            return 0;
+        }
+
+        QByteArray items(list.size() * 4, Qt::Uninitialized);
+        auto out = reinterpret_cast<uchar *>(items.data());
+        for (int i = 0; i < list.size(); ++i) {
+            Snapshot::write<quint32>(out + i * 4, addString(list.at(i)));
+        }
+
+        const auto it = listIndex.constFind(items);
+        if (it != listIndex.constEnd()) {
+            return it.value();
+        }
+
+        const quint32 idx = listCount++;
+        appendTableEntry(listTable, listItemCount, static_cast<quint32>(list.size()));
+        listItemCount += static_cast<quint32>(list.size());
+        listItems.append(items);
+        listIndex.insert(items, idx);
+        return idx;
+    }
+
+    uchar *appendRecord(int size)
+    {
+        const int offset = records.size();
+        records.append(QByteArray(size, '\0'));
+        count++;
+        return reinterpret_cast<uchar *>(records.data() + offset);
+    }
+
+    void addUser(const UserData &user)
+    {
+        if (content != SnapshotReader::UserContent) {
+            reset(SnapshotReader::UserContent);
+        }
+
+        uchar *r = appendRecord(Snapshot::UserRecordSize);
+
+        recordIds.append(user.id());
+        Snapshot::write<quint32>(r + Snapshot::UserId, addString(recordIds.last()));
+        Snapshot::write<quint32>(r + Snapshot::UserStorageLocation, addString(user.storageLocation()));
+        Snapshot::write<quint32>(r + Snapshot::UserBackend, addString(user.backend()));
+        Snapshot::write<quint32>(r + Snapshot::UserEmail, addString(user.email()));
+        Snapshot::write<quint32>(r + Snapshot::UserDisplayname, addString(user.displayname()));
+        Snapshot::write<quint32>(r + Snapshot::UserPhone, addString(user.phone()));
+        Snapshot::write<quint32>(r + Snapshot::UserAddress, addString(user.address()));
+        Snapshot::write<quint32>(r + Snapshot::UserWebsite, addString(user.website().toString(QUrl::FullyEncoded)));
+        Snapshot::write<quint32>(r + Snapshot::UserTwitter, addString(user.twitter()));
+        Snapshot::write<quint32>(r + Snapshot::UserLanguage, addString(user.language()));
+        Snapshot::write<quint32>(r + Snapshot::UserLocale, addString(user.locale()));
+        Snapshot::write<quint32>(r + Snapshot::UserSubadmin, addList(user.subadmin()));
+        Snapshot::write<quint32>(r + Snapshot::UserGroups, addList(user.groups()));
+        Snapshot::write<quint32>(r + Snapshot::UserCapabilities, static_cast<quint32>(user.backendCapabilities()));
+
+        quint32 flags = 0;
+        if (user.isEnabled()) {
+            flags |= Snapshot::UserEnabledFlag;
+        }
+
+        const QDateTime lastLogin = user.lastLogin();
+        if (lastLogin.isValid()) {
+            flags |= Snapshot::UserLastLoginFlag;
+            Snapshot::write<qint64>(r + Snapshot::UserLastLogin, lastLogin.toMSecsSinceEpoch());
+        }
+
+        const Quota quota = user.quota();
+        if (!quota.isNull()) {
+            flags |= Snapshot::UserQuotaFlag;
+            Snapshot::write<qint64>(r + Snapshot::UserQuotaFree, quota.free());
+            Snapshot::write<qint64>(r + Snapshot::UserQuotaUsed, quota.used());
+            Snapshot::write<qint64>(r + Snapshot::UserQuotaQuota, quota.quota());
+            Snapshot::write<qint64>(r + Snapshot::UserQuotaTotal, quota.total());
+            Snapshot::writeDouble(r + Snapshot::UserQuotaRelative, quota.relative());
+        }
+
+        Snapshot::write<quint32>(r + Snapshot::UserFlags, flags);
+    }
+
+    int recordSize() const
+    {
+        switch (content) {
+        case SnapshotReader::UserContent:
+            return Snapshot::UserRecordSize;
+        case SnapshotReader::ServerStatusContent:
+            return Snapshot::ServerStatusRecordSize;
+        default:
+            return 0;
+        }
+    }
+
+    QByteArray idIndex() const
+    {
+        QVector<quint32> order(recordIds.size());
+        for (int i = 0; i < order.size(); ++i) {
+            order[i] = static_cast<quint32>(i);
+        }
+        std::stable_sort(order.begin(), order.end(), [this](quint32 a, quint32 b) {
+            return recordIds.at(static_cast<int>(a)) < recordIds.at(static_cast<int>(b));
+        });
+
+        QByteArray index(order.size() * 4, Qt::Uninitialized);
+        auto out = reinterpret_cast<uchar *>(index.data());
+        for (int i = 0; i < order.size(); ++i) {
+            Snapshot::write<quint32>(out + i * 4, order.at(i));
+        }
+        return index;
+    }
+
+    QByteArray records;
+    QStringList recordIds;
+    QByteArray stringTable;
+    QByteArray stringData;
+    QByteArray listTable;
+    QByteArray listItems;
+    QHash<QString, quint32> stringIndex;
+    QHash<QByteArray, quint32> listIndex;
+    SnapshotReader::Content content = SnapshotReader::NoContent;
+    quint32 stringCount = 0;
+    quint32 stringDataLength = 0;
+    quint32 listCount = 0;
+    quint32 listItemCount = 0;
+    int count = 0;
+    bool idIndexEnabled = false;
+};
+
+}
+
+SnapshotWriter::SnapshotWriter() : wl_ptr(new SnapshotWriterPrivate)
+{
+
+}
+
+SnapshotWriter::~SnapshotWriter() = default;
+
+void SnapshotWriter::addUser(const UserData &user)
+{
+    Q_D(SnapshotWriter);
+    d->addUser(user);
+}
+
+void SnapshotWriter::addUsers(const QVector<UserData> &users)
+{
+    Q_D(SnapshotWriter);
+    if (d->content != SnapshotReader::UserContent) {
+        d->reset(SnapshotReader::UserContent);
+    }
+    d->records.reserve(d->records.size() + users.size() * Snapshot::UserRecordSize);
+    d->stringIndex.reserve(d->stringIndex.size() + users.size() * 4);
+    for (const UserData &user : users) {
+        d->addUser(user);
+    }
+}
+
+void SnapshotWriter::setServerStatus(const ServerStatus &status)
+{
+    Q_D(SnapshotWriter);
+    d->reset(SnapshotReader::ServerStatusContent);
+
+    uchar *r = d->appendRecord(Snapshot::ServerStatusRecordSize);
+
+    Snapshot::write<quint32>(r + Snapshot::ServerStatusVersion, d->addString(status.version()));
+    Snapshot::write<quint32>(r + Snapshot::ServerStatusVersionstring, d->addString(status.versionstring()));
+    Snapshot::write<quint32>(r + Snapshot::ServerStatusEdition, d->addString(status.edition()));
+    Snapshot::write<quint32>(r + Snapshot::ServerStatusProductname, d->addString(status.productname()));
+
+    quint32 flags = 0;
+    if (status.isInstalled()) {
+        flags |= Snapshot::ServerStatusInstalledFlag;
+    }
+    if (status.isInMaintenance()) {
+        flags |= Snapshot::ServerStatusMaintenanceFlag;
+    }
+    if (status.needsDbUpgrade()) {
+        flags |= Snapshot::ServerStatusNeedsDbUpgradeFlag;
+    }
+    if (status.hasExtendedSupport()) {
+        flags |= Snapshot::ServerStatusExtendedSupportFlag;
+    }
+    Snapshot::write<quint32>(r + Snapshot::ServerStatusFlags, flags);
+}
+
+int SnapshotWriter::count() const
+{
+    Q_D(const SnapshotWriter);
+    return d->count;
+}
+
+bool SnapshotWriter::isIdIndexEnabled() const
+{
+    Q_D(const SnapshotWriter);
+    return d->idIndexEnabled;
+}
+
+void SnapshotWriter::setIdIndexEnabled(bool enabled)
+{
+    Q_D(SnapshotWriter);
+    d->idIndexEnabled = enabled;
+}
+
+void SnapshotWriter::clear()
+{
+    Q_D(SnapshotWriter);
+    d->reset(SnapshotReader::NoContent);
+}
+
+QByteArray SnapshotWriter::toByteArray() const
+{
+    Q_D(const SnapshotWriter);
+
+    const qint64 recordsOffset = Snapshot::HeaderSize;
+    const qint64 recordsEnd = recordsOffset + d->records.size();
+    const qint64 listsOffset = recordsEnd + Snapshot::padding(recordsEnd);
+    const qint64 listsEnd = listsOffset + d->listTable.size() + d->listItems.size();
+    const qint64 stringsOffset = listsEnd + Snapshot::padding(listsEnd);
+    const qint64 stringsEnd = stringsOffset + d->stringTable.size() + d->stringData.size();
+
+    const bool withIndex = d->idIndexEnabled && d->content == SnapshotReader::UserContent;
+    const QByteArray index = withIndex ? d->idIndex() : QByteArray();
+    const qint64 indexOffset = withIndex ? stringsEnd + Snapshot::padding(stringsEnd) : 0;
+    const qint64 end = withIndex ? indexOffset + index.size() : stringsEnd;
+
+    QByteArray out(static_cast<int>(end), '\0');
+    auto o = reinterpret_cast<uchar *>(out.data());
+
+    std::memcpy(o + Snapshot::HeaderMagic, Snapshot::Magic, 4);
+    Snapshot::write<quint16>(o + Snapshot::HeaderVersion, Snapshot::FormatVersion);
+    Snapshot::write<quint16>(o + Snapshot::HeaderHeaderSize, static_cast<quint16>(Snapshot::HeaderSize));
+    Snapshot::write<quint32>(o + Snapshot::HeaderContent, static_cast<quint32>(d->content));
+    Snapshot::write<quint32>(o + Snapshot::HeaderFlags, withIndex ? Snapshot::IdIndexFlag : 0);
+    Snapshot::write<quint32>(o + Snapshot::HeaderRecordSize, static_cast<quint32>(d->recordSize()));
+    Snapshot::write<quint32>(o + Snapshot::HeaderRecordCount, static_cast<quint32>(d->count));
+    Snapshot::write<quint32>(o + Snapshot::HeaderStringCount, d->stringCount);
+    Snapshot::write<quint32>(o + Snapshot::HeaderListCount, d->listCount);
+    Snapshot::write<quint32>(o + Snapshot::HeaderListItemCount, d->listItemCount);
+    Snapshot::write<quint32>(o + Snapshot::HeaderStringDataLength, d->stringDataLength);
+    Snapshot::write<quint64>(o + Snapshot::HeaderRecordsOffset, static_cast<quint64>(recordsOffset));
+    Snapshot::write<quint64>(o + Snapshot::HeaderListsOffset, static_cast<quint64>(listsOffset));
+    Snapshot::write<quint64>(o + Snapshot::HeaderStringsOffset, static_cast<quint64>(stringsOffset));
+    Snapshot::write<qint64>(o + Snapshot::HeaderCreated, QDateTime::currentMSecsSinceEpoch());
+    Snapshot::write<quint64>(o + Snapshot::HeaderIndexOffset, static_cast<quint64>(indexOffset));
+
+    std::memcpy(o + recordsOffset, d->records.constData(), static_cast<size_t>(d->records.size()));
+    std::memcpy(o + listsOffset, d->listTable.constData(), static_cast<size_t>(d->listTable.size()));
+    std::memcpy(o + listsOffset + d->listTable.size(), d->listItems.constData(), static_cast<size_t>(d->listItems.size()));
+    std::memcpy(o + stringsOffset, d->stringTable.constData(), static_cast<size_t>(d->stringTable.size()));
+    std::memcpy(o + stringsOffset + d->stringTable.size(), d->stringData.constData(), static_cast<size_t>(d->stringData.size()));
+    if (withIndex) {
+        std::memcpy(o + indexOffset, index.constData(), static_cast<size_t>(index.size()));
+    }
+
+    return out;
+}
+
+bool SnapshotWriter::write(QIODevice *device) const
+{
+    Q_ASSERT_X(device, "write snapshot", "invalid device");
+
+    const QByteArray data = toByteArray();
+    if (device->write(data) != data.size()) {
+        qCWarning(wlCore) << "Failed to write snapshot:" << device->errorString();
+        return false;
+    }
+    return true;
+}
+
+quint16 SnapshotWriter::formatVersion()
+{
+    return Snapshot::FormatVersion;
+}
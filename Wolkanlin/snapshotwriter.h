@@ -0,0 +1,133 @@
+/*
+ * SPDX-FileCopyrightText: (C) 2021 Matthias Fehring / www.huessenbergnetz.de
+ * SPDX-License-Identifier: LGPL-3.0-or-later
+ */
+
+#ifndef WOLKANLIN_SNAPSHOTWRITER_H
+#define WOLKANLIN_SNAPSHOTWRITER_H
+
+#include "wolkanlin_export.h"
+#include <QByteArray>
+#include <QVector>
+#include <memory>
+
+class QIODevice;
+
+namespace Wolkanlin {
+
+class SnapshotWriterPrivate;
+class UserData;
+class ServerStatus;
+
+/*!
+ * \brief Writes users or a server status into a versioned binary snapshot.
+ *
+ * The QDataStream operators of User, UserData and ServerStatus write the fields one after
+ * another without any version information, so data written by an older version of this library
+ * can not be read anymore if a field has been added. The snapshot format is meant for persistent
+ * caches. It starts with a header containing a magic number, the format version and the size of
+ * the records, followed by fixed width records and a table of all distinct strings and string
+ * lists. Values that are repeated in many records, like group names or the language, are stored
+ * only once. Use SnapshotReader to read the data back.
+ *
+ * A snapshot contains either a list of users or a single server status. Records are encoded
+ * when they are added, so adding many users does not keep copies of the UserData objects.
+ *
+ * \code{.cpp}
+ * SnapshotWriter writer;
+ * writer.addUsers(directory->users());
+ * QFile file(cachePath);
+ * if (file.open(QIODevice::WriteOnly)) {
+ *     writer.write(&file);
+ * }
+ * \endcode
+ *
+ * \headerfile "" <Wolkanlin/SnapshotWriter>
+ */
+class WOLKANLIN_EXPORT SnapshotWriter
+{
+public:
+    /*!
+     * \brief Constructs a new empty %SnapshotWriter.
+     */
+    SnapshotWriter();
+
+    /*!
+     * \brief Destroys the %SnapshotWriter.
+     */
+    ~SnapshotWriter();
+
+    /*!
+     * \brief Adds the data of a single \a user to the snapshot.
+     *
+     * If a server status has been set before, it will be removed.
+     */
+    void addUser(const UserData &user);
+
+    /*!
+     * \brief Adds the data of all \a users to the snapshot.
+     *
+     * If a server status has been set before, it will be removed.
+     */
+    void addUsers(const QVector<UserData> &users);
+
+    /*!
+     * \brief Sets the server \a status as content of the snapshot.
+     *
+     * Users and a server status that have been added before will be removed.
+     */
+    void setServerStatus(const ServerStatus &status);
+
+    /*!
+     * \brief Returns the number of records in the snapshot.
+     */
+    int count() const;
+
+    /*!
+     * \brief Returns \c true if an index of the user IDs will be written.
+     *
+     * \sa setIdIndexEnabled()
+     */
+    bool isIdIndexEnabled() const;
+
+    /*!
+     * \brief Set \a enabled to \c true to write an index of the user IDs.
+     *
+     * The index contains the records sorted by user ID and lets SnapshotReader::indexOf()
+     * find a single user with a binary search without decoding other records. It adds
+     * four bytes per user. The index is disabled by default.
+     */
+    void setIdIndexEnabled(bool enabled);
+
+    /*!
+     * \brief Removes all records from the snapshot.
+     */
+    void clear();
+
+    /*!
+     * \brief Returns the complete snapshot.
+     */
+    QByteArray toByteArray() const;
+
+    /*!
+     * \brief Writes the complete snapshot to \a device.
+     *
+     * Returns \c true on success, otherwise returns \c false.
+     */
+    bool write(QIODevice *device) const;
+
+    /*!
+     * \brief Returns the version of the snapshot format written by this class.
+     */
+    static quint16 formatVersion();
+
+private:
+    const std::unique_ptr<SnapshotWriterPrivate> wl_ptr;
+
+    Q_DECLARE_PRIVATE_D(wl_ptr, SnapshotWriter)
+    Q_DISABLE_COPY(SnapshotWriter)
+};
+
+}
+
+#endif // WOLKANLIN_SNAPSHOTWRITER_H
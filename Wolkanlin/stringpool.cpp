@@ -0,0 +1,125 @@
+/*
+ * SPDX-FileCopyrightText: (C) 2021 Matthias Fehring / www.huessenbergnetz.de
+ * SPDX-License-Identifier: LGPL-3.0-or-later
+ */
+
+#include "stringpool.h"
+#include "logging.h"
+#include <QSet>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QGlobalStatic>
+#include <QJsonArray>
+#include <QJsonValue>
+
+using namespace Wolkanlin;
+
+namespace Wolkanlin {
+
+class StringPoolPrivate
+{
+public:
+    QString intern(const QString &str)
+    {
+        if (str.isEmpty()) {
+            return str;
+        }
+
+        stats.lookups++;
+
+        const auto it = strings.constFind(str);
+        if (it != strings.constEnd()) {
+            stats.hits++;
+            stats.savedBytes += bytesUsed(str);
+            return *it;
+        }
+
+        strings.insert(str);
+        stats.pooledBytes += bytesUsed(str);
+        return str;
+    }
+
+    static qint64 bytesUsed(const QString &str)
+    {
+        // payload plus the approximate size of the QString data header
+        return static_cast<qint64>(str.capacity() + 1) * static_cast<qint64>(sizeof(QChar)) + 24;
+    }
+
+    mutable QMutex lock;
+    QSet<QString> strings;
+    StringPool::Statistics stats;
+};
+
+}
+
+Q_GLOBAL_STATIC(StringPool, globalPool)
+
+StringPool::StringPool() : wl_ptr(new StringPoolPrivate)
+{
+
+}
+
+StringPool::~StringPool() = default;
+
+QString StringPool::intern(const QString &str)
+{
+    Q_D(StringPool);
+    QMutexLocker locker(&d->lock);
+    return d->intern(str);
+}
+
+QStringList StringPool::intern(const QStringList &list)
+{
+    Q_D(StringPool);
+    QStringList interned;
+    interned.reserve(list.size());
+    QMutexLocker locker(&d->lock);
+    for (const QString &str : list) {
+        interned << d->intern(str);
+    }
+    return interned;
+}
+
+QStringList StringPool::intern(const QJsonArray &array)
+{
+    Q_D(StringPool);
+    QStringList interned;
+    if (!array.empty()) {
+        interned.reserve(array.size());
+        QMutexLocker locker(&d->lock);
+        for (const QJsonValue &v : array) {
+            interned << d->intern(v.toString());
+        }
+    }
+    return interned;
+}
+
+int StringPool::size() const
+{
+    Q_D(const StringPool);
+    QMutexLocker locker(&d->lock);
+    return d->strings.size();
+}
+
+StringPool::Statistics StringPool::statistics() const
+{
+    Q_D(const StringPool);
+    QMutexLocker locker(&d->lock);
+    Statistics stats = d->stats;
+    stats.uniqueStrings = d->strings.size();
+    return stats;
+}
+
+void StringPool::clear()
+{
+    Q_D(StringPool);
+    QMutexLocker locker(&d->lock);
+    qCDebug(wlCore) << "Clearing string pool with" << d->strings.size() << "strings";
+    d->strings.clear();
+    d->stats = Statistics();
+}
+
+StringPool *StringPool::global()
+{
+    return globalPool();
+}
@@ -0,0 +1,114 @@
+/*
+ * SPDX-FileCopyrightText: (C) 2021 Matthias Fehring / www.huessenbergnetz.de
+ * SPDX-License-Identifier: LGPL-3.0-or-later
+ */
+
+#ifndef WOLKANLIN_STRINGPOOL_H
+#define WOLKANLIN_STRINGPOOL_H
+
+#include "wolkanlin_export.h"
+#include <QString>
+#include <QStringList>
+#include <memory>
+
+class QJsonArray;
+
+namespace Wolkanlin {
+
+class StringPoolPrivate;
+
+/*!
+ * \brief Interning pool for strings that are repeated many times.
+ *
+ * Data of many users contains values that are drawn from small vocabularies, like group names,
+ * the user backend, the language and the locale. Without interning every occurrence of such a
+ * value is stored in its own QString. intern() returns an implicitly shared copy of an already
+ * known equal string, so identical values share a single allocation.
+ *
+ * UserData::fromJson() with a pool argument interns the values into the given %StringPool.
+ * The bulk decoding paths of GetUserDetailsListJob, BulkUserFetcher and UserListModel use
+ * global(). Use statistics() to measure the effect.
+ *
+ * All functions of this class are thread-safe.
+ *
+ * \headerfile "" <Wolkanlin/StringPool>
+ */
+class WOLKANLIN_EXPORT StringPool
+{
+public:
+    /*!
+     * \brief Usage statistics of a %StringPool.
+     */
+    struct Statistics {
+        qint64 lookups = 0;     /**< Number of calls to intern() with a non-empty string. */
+        qint64 hits = 0;        /**< Number of lookups that returned an already pooled string. */
+        qint64 savedBytes = 0;  /**< Approximate number of bytes saved by sharing pooled strings. */
+        qint64 pooledBytes = 0; /**< Approximate number of bytes used by the pooled strings. */
+        int uniqueStrings = 0;  /**< Number of distinct strings in the pool. */
+    };
+
+    /*!
+     * \brief Constructs a new empty %StringPool.
+     */
+    StringPool();
+
+    /*!
+     * \brief Destroys the %StringPool.
+     *
+     * Strings returned by intern() stay valid, they are implicitly shared.
+     */
+    ~StringPool();
+
+    /*!
+     * \brief Returns a string equal to \a str that shares its data with all other equal strings returned by this pool.
+     *
+     * Empty strings are returned as they are and not added to the pool.
+     */
+    QString intern(const QString &str);
+
+    /*!
+     * \brief Returns a list containing the interned strings of \a list.
+     */
+    QStringList intern(const QStringList &list);
+
+    /*!
+     * \brief Returns a list containing the interned string values of the JSON \a array.
+     *
+     * Values that are not strings are converted into empty strings.
+     */
+    QStringList intern(const QJsonArray &array);
+
+    /*!
+     * \brief Returns the number of distinct strings in the pool.
+     */
+    int size() const;
+
+    /*!
+     * \brief Returns the usage statistics of the pool.
+     */
+    Statistics statistics() const;
+
+    /*!
+     * \brief Removes all strings from the pool and resets the statistics.
+     */
+    void clear();
+
+    /*!
+     * \brief Returns a pointer to the global default pool.
+     *
+     * This pool is used by the bulk decoding paths of the library, it is never used implicitly
+     * by UserData::fromJson(). The pool is not cleared automatically, call clear() if the pooled
+     * strings are not needed anymore.
+     */
+    static StringPool *global();
+
+private:
+    const std::unique_ptr<StringPoolPrivate> wl_ptr;
+
+    Q_DECLARE_PRIVATE_D(wl_ptr, StringPool)
+    Q_DISABLE_COPY(StringPool)
+};
+
+}
+
+#endif // WOLKANLIN_STRINGPOOL_H
@@ -13,15 +13,23 @@
 #include <QUrl>
 #include <memory>
 
+#if QT_VERSION >= QT_VERSION_CHECK(5, 12, 0)
+class QCborStreamWriter;
+class QCborStreamReader;
+#endif
+
 namespace Wolkanlin {
 
 class AbstractConfiguration;
 class UserPrivate;
+class UserData;
 
 /*!
  * \brief Stores information about a single user.
  *
- * This object stores information like returned by GetUserJob.
+ * This object stores information like returned by GetUserJob. It is a thin QObject wrapper
+ * around UserData that adds notifier signals for use with property bindings. If you have to
+ * store information about many users, use UserData directly.
  *
  * <H3 id="user-json-example">JSON representation example</H3>
  * This is the JSON object like it is returned by the Nextcloud API. fromJson() loads
@@ -249,12 +257,51 @@ public:
     Q_DECLARE_FLAGS(Capabilities, Capability)
     Q_FLAG(Capabilities)
 
+    /*!
+     * \brief This enum describes the data fields of a user.
+     *
+     * They are used in the Fields flags to describe which fields differ between
+     * two sets of user data.
+     *
+     * \sa UserData::diff(), changed()
+     */
+    enum Field : quint32 {
+        NoField                     = 0x00000,  /**< no field */
+        EnabledField                = 0x00001,  /**< the \link User::enabled enabled\endlink field */
+        StorageLocationField        = 0x00002,  /**< the \link User::storageLocation storageLocation\endlink field */
+        IdField                     = 0x00004,  /**< the \link User::id id\endlink field */
+        LastLoginField              = 0x00008,  /**< the \link User::lastLogin lastLogin\endlink field */
+        BackendField                = 0x00010,  /**< the \link User::backend backend\endlink field */
+        SubadminField               = 0x00020,  /**< the \link User::subadmin subadmin\endlink field */
+        QuotaField                  = 0x00040,  /**< the \link User::quota quota\endlink field */
+        EmailField                  = 0x00080,  /**< the \link User::email email\endlink field */
+        DisplaynameField            = 0x00100,  /**< the \link User::displayname displayname\endlink field */
+        PhoneField                  = 0x00200,  /**< the \link User::phone phone\endlink field */
+        AddressField                = 0x00400,  /**< the \link User::address address\endlink field */
+        WebsiteField                = 0x00800,  /**< the \link User::website website\endlink field */
+        TwitterField                = 0x01000,  /**< the \link User::twitter twitter\endlink field */
+        GroupsField                 = 0x02000,  /**< the \link User::groups groups\endlink field */
+        LanguageField               = 0x04000,  /**< the \link User::language language\endlink field */
+        LocaleField                 = 0x08000,  /**< the \link User::locale locale\endlink field */
+        BackendCapabilitiesField    = 0x10000,  /**< the \link User::backendCapabilities backendCapabilities\endlink field */
+        AllFields                   = 0x1FFFF   /**< all fields */
+    };
+    Q_DECLARE_FLAGS(Fields, Field)
+    Q_FLAG(Fields)
+
     /*!
      * \brief Constructs a new empty %User object with the given \a parent.
      *
      * isEmpty() will return \c true.
      */
     explicit User(QObject *parent = nullptr);
+    /*!
+     * \brief Constructs a new %User object with the given \a parent from \a data.
+     *
+     * The properties will be initialized with the values of \a data, that
+     * is implicitly shared with the new object.
+     */
+    explicit User(const UserData &data, QObject *parent = nullptr);
     /*!
      * \brief Destroys the %User object.
      */
@@ -358,6 +405,22 @@ public:
      */
     bool isEmpty() const;
 
+    /*!
+     * \brief Returns the data of this %User as lightweight UserData value.
+     *
+     * The data is implicitly shared, so this is a cheap operation.
+     */
+    UserData userData() const;
+
+    /*!
+     * \brief Sets all properties at once to the values of \a data.
+     *
+     * The data is implicitly shared with \a data. At first all values are applied, afterwards
+     * changed() is emitted once with all changed fields, followed by the notifier signals
+     * of the changed properties. If nothing has been changed, no signal is emitted.
+     */
+    void setUserData(const UserData &data);
+
     /*!
      * \brief Convertes the %User object to a JSON object where the property names are the keys.
      *
@@ -384,6 +447,41 @@ public:
      */
     static User *fromJson(const QJsonObject &json, QObject *parent = nullptr);
 
+#if QT_VERSION >= QT_VERSION_CHECK(5, 12, 0) || defined(W_DOXYGEN)
+    /*!
+     * \brief Writes the %User object as CBOR map with integer keys to \a writer.
+     *
+     * See UserData::toCbor() for more information.
+     *
+     * Available since Qt 5.12.
+     */
+    void toCbor(QCborStreamWriter &writer) const;
+
+    /*!
+     * \brief Returns the %User object encoded as CBOR.
+     *
+     * \overload
+     */
+    QByteArray toCbor() const;
+
+    /*!
+     * \brief Creates a new %User object with the given \a parent from the CBOR map at the current position of \a reader.
+     *
+     * See UserData::fromCbor() for more information. If the map can not be read, a pointer
+     * to an empty %User object will be returned.
+     *
+     * Available since Qt 5.12.
+     */
+    static User *fromCbor(QCborStreamReader &reader, QObject *parent = nullptr);
+
+    /*!
+     * \brief Creates a new %User object with the given \a parent from the \a cbor encoded data.
+     *
+     * \overload
+     */
+    static User *fromCbor(const QByteArray &cbor, QObject *parent = nullptr);
+#endif
+
     /*!
      * \brief Get data from the Nextcloud server for the user identified by \a id.
      *
@@ -496,6 +594,18 @@ Q_SIGNALS:
      */
     void isLoadingChanged(bool isLoading);
 
+    /*!
+     * \brief Emitted once after one or more properties have been changed together.
+     *
+     * \a fields contains all changed fields. This signal is emitted after all values have
+     * been updated and before the notifier signals of the single properties, that are
+     * emitted once per changed property afterwards. Connect to this signal to handle
+     * an update of multiple properties at once.
+     *
+     * \sa setUserData(), get()
+     */
+    void changed(Wolkanlin::User::Fields fields);
+
     /*!
      * \brief Emitted when getting user meta data succeeded.
      *
@@ -544,5 +654,6 @@ WOLKANLIN_EXPORT QDebug operator<<(QDebug dbg, const Wolkanlin::User &user);
 WOLKANLIN_EXPORT QDataStream &operator<<(QDataStream &stream, const Wolkanlin::User &user);
 
 Q_DECLARE_OPERATORS_FOR_FLAGS(Wolkanlin::User::Capabilities)
+Q_DECLARE_OPERATORS_FOR_FLAGS(Wolkanlin::User::Fields)
 
 #endif // WOLKANLIN_USER_H
@@ -0,0 +1,390 @@
+/*
+ * SPDX-FileCopyrightText: (C) 2021 Matthias Fehring / www.huessenbergnetz.de
+ * SPDX-License-Identifier: LGPL-3.0-or-later
+ */
+
+#include "usercache_p.h"
+#include "snapshotwriter.h"
+#include "getuserdetailslistjob.h"
+#include "metricsregistry.h"
+#include "global.h"
+#include "logging.h"
+#include <QSaveFile>
+#include <QFileInfo>
+#include <QDir>
+
+using namespace Wolkanlin;
+
+UserCachePrivate::UserCachePrivate(UserCache *q)
+    : q_ptr(q)
+{
+
+}
+
+UserCachePrivate::~UserCachePrivate() = default;
+
+void UserCachePrivate::unmap()
+{
+    reader.reset();
+    if (map) {
+        file.unmap(map);
+        map = nullptr;
+    }
+    if (file.isOpen()) {
+        file.close();
+    }
+}
+
+void UserCachePrivate::onRevalidateSucceeded()
+{
+    Q_Q(UserCache);
+
+    const QVector<UserData> users = revalidateJob ? revalidateJob->users() : QVector<UserData>();
+    revalidateJob.clear();
+
+    // look up every received user via the id index, only records of received users are decoded
+    int added = 0;
+    int modified = 0;
+    int found = 0;
+    if (reader) {
+        for (const UserData &user : users) {
+            const int idx = reader->indexOf(user.id());
+            if (idx < 0) {
+                added++;
+            } else {
+                found++;
+                if (reader->user(idx).contentHash() != user.contentHash()) {
+                    modified++;
+                }
+            }
+        }
+    } else {
+        added = users.size();
+    }
+    const int removed = qMax(q->count() - found, 0);
+
+    if (!reader || added > 0 || removed > 0 || modified > 0) {
+        if (Q_UNLIKELY(!q->save(users))) {
+            //: Error message, %1 will be the file name of the user cache
+            //% "Failed to write the user cache file %1."
+            onRevalidateFailed(WriteError, qtTrId("libwolkanlin-error-write-user-cache").arg(file.fileName()));
+            return;
+        }
+    } else {
+        qCDebug(wlCore) << "User cache" << file.fileName() << "is up to date.";
+    }
+
+    setIsRevalidating(false);
+
+    Q_EMIT q->revalidated(added, removed, modified);
+}
+
+void UserCachePrivate::onRevalidateFailed(int errorCode, const QString &errorString)
+{
+    Q_Q(UserCache);
+
+    revalidateJob.clear();
+    qCWarning(wlCore) << "Failed to revalidate the user cache:" << errorString;
+
+    setIsRevalidating(false);
+
+    Q_EMIT q->revalidationFailed(errorCode, errorString);
+}
+
+void UserCachePrivate::setIsRevalidating(bool revalidating)
+{
+    if (isRevalidating != revalidating) {
+        Q_Q(UserCache);
+        isRevalidating = revalidating;
+        Q_EMIT q->isRevalidatingChanged(isRevalidating);
+    }
+}
+
+bool UserCachePrivate::mapFile()
+{
+    unmap();
+
+    if (Q_UNLIKELY(file.fileName().isEmpty())) {
+        qCWarning(wlCore) << "Can not open user cache without file name.";
+        return false;
+    }
+
+    if (!file.open(QIODevice::ReadOnly)) {
+        qCDebug(wlCore) << "Can not open user cache" << file.fileName() << ":" << file.errorString();
+        return false;
+    }
+
+    const qint64 size = file.size();
+    map = size > 0 ? file.map(0, size) : nullptr;
+    if (!map) {
+        qCWarning(wlCore) << "Can not map user cache" << file.fileName() << "into memory:" << file.errorString();
+        unmap();
+        return false;
+    }
+
+    reader.reset(new SnapshotReader(map, size));
+    if (!reader->isValid() || reader->content() != SnapshotReader::UserContent) {
+        qCWarning(wlCore) << "Invalid user cache" << file.fileName() << "- error:" << reader->error();
+        unmap();
+        return false;
+    }
+
+    qCDebug(wlCore) << "Opened user cache" << file.fileName() << "with" << reader->count() << "users created at" << reader->created();
+    return true;
+}
+
+void UserCachePrivate::updateMetricsHost()
+{
+    AbstractConfiguration *config = configuration ? configuration : Wolkanlin::defaultConfiguration();
+    metricsHost = config ? config->snapshot().host() : QString();
+}
+
+UserCache::UserCache(QObject *parent)
+    : QObject(parent), wl_ptr(new UserCachePrivate(this))
+{
+
+}
+
+UserCache::UserCache(const QString &fileName, QObject *parent)
+    : QObject(parent), wl_ptr(new UserCachePrivate(this))
+{
+    Q_D(UserCache);
+    d->file.setFileName(fileName);
+}
+
+UserCache::~UserCache()
+{
+    Q_D(UserCache);
+    if (d->revalidateJob) {
+        d->revalidateJob->kill(WJob::Quietly);
+    }
+    d->unmap();
+}
+
+QString UserCache::fileName() const
+{
+    Q_D(const UserCache);
+    return d->file.fileName();
+}
+
+void UserCache::setFileName(const QString &fileName)
+{
+    Q_D(UserCache);
+    if (d->file.fileName() != fileName) {
+        close();
+        qCDebug(wlCore) << "Changing user cache file name from" << d->file.fileName() << "to" << fileName;
+        d->file.setFileName(fileName);
+        Q_EMIT fileNameChanged(fileName);
+    }
+}
+
+AbstractConfiguration *UserCache::configuration() const
+{
+    Q_D(const UserCache);
+    return d->configuration;
+}
+
+void UserCache::setConfiguration(AbstractConfiguration *configuration)
+{
+    Q_D(UserCache);
+    if (d->configuration != configuration) {
+        qCDebug(wlCore) << "Changing configuration from" << d->configuration << "to" << configuration;
+        d->configuration = configuration;
+        d->updateMetricsHost();
+        Q_EMIT configurationChanged(d->configuration);
+    }
+}
+
+QNetworkAccessManager *UserCache::networkAccessManager() const
+{
+    Q_D(const UserCache);
+    return d->nam;
+}
+
+void UserCache::setNetworkAccessManager(QNetworkAccessManager *nam)
+{
+    Q_D(UserCache);
+    d->nam = nam;
+}
+
+bool UserCache::open()
+{
+    Q_D(UserCache);
+
+    d->updateMetricsHost();
+
+    const int oldCount = count();
+    const bool opened = d->mapFile();
+
+    if (oldCount != count()) {
+        Q_EMIT countChanged(count());
+    }
+
+    return opened;
+}
+
+void UserCache::close()
+{
+    Q_D(UserCache);
+
+    const int oldCount = count();
+    d->unmap();
+
+    if (oldCount != 0) {
+        Q_EMIT countChanged(0);
+    }
+}
+
+bool UserCache::isOpen() const
+{
+    Q_D(const UserCache);
+    return d->reader != nullptr;
+}
+
+int UserCache::count() const
+{
+    Q_D(const UserCache);
+    return d->reader ? d->reader->count() : 0;
+}
+
+QDateTime UserCache::created() const
+{
+    Q_D(const UserCache);
+    return d->reader ? d->reader->created() : QDateTime();
+}
+
+bool UserCache::contains(const QString &id) const
+{
+    Q_D(const UserCache);
+    return d->reader && d->reader->indexOf(id) >= 0;
+}
+
+UserData UserCache::user(const QString &id) const
+{
+    Q_D(const UserCache);
+    if (!d->reader) {
+        return UserData();
+    }
+
+    const int idx = d->reader->indexOf(id);
+    if (idx < 0) {
+        return UserData();
+    }
+
+    MetricsRegistry::global()->recordCacheHit(QStringLiteral("UserCache"), d->metricsHost);
+    return d->reader->user(idx);
+}
+
+QStringList UserCache::ids() const
+{
+    Q_D(const UserCache);
+    QStringList lst;
+    if (d->reader) {
+        const int cnt = d->reader->count();
+        lst.reserve(cnt);
+        for (int i = 0; i < cnt; ++i) {
+            lst.append(d->reader->userId(i));
+        }
+    }
+    return lst;
+}
+
+QVector<UserData> UserCache::users() const
+{
+    Q_D(const UserCache);
+    if (!d->reader) {
+        return QVector<UserData>();
+    }
+
+    MetricsRegistry::global()->recordCacheHit(QStringLiteral("UserCache"), d->metricsHost, d->reader->count());
+    return d->reader->users();
+}
+
+bool UserCache::save(const QVector<UserData> &users)
+{
+    Q_D(UserCache);
+
+    const QString fn = d->file.fileName();
+    if (Q_UNLIKELY(fn.isEmpty())) {
+        qCWarning(wlCore) << "Can not save user cache without file name.";
+        return false;
+    }
+
+    const QFileInfo fi(fn);
+    if (!fi.absoluteDir().exists() && !QDir().mkpath(fi.absolutePath())) {
+        qCWarning(wlCore) << "Can not create directory for user cache" << fn;
+        return false;
+    }
+
+    SnapshotWriter writer;
+    writer.setIdIndexEnabled(true);
+    writer.addUsers(users);
+
+    QSaveFile out(fn);
+    if (!out.open(QIODevice::WriteOnly)) {
+        qCWarning(wlCore) << "Can not open user cache" << fn << "for writing:" << out.errorString();
+        return false;
+    }
+
+    if (!writer.write(&out)) {
+        out.cancelWriting();
+        return false;
+    }
+
+    // some platforms can not replace a file that is still mapped into memory
+    const int oldCount = count();
+    d->unmap();
+
+    const bool committed = out.commit();
+    if (!committed) {
+        qCWarning(wlCore) << "Failed to write user cache" << fn << ":" << out.errorString();
+    } else {
+        qCDebug(wlCore) << "Saved" << users.size() << "users to user cache" << fn;
+    }
+
+    const bool opened = d->mapFile();
+
+    if (oldCount != count()) {
+        Q_EMIT countChanged(count());
+    }
+
+    return committed && opened;
+}
+
+bool UserCache::isRevalidating() const
+{
+    Q_D(const UserCache);
+    return d->isRevalidating;
+}
+
+void UserCache::revalidate()
+{
+    Q_D(UserCache);
+
+    if (d->revalidateJob) {
+        qCDebug(wlCore) << "User cache is already revalidating.";
+        return;
+    }
+
+    auto job = new GetUserDetailsListJob(this);
+    job->setFetchAllPages(true);
+    if (d->configuration) {
+        job->setConfiguration(d->configuration);
+    }
+    if (d->nam) {
+        job->setNetworkAccessManager(d->nam);
+    }
+
+    connect(job, &GetUserDetailsListJob::succeeded, this, [d](){
+        d->onRevalidateSucceeded();
+    });
+    connect(job, &GetUserDetailsListJob::failed, this, [d](int errorCode, const QString &errorString){
+        d->onRevalidateFailed(errorCode, errorString);
+    });
+
+    d->revalidateJob = job;
+    d->setIsRevalidating(true);
+    job->start();
+}
+
+#include "moc_usercache.cpp"
@@ -0,0 +1,285 @@
+/*
+ * SPDX-FileCopyrightText: (C) 2021 Matthias Fehring / www.huessenbergnetz.de
+ * SPDX-License-Identifier: LGPL-3.0-or-later
+ */
+
+#ifndef WOLKANLIN_USERCACHE_H
+#define WOLKANLIN_USERCACHE_H
+
+#include "wolkanlin_export.h"
+#include "userdata.h"
+#include <QObject>
+#include <QStringList>
+#include <QVector>
+#include <QDateTime>
+#include <memory>
+
+class QNetworkAccessManager;
+
+namespace Wolkanlin {
+
+class AbstractConfiguration;
+class UserCachePrivate;
+
+/*!
+ * \brief Persistent cache of the user directory that is memory mapped for instant lookups.
+ *
+ * %UserCache stores a snapshot of all users in a file using the format of SnapshotWriter
+ * together with an index of the user IDs. open() maps the file into memory via QFile::map()
+ * and only validates the header, so opening a cache is nearly free regardless of the number
+ * of cached users. user() finds a single user with a binary search on the index and only
+ * decodes the record of this user.
+ *
+ * To get the cache up to date, call revalidate() after opening it. It requests the complete
+ * user directory via GetUserDetailsListJob in the background, compares the result with the
+ * cached data and replaces the cache file if something has been changed. The cached data
+ * can be used while the revalidation is running.
+ *
+ * \code{.cpp}
+ * auto cache = new UserCache(QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + QLatin1String("/users.cache"), this);
+ * if (cache->open()) {
+ *     showUsers(cache->ids());
+ * }
+ * connect(cache, &UserCache::revalidated, this, [this, cache](){
+ *     showUsers(cache->ids());
+ * });
+ * cache->revalidate();
+ * \endcode
+ *
+ * \headerfile "" <Wolkanlin/UserCache>
+ */
+class WOLKANLIN_EXPORT UserCache : public QObject
+{
+    Q_OBJECT
+    /*!
+     * \brief Path to the cache file.
+     *
+     * Changing the file name closes the currently opened cache.
+     *
+     * \par Access methods
+     * \li QString fileName() const
+     * \li void setFileName(const QString &fileName)
+     *
+     * \par Notifier signal
+     * \li void fileNameChanged(const QString &fileName)
+     */
+    Q_PROPERTY(QString fileName READ fileName WRITE setFileName NOTIFY fileNameChanged)
+    /*!
+     * \brief Pointer to an object providing configuration data.
+     *
+     * The configuration will be used by revalidate(). If it is a \c nullptr, the global default
+     * configuration will be used. See Job::configuration.
+     *
+     * \par Access methods
+     * \li AbstractConfiguration *configuration() const
+     * \li void setConfiguration(AbstractConfiguration *configuration)
+     *
+     * \par Notifier signal
+     * \li void configurationChanged(Wolkanlin::AbstractConfiguration *configuration)
+     */
+    Q_PROPERTY(Wolkanlin::AbstractConfiguration *configuration READ configuration WRITE setConfiguration NOTIFY configurationChanged)
+    /*!
+     * \brief Number of users in the opened cache.
+     *
+     * \par Access methods
+     * \li int count() const
+     *
+     * \par Notifier signal
+     * \li void countChanged(int count)
+     */
+    Q_PROPERTY(int count READ count NOTIFY countChanged)
+    /*!
+     * \brief Returns \c true while revalidate() is requesting data from the remote server.
+     *
+     * \par Access methods
+     * \li bool isRevalidating() const
+     *
+     * \par Notifier signal
+     * \li void isRevalidatingChanged(bool isRevalidating)
+     */
+    Q_PROPERTY(bool isRevalidating READ isRevalidating NOTIFY isRevalidatingChanged)
+public:
+    /*!
+     * \brief Constructs a new %UserCache object with the given \a parent.
+     */
+    explicit UserCache(QObject *parent = nullptr);
+
+    /*!
+     * \brief Constructs a new %UserCache object for \a fileName with the given \a parent.
+     *
+     * The cache file is not opened automatically, use open().
+     */
+    explicit UserCache(const QString &fileName, QObject *parent = nullptr);
+
+    /*!
+     * \brief Closes the cache and destroys the %UserCache object.
+     */
+    ~UserCache() override;
+
+    /*!
+     * \brief Getter function for the \link UserCache::fileName fileName\endlink property.
+     * \sa setFileName(), fileNameChanged()
+     */
+    QString fileName() const;
+
+    /*!
+     * \brief Setter function for the \link UserCache::fileName fileName\endlink property.
+     * \sa fileName(), fileNameChanged()
+     */
+    void setFileName(const QString &fileName);
+
+    /*!
+     * \brief Getter function for the \link UserCache::configuration configuration\endlink property.
+     * \sa setConfiguration(), configurationChanged()
+     */
+    AbstractConfiguration *configuration() const;
+
+    /*!
+     * \brief Setter function for the \link UserCache::configuration configuration\endlink property.
+     * \sa configuration(), configurationChanged()
+     */
+    void setConfiguration(AbstractConfiguration *configuration);
+
+    /*!
+     * \brief Returns the network access manager used by revalidate().
+     *
+     * Returns a \c nullptr if no network access manager has been set.
+     */
+    QNetworkAccessManager *networkAccessManager() const;
+
+    /*!
+     * \brief Sets the network access manager used by revalidate() to \a nam.
+     */
+    void setNetworkAccessManager(QNetworkAccessManager *nam);
+
+    /*!
+     * \brief Opens and memory maps the cache file.
+     *
+     * Returns \c true on success. Returns \c false if the file does not exist, can not be mapped
+     * or does not contain a valid user snapshot.
+     */
+    bool open();
+
+    /*!
+     * \brief Unmaps and closes the cache file.
+     */
+    void close();
+
+    /*!
+     * \brief Returns \c true if the cache file is opened.
+     */
+    bool isOpen() const;
+
+    /*!
+     * \brief Getter function for the \link UserCache::count count\endlink property.
+     * \sa countChanged()
+     */
+    int count() const;
+
+    /*!
+     * \brief Returns the date and time in UTC the cache file has been written.
+     *
+     * Returns an invalid QDateTime if the cache is not opened.
+     */
+    QDateTime created() const;
+
+    /*!
+     * \brief Returns \c true if the cache contains a user with \a id.
+     */
+    bool contains(const QString &id) const;
+
+    /*!
+     * \brief Returns the data of the user identified by \a id.
+     *
+     * Only the record of this user will be decoded. Returns an empty UserData object if
+     * the cache does not contain a user with \a id. If the MetricsRegistry is enabled, a found
+     * user is recorded as cache hit of the \c UserCache endpoint on the configured host.
+     */
+    UserData user(const QString &id) const;
+
+    /*!
+     * \brief Returns the IDs of all cached users.
+     */
+    QStringList ids() const;
+
+    /*!
+     * \brief Returns the data of all cached users.
+     *
+     * If the MetricsRegistry is enabled, all returned users are recorded at once as cache hits
+     * of the \c UserCache endpoint on the configured host.
+     */
+    QVector<UserData> users() const;
+
+    /*!
+     * \brief Replaces the content of the cache file with \a users and opens it.
+     *
+     * The file is written atomically, so other processes will either see the old or the new
+     * content. Returns \c true on success, otherwise returns \c false.
+     */
+    bool save(const QVector<UserData> &users);
+
+    /*!
+     * \brief Getter function for the \link UserCache::isRevalidating isRevalidating\endlink property.
+     * \sa isRevalidatingChanged()
+     */
+    bool isRevalidating() const;
+
+    /*!
+     * \brief Requests the complete user directory from the remote server and updates the cache.
+     *
+     * If the data on the server differs from the cached data, the cache file will be replaced
+     * via save(). revalidated() is emitted afterwards. If the request fails, revalidationFailed()
+     * is emitted and the cache stays unchanged. If writing the new data fails, revalidationFailed()
+     * is emitted with the WriteError code. If a revalidation is already running, this does
+     * nothing.
+     */
+    Q_INVOKABLE void revalidate();
+
+Q_SIGNALS:
+    /*!
+     * \brief Notifier signal for the \link UserCache::fileName fileName\endlink property.
+     * \sa fileName(), setFileName()
+     */
+    void fileNameChanged(const QString &fileName);
+
+    /*!
+     * \brief Notifier signal for the \link UserCache::configuration configuration\endlink property.
+     * \sa configuration(), setConfiguration()
+     */
+    void configurationChanged(Wolkanlin::AbstractConfiguration *configuration);
+
+    /*!
+     * \brief Notifier signal for the \link UserCache::count count\endlink property.
+     * \sa count()
+     */
+    void countChanged(int count);
+
+    /*!
+     * \brief Notifier signal for the \link UserCache::isRevalidating isRevalidating\endlink property.
+     * \sa isRevalidating()
+     */
+    void isRevalidatingChanged(bool isRevalidating);
+
+    /*!
+     * \brief Emitted after revalidate() has been finished successfully.
+     *
+     * \a added, \a removed and \a modified contain the number of users that have been changed
+     * compared to the previously cached data.
+     */
+    void revalidated(int added, int removed, int modified);
+
+    /*!
+     * \brief Emitted if requesting the user directory in revalidate() has been failed.
+     */
+    void revalidationFailed(int errorCode, const QString &errorString);
+
+private:
+    const std::unique_ptr<UserCachePrivate> wl_ptr;
+
+    Q_DECLARE_PRIVATE_D(wl_ptr, UserCache)
+    Q_DISABLE_COPY(UserCache)
+};
+
+}
+
+#endif // WOLKANLIN_USERCACHE_H
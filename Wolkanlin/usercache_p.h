@@ -0,0 +1,49 @@
+/*
+ * SPDX-FileCopyrightText: (C) 2021 Matthias Fehring / www.huessenbergnetz.de
+ * SPDX-License-Identifier: LGPL-3.0-or-later
+ */
+
+#ifndef WOLKANLIN_USERCACHE_P_H
+#define WOLKANLIN_USERCACHE_P_H
+
+#include "usercache.h"
+#include "snapshotreader.h"
+#include <QFile>
+#include <QPointer>
+
+namespace Wolkanlin {
+
+class GetUserDetailsListJob;
+
+class UserCachePrivate
+{
+public:
+    explicit UserCachePrivate(UserCache *q);
+    ~UserCachePrivate();
+
+    bool mapFile();
+    void unmap();
+    void onRevalidateSucceeded();
+    void onRevalidateFailed(int errorCode, const QString &errorString);
+    void setIsRevalidating(bool revalidating);
+    void updateMetricsHost();
+
+    QFile file;
+    std::unique_ptr<SnapshotReader> reader;
+    QPointer<GetUserDetailsListJob> revalidateJob;
+    // resolved once, the lookups must not call the configuration
+    QString metricsHost;
+    uchar *map = nullptr;
+    QNetworkAccessManager *nam = nullptr;
+    AbstractConfiguration *configuration = nullptr;
+    UserCache *q_ptr = nullptr;
+    bool isRevalidating = false;
+
+private:
+    Q_DECLARE_PUBLIC(UserCache)
+    Q_DISABLE_COPY(UserCachePrivate)
+};
+
+}
+
+#endif // WOLKANLIN_USERCACHE_P_H
@@ -0,0 +1,688 @@
+/*
+ * SPDX-FileCopyrightText: (C) 2021 Matthias Fehring / www.huessenbergnetz.de
+ * SPDX-License-Identifier: LGPL-3.0-or-later
+ */
+
+#include "userdata_p.h"
+#include "logging.h"
+#include "stringpool.h"
+#include "cbor_p.h"
+#include <QDebug>
+#include <QDataStream>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonArray>
+#include <QJsonValue>
+#include <QtEndian>
+
+using namespace Wolkanlin;
+
+UserData::UserData() : d(new UserDataPrivate)
+{
+
+}
+
+UserData::UserData(const UserData &other) = default;
+UserData::UserData(UserData &&other) noexcept = default;
+UserData& UserData::operator=(const UserData &other) = default;
+UserData& UserData::operator=(UserData &&other) noexcept = default;
+UserData::~UserData() = default;
+
+bool UserData::operator==(const UserData &other) const noexcept
+{
+    if (d == other.d) {
+        return true;
+    }
+
+    return d->id == other.d->id &&
+            d->enabled == other.d->enabled &&
+            d->lastLogin == other.d->lastLogin &&
+            d->storageLocation == other.d->storageLocation &&
+            d->backend == other.d->backend &&
+            d->subadmin == other.d->subadmin &&
+            d->quota == other.d->quota &&
+            d->email == other.d->email &&
+            d->displayname == other.d->displayname &&
+            d->phone == other.d->phone &&
+            d->address == other.d->address &&
+            d->website == other.d->website &&
+            d->twitter == other.d->twitter &&
+            d->groups == other.d->groups &&
+            d->language == other.d->language &&
+            d->locale == other.d->locale &&
+            d->backendCapabilities == other.d->backendCapabilities;
+}
+
+bool UserData::isEmpty() const
+{
+    return d->id.isEmpty();
+}
+
+bool UserData::isEnabled() const
+{
+    return d->enabled;
+}
+
+void UserData::setEnabled(bool enabled)
+{
+    d->enabled = enabled;
+}
+
+QString UserData::storageLocation() const
+{
+    return d->storageLocation;
+}
+
+void UserData::setStorageLocation(const QString &storageLocation)
+{
+    d->storageLocation = storageLocation;
+}
+
+QString UserData::id() const
+{
+    return d->id;
+}
+
+void UserData::setId(const QString &id)
+{
+    d->id = id;
+}
+
+QDateTime UserData::lastLogin() const
+{
+    return d->lastLogin;
+}
+
+void UserData::setLastLogin(const QDateTime &lastLogin)
+{
+    d->lastLogin = lastLogin;
+}
+
+QString UserData::backend() const
+{
+    return d->backend;
+}
+
+void UserData::setBackend(const QString &backend)
+{
+    d->backend = backend;
+}
+
+QStringList UserData::subadmin() const
+{
+    return d->subadmin;
+}
+
+void UserData::setSubadmin(const QStringList &subadmin)
+{
+    d->subadmin = subadmin;
+}
+
+Quota UserData::quota() const
+{
+    return d->quota;
+}
+
+void UserData::setQuota(const Quota &quota)
+{
+    d->quota = quota;
+}
+
+QString UserData::email() const
+{
+    return d->email;
+}
+
+void UserData::setEmail(const QString &email)
+{
+    d->email = email;
+}
+
+QString UserData::displayname() const
+{
+    return d->displayname;
+}
+
+void UserData::setDisplayname(const QString &displayname)
+{
+    d->displayname = displayname;
+}
+
+QString UserData::phone() const
+{
+    return d->phone;
+}
+
+void UserData::setPhone(const QString &phone)
+{
+    d->phone = phone;
+}
+
+QString UserData::address() const
+{
+    return d->address;
+}
+
+void UserData::setAddress(const QString &address)
+{
+    d->address = address;
+}
+
+QUrl UserData::website() const
+{
+    return d->website;
+}
+
+void UserData::setWebsite(const QUrl &website)
+{
+    d->website = website;
+}
+
+QString UserData::twitter() const
+{
+    return d->twitter;
+}
+
+void UserData::setTwitter(const QString &twitter)
+{
+    d->twitter = twitter;
+}
+
+QStringList UserData::groups() const
+{
+    return d->groups;
+}
+
+void UserData::setGroups(const QStringList &groups)
+{
+    d->groups = groups;
+}
+
+QString UserData::language() const
+{
+    return d->language;
+}
+
+void UserData::setLanguage(const QString &language)
+{
+    d->language = language;
+}
+
+QString UserData::locale() const
+{
+    return d->locale;
+}
+
+void UserData::setLocale(const QString &locale)
+{
+    d->locale = locale;
+}
+
+User::Capabilities UserData::backendCapabilities() const
+{
+    return d->backendCapabilities;
+}
+
+void UserData::setBackendCapabilities(User::Capabilities backendCapabilities)
+{
+    d->backendCapabilities = backendCapabilities;
+}
+
+User::Fields UserData::diff(const UserData &other) const
+{
+    User::Fields fields;
+
+    if (d == other.d) {
+        return fields;
+    }
+
+    if (d->enabled != other.d->enabled) {
+        fields |= User::EnabledField;
+    }
+    if (d->storageLocation != other.d->storageLocation) {
+        fields |= User::StorageLocationField;
+    }
+    if (d->id != other.d->id) {
+        fields |= User::IdField;
+    }
+    if (d->lastLogin != other.d->lastLogin) {
+        fields |= User::LastLoginField;
+    }
+    if (d->backend != other.d->backend) {
+        fields |= User::BackendField;
+    }
+    if (d->subadmin != other.d->subadmin) {
+        fields |= User::SubadminField;
+    }
+    if (d->quota != other.d->quota) {
+        fields |= User::QuotaField;
+    }
+    if (d->email != other.d->email) {
+        fields |= User::EmailField;
+    }
+    if (d->displayname != other.d->displayname) {
+        fields |= User::DisplaynameField;
+    }
+    if (d->phone != other.d->phone) {
+        fields |= User::PhoneField;
+    }
+    if (d->address != other.d->address) {
+        fields |= User::AddressField;
+    }
+    if (d->website != other.d->website) {
+        fields |= User::WebsiteField;
+    }
+    if (d->twitter != other.d->twitter) {
+        fields |= User::TwitterField;
+    }
+    if (d->groups != other.d->groups) {
+        fields |= User::GroupsField;
+    }
+    if (d->language != other.d->language) {
+        fields |= User::LanguageField;
+    }
+    if (d->locale != other.d->locale) {
+        fields |= User::LocaleField;
+    }
+    if (d->backendCapabilities != other.d->backendCapabilities) {
+        fields |= User::BackendCapabilitiesField;
+    }
+
+    return fields;
+}
+
+quint64 UserData::contentHash() const
+{
+    // 64bit FNV-1a, every field is terminated so that moving content
+    // between adjacent fields changes the hash
+    quint64 h = Q_UINT64_C(14695981039346656037);
+
+    UserDataPrivate::hashInt(h, d->enabled ? 1 : 0);
+    UserDataPrivate::hashString(h, d->storageLocation);
+    UserDataPrivate::hashString(h, d->id);
+    UserDataPrivate::hashInt(h, d->lastLogin.isValid() ? d->lastLogin.toMSecsSinceEpoch() : -1);
+    UserDataPrivate::hashString(h, d->backend);
+    UserDataPrivate::hashStringList(h, d->subadmin);
+    UserDataPrivate::hashInt(h, d->quota.free());
+    UserDataPrivate::hashInt(h, d->quota.used());
+    UserDataPrivate::hashInt(h, d->quota.quota());
+    UserDataPrivate::hashInt(h, d->quota.total());
+    UserDataPrivate::hashString(h, d->email);
+    UserDataPrivate::hashString(h, d->displayname);
+    UserDataPrivate::hashString(h, d->phone);
+    UserDataPrivate::hashString(h, d->address);
+    UserDataPrivate::hashString(h, d->website.toString());
+    UserDataPrivate::hashString(h, d->twitter);
+    UserDataPrivate::hashStringList(h, d->groups);
+    UserDataPrivate::hashString(h, d->language);
+    UserDataPrivate::hashString(h, d->locale);
+    UserDataPrivate::hashInt(h, static_cast<qint64>(d->backendCapabilities));
+
+    return h;
+}
+
+QJsonObject UserData::toJson() const
+{
+    QJsonObject o;
+    if (Q_LIKELY(!isEmpty())) {
+        o.insert(QStringLiteral("enabled"), d->enabled);
+        o.insert(QStringLiteral("storageLocation"), d->storageLocation);
+        o.insert(QStringLiteral("id"), d->id);
+        o.insert(QStringLiteral("lastLogin"), d->lastLogin.toMSecsSinceEpoch());
+        o.insert(QStringLiteral("backend"), d->backend);
+        o.insert(QStringLiteral("subadmin"), QJsonArray::fromStringList(d->subadmin));
+        o.insert(QStringLiteral("quota"), d->quota.toJson());
+        o.insert(QStringLiteral("email"), d->email);
+        o.insert(QStringLiteral("displayname"), d->displayname);
+        o.insert(QStringLiteral("phone"), d->phone);
+        o.insert(QStringLiteral("address"), d->address);
+        o.insert(QStringLiteral("website"), d->website.toString());
+        o.insert(QStringLiteral("twitter"), d->twitter);
+        o.insert(QStringLiteral("groups"), QJsonArray::fromStringList(d->groups));
+        o.insert(QStringLiteral("language"), d->language);
+        o.insert(QStringLiteral("locale"), d->locale);
+        QJsonObject backendCaps;
+        backendCaps.insert(QStringLiteral("setDisplayName"), d->backendCapabilities.testFlag(User::CanSetDisplayName));
+        backendCaps.insert(QStringLiteral("setPassword"), d->backendCapabilities.testFlag(User::CanSetPassword));
+        o.insert(QStringLiteral("backendCapabilities"), backendCaps);
+    } else {
+        qCWarning(wlCore) << "Wolkanlin::UserData is empty, created QJsonObject will be empty, too.";
+    }
+    return o;
+}
+
+UserData UserData::fromJson(const QJsonDocument &json)
+{
+    if (json.isObject()) {
+        return UserData::fromJson(json.object());
+    } else {
+        qCWarning(wlCore) << "JSON document is not an object, creating empty Wolkanlin::UserData.";
+        return UserData();
+    }
+}
+
+UserData UserData::fromJson(const QJsonObject &json)
+{
+    return UserDataPrivate::fromJson(json, nullptr);
+}
+
+UserData UserData::fromJson(const QJsonObject &json, StringPool *pool)
+{
+    return UserDataPrivate::fromJson(json, pool);
+}
+
+UserData UserDataPrivate::fromJson(const QJsonObject &json, StringPool *pool)
+{
+    if (json.isEmpty()) {
+        qCWarning(wlCore) << "JSON object is empty, creating empty Wolkanlin::UserData object.";
+        return UserData();
+    }
+
+    QJsonObject data;
+
+    if (json.contains(QStringLiteral("data"))) {
+        data = json.value(QStringLiteral("data")).toObject();
+    } else if (json.contains(QStringLiteral("ocs"))) {
+        data = json.value(QStringLiteral("ocs")).toObject().value(QStringLiteral("data")).toObject();
+    } else {
+        data = json;
+    }
+
+    const QString id = data.value(QStringLiteral("id")).toString();
+
+    if (Q_UNLIKELY(id.isEmpty())) {
+        qCWarning(wlCore) << "JSON does not contain a valid user id, creating empty Wolkanlin::UserData object.";
+        return UserData();
+    }
+
+    UserData user;
+    auto d = user.d.data();
+    d->enabled = data.value(QStringLiteral("enabled")).toBool();
+    d->storageLocation = data.value(QStringLiteral("storageLocation")).toString();
+    d->id = id;
+    d->lastLogin = QDateTime::fromMSecsSinceEpoch(static_cast<qint64>(data.value(QStringLiteral("lastLogin")).toDouble()), Qt::UTC);
+    d->backend = jsonValueToString(data.value(QStringLiteral("backend")), pool);
+    d->subadmin = jsonArrayToStringList(data.value(QStringLiteral("subadmin")), pool);
+    d->quota = Quota::fromJson(data.value(QStringLiteral("quota")).toObject());
+    d->email = data.value(QStringLiteral("email")).toString();
+    d->displayname = data.value(QStringLiteral("displayname")).toString();
+    d->phone = data.value(QStringLiteral("phone")).toString();
+    d->address = data.value(QStringLiteral("address")).toString();
+    d->website = QUrl(data.value(QStringLiteral("website")).toString());
+    d->twitter = data.value(QStringLiteral("twitter")).toString();
+    d->groups = jsonArrayToStringList(data.value(QStringLiteral("groups")), pool);
+    d->language = jsonValueToString(data.value(QStringLiteral("language")), pool);
+    d->locale = jsonValueToString(data.value(QStringLiteral("locale")), pool);
+
+    const QJsonObject backendCaps = data.value(QStringLiteral("backendCapabilities")).toObject();
+    if (backendCaps.value(QStringLiteral("setDisplayName")).toBool()) {
+        d->backendCapabilities |= User::CanSetDisplayName;
+    }
+    if (backendCaps.value(QStringLiteral("setPassword")).toBool()) {
+        d->backendCapabilities |= User::CanSetPassword;
+    }
+
+    return user;
+}
+
+#if QT_VERSION >= QT_VERSION_CHECK(5, 12, 0)
+void UserData::toCbor(QCborStreamWriter &writer) const
+{
+    writer.startMap();
+    if (Q_LIKELY(!isEmpty())) {
+        Cbor::writeString(writer, Cbor::UserId, d->id);
+        Cbor::writeBool(writer, Cbor::UserEnabled, d->enabled);
+        Cbor::writeString(writer, Cbor::UserStorageLocation, d->storageLocation);
+        if (d->lastLogin.isValid()) {
+            Cbor::writeKey(writer, Cbor::UserLastLogin);
+            writer.append(d->lastLogin.toMSecsSinceEpoch());
+        }
+        Cbor::writeString(writer, Cbor::UserBackend, d->backend);
+        Cbor::writeStringList(writer, Cbor::UserSubadmin, d->subadmin);
+        if (!d->quota.isNull()) {
+            Cbor::writeKey(writer, Cbor::UserQuota);
+            d->quota.toCbor(writer);
+        }
+        Cbor::writeString(writer, Cbor::UserEmail, d->email);
+        Cbor::writeString(writer, Cbor::UserDisplayname, d->displayname);
+        Cbor::writeString(writer, Cbor::UserPhone, d->phone);
+        Cbor::writeString(writer, Cbor::UserAddress, d->address);
+        Cbor::writeString(writer, Cbor::UserWebsite, d->website.toString());
+        Cbor::writeString(writer, Cbor::UserTwitter, d->twitter);
+        Cbor::writeStringList(writer, Cbor::UserGroups, d->groups);
+        Cbor::writeString(writer, Cbor::UserLanguage, d->language);
+        Cbor::writeString(writer, Cbor::UserLocale, d->locale);
+        Cbor::writeInteger(writer, Cbor::UserBackendCapabilities, static_cast<quint32>(d->backendCapabilities));
+    } else {
+        qCWarning(wlCore) << "Wolkanlin::UserData is empty, created CBOR map will be empty, too.";
+    }
+    writer.endMap();
+}
+
+QByteArray UserData::toCbor() const
+{
+    QByteArray cbor;
+    QCborStreamWriter writer(&cbor);
+    toCbor(writer);
+    return cbor;
+}
+
+UserData UserData::fromCbor(QCborStreamReader &reader)
+{
+    if (Q_UNLIKELY(!reader.isMap() || !reader.enterContainer())) {
+        qCWarning(wlCore) << "CBOR data does not contain a map, creating empty Wolkanlin::UserData object.";
+        if (reader.lastError() == QCborError::NoError) {
+            reader.next();
+        }
+        return UserData();
+    }
+
+    UserData user;
+    auto d = user.d.data();
+
+    while (reader.lastError() == QCborError::NoError && reader.hasNext()) {
+        switch (Cbor::readKey(reader)) {
+        case Cbor::UserId:
+            d->id = Cbor::readString(reader);
+            break;
+        case Cbor::UserEnabled:
+            d->enabled = Cbor::readBool(reader);
+            break;
+        case Cbor::UserStorageLocation:
+            d->storageLocation = Cbor::readString(reader);
+            break;
+        case Cbor::UserLastLogin:
+            d->lastLogin = QDateTime::fromMSecsSinceEpoch(Cbor::readInteger(reader), Qt::UTC);
+            break;
+        case Cbor::UserBackend:
+            d->backend = Cbor::readString(reader);
+            break;
+        case Cbor::UserSubadmin:
+            d->subadmin = Cbor::readStringList(reader);
+            break;
+        case Cbor::UserQuota:
+            d->quota = Quota::fromCbor(reader);
+            break;
+        case Cbor::UserEmail:
+            d->email = Cbor::readString(reader);
+            break;
+        case Cbor::UserDisplayname:
+            d->displayname = Cbor::readString(reader);
+            break;
+        case Cbor::UserPhone:
+            d->phone = Cbor::readString(reader);
+            break;
+        case Cbor::UserAddress:
+            d->address = Cbor::readString(reader);
+            break;
+        case Cbor::UserWebsite:
+            d->website = QUrl(Cbor::readString(reader));
+            break;
+        case Cbor::UserTwitter:
+            d->twitter = Cbor::readString(reader);
+            break;
+        case Cbor::UserGroups:
+            d->groups = Cbor::readStringList(reader);
+            break;
+        case Cbor::UserLanguage:
+            d->language = Cbor::readString(reader);
+            break;
+        case Cbor::UserLocale:
+            d->locale = Cbor::readString(reader);
+            break;
+        case Cbor::UserBackendCapabilities:
+            d->backendCapabilities = User::Capabilities(static_cast<quint32>(Cbor::readInteger(reader)));
+            break;
+        default:
+            reader.next();
+            break;
+        }
+    }
+
+    if (Q_UNLIKELY(reader.lastError() != QCborError::NoError)) {
+        qCWarning(wlCore) << "Failed to read CBOR data, creating empty Wolkanlin::UserData object:" << reader.lastError().toString();
+        return UserData();
+    }
+
+    reader.leaveContainer();
+
+    if (Q_UNLIKELY(d->id.isEmpty())) {
+        qCWarning(wlCore) << "CBOR data does not contain a valid user id, creating empty Wolkanlin::UserData object.";
+        return UserData();
+    }
+
+    return user;
+}
+
+UserData UserData::fromCbor(const QByteArray &cbor)
+{
+    QCborStreamReader reader(cbor);
+    return UserData::fromCbor(reader);
+}
+#endif
+
+QStringList UserDataPrivate::jsonArrayToStringList(const QJsonArray &array, StringPool *pool)
+{
+    if (pool) {
+        return pool->intern(array);
+    }
+
+    QStringList list;
+    if (!array.empty()) {
+        list.reserve(array.size());
+        for (const QJsonValue &v : array) {
+            list << v.toString();
+        }
+    }
+    return list;
+}
+
+QStringList UserDataPrivate::jsonArrayToStringList(const QJsonValue &value, StringPool *pool)
+{
+    return jsonArrayToStringList(value.toArray(), pool);
+}
+
+QString UserDataPrivate::jsonValueToString(const QJsonValue &value, StringPool *pool)
+{
+    return pool ? pool->intern(value.toString()) : value.toString();
+}
+
+void UserDataPrivate::hashData(quint64 &hash, const char *data, int size)
+{
+    for (int i = 0; i < size; ++i) {
+        hash ^= static_cast<quint8>(data[i]);
+        hash *= Q_UINT64_C(1099511628211);
+    }
+}
+
+void UserDataPrivate::hashString(quint64 &hash, const QString &str)
+{
+    hashData(hash, reinterpret_cast<const char *>(str.constData()), str.size() * static_cast<int>(sizeof(QChar)));
+    hashInt(hash, str.size());
+}
+
+void UserDataPrivate::hashStringList(quint64 &hash, const QStringList &list)
+{
+    for (const QString &str : list) {
+        hashString(hash, str);
+    }
+    hashInt(hash, list.size());
+}
+
+void UserDataPrivate::hashInt(quint64 &hash, qint64 value)
+{
+    const qint64 le = qToLittleEndian(value);
+    hashData(hash, reinterpret_cast<const char *>(&le), static_cast<int>(sizeof(le)));
+}
+
+QDebug operator<<(QDebug dbg, const Wolkanlin::UserData &user)
+{
+    QDebugStateSaver saver(dbg);
+    dbg.nospace() << "Wolkanlin::UserData(";
+    dbg << "id: " << user.id();
+    dbg << ", enabled: " << user.isEnabled();
+    dbg << ", lastLogin: " << user.lastLogin();
+    dbg << ", storageLocation: " << user.storageLocation();
+    dbg << ", backend: " << user.backend();
+    dbg << ", subadmin: " << user.subadmin();
+    dbg << ", quota: " << user.quota();
+    dbg << ", email: " << user.email();
+    dbg << ", displayname: " << user.displayname();
+    dbg << ", phone: " << user.phone();
+    dbg << ", address: " << user.address();
+    dbg << ", website: " << user.website();
+    dbg << ", twitter: " << user.twitter();
+    dbg << ", groups: " << user.groups();
+    dbg << ", language: " << user.language();
+    dbg << ", locale: " << user.locale();
+    dbg << ", backendCapabilities: " << user.backendCapabilities();
+    dbg << ')';
+    return dbg.maybeSpace();
+}
+
+QDataStream &Wolkanlin::operator>>(QDataStream &stream, Wolkanlin::UserData &user)
+{
+    auto d = user.d.data();
+    stream >> d->id;
+    stream >> d->enabled;
+    stream >> d->lastLogin;
+    stream >> d->storageLocation;
+    stream >> d->backend;
+    stream >> d->subadmin;
+    stream >> d->quota;
+    stream >> d->email;
+    stream >> d->displayname;
+    stream >> d->phone;
+    stream >> d->address;
+    stream >> d->website;
+    stream >> d->twitter;
+    stream >> d->groups;
+    stream >> d->language;
+    stream >> d->locale;
+    stream >> d->backendCapabilities;
+    return stream;
+}
+
+QDataStream &operator<<(QDataStream &stream, const Wolkanlin::UserData &user)
+{
+    stream << user.id()
+           << user.isEnabled()
+           << user.lastLogin()
+           << user.storageLocation()
+           << user.backend()
+           << user.subadmin()
+           << user.quota()
+           << user.email()
+           << user.displayname()
+           << user.phone()
+           << user.address()
+           << user.website()
+           << user.twitter()
+           << user.groups()
+           << user.language()
+           << user.locale()
+           << user.backendCapabilities();
+    return stream;
+}
+
+#include "moc_userdata.cpp"
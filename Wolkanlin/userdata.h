@@ -0,0 +1,496 @@
+/*
+ * SPDX-FileCopyrightText: (C) 2021 Matthias Fehring / www.huessenbergnetz.de
+ * SPDX-License-Identifier: LGPL-3.0-or-later
+ */
+
+#ifndef WOLKANLIN_USERDATA_H
+#define WOLKANLIN_USERDATA_H
+
+#include "wolkanlin_export.h"
+#include "quota.h"
+#include "user.h"
+#include <QSharedDataPointer>
+#include <QDateTime>
+#include <QUrl>
+#include <QStringList>
+#include <QJsonObject>
+
+#if QT_VERSION >= QT_VERSION_CHECK(5, 12, 0)
+class QCborStreamWriter;
+class QCborStreamReader;
+#endif
+
+class QJsonDocument;
+
+namespace Wolkanlin {
+
+class UserDataPrivate;
+class StringPool;
+
+/*!
+ * \brief Lightweight implicitly shared value class storing information about a single user.
+ *
+ * %UserData stores the same information as User, but as a copy-on-write value type
+ * without QObject overhead. Copying a %UserData object is cheap and it can be stored
+ * by value in containers like QVector. Bulk APIs that return information about many
+ * users use this class, while User can be used for single users and QML bindings.
+ *
+ * See the <A href="classWolkanlin_1_1User.html#user-json-example">JSON representation example</A>
+ * of User to learn more about the JSON data used by fromJson() and toJson().
+ *
+ * \headerfile "" <Wolkanlin/UserData>
+ */
+class WOLKANLIN_EXPORT UserData
+{
+    Q_GADGET
+    /*!
+     * \brief Returns \c true if the user is enabled, otherwise returns \c false.
+     * \sa User::enabled
+     */
+    Q_PROPERTY(bool enabled READ isEnabled CONSTANT)
+    /*!
+     * \brief This property holds the storage location of the user’s data on the server.
+     * \sa User::storageLocation
+     */
+    Q_PROPERTY(QString storageLocation READ storageLocation CONSTANT)
+    /*!
+     * \brief This property holds the id/user name of the user.
+     * \sa User::id
+     */
+    Q_PROPERTY(QString id READ id CONSTANT)
+    /*!
+     * \brief This property holds the date and time the user logged in the last time.
+     * \sa User::lastLogin
+     */
+    Q_PROPERTY(QDateTime lastLogin READ lastLogin CONSTANT)
+    /*!
+     * \brief This property holds the backend the user is stored in.
+     * \sa User::backend
+     */
+    Q_PROPERTY(QString backend READ backend CONSTANT)
+    /*!
+     * \brief This property holds a list of groups the user is admin of.
+     * \sa User::subadmin
+     */
+    Q_PROPERTY(QStringList subadmin READ subadmin CONSTANT)
+    /*!
+     * \brief This property holds information about the user’s quota.
+     * \sa User::quota
+     */
+    Q_PROPERTY(Wolkanlin::Quota quota READ quota CONSTANT)
+    /*!
+     * \brief This property holds the user’s email address.
+     * \sa User::email
+     */
+    Q_PROPERTY(QString email READ email CONSTANT)
+    /*!
+     * \brief This property holds the user’s display name.
+     * \sa User::displayname
+     */
+    Q_PROPERTY(QString displayname READ displayname CONSTANT)
+    /*!
+     * \brief This property holds the user’s phone number.
+     * \sa User::phone
+     */
+    Q_PROPERTY(QString phone READ phone CONSTANT)
+    /*!
+     * \brief This property holds the user’s address.
+     * \sa User::address
+     */
+    Q_PROPERTY(QString address READ address CONSTANT)
+    /*!
+     * \brief This property holds the user’s website URL.
+     * \sa User::website
+     */
+    Q_PROPERTY(QUrl website READ website CONSTANT)
+    /*!
+     * \brief This property holds the user’s twitter user name.
+     * \sa User::twitter
+     */
+    Q_PROPERTY(QString twitter READ twitter CONSTANT)
+    /*!
+     * \brief This property holds a list of groups the user is member of.
+     * \sa User::groups
+     */
+    Q_PROPERTY(QStringList groups READ groups CONSTANT)
+    /*!
+     * \brief This property holds the language the user uses as BCP 47 language tag.
+     * \sa User::language
+     */
+    Q_PROPERTY(QString language READ language CONSTANT)
+    /*!
+     * \brief This property holds the locale scheme the user uses as BCP 47 language tag.
+     * \sa User::locale
+     */
+    Q_PROPERTY(QString locale READ locale CONSTANT)
+    /*!
+     * \brief This property holds the capabilities the user has on the backend.
+     * \sa User::backendCapabilities
+     */
+    Q_PROPERTY(Wolkanlin::User::Capabilities backendCapabilities READ backendCapabilities CONSTANT)
+public:
+    /*!
+     * \brief Constructs a new empty %UserData object.
+     *
+     * isEmpty() will return \c true.
+     */
+    UserData();
+    /*!
+     * \brief Constructs a copy of \a other.
+     */
+    UserData(const UserData &other);
+    /*!
+     * \brief Move-constructs a %UserData instance, making it point at the same object that \a other was pointing to.
+     */
+    UserData(UserData &&other) noexcept;
+    /*!
+     * \brief Destroys the %UserData object.
+     */
+    ~UserData();
+
+    /*!
+     * \brief Assigns \a other to this %UserData and returns a reference to this instance.
+     */
+    UserData &operator=(const UserData &other);
+    /*!
+     * \brief Move-assigns \a other to this %UserData instance.
+     */
+    UserData &operator=(UserData &&other) noexcept;
+
+    /*!
+     * \brief Returns \c true if \a this and \a other have the same content; otherwise returns \c false.
+     */
+    bool operator==(const UserData &other) const noexcept;
+    /*!
+     * \brief Returns \c true if \a this and \a other have not the same content; otherwise returns \c false.
+     */
+    inline bool operator!=(const UserData &other) const noexcept { return !operator==(other); }
+
+    /*!
+     * \brief Swaps this %UserData with \a other.
+     */
+    void swap(UserData &other) noexcept { d.swap(other.d); }
+
+    /*!
+     * \brief Returns \c true if the %UserData object is empty, otherwise returns \c false.
+     *
+     * The %UserData object is empty, if no \link UserData::id id\endlink has been set.
+     */
+    bool isEmpty() const;
+
+    /*!
+     * \brief Getter function for the \link UserData::enabled enabled\endlink property.
+     * \sa setEnabled()
+     */
+    bool isEnabled() const;
+    /*!
+     * \brief Setter function for the \link UserData::enabled enabled\endlink property.
+     * \sa isEnabled()
+     */
+    void setEnabled(bool enabled);
+
+    /*!
+     * \brief Getter function for the \link UserData::storageLocation storageLocation\endlink property.
+     * \sa setStorageLocation()
+     */
+    QString storageLocation() const;
+    /*!
+     * \brief Setter function for the \link UserData::storageLocation storageLocation\endlink property.
+     * \sa storageLocation()
+     */
+    void setStorageLocation(const QString &storageLocation);
+
+    /*!
+     * \brief Getter function for the \link UserData::id id\endlink property.
+     * \sa setId()
+     */
+    QString id() const;
+    /*!
+     * \brief Setter function for the \link UserData::id id\endlink property.
+     * \sa id()
+     */
+    void setId(const QString &id);
+
+    /*!
+     * \brief Getter function for the \link UserData::lastLogin lastLogin\endlink property.
+     * \sa setLastLogin()
+     */
+    QDateTime lastLogin() const;
+    /*!
+     * \brief Setter function for the \link UserData::lastLogin lastLogin\endlink property.
+     * \sa lastLogin()
+     */
+    void setLastLogin(const QDateTime &lastLogin);
+
+    /*!
+     * \brief Getter function for the \link UserData::backend backend\endlink property.
+     * \sa setBackend()
+     */
+    QString backend() const;
+    /*!
+     * \brief Setter function for the \link UserData::backend backend\endlink property.
+     * \sa backend()
+     */
+    void setBackend(const QString &backend);
+
+    /*!
+     * \brief Getter function for the \link UserData::subadmin subadmin\endlink property.
+     * \sa setSubadmin()
+     */
+    QStringList subadmin() const;
+    /*!
+     * \brief Setter function for the \link UserData::subadmin subadmin\endlink property.
+     * \sa subadmin()
+     */
+    void setSubadmin(const QStringList &subadmin);
+
+    /*!
+     * \brief Getter function for the \link UserData::quota quota\endlink property.
+     * \sa setQuota()
+     */
+    Quota quota() const;
+    /*!
+     * \brief Setter function for the \link UserData::quota quota\endlink property.
+     * \sa quota()
+     */
+    void setQuota(const Quota &quota);
+
+    /*!
+     * \brief Getter function for the \link UserData::email email\endlink property.
+     * \sa setEmail()
+     */
+    QString email() const;
+    /*!
+     * \brief Setter function for the \link UserData::email email\endlink property.
+     * \sa email()
+     */
+    void setEmail(const QString &email);
+
+    /*!
+     * \brief Getter function for the \link UserData::displayname displayname\endlink property.
+     * \sa setDisplayname()
+     */
+    QString displayname() const;
+    /*!
+     * \brief Setter function for the \link UserData::displayname displayname\endlink property.
+     * \sa displayname()
+     */
+    void setDisplayname(const QString &displayname);
+
+    /*!
+     * \brief Getter function for the \link UserData::phone phone\endlink property.
+     * \sa setPhone()
+     */
+    QString phone() const;
+    /*!
+     * \brief Setter function for the \link UserData::phone phone\endlink property.
+     * \sa phone()
+     */
+    void setPhone(const QString &phone);
+
+    /*!
+     * \brief Getter function for the \link UserData::address address\endlink property.
+     * \sa setAddress()
+     */
+    QString address() const;
+    /*!
+     * \brief Setter function for the \link UserData::address address\endlink property.
+     * \sa address()
+     */
+    void setAddress(const QString &address);
+
+    /*!
+     * \brief Getter function for the \link UserData::website website\endlink property.
+     * \sa setWebsite()
+     */
+    QUrl website() const;
+    /*!
+     * \brief Setter function for the \link UserData::website website\endlink property.
+     * \sa website()
+     */
+    void setWebsite(const QUrl &website);
+
+    /*!
+     * \brief Getter function for the \link UserData::twitter twitter\endlink property.
+     * \sa setTwitter()
+     */
+    QString twitter() const;
+    /*!
+     * \brief Setter function for the \link UserData::twitter twitter\endlink property.
+     * \sa twitter()
+     */
+    void setTwitter(const QString &twitter);
+
+    /*!
+     * \brief Getter function for the \link UserData::groups groups\endlink property.
+     * \sa setGroups()
+     */
+    QStringList groups() const;
+    /*!
+     * \brief Setter function for the \link UserData::groups groups\endlink property.
+     * \sa groups()
+     */
+    void setGroups(const QStringList &groups);
+
+    /*!
+     * \brief Getter function for the \link UserData::language language\endlink property.
+     * \sa setLanguage()
+     */
+    QString language() const;
+    /*!
+     * \brief Setter function for the \link UserData::language language\endlink property.
+     * \sa language()
+     */
+    void setLanguage(const QString &language);
+
+    /*!
+     * \brief Getter function for the \link UserData::locale locale\endlink property.
+     * \sa setLocale()
+     */
+    QString locale() const;
+    /*!
+     * \brief Setter function for the \link UserData::locale locale\endlink property.
+     * \sa locale()
+     */
+    void setLocale(const QString &locale);
+
+    /*!
+     * \brief Getter function for the \link UserData::backendCapabilities backendCapabilities\endlink property.
+     * \sa setBackendCapabilities()
+     */
+    User::Capabilities backendCapabilities() const;
+    /*!
+     * \brief Setter function for the \link UserData::backendCapabilities backendCapabilities\endlink property.
+     * \sa backendCapabilities()
+     */
+    void setBackendCapabilities(User::Capabilities backendCapabilities);
+
+    /*!
+     * \brief Returns the fields whose values differ between \a this and \a other.
+     *
+     * Returns User::NoField if both objects have the same content.
+     */
+    User::Fields diff(const UserData &other) const;
+
+    /*!
+     * \brief Returns a 64bit hash value over the content of all fields.
+     *
+     * Objects with the same content have the same hash value. The value is stable across
+     * different runs of the application and can be used to detect changed user data
+     * without comparing every field.
+     */
+    quint64 contentHash() const;
+
+    /*!
+     * \brief Converts the %UserData object to a JSON object where the property names are the keys.
+     *
+     * The created JSON object is the same as created by User::toJson(). Only the content of the
+     * “data“ key will be created. If isEmpty() returns \c true, an empty JSON object will be returned.
+     *
+     * \sa fromJson()
+     */
+    QJsonObject toJson() const;
+
+    /*!
+     * \brief Creates a new %UserData object from \a json.
+     *
+     * Will convert the \a json into a JSON object at first. If the \a json is empty or does not
+     * contain an object, an empty %UserData object will be returned.
+     */
+    static UserData fromJson(const QJsonDocument &json);
+    /*!
+     * \brief Creates a new %UserData object from \a json.
+     *
+     * Can read from the root object as well as from the “ocs“ and “data“ keys content.
+     * If \a json is empty or does not contain a valid user id, an empty %UserData object
+     * will be returned.
+     */
+    static UserData fromJson(const QJsonObject &json);
+    /*!
+     * \brief Creates a new %UserData object from \a json and interns repeated values in \a pool.
+     *
+     * Works like fromJson(const QJsonObject &json) but the values of the \link UserData::groups groups\endlink,
+     * \link UserData::subadmin subadmin\endlink, \link UserData::backend backend\endlink,
+     * \link UserData::language language\endlink and \link UserData::locale locale\endlink properties
+     * are interned in the string \a pool, so that equal values of different users share their data.
+     * If \a pool is a \c nullptr, no values will be interned. Use StringPool::global() explicitly
+     * to share the values across the whole application.
+     *
+     * This is used by the bulk decoding paths that create data for many users.
+     */
+    static UserData fromJson(const QJsonObject &json, StringPool *pool);
+
+#if QT_VERSION >= QT_VERSION_CHECK(5, 12, 0) || defined(W_DOXYGEN)
+    /*!
+     * \brief Writes the content of the %UserData object as CBOR map to \a writer.
+     *
+     * The map uses small integer keys instead of the property names and omits empty values,
+     * so the encoding is much smaller and faster to process than the JSON representation.
+     * It is intended to hand over user data to other processes or to store it in caches.
+     * If isEmpty() returns \c true, an empty map will be written.
+     *
+     * Available since Qt 5.12.
+     *
+     * \sa fromCbor()
+     */
+    void toCbor(QCborStreamWriter &writer) const;
+
+    /*!
+     * \brief Returns the content of the %UserData object encoded as CBOR.
+     *
+     * \overload
+     */
+    QByteArray toCbor() const;
+
+    /*!
+     * \brief Reads a %UserData object from the CBOR map at the current position of \a reader.
+     *
+     * The \a reader will be advanced to the element following the map, so multiple users can be
+     * read from the same stream. Unknown keys are skipped. If the map can not be read or does not
+     * contain a valid user id, an empty %UserData object will be returned.
+     *
+     * Available since Qt 5.12.
+     *
+     * \sa toCbor()
+     */
+    static UserData fromCbor(QCborStreamReader &reader);
+
+    /*!
+     * \brief Creates a new %UserData object from the \a cbor encoded data.
+     *
+     * \overload
+     */
+    static UserData fromCbor(const QByteArray &cbor);
+#endif
+
+private:
+    QSharedDataPointer<UserDataPrivate> d;
+
+    friend class UserDataPrivate;
+    friend QDataStream &operator>>(QDataStream &stream, UserData &user);
+};
+
+/*!
+ * \relates Wolkanlin::UserData
+ * \brief Reads a %UserData from \a stream and stores it to \a user.
+ */
+WOLKANLIN_EXPORT QDataStream &operator>>(QDataStream &stream, UserData &user);
+
+}
+
+Q_DECLARE_METATYPE(Wolkanlin::UserData)
+Q_DECLARE_TYPEINFO(Wolkanlin::UserData, Q_MOVABLE_TYPE);
+
+/*!
+ * \relates Wolkanlin::UserData
+ * \brief Writes the \a user to the \a dbg stream and returns the stream.
+ */
+WOLKANLIN_EXPORT QDebug operator<<(QDebug dbg, const Wolkanlin::UserData &user);
+
+/*!
+ * \relates Wolkanlin::UserData
+ * \brief Writes \a user to the \a stream.
+ */
+WOLKANLIN_EXPORT QDataStream &operator<<(QDataStream &stream, const Wolkanlin::UserData &user);
+
+#endif // WOLKANLIN_USERDATA_H
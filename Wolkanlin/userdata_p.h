@@ -0,0 +1,55 @@
+/*
+ * SPDX-FileCopyrightText: (C) 2021 Matthias Fehring / www.huessenbergnetz.de
+ * SPDX-License-Identifier: LGPL-3.0-or-later
+ */
+
+#ifndef WOLKANLIN_USERDATA_P_H
+#define WOLKANLIN_USERDATA_P_H
+
+#include "userdata.h"
+#include <QSharedData>
+
+class QJsonArray;
+class QJsonValue;
+
+namespace Wolkanlin {
+
+class StringPool;
+
+class UserDataPrivate : public QSharedData
+{
+public:
+    static UserData fromJson(const QJsonObject &json, StringPool *pool);
+
+    static QStringList jsonArrayToStringList(const QJsonArray &array, StringPool *pool = nullptr);
+    static QStringList jsonArrayToStringList(const QJsonValue &value, StringPool *pool = nullptr);
+
+    static QString jsonValueToString(const QJsonValue &value, StringPool *pool = nullptr);
+
+    static void hashData(quint64 &hash, const char *data, int size);
+    static void hashString(quint64 &hash, const QString &str);
+    static void hashStringList(quint64 &hash, const QStringList &list);
+    static void hashInt(quint64 &hash, qint64 value);
+
+    Quota quota;
+    QString storageLocation;
+    QString id;
+    QString backend;
+    QString email;
+    QString displayname;
+    QString phone;
+    QString address;
+    QString twitter;
+    QString language;
+    QString locale;
+    QStringList subadmin;
+    QStringList groups;
+    QUrl website;
+    QDateTime lastLogin;
+    User::Capabilities backendCapabilities;
+    bool enabled = false;
+};
+
+}
+
+#endif // WOLKANLIN_USERDATA_P_H
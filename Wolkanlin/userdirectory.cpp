@@ -0,0 +1,247 @@
+/*
+ * SPDX-FileCopyrightText: (C) 2021 Matthias Fehring / www.huessenbergnetz.de
+ * SPDX-License-Identifier: LGPL-3.0-or-later
+ */
+
+#include "userdirectory_p.h"
+#include "getuserdetailslistjob.h"
+#include "logging.h"
+
+using namespace Wolkanlin;
+
+UserDirectoryPrivate::UserDirectoryPrivate(UserDirectory *q)
+    : q_ptr(q)
+{
+
+}
+
+UserDirectoryPrivate::~UserDirectoryPrivate() = default;
+
+void UserDirectoryPrivate::onRefreshSucceeded()
+{
+    Q_Q(UserDirectory);
+
+    const QVector<UserData> users = refreshJob ? refreshJob->users() : QVector<UserData>();
+    refreshJob.clear();
+
+    q->sync(users);
+
+    setIsRefreshing(false);
+}
+
+void UserDirectoryPrivate::onRefreshFailed(int errorCode, const QString &errorString)
+{
+    Q_Q(UserDirectory);
+
+    refreshJob.clear();
+    qCWarning(wlCore) << "Failed to refresh the user directory:" << errorString;
+
+    Q_EMIT q->refreshFailed(errorCode, errorString);
+
+    setIsRefreshing(false);
+}
+
+void UserDirectoryPrivate::setIsRefreshing(bool refreshing)
+{
+    if (isRefreshing != refreshing) {
+        Q_Q(UserDirectory);
+        isRefreshing = refreshing;
+        Q_EMIT q->isRefreshingChanged(isRefreshing);
+    }
+}
+
+UserDirectory::UserDirectory(QObject *parent)
+    : QObject(parent), wl_ptr(new UserDirectoryPrivate(this))
+{
+
+}
+
+UserDirectory::~UserDirectory()
+{
+    Q_D(UserDirectory);
+    if (d->refreshJob) {
+        d->refreshJob->kill(WJob::Quietly);
+    }
+}
+
+AbstractConfiguration *UserDirectory::configuration() const
+{
+    Q_D(const UserDirectory);
+    return d->configuration;
+}
+
+void UserDirectory::setConfiguration(AbstractConfiguration *configuration)
+{
+    Q_D(UserDirectory);
+    if (d->configuration != configuration) {
+        qCDebug(wlCore) << "Changing configuration from" << d->configuration << "to" << configuration;
+        d->configuration = configuration;
+        Q_EMIT configurationChanged(d->configuration);
+    }
+}
+
+int UserDirectory::count() const
+{
+    Q_D(const UserDirectory);
+    return d->snapshot.size();
+}
+
+bool UserDirectory::isRefreshing() const
+{
+    Q_D(const UserDirectory);
+    return d->isRefreshing;
+}
+
+QNetworkAccessManager *UserDirectory::networkAccessManager() const
+{
+    Q_D(const UserDirectory);
+    return d->nam;
+}
+
+void UserDirectory::setNetworkAccessManager(QNetworkAccessManager *nam)
+{
+    Q_D(UserDirectory);
+    d->nam = nam;
+}
+
+bool UserDirectory::contains(const QString &id) const
+{
+    Q_D(const UserDirectory);
+    return d->snapshot.contains(id);
+}
+
+UserData UserDirectory::user(const QString &id) const
+{
+    Q_D(const UserDirectory);
+    return d->snapshot.value(id).user;
+}
+
+QStringList UserDirectory::ids() const
+{
+    Q_D(const UserDirectory);
+    return d->snapshot.keys();
+}
+
+UserDirectory::Delta UserDirectory::lastDelta() const
+{
+    Q_D(const UserDirectory);
+    return d->lastDelta;
+}
+
+UserDirectory::Delta UserDirectory::sync(const QVector<UserData> &users)
+{
+    Q_D(UserDirectory);
+
+    Delta delta;
+    const int oldCount = d->snapshot.size();
+
+    // entries found in the new list are moved out of the old snapshot,
+    // everything that is left over afterwards has been removed
+    QHash<QString, UserDirectoryPrivate::Entry> newSnapshot;
+    newSnapshot.reserve(users.size());
+
+    for (const UserData &user : users) {
+        const QString id = user.id();
+        if (Q_UNLIKELY(id.isEmpty() || newSnapshot.contains(id))) {
+            continue;
+        }
+
+        UserDirectoryPrivate::Entry entry;
+        entry.user = user;
+        entry.hash = user.contentHash();
+
+        auto it = d->snapshot.find(id);
+        if (it == d->snapshot.end()) {
+            delta.added.append(user);
+        } else {
+            if (it->hash != entry.hash) {
+                Modification mod;
+                mod.previous = it->user;
+                mod.current = user;
+                mod.fields = user.diff(it->user);
+                delta.modified.append(mod);
+            } else {
+                // keep the already stored data to not hold two equal copies
+                entry.user = it->user;
+            }
+            d->snapshot.erase(it);
+        }
+
+        newSnapshot.insert(id, entry);
+    }
+
+    delta.removed.reserve(d->snapshot.size());
+    for (auto it = d->snapshot.cbegin(); it != d->snapshot.cend(); ++it) {
+        delta.removed.append(it->user);
+    }
+
+    d->snapshot.swap(newSnapshot);
+    d->lastDelta = delta;
+
+    qCDebug(wlCore) << "Synchronized user directory:" << delta.added.size() << "added," << delta.removed.size() << "removed," << delta.modified.size() << "modified," << d->snapshot.size() << "total";
+
+    for (const UserData &user : delta.added) {
+        Q_EMIT userAdded(user);
+    }
+
+    for (const UserData &user : delta.removed) {
+        Q_EMIT userRemoved(user);
+    }
+
+    for (const Modification &mod : delta.modified) {
+        Q_EMIT userModified(mod.current, mod.previous, mod.fields);
+    }
+
+    if (oldCount != d->snapshot.size()) {
+        Q_EMIT countChanged(d->snapshot.size());
+    }
+
+    Q_EMIT synchronized(delta.added.size(), delta.removed.size(), delta.modified.size());
+
+    return delta;
+}
+
+void UserDirectory::refresh()
+{
+    Q_D(UserDirectory);
+
+    if (d->refreshJob) {
+        qCDebug(wlCore) << "User directory is already refreshing.";
+        return;
+    }
+
+    auto job = new GetUserDetailsListJob(this);
+    job->setFetchAllPages(true);
+    if (d->configuration) {
+        job->setConfiguration(d->configuration);
+    }
+    if (d->nam) {
+        job->setNetworkAccessManager(d->nam);
+    }
+
+    connect(job, &GetUserDetailsListJob::succeeded, this, [d](){
+        d->onRefreshSucceeded();
+    });
+    connect(job, &GetUserDetailsListJob::failed, this, [d](int errorCode, const QString &errorString){
+        d->onRefreshFailed(errorCode, errorString);
+    });
+
+    d->refreshJob = job;
+    d->setIsRefreshing(true);
+    job->start();
+}
+
+void UserDirectory::clear()
+{
+    Q_D(UserDirectory);
+
+    const int oldCount = d->snapshot.size();
+    d->snapshot.clear();
+    d->lastDelta = Delta();
+
+    if (oldCount != 0) {
+        Q_EMIT countChanged(0);
+    }
+}
+
+#include "moc_userdirectory.cpp"
@@ -0,0 +1,249 @@
+/*
+ * SPDX-FileCopyrightText: (C) 2021 Matthias Fehring / www.huessenbergnetz.de
+ * SPDX-License-Identifier: LGPL-3.0-or-later
+ */
+
+#ifndef WOLKANLIN_USERDIRECTORY_H
+#define WOLKANLIN_USERDIRECTORY_H
+
+#include "wolkanlin_export.h"
+#include "user.h"
+#include "userdata.h"
+#include <QObject>
+#include <QStringList>
+#include <QVector>
+#include <memory>
+
+class QNetworkAccessManager;
+
+namespace Wolkanlin {
+
+class AbstractConfiguration;
+class UserDirectoryPrivate;
+
+/*!
+ * \brief Mirrors the user directory of the remote server and reports only the changes.
+ *
+ * %UserDirectory keeps a snapshot of the users keyed by their ID together with a content hash
+ * per user, see UserData::contentHash(). Every call to sync() compares the new list of users
+ * with the snapshot and emits userAdded(), userRemoved() and userModified() only for the users
+ * that have been changed. For modified users the changed fields are reported, see UserData::diff().
+ * Unchanged users are only checked by their hash, so consumers of the signals only have to do
+ * work that is proportional to the number of changes.
+ *
+ * refresh() requests the complete user directory via GetUserDetailsListJob and synchronizes
+ * the snapshot with the result.
+ *
+ * \headerfile "" <Wolkanlin/UserDirectory>
+ */
+class WOLKANLIN_EXPORT UserDirectory : public QObject
+{
+    Q_OBJECT
+    /*!
+     * \brief Pointer to an object providing configuration data.
+     *
+     * The configuration will be used by refresh(). If it is a \c nullptr, the global default
+     * configuration will be used. See Job::configuration.
+     *
+     * \par Access methods
+     * \li AbstractConfiguration *configuration() const
+     * \li void setConfiguration(AbstractConfiguration *configuration)
+     *
+     * \par Notifier signal
+     * \li void configurationChanged(Wolkanlin::AbstractConfiguration *configuration)
+     */
+    Q_PROPERTY(Wolkanlin::AbstractConfiguration *configuration READ configuration WRITE setConfiguration NOTIFY configurationChanged)
+    /*!
+     * \brief Number of users in the current snapshot.
+     *
+     * \par Access methods
+     * \li int count() const
+     *
+     * \par Notifier signal
+     * \li void countChanged(int count)
+     */
+    Q_PROPERTY(int count READ count NOTIFY countChanged)
+    /*!
+     * \brief Returns \c true while refresh() is requesting data from the remote server.
+     *
+     * \par Access methods
+     * \li bool isRefreshing() const
+     *
+     * \par Notifier signal
+     * \li void isRefreshingChanged(bool isRefreshing)
+     */
+    Q_PROPERTY(bool isRefreshing READ isRefreshing NOTIFY isRefreshingChanged)
+public:
+    /*!
+     * \brief Describes the modification of a single user.
+     */
+    struct Modification {
+        UserData previous;                      /**< The user data in the previous snapshot. */
+        UserData current;                       /**< The user data in the current snapshot. */
+        User::Fields fields = User::NoField;    /**< The fields that have been changed. */
+    };
+
+    /*!
+     * \brief Describes the changes between two snapshots.
+     */
+    struct Delta {
+        QVector<UserData> added;                /**< Users that are new in the current snapshot. */
+        QVector<UserData> removed;              /**< Users that are not part of the current snapshot anymore. */
+        QVector<Modification> modified;         /**< Users whose data has been changed. */
+
+        /*!
+         * \brief Returns \c true if nothing has been changed.
+         */
+        bool isEmpty() const { return added.empty() && removed.empty() && modified.empty(); }
+    };
+
+    /*!
+     * \brief Constructs a new empty %UserDirectory object with the given \a parent.
+     */
+    explicit UserDirectory(QObject *parent = nullptr);
+
+    /*!
+     * \brief Destroys the %UserDirectory object.
+     */
+    ~UserDirectory() override;
+
+    /*!
+     * \brief Getter function for the \link UserDirectory::configuration configuration\endlink property.
+     * \sa setConfiguration(), configurationChanged()
+     */
+    AbstractConfiguration *configuration() const;
+
+    /*!
+     * \brief Setter function for the \link UserDirectory::configuration configuration\endlink property.
+     * \sa configuration(), configurationChanged()
+     */
+    void setConfiguration(AbstractConfiguration *configuration);
+
+    /*!
+     * \brief Getter function for the \link UserDirectory::count count\endlink property.
+     * \sa countChanged()
+     */
+    int count() const;
+
+    /*!
+     * \brief Getter function for the \link UserDirectory::isRefreshing isRefreshing\endlink property.
+     * \sa isRefreshingChanged()
+     */
+    bool isRefreshing() const;
+
+    /*!
+     * \brief Returns the network access manager used by refresh().
+     * \sa setNetworkAccessManager()
+     */
+    QNetworkAccessManager *networkAccessManager() const;
+
+    /*!
+     * \brief Sets the network access manager \a nam used by refresh().
+     *
+     * See Job::setNetworkAccessManager(). The directory does not take ownership of \a nam.
+     *
+     * \sa networkAccessManager()
+     */
+    void setNetworkAccessManager(QNetworkAccessManager *nam);
+
+    /*!
+     * \brief Returns \c true if the snapshot contains a user with \a id.
+     */
+    bool contains(const QString &id) const;
+
+    /*!
+     * \brief Returns the data of the user with \a id from the snapshot.
+     *
+     * Returns an empty UserData object if the snapshot does not contain a user with \a id.
+     */
+    UserData user(const QString &id) const;
+
+    /*!
+     * \brief Returns the IDs of all users in the snapshot in no particular order.
+     */
+    QStringList ids() const;
+
+    /*!
+     * \brief Returns the changes performed by the last call to sync().
+     */
+    Delta lastDelta() const;
+
+    /*!
+     * \brief Synchronizes the snapshot with the complete list of \a users.
+     *
+     * Users that are not part of \a users will be removed from the snapshot. Users without
+     * a valid ID will be ignored. Emits the change signals for every added, removed and modified
+     * user and synchronized() at the end. Returns the changes, that are also available via lastDelta().
+     */
+    Delta sync(const QVector<UserData> &users);
+
+    /*!
+     * \brief Requests the complete user directory from the remote server and synchronizes the snapshot.
+     *
+     * Does nothing if a refresh is already running. On success sync() will be called with
+     * the received users, otherwise refreshFailed() will be emitted and the snapshot will not
+     * be changed.
+     */
+    Q_INVOKABLE void refresh();
+
+    /*!
+     * \brief Removes all users from the snapshot without emitting the change signals.
+     */
+    Q_INVOKABLE void clear();
+
+Q_SIGNALS:
+    /*!
+     * \brief Notifier signal for the \link UserDirectory::configuration configuration\endlink property.
+     * \sa setConfiguration(), configuration()
+     */
+    void configurationChanged(Wolkanlin::AbstractConfiguration *configuration);
+
+    /*!
+     * \brief Notifier signal for the \link UserDirectory::count count\endlink property.
+     * \sa count()
+     */
+    void countChanged(int count);
+
+    /*!
+     * \brief Notifier signal for the \link UserDirectory::isRefreshing isRefreshing\endlink property.
+     * \sa isRefreshing()
+     */
+    void isRefreshingChanged(bool isRefreshing);
+
+    /*!
+     * \brief Emitted by sync() for every \a user that is new in the snapshot.
+     */
+    void userAdded(const Wolkanlin::UserData &user);
+
+    /*!
+     * \brief Emitted by sync() for every \a user that has been removed from the snapshot.
+     */
+    void userRemoved(const Wolkanlin::UserData &user);
+
+    /*!
+     * \brief Emitted by sync() for every user whose data has been changed from \a previous to \a current.
+     *
+     * \a fields contains the fields that have been changed.
+     */
+    void userModified(const Wolkanlin::UserData &current, const Wolkanlin::UserData &previous, Wolkanlin::User::Fields fields);
+
+    /*!
+     * \brief Emitted at the end of every sync() with the number of \a added, \a removed and \a modified users.
+     */
+    void synchronized(int added, int removed, int modified);
+
+    /*!
+     * \brief Emitted if refresh() failed with \a errorCode and \a errorString.
+     */
+    void refreshFailed(int errorCode, const QString &errorString);
+
+private:
+    const std::unique_ptr<UserDirectoryPrivate> wl_ptr;
+
+    Q_DECLARE_PRIVATE_D(wl_ptr, UserDirectory)
+    Q_DISABLE_COPY(UserDirectory)
+};
+
+}
+
+#endif // WOLKANLIN_USERDIRECTORY_H
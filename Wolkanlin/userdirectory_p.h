@@ -0,0 +1,47 @@
+/*
+ * SPDX-FileCopyrightText: (C) 2021 Matthias Fehring / www.huessenbergnetz.de
+ * SPDX-License-Identifier: LGPL-3.0-or-later
+ */
+
+#ifndef WOLKANLIN_USERDIRECTORY_P_H
+#define WOLKANLIN_USERDIRECTORY_P_H
+
+#include "userdirectory.h"
+#include <QHash>
+#include <QPointer>
+
+namespace Wolkanlin {
+
+class GetUserDetailsListJob;
+
+class UserDirectoryPrivate
+{
+public:
+    struct Entry {
+        UserData user;
+        quint64 hash = 0;
+    };
+
+    explicit UserDirectoryPrivate(UserDirectory *q);
+    ~UserDirectoryPrivate();
+
+    void onRefreshSucceeded();
+    void onRefreshFailed(int errorCode, const QString &errorString);
+    void setIsRefreshing(bool refreshing);
+
+    QHash<QString, Entry> snapshot;
+    UserDirectory::Delta lastDelta;
+    QPointer<GetUserDetailsListJob> refreshJob;
+    QNetworkAccessManager *nam = nullptr;
+    AbstractConfiguration *configuration = nullptr;
+    UserDirectory *q_ptr = nullptr;
+    bool isRefreshing = false;
+
+private:
+    Q_DECLARE_PUBLIC(UserDirectory)
+    Q_DISABLE_COPY(UserDirectoryPrivate)
+};
+
+}
+
+#endif // WOLKANLIN_USERDIRECTORY_P_H
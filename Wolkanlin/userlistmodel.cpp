@@ -0,0 +1,645 @@
+/*
+ * SPDX-FileCopyrightText: (C) 2021 Matthias Fehring / www.huessenbergnetz.de
+ * SPDX-License-Identifier: LGPL-3.0-or-later
+ */
+
+#include "userlistmodel_p.h"
+#include "getuserjob.h"
+#include "getuserlistjob.h"
+#include "global.h"
+#include "logging.h"
+#include "stringpool.h"
+#include <QTimer>
+#include <QNetworkAccessManager>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <algorithm>
+
+using namespace Wolkanlin;
+
+UserListModelPrivate::UserListModelPrivate(UserListModel *q)
+    : q_ptr(q)
+{
+    dispatchTimer = new QTimer(q);
+    dispatchTimer->setSingleShot(true);
+    dispatchTimer->setInterval(0);
+    QObject::connect(dispatchTimer, &QTimer::timeout, q, [this](){
+        dispatch();
+    });
+}
+
+UserListModelPrivate::~UserListModelPrivate() = default;
+
+void UserListModelPrivate::requestRow(int row)
+{
+    if (row < 0 || row >= rows.size() || states.at(row) != RowState::NotLoaded) {
+        return;
+    }
+
+    states[row] = RowState::Queued;
+    queue.append(row);
+
+    const int lastPrefetchRow = qMin(rows.size() - 1, row + prefetchWindow);
+    for (int r = row + 1; r <= lastPrefetchRow; ++r) {
+        if (states.at(r) == RowState::NotLoaded) {
+            states[r] = RowState::Queued;
+            queue.append(r);
+        }
+    }
+
+    scheduleDispatch();
+}
+
+void UserListModelPrivate::retryFailedRows()
+{
+    // failed rows are requested again when they become visible the next time
+    auto it = failedRows.begin();
+    while (it != failedRows.end()) {
+        if (!isInWindow(*it)) {
+            states[*it] = RowState::NotLoaded;
+            it = failedRows.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+void UserListModelPrivate::scheduleDispatch()
+{
+    if (!dispatchTimer->isActive()) {
+        dispatchTimer->start();
+    }
+}
+
+void UserListModelPrivate::dispatch()
+{
+    if (visibleFirst > -1) {
+        const QList<int> runningRows = runningJobs.keys();
+        for (int row : runningRows) {
+            if (!isInWindow(row)) {
+                cancelJob(row);
+            }
+        }
+
+        auto outside = std::remove_if(queue.begin(), queue.end(), [this](int row) {
+            if (!isInWindow(row)) {
+                states[row] = RowState::NotLoaded;
+                return true;
+            }
+            return false;
+        });
+        queue.erase(outside, queue.end());
+
+        // rows that are currently visible are requested first
+        const int first = visibleFirst;
+        const int last = visibleLast;
+        std::stable_sort(queue.begin(), queue.end(), [first, last](int a, int b) {
+            const int distA = a < first ? first - a : (a > last ? a - last : 0);
+            const int distB = b < first ? first - b : (b > last ? b - last : 0);
+            return distA < distB;
+        });
+    }
+
+    while (runningJobs.size() < maxConcurrentRequests && !queue.empty()) {
+        startJob(queue.takeFirst());
+    }
+
+    updateIsLoading();
+}
+
+void UserListModelPrivate::startJob(int row)
+{
+    Q_Q(UserListModel);
+
+    states[row] = RowState::Loading;
+
+    auto job = new GetUserJob(ids.at(row), q);
+    if (configuration) {
+        job->setConfiguration(configuration);
+    }
+    job->setNetworkAccessManager(networkAccessManager());
+
+    const quint64 gen = generation;
+    QObject::connect(job, &GetUserJob::succeeded, q, [this, row, gen](const QJsonDocument &json){
+        onUserReceived(row, gen, json);
+    });
+    QObject::connect(job, &GetUserJob::failed, q, [this, row, gen](){
+        onUserFailed(row, gen);
+    });
+
+    runningJobs.insert(row, job);
+    qCDebug(wlCore) << "Requesting details for user" << ids.at(row) << "at row" << row;
+    job->start();
+}
+
+void UserListModelPrivate::cancelJob(int row)
+{
+    GetUserJob *job = runningJobs.take(row);
+    if (job) {
+        qCDebug(wlCore) << "Canceling request for user at row" << row;
+        job->kill(WJob::Quietly);
+        states[row] = RowState::NotLoaded;
+    }
+}
+
+void UserListModelPrivate::cancelAll()
+{
+    if (!runningJobs.empty()) {
+        qCDebug(wlCore) << "Canceling" << runningJobs.size() << "running requests";
+        const QList<GetUserJob*> jobs = runningJobs.values();
+        for (GetUserJob *job : jobs) {
+            job->kill(WJob::Quietly);
+        }
+        runningJobs.clear();
+    }
+
+    for (auto it = queue.cbegin(); it != queue.cend(); ++it) {
+        states[*it] = RowState::NotLoaded;
+    }
+    queue.clear();
+
+    if (listJob) {
+        listJob->kill(WJob::Quietly);
+        listJob.clear();
+    }
+}
+
+void UserListModelPrivate::reset(const QStringList &newIds)
+{
+    Q_Q(UserListModel);
+
+    cancelAll();
+
+    const int oldCount = ids.size();
+    pendingIdPages.clear();
+    nextIdOffset = 0;
+
+    q->beginResetModel();
+    ids = newIds;
+    rows.clear();
+    states.clear();
+    failedRows.clear();
+    generation++;
+    visibleFirst = -1;
+    visibleLast = -1;
+    q->endResetModel();
+
+    if (oldCount != ids.size()) {
+        Q_EMIT q->totalCountChanged(ids.size());
+    }
+
+    updateIsLoading();
+}
+
+bool UserListModelPrivate::isInWindow(int row) const
+{
+    if (visibleFirst < 0) {
+        return true;
+    }
+
+    return row >= (visibleFirst - prefetchWindow) && row <= (visibleLast + prefetchWindow);
+}
+
+void UserListModelPrivate::onUserReceived(int row, quint64 gen, const QJsonDocument &json)
+{
+    if (gen != generation) {
+        return;
+    }
+
+    Q_Q(UserListModel);
+
+    runningJobs.remove(row);
+
+    const UserData user = UserData::fromJson(json.object(), StringPool::global());
+    rows[row] = user;
+    if (user.isEmpty()) {
+        states[row] = RowState::Failed;
+        failedRows.insert(row);
+    } else {
+        states[row] = RowState::Loaded;
+    }
+
+    const QModelIndex idx = q->index(row);
+    Q_EMIT q->dataChanged(idx, idx);
+
+    scheduleDispatch();
+}
+
+void UserListModelPrivate::onUserFailed(int row, quint64 gen)
+{
+    if (gen != generation) {
+        return;
+    }
+
+    Q_Q(UserListModel);
+
+    runningJobs.remove(row);
+    states[row] = RowState::Failed;
+    failedRows.insert(row);
+    qCWarning(wlCore) << "Failed to request details for user" << ids.at(row);
+
+    const QModelIndex idx = q->index(row);
+    Q_EMIT q->dataChanged(idx, idx, {UserListModel::IsLoadedRole});
+
+    scheduleDispatch();
+}
+
+void UserListModelPrivate::onIdsReceived(const QStringList &pageIds, int offset)
+{
+    Q_Q(UserListModel);
+
+    // pages might arrive out of order, only append the contiguous part
+    pendingIdPages.insert(offset, pageIds);
+
+    const int oldCount = ids.size();
+
+    auto it = pendingIdPages.begin();
+    while (it != pendingIdPages.end() && it.key() == nextIdOffset) {
+        ids.append(it.value());
+        nextIdOffset += it.value().size();
+        it = pendingIdPages.erase(it);
+    }
+
+    if (ids.size() != oldCount) {
+        qCDebug(wlCore) << "Received" << (ids.size() - oldCount) << "user IDs, having" << ids.size() << "IDs now";
+        Q_EMIT q->totalCountChanged(ids.size());
+        if (rows.empty()) {
+            // make the first rows available without waiting for the view to call fetchMore()
+            q->fetchMore(QModelIndex());
+        }
+    }
+}
+
+void UserListModelPrivate::onUserListReceived()
+{
+    listJob.clear();
+    pendingIdPages.clear();
+    updateIsLoading();
+}
+
+void UserListModelPrivate::updateIsLoading()
+{
+    const bool loading = !listJob.isNull() || !runningJobs.empty() || !queue.empty();
+    if (isLoading != loading) {
+        Q_Q(UserListModel);
+        isLoading = loading;
+        Q_EMIT q->isLoadingChanged(isLoading);
+    }
+}
+
+QNetworkAccessManager *UserListModelPrivate::networkAccessManager()
+{
+    if (nam) {
+        return nam;
+    }
+
+    QNetworkAccessManager *defNam = Wolkanlin::defaultNetworkAccessManager();
+    if (defNam) {
+        return defNam;
+    }
+
+    if (!ownNam) {
+        Q_Q(UserListModel);
+        ownNam = new QNetworkAccessManager(q);
+        qCDebug(wlCore) << "Using default created" << ownNam;
+    }
+
+    return ownNam;
+}
+
+UserListModel::UserListModel(QObject *parent)
+    : QAbstractListModel(parent), wl_ptr(new UserListModelPrivate(this))
+{
+
+}
+
+UserListModel::~UserListModel()
+{
+    Q_D(UserListModel);
+    d->cancelAll();
+}
+
+int UserListModel::rowCount(const QModelIndex &parent) const
+{
+    if (parent.isValid()) {
+        return 0;
+    }
+
+    Q_D(const UserListModel);
+    return d->rows.size();
+}
+
+QVariant UserListModel::data(const QModelIndex &index, int role) const
+{
+    QVariant var;
+
+    Q_D(const UserListModel);
+
+    if (!index.isValid() || index.row() < 0 || index.row() >= d->rows.size()) {
+        return var;
+    }
+
+    const int row = index.row();
+
+    const UserData &user = d->rows.at(row);
+
+    switch (role) {
+    case Qt::DisplayRole:
+        if (!user.displayname().isEmpty()) {
+            var.setValue(user.displayname());
+        } else {
+            var.setValue(d->ids.at(row));
+        }
+        break;
+    case IdRole:
+        var.setValue(d->ids.at(row));
+        break;
+    case EnabledRole:
+        var.setValue(user.isEnabled());
+        break;
+    case StorageLocationRole:
+        var.setValue(user.storageLocation());
+        break;
+    case LastLoginRole:
+        var.setValue(user.lastLogin());
+        break;
+    case BackendRole:
+        var.setValue(user.backend());
+        break;
+    case SubadminRole:
+        var.setValue(user.subadmin());
+        break;
+    case QuotaRole:
+        var.setValue(user.quota());
+        break;
+    case EmailRole:
+        var.setValue(user.email());
+        break;
+    case DisplaynameRole:
+        var.setValue(user.displayname());
+        break;
+    case PhoneRole:
+        var.setValue(user.phone());
+        break;
+    case AddressRole:
+        var.setValue(user.address());
+        break;
+    case WebsiteRole:
+        var.setValue(user.website());
+        break;
+    case TwitterRole:
+        var.setValue(user.twitter());
+        break;
+    case GroupsRole:
+        var.setValue(user.groups());
+        break;
+    case LanguageRole:
+        var.setValue(user.language());
+        break;
+    case LocaleRole:
+        var.setValue(user.locale());
+        break;
+    case BackendCapabilitiesRole:
+        var.setValue(user.backendCapabilities());
+        break;
+    case IsLoadedRole:
+        var.setValue(d->states.at(row) == UserListModelPrivate::RowState::Loaded);
+        break;
+    case UserDataRole:
+        var.setValue(user);
+        break;
+    default:
+        break;
+    }
+
+    return var;
+}
+
+QHash<int, QByteArray> UserListModel::roleNames() const
+{
+    QHash<int, QByteArray> roles = QAbstractListModel::roleNames();
+    roles.insert(IdRole, QByteArrayLiteral("id"));
+    roles.insert(EnabledRole, QByteArrayLiteral("enabled"));
+    roles.insert(StorageLocationRole, QByteArrayLiteral("storageLocation"));
+    roles.insert(LastLoginRole, QByteArrayLiteral("lastLogin"));
+    roles.insert(BackendRole, QByteArrayLiteral("backend"));
+    roles.insert(SubadminRole, QByteArrayLiteral("subadmin"));
+    roles.insert(QuotaRole, QByteArrayLiteral("quota"));
+    roles.insert(EmailRole, QByteArrayLiteral("email"));
+    roles.insert(DisplaynameRole, QByteArrayLiteral("displayname"));
+    roles.insert(PhoneRole, QByteArrayLiteral("phone"));
+    roles.insert(AddressRole, QByteArrayLiteral("address"));
+    roles.insert(WebsiteRole, QByteArrayLiteral("website"));
+    roles.insert(TwitterRole, QByteArrayLiteral("twitter"));
+    roles.insert(GroupsRole, QByteArrayLiteral("groups"));
+    roles.insert(LanguageRole, QByteArrayLiteral("language"));
+    roles.insert(LocaleRole, QByteArrayLiteral("locale"));
+    roles.insert(BackendCapabilitiesRole, QByteArrayLiteral("backendCapabilities"));
+    roles.insert(IsLoadedRole, QByteArrayLiteral("isLoaded"));
+    roles.insert(UserDataRole, QByteArrayLiteral("userData"));
+    return roles;
+}
+
+bool UserListModel::canFetchMore(const QModelIndex &parent) const
+{
+    if (parent.isValid()) {
+        return false;
+    }
+
+    Q_D(const UserListModel);
+    return d->rows.size() < d->ids.size();
+}
+
+void UserListModel::fetchMore(const QModelIndex &parent)
+{
+    if (parent.isValid()) {
+        return;
+    }
+
+    Q_D(UserListModel);
+
+    const int remaining = d->ids.size() - d->rows.size();
+    if (remaining <= 0) {
+        return;
+    }
+
+    const int first = d->rows.size();
+    const int count = qMin(remaining, d->pageSize);
+
+    qCDebug(wlCore) << "Adding" << count << "rows to the user list model";
+
+    beginInsertRows(QModelIndex(), first, first + count - 1);
+    d->rows.resize(first + count);
+    d->states.resize(first + count);
+    endInsertRows();
+
+    // without a visible range all new rows are requested, otherwise only the ones near the visible rows
+    for (int row = first; row < first + count; ++row) {
+        if (d->isInWindow(row) && d->states.at(row) == UserListModelPrivate::RowState::NotLoaded) {
+            d->states[row] = UserListModelPrivate::RowState::Queued;
+            d->queue.append(row);
+        }
+    }
+
+    d->scheduleDispatch();
+}
+
+void UserListModel::load()
+{
+    Q_D(UserListModel);
+
+    d->reset(QStringList());
+
+    auto job = new GetUserListJob(this);
+    if (d->configuration) {
+        job->setConfiguration(d->configuration);
+    }
+    job->setNetworkAccessManager(d->networkAccessManager());
+    job->setFetchAllPages(true);
+    job->setMaxConcurrentPages(qMax(d->maxConcurrentRequests / 2, 1));
+
+    connect(job, &GetUserListJob::idsReceived, this, [d](const QStringList &ids, int offset){
+        d->onIdsReceived(ids, offset);
+    });
+    connect(job, &GetUserListJob::succeeded, this, [d](){
+        d->onUserListReceived();
+    });
+    connect(job, &GetUserListJob::failed, this, [this, d](int error, const QString &errorString){
+        d->listJob.clear();
+        d->updateIsLoading();
+        Q_EMIT failed(error, errorString);
+    });
+
+    d->listJob = job;
+    d->updateIsLoading();
+    job->start();
+}
+
+void UserListModel::setUserIds(const QStringList &ids)
+{
+    Q_D(UserListModel);
+    d->reset(ids);
+}
+
+void UserListModel::setVisibleRange(int first, int last)
+{
+    Q_D(UserListModel);
+
+    if (first > last) {
+        std::swap(first, last);
+    }
+
+    d->visibleFirst = qMax(first, 0);
+    d->visibleLast = qMin(last, d->rows.size() - 1);
+
+    d->retryFailedRows();
+
+    for (int row = d->visibleFirst; row <= d->visibleLast; ++row) {
+        d->requestRow(row);
+    }
+
+    d->scheduleDispatch();
+}
+
+UserData UserListModel::userData(int row) const
+{
+    Q_D(const UserListModel);
+    if (row < 0 || row >= d->rows.size()) {
+        return UserData();
+    }
+    return d->rows.at(row);
+}
+
+QNetworkAccessManager *UserListModel::networkAccessManager() const
+{
+    Q_D(const UserListModel);
+    return d->nam ? d->nam : d->ownNam;
+}
+
+void UserListModel::setNetworkAccessManager(QNetworkAccessManager *nam)
+{
+    Q_D(UserListModel);
+    d->nam = nam;
+}
+
+AbstractConfiguration *UserListModel::configuration() const
+{
+    Q_D(const UserListModel);
+    return d->configuration;
+}
+
+void UserListModel::setConfiguration(AbstractConfiguration *configuration)
+{
+    Q_D(UserListModel);
+    if (d->configuration != configuration) {
+        qCDebug(wlCore) << "Changing configuration from" << d->configuration << "to" << configuration;
+        d->configuration = configuration;
+        Q_EMIT configurationChanged(d->configuration);
+    }
+}
+
+int UserListModel::pageSize() const
+{
+    Q_D(const UserListModel);
+    return d->pageSize;
+}
+
+void UserListModel::setPageSize(int pageSize)
+{
+    Q_D(UserListModel);
+    pageSize = qMax(pageSize, 1);
+    if (d->pageSize != pageSize) {
+        qCDebug(wlCore) << "Changing pageSize from" << d->pageSize << "to" << pageSize;
+        d->pageSize = pageSize;
+        Q_EMIT pageSizeChanged(d->pageSize);
+    }
+}
+
+int UserListModel::prefetchWindow() const
+{
+    Q_D(const UserListModel);
+    return d->prefetchWindow;
+}
+
+void UserListModel::setPrefetchWindow(int prefetchWindow)
+{
+    Q_D(UserListModel);
+    prefetchWindow = qMax(prefetchWindow, 0);
+    if (d->prefetchWindow != prefetchWindow) {
+        qCDebug(wlCore) << "Changing prefetchWindow from" << d->prefetchWindow << "to" << prefetchWindow;
+        d->prefetchWindow = prefetchWindow;
+        Q_EMIT prefetchWindowChanged(d->prefetchWindow);
+    }
+}
+
+int UserListModel::maxConcurrentRequests() const
+{
+    Q_D(const UserListModel);
+    return d->maxConcurrentRequests;
+}
+
+void UserListModel::setMaxConcurrentRequests(int maxConcurrentRequests)
+{
+    Q_D(UserListModel);
+    maxConcurrentRequests = qMax(maxConcurrentRequests, 1);
+    if (d->maxConcurrentRequests != maxConcurrentRequests) {
+        qCDebug(wlCore) << "Changing maxConcurrentRequests from" << d->maxConcurrentRequests << "to" << maxConcurrentRequests;
+        d->maxConcurrentRequests = maxConcurrentRequests;
+        Q_EMIT maxConcurrentRequestsChanged(d->maxConcurrentRequests);
+        d->scheduleDispatch();
+    }
+}
+
+int UserListModel::totalCount() const
+{
+    Q_D(const UserListModel);
+    return d->ids.size();
+}
+
+bool UserListModel::isLoading() const
+{
+    Q_D(const UserListModel);
+    return d->isLoading;
+}
+
+#include "moc_userlistmodel.cpp"
@@ -0,0 +1,358 @@
+/*
+ * SPDX-FileCopyrightText: (C) 2021 Matthias Fehring / www.huessenbergnetz.de
+ * SPDX-License-Identifier: LGPL-3.0-or-later
+ */
+
+#ifndef WOLKANLIN_USERLISTMODEL_H
+#define WOLKANLIN_USERLISTMODEL_H
+
+#include "wolkanlin_export.h"
+#include <QAbstractListModel>
+#include <QStringList>
+#include <memory>
+
+class QNetworkAccessManager;
+
+namespace Wolkanlin {
+
+class AbstractConfiguration;
+class UserData;
+class UserListModelPrivate;
+
+/*!
+ * \brief List model providing information about the users on the remote server.
+ *
+ * The model loads the list of user IDs in concurrently requested pages via GetUserListJob
+ * when calling load(). IDs are added as soon as their page has been received. The model exposes
+ * the rows incrementally via canFetchMore() and fetchMore() in steps of
+ * \link UserListModel::pageSize pageSize\endlink rows. User details are only requested via
+ * GetUserJob for rows that are reported as visible via setVisibleRange(), together with the
+ * following \link UserListModel::prefetchWindow prefetchWindow\endlink rows. Until a visible
+ * range has been set, the details of all rows added by fetchMore() are requested. Not more than
+ * \link UserListModel::maxConcurrentRequests maxConcurrentRequests\endlink requests
+ * are performed at the same time, all of them using the same network access manager.
+ *
+ * Views should report the currently visible rows via setVisibleRange(). Pending and running
+ * requests for rows that are outside of the visible range extended by the prefetch window
+ * will be canceled. Until the details for a row have been loaded, only the IdRole and the
+ * Qt::DisplayRole, that falls back to the ID, will return useful data. Querying the data()
+ * never starts a request. Rows whose request failed will be requested again after they
+ * have left the visible range and become visible again.
+ *
+ * The model can handle huge user directories, because only the IDs and the data for
+ * the rows that have been visible are stored.
+ *
+ * \headerfile "" <Wolkanlin/UserListModel>
+ */
+class WOLKANLIN_EXPORT UserListModel : public QAbstractListModel
+{
+    Q_OBJECT
+    /*!
+     * \brief Pointer to an object providing configuration data.
+     *
+     * The configuration will be set on all jobs created by the model. If it is a \c nullptr,
+     * the global default configuration will be used. See Job::configuration.
+     *
+     * \par Access methods
+     * \li AbstractConfiguration *configuration() const
+     * \li void setConfiguration(AbstractConfiguration *configuration)
+     *
+     * \par Notifier signal
+     * \li void configurationChanged(Wolkanlin::AbstractConfiguration *configuration)
+     */
+    Q_PROPERTY(Wolkanlin::AbstractConfiguration *configuration READ configuration WRITE setConfiguration NOTIFY configurationChanged)
+    /*!
+     * \brief Number of rows that will be added by a call to fetchMore().
+     *
+     * Default value: \c 100
+     *
+     * \par Access methods
+     * \li int pageSize() const
+     * \li void setPageSize(int pageSize)
+     *
+     * \par Notifier signal
+     * \li void pageSizeChanged(int pageSize)
+     */
+    Q_PROPERTY(int pageSize READ pageSize WRITE setPageSize NOTIFY pageSizeChanged)
+    /*!
+     * \brief Number of rows around the visible rows whose details will be requested in advance.
+     *
+     * Default value: \c 50
+     *
+     * \par Access methods
+     * \li int prefetchWindow() const
+     * \li void setPrefetchWindow(int prefetchWindow)
+     *
+     * \par Notifier signal
+     * \li void prefetchWindowChanged(int prefetchWindow)
+     */
+    Q_PROPERTY(int prefetchWindow READ prefetchWindow WRITE setPrefetchWindow NOTIFY prefetchWindowChanged)
+    /*!
+     * \brief Maximum number of user detail requests that will be performed at the same time.
+     *
+     * Default value: \c 6
+     *
+     * \par Access methods
+     * \li int maxConcurrentRequests() const
+     * \li void setMaxConcurrentRequests(int maxConcurrentRequests)
+     *
+     * \par Notifier signal
+     * \li void maxConcurrentRequestsChanged(int maxConcurrentRequests)
+     */
+    Q_PROPERTY(int maxConcurrentRequests READ maxConcurrentRequests WRITE setMaxConcurrentRequests NOTIFY maxConcurrentRequestsChanged)
+    /*!
+     * \brief Total number of users known to the model.
+     *
+     * This is the number of user IDs, that might be greater than the number of rows
+     * that have already been added via fetchMore().
+     *
+     * \par Access methods
+     * \li int totalCount() const
+     *
+     * \par Notifier signal
+     * \li void totalCountChanged(int totalCount)
+     */
+    Q_PROPERTY(int totalCount READ totalCount NOTIFY totalCountChanged)
+    /*!
+     * \brief Returns \c true while the model is loading data.
+     *
+     * \par Access methods
+     * \li bool isLoading() const
+     *
+     * \par Notifier signal
+     * \li void isLoadingChanged(bool isLoading)
+     */
+    Q_PROPERTY(bool isLoading READ isLoading NOTIFY isLoadingChanged)
+public:
+    /*!
+     * \brief The data roles provided by the model.
+     *
+     * The role names used in roleNames() are the names of the matching User properties.
+     */
+    enum Roles : int {
+        IdRole = Qt::UserRole + 1,  /**< User::id as QString, available without loading the details. Role name: \c id */
+        EnabledRole,                /**< User::enabled as \c bool. Role name: \c enabled */
+        StorageLocationRole,        /**< User::storageLocation as QString. Role name: \c storageLocation */
+        LastLoginRole,              /**< User::lastLogin as QDateTime. Role name: \c lastLogin */
+        BackendRole,                /**< User::backend as QString. Role name: \c backend */
+        SubadminRole,               /**< User::subadmin as QStringList. Role name: \c subadmin */
+        QuotaRole,                  /**< User::quota as Quota. Role name: \c quota */
+        EmailRole,                  /**< User::email as QString. Role name: \c email */
+        DisplaynameRole,            /**< User::displayname as QString. Role name: \c displayname */
+        PhoneRole,                  /**< User::phone as QString. Role name: \c phone */
+        AddressRole,                /**< User::address as QString. Role name: \c address */
+        WebsiteRole,                /**< User::website as QUrl. Role name: \c website */
+        TwitterRole,                /**< User::twitter as QString. Role name: \c twitter */
+        GroupsRole,                 /**< User::groups as QStringList. Role name: \c groups */
+        LanguageRole,               /**< User::language as QString. Role name: \c language */
+        LocaleRole,                 /**< User::locale as QString. Role name: \c locale */
+        BackendCapabilitiesRole,    /**< User::backendCapabilities as User::Capabilities. Role name: \c backendCapabilities */
+        IsLoadedRole,               /**< \c true if the details for the user have been loaded. Role name: \c isLoaded */
+        UserDataRole                /**< All user details as UserData. Role name: \c userData */
+    };
+    Q_ENUM(Roles)
+
+    /*!
+     * \brief Constructs a new empty %UserListModel object with the given \a parent.
+     */
+    explicit UserListModel(QObject *parent = nullptr);
+
+    /*!
+     * \brief Destroys the %UserListModel object and cancels all running requests.
+     */
+    ~UserListModel() override;
+
+    /*!
+     * \brief Returns the number of rows that have been added via fetchMore().
+     */
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+
+    /*!
+     * \brief Returns the data for the given \a role at \a index.
+     *
+     * If the details for the user at \a index have not been loaded yet, they will be requested
+     * together with the details for the rows in the \link UserListModel::prefetchWindow prefetchWindow\endlink.
+     */
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+
+    /*!
+     * \brief Returns the role names of the model.
+     * \sa Roles
+     */
+    QHash<int, QByteArray> roleNames() const override;
+
+    /*!
+     * \brief Returns \c true if there are user IDs that have not been added as rows yet.
+     */
+    bool canFetchMore(const QModelIndex &parent) const override;
+
+    /*!
+     * \brief Adds up to \link UserListModel::pageSize pageSize\endlink rows to the model.
+     *
+     * The details for the new rows that are near the visible range will be requested.
+     */
+    void fetchMore(const QModelIndex &parent) override;
+
+    /*!
+     * \brief Clears the model and starts loading the list of user IDs from the remote server.
+     *
+     * If requesting the list fails, failed() will be emitted.
+     */
+    Q_INVOKABLE void load();
+
+    /*!
+     * \brief Clears the model and sets the list of user \a ids to show.
+     *
+     * Use this if the user IDs are already known, for example from a previous GetUserListJob.
+     */
+    Q_INVOKABLE void setUserIds(const QStringList &ids);
+
+    /*!
+     * \brief Reports the range of rows from \a first to \a last that are currently visible in the view.
+     *
+     * Requests for rows that are outside of this range extended by the
+     * \link UserListModel::prefetchWindow prefetchWindow\endlink will be canceled,
+     * requests for the visible rows will be prioritized. Rows that failed to load and that are
+     * outside of the extended range will be requested again when they become visible.
+     */
+    Q_INVOKABLE void setVisibleRange(int first, int last);
+
+    /*!
+     * \brief Returns the user details at \a row.
+     *
+     * The returned object will be empty if the details have not been loaded yet.
+     * This does not request the data.
+     */
+    UserData userData(int row) const;
+
+    /*!
+     * \brief Returns the network access manager used by the model.
+     * \sa setNetworkAccessManager()
+     */
+    QNetworkAccessManager *networkAccessManager() const;
+
+    /*!
+     * \brief Sets the network access manager \a nam that will be shared by all requests of the model.
+     *
+     * If no network access manager has been set, Wolkanlin::defaultNetworkAccessManager()
+     * will be used. If that is not available, the model will create its own one.
+     * The model does not take ownership of \a nam.
+     *
+     * \sa networkAccessManager()
+     */
+    void setNetworkAccessManager(QNetworkAccessManager *nam);
+
+    /*!
+     * \brief Getter function for the \link UserListModel::configuration configuration\endlink property.
+     * \sa setConfiguration(), configurationChanged()
+     */
+    AbstractConfiguration *configuration() const;
+
+    /*!
+     * \brief Setter function for the \link UserListModel::configuration configuration\endlink property.
+     * \sa configuration(), configurationChanged()
+     */
+    void setConfiguration(AbstractConfiguration *configuration);
+
+    /*!
+     * \brief Getter function for the \link UserListModel::pageSize pageSize\endlink property.
+     * \sa setPageSize(), pageSizeChanged()
+     */
+    int pageSize() const;
+
+    /*!
+     * \brief Setter function for the \link UserListModel::pageSize pageSize\endlink property.
+     * \sa pageSize(), pageSizeChanged()
+     */
+    void setPageSize(int pageSize);
+
+    /*!
+     * \brief Getter function for the \link UserListModel::prefetchWindow prefetchWindow\endlink property.
+     * \sa setPrefetchWindow(), prefetchWindowChanged()
+     */
+    int prefetchWindow() const;
+
+    /*!
+     * \brief Setter function for the \link UserListModel::prefetchWindow prefetchWindow\endlink property.
+     * \sa prefetchWindow(), prefetchWindowChanged()
+     */
+    void setPrefetchWindow(int prefetchWindow);
+
+    /*!
+     * \brief Getter function for the \link UserListModel::maxConcurrentRequests maxConcurrentRequests\endlink property.
+     * \sa setMaxConcurrentRequests(), maxConcurrentRequestsChanged()
+     */
+    int maxConcurrentRequests() const;
+
+    /*!
+     * \brief Setter function for the \link UserListModel::maxConcurrentRequests maxConcurrentRequests\endlink property.
+     * \sa maxConcurrentRequests(), maxConcurrentRequestsChanged()
+     */
+    void setMaxConcurrentRequests(int maxConcurrentRequests);
+
+    /*!
+     * \brief Getter function for the \link UserListModel::totalCount totalCount\endlink property.
+     * \sa totalCountChanged()
+     */
+    int totalCount() const;
+
+    /*!
+     * \brief Getter function for the \link UserListModel::isLoading isLoading\endlink property.
+     * \sa isLoadingChanged()
+     */
+    bool isLoading() const;
+
+Q_SIGNALS:
+    /*!
+     * \brief Notifier signal for the \link UserListModel::configuration configuration\endlink property.
+     * \sa setConfiguration(), configuration()
+     */
+    void configurationChanged(Wolkanlin::AbstractConfiguration *configuration);
+
+    /*!
+     * \brief Notifier signal for the \link UserListModel::pageSize pageSize\endlink property.
+     * \sa setPageSize(), pageSize()
+     */
+    void pageSizeChanged(int pageSize);
+
+    /*!
+     * \brief Notifier signal for the \link UserListModel::prefetchWindow prefetchWindow\endlink property.
+     * \sa setPrefetchWindow(), prefetchWindow()
+     */
+    void prefetchWindowChanged(int prefetchWindow);
+
+    /*!
+     * \brief Notifier signal for the \link UserListModel::maxConcurrentRequests maxConcurrentRequests\endlink property.
+     * \sa setMaxConcurrentRequests(), maxConcurrentRequests()
+     */
+    void maxConcurrentRequestsChanged(int maxConcurrentRequests);
+
+    /*!
+     * \brief Notifier signal for the \link UserListModel::totalCount totalCount\endlink property.
+     * \sa totalCount()
+     */
+    void totalCountChanged(int totalCount);
+
+    /*!
+     * \brief Notifier signal for the \link UserListModel::isLoading isLoading\endlink property.
+     * \sa isLoading()
+     */
+    void isLoadingChanged(bool isLoading);
+
+    /*!
+     * \brief Emitted when requesting the list of user IDs failed.
+     *
+     * \a error will contain the error code, \a errorString a human-readable error message.
+     */
+    void failed(int error, const QString &errorString);
+
+private:
+    const std::unique_ptr<UserListModelPrivate> wl_ptr;
+
+    Q_DECLARE_PRIVATE_D(wl_ptr, UserListModel)
+    Q_DISABLE_COPY(UserListModel)
+};
+
+}
+
+#endif // WOLKANLIN_USERLISTMODEL_H
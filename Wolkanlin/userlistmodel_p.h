@@ -0,0 +1,83 @@
+/*
+ * SPDX-FileCopyrightText: (C) 2021 Matthias Fehring / www.huessenbergnetz.de
+ * SPDX-License-Identifier: LGPL-3.0-or-later
+ */
+
+#ifndef WOLKANLIN_USERLISTMODEL_P_H
+#define WOLKANLIN_USERLISTMODEL_P_H
+
+#include "userlistmodel.h"
+#include "userdata.h"
+#include <QVector>
+#include <QHash>
+#include <QMap>
+#include <QSet>
+#include <QPointer>
+
+class QTimer;
+
+namespace Wolkanlin {
+
+class GetUserJob;
+class GetUserListJob;
+
+class UserListModelPrivate
+{
+public:
+    enum class RowState : quint8 {
+        NotLoaded   = 0,
+        Queued      = 1,
+        Loading     = 2,
+        Loaded      = 3,
+        Failed      = 4
+    };
+
+    explicit UserListModelPrivate(UserListModel *q);
+    ~UserListModelPrivate();
+
+    void requestRow(int row);
+    void retryFailedRows();
+    void scheduleDispatch();
+    void dispatch();
+    void startJob(int row);
+    void cancelJob(int row);
+    void cancelAll();
+    void reset(const QStringList &newIds);
+    bool isInWindow(int row) const;
+    void onUserReceived(int row, quint64 gen, const QJsonDocument &json);
+    void onUserFailed(int row, quint64 gen);
+    void onIdsReceived(const QStringList &pageIds, int offset);
+    void onUserListReceived();
+    void updateIsLoading();
+    QNetworkAccessManager *networkAccessManager();
+
+    QStringList ids;
+    QVector<UserData> rows;
+    QVector<RowState> states;
+    QVector<int> queue;
+    QSet<int> failedRows;
+    QMap<int, QStringList> pendingIdPages;
+    QHash<int, GetUserJob*> runningJobs;
+    QPointer<GetUserListJob> listJob;
+    QNetworkAccessManager *nam = nullptr;
+    QNetworkAccessManager *ownNam = nullptr;
+    AbstractConfiguration *configuration = nullptr;
+    QTimer *dispatchTimer = nullptr;
+    UserListModel *q_ptr = nullptr;
+    quint64 generation = 0;
+    int pageSize = 100;
+    int prefetchWindow = 50;
+    int maxConcurrentRequests = 6;
+    int visibleFirst = -1;
+    int visibleLast = -1;
+    int nextIdOffset = 0;
+    bool isLoading = false;
+
+private:
+    Q_DECLARE_PUBLIC(UserListModel)
+    Q_DISABLE_COPY(UserListModelPrivate)
+};
+
+}
+
+#endif // WOLKANLIN_USERLISTMODEL_P_H
@@ -0,0 +1,224 @@
+/*
+ * SPDX-FileCopyrightText: (C) 2021 Matthias Fehring / www.huessenbergnetz.de
+ * SPDX-License-Identifier: LGPL-3.0-or-later
+ */
+
+#include "testconfig.h"
+#include "mockserver.h"
+#include <QTest>
+#include <QObject>
+#include <QTimer>
+#include <QNetworkAccessManager>
+#include <QNetworkReply>
+#include <Wolkanlin/GetUserJob>
+#include <Wolkanlin/GetUserListJob>
+
+using namespace Wolkanlin;
+
+// reply that serves a fixed payload without any network access, a null payload never finishes
+class StubReply : public QNetworkReply
+{
+public:
+    StubReply(QNetworkAccessManager::Operation op, const QNetworkRequest &request, const QByteArray &payload, QObject *parent)
+        : QNetworkReply(parent), m_payload(payload)
+    {
+        setOperation(op);
+        setRequest(request);
+        setUrl(request.url());
+        open(QIODevice::ReadOnly | QIODevice::Unbuffered);
+
+        if (!m_payload.isNull()) {
+            setAttribute(QNetworkRequest::HttpStatusCodeAttribute, 200);
+            setHeader(QNetworkRequest::ContentTypeHeader, QByteArrayLiteral("application/json; charset=utf-8"));
+            QTimer::singleShot(0, this, [this](){
+                setFinished(true);
+                Q_EMIT metaDataChanged();
+                Q_EMIT readyRead();
+                Q_EMIT finished();
+            });
+        }
+    }
+
+    void abort() override
+    {
+        if (!isFinished()) {
+            setError(QNetworkReply::OperationCanceledError, QStringLiteral("Operation canceled"));
+            setFinished(true);
+        }
+    }
+
+    qint64 bytesAvailable() const override
+    {
+        return m_payload.size() - m_offset + QNetworkReply::bytesAvailable();
+    }
+
+    bool isSequential() const override
+    {
+        return true;
+    }
+
+protected:
+    qint64 readData(char *data, qint64 maxSize) override
+    {
+        const qint64 size = qMin(maxSize, static_cast<qint64>(m_payload.size()) - m_offset);
+        if (size <= 0) {
+            return isFinished() ? -1 : 0;
+        }
+        memcpy(data, m_payload.constData() + m_offset, static_cast<size_t>(size));
+        m_offset += size;
+        return size;
+    }
+
+private:
+    QByteArray m_payload;
+    qint64 m_offset = 0;
+};
+
+// network access manager that answers every request with a StubReply
+class StubNetworkAccessManager : public QNetworkAccessManager
+{
+public:
+    using QNetworkAccessManager::QNetworkAccessManager;
+
+    void setPayload(const QByteArray &payload) { m_payload = payload; }
+
+protected:
+    QNetworkReply *createRequest(Operation op, const QNetworkRequest &request, QIODevice *outgoingData) override
+    {
+        Q_UNUSED(outgoingData)
+        return new StubReply(op, request, m_payload, this);
+    }
+
+private:
+    QByteArray m_payload;
+};
+
+class SetupBenchmarkJob : public GetUserJob
+{
+public:
+    using GetUserJob::GetUserJob;
+
+    void setupRequest() { sendRequest(); }
+};
+
+class JobsBenchmark : public QObject
+{
+    Q_OBJECT
+public:
+    JobsBenchmark(QObject *parent = nullptr);
+    ~JobsBenchmark() override;
+
+private slots:
+    void initTestCase();
+    void benchProcessReply_data();
+    void benchProcessReply();
+    void benchSendRequestSetup();
+    void benchGetUserRoundTrip();
+
+private:
+    static QByteArray createPayload(int minSize);
+
+    TestConfig *m_config = nullptr;
+    QNetworkAccessManager *m_nam = nullptr;
+    StubNetworkAccessManager *m_stubNam = nullptr;
+    MockServer *m_server = nullptr;
+};
+
+JobsBenchmark::JobsBenchmark(QObject *parent) : QObject(parent)
+{
+
+}
+
+JobsBenchmark::~JobsBenchmark() = default;
+
+void JobsBenchmark::initTestCase()
+{
+    m_config = new TestConfig(false, this);
+    m_config->setHost(QStringLiteral("localhost"));
+    m_config->setPort(9);
+    m_config->setUseSsl(false);
+    m_config->setUsername(QStringLiteral("user"));
+    m_config->setPassword(QStringLiteral("password"));
+
+    m_nam = new QNetworkAccessManager(this);
+    m_stubNam = new StubNetworkAccessManager(this);
+
+    m_server = new MockServer(this);
+    QVERIFY(m_server->start());
+    m_server->setCredentials(QStringLiteral("user"), QStringLiteral("password"));
+}
+
+QByteArray JobsBenchmark::createPayload(int minSize)
+{
+    QByteArray payload = QByteArrayLiteral("{\"ocs\":{\"meta\":{\"status\":\"ok\",\"statuscode\":100,\"message\":\"OK\",\"totalitems\":\"\",\"itemsperpage\":\"\"},\"data\":{\"users\":[");
+    payload.reserve(minSize + 64);
+    int i = 0;
+    while (payload.size() < minSize) {
+        if (i > 0) {
+            payload.append(',');
+        }
+        payload.append("\"user");
+        payload.append(QByteArray::number(i).rightJustified(8, '0'));
+        payload.append('"');
+        ++i;
+    }
+    payload.append("]}}}");
+    return payload;
+}
+
+void JobsBenchmark::benchProcessReply_data()
+{
+    QTest::addColumn<QByteArray>("payload");
+
+    QTest::newRow("1KB") << createPayload(1024);
+    QTest::newRow("1MB") << createPayload(1024 * 1024);
+    QTest::newRow("10MB") << createPayload(10 * 1024 * 1024);
+}
+
+void JobsBenchmark::benchProcessReply()
+{
+    QFETCH(QByteArray, payload);
+
+    // the reply is served by the stub, so this measures reading and parsing the payload
+    // plus the small constant overhead of the job itself
+    m_stubNam->setPayload(payload);
+
+    QBENCHMARK {
+        GetUserListJob job;
+        job.setConfiguration(m_config);
+        job.setNetworkAccessManager(m_stubNam);
+        job.setAutoDelete(false);
+        QVERIFY(job.exec());
+    }
+}
+
+void JobsBenchmark::benchSendRequestSetup()
+{
+    // replies of the stub never finish and nothing is sent, only the request setup is measured
+    m_stubNam->setPayload(QByteArray());
+
+    QBENCHMARK {
+        SetupBenchmarkJob job(QStringLiteral("user"));
+        job.setConfiguration(m_config);
+        job.setNetworkAccessManager(m_stubNam);
+        job.setAutoDelete(false);
+        job.setupRequest();
+        job.kill(WJob::Quietly);
+    }
+}
+
+void JobsBenchmark::benchGetUserRoundTrip()
+{
+    auto conf = m_server->createConfig(this);
+
+    QBENCHMARK {
+        auto job = new GetUserJob(MockServer::userId(1), this);
+        job->setConfiguration(conf);
+        job->setNetworkAccessManager(m_nam);
+        QVERIFY(job->exec());
+    }
+}
+
+QTEST_MAIN(JobsBenchmark)
+
+#include "benchjobs.moc"
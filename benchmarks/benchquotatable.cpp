@@ -0,0 +1,129 @@
+/*
+ * SPDX-FileCopyrightText: (C) 2021 Matthias Fehring / www.huessenbergnetz.de
+ * SPDX-License-Identifier: LGPL-3.0-or-later
+ */
+
+#include <QTest>
+#include <QObject>
+#include <QVector>
+#include <Wolkanlin/QuotaTable>
+#include <Wolkanlin/Quota>
+#include <Wolkanlin/UserData>
+
+using namespace Wolkanlin;
+
+class QuotaTableBenchmark : public QObject
+{
+    Q_OBJECT
+public:
+    QuotaTableBenchmark(QObject *parent = nullptr);
+    ~QuotaTableBenchmark() override;
+
+private slots:
+    void initTestCase();
+    void benchAppend();
+    void benchSumUserData();
+    void benchSum();
+    void benchPercentile();
+    void benchHistogram();
+    void benchTopByUsage();
+    void benchTopByQuotaUsage();
+
+private:
+    QVector<UserData> m_users;
+    QuotaTable m_table;
+};
+
+QuotaTableBenchmark::QuotaTableBenchmark(QObject *parent) : QObject(parent)
+{
+
+}
+
+QuotaTableBenchmark::~QuotaTableBenchmark() = default;
+
+void QuotaTableBenchmark::initTestCase()
+{
+    const int count = 100000;
+    m_users.reserve(count);
+    for (int i = 0; i < count; ++i) {
+        // spread the values pseudo randomly, so that the selection algorithms do not work on sorted data
+        const qint64 quota = (i % 7 == 0) ? -3 : static_cast<qint64>(1 + i % 50) * 1073741824;
+        const qint64 used = static_cast<qint64>((i * 7919) % 100000) * 53687;
+        const qint64 total = quota > 0 ? quota : 5497558138880;
+        UserData u;
+        u.setId(QStringLiteral("user%1").arg(i));
+        u.setQuota(Quota(total - used, used, quota, total, static_cast<double>(used) / static_cast<double>(total) * 100.0));
+        m_users.append(u);
+    }
+    m_table.append(m_users);
+    QCOMPARE(m_table.size(), count);
+}
+
+void QuotaTableBenchmark::benchAppend()
+{
+    QBENCHMARK {
+        QuotaTable table;
+        table.append(m_users);
+    }
+}
+
+void QuotaTableBenchmark::benchSumUserData()
+{
+    qint64 used = 0;
+    QBENCHMARK {
+        used = 0;
+        for (const UserData &u : m_users) {
+            used += u.quota().used();
+        }
+    }
+    QCOMPARE(used, m_table.sum(QuotaTable::UsedColumn));
+}
+
+void QuotaTableBenchmark::benchSum()
+{
+    qint64 used = 0;
+    QBENCHMARK {
+        used = m_table.sum(QuotaTable::UsedColumn);
+    }
+    QVERIFY(used > 0);
+}
+
+void QuotaTableBenchmark::benchPercentile()
+{
+    qint64 p95 = 0;
+    QBENCHMARK {
+        p95 = m_table.percentile(QuotaTable::UsedColumn, 95.0);
+    }
+    QVERIFY(p95 > 0);
+}
+
+void QuotaTableBenchmark::benchHistogram()
+{
+    QVector<int> histogram;
+    QBENCHMARK {
+        histogram = m_table.relativeHistogram(20);
+    }
+    QCOMPARE(histogram.size(), 20);
+}
+
+void QuotaTableBenchmark::benchTopByUsage()
+{
+    QVector<int> rows;
+    QBENCHMARK {
+        rows = m_table.topByUsage(100);
+    }
+    QCOMPARE(rows.size(), 100);
+}
+
+void QuotaTableBenchmark::benchTopByQuotaUsage()
+{
+    QVector<int> rows;
+    QBENCHMARK {
+        rows = m_table.topByQuotaUsage(100);
+    }
+    QCOMPARE(rows.size(), 100);
+}
+
+QTEST_MAIN(QuotaTableBenchmark)
+
+#include "benchquotatable.moc"
@@ -0,0 +1,299 @@
+/*
+ * SPDX-FileCopyrightText: (C) 2021 Matthias Fehring / www.huessenbergnetz.de
+ * SPDX-License-Identifier: LGPL-3.0-or-later
+ */
+
+#include <QTest>
+#include <QObject>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonArray>
+#include <QJsonValue>
+#include <QDataStream>
+#include <Wolkanlin/User>
+#include <Wolkanlin/Quota>
+#include <Wolkanlin/ServerStatus>
+#include <Wolkanlin/UserData>
+#include <Wolkanlin/SnapshotWriter>
+#include <Wolkanlin/SnapshotReader>
+#include <memory>
+#if QT_VERSION >= QT_VERSION_CHECK(5, 12, 0)
+#include <QCborStreamReader>
+#include <QCborStreamWriter>
+#endif
+
+using namespace Wolkanlin;
+
+class SerializationBenchmark : public QObject
+{
+    Q_OBJECT
+public:
+    SerializationBenchmark(QObject *parent = nullptr);
+    ~SerializationBenchmark() override;
+
+private slots:
+    void initTestCase();
+    void benchUserFromJson();
+    void benchUserToJson();
+    void benchUserDataStream();
+    void benchUserToCbor();
+    void benchUserFromCbor();
+    void benchQuotaFromJson();
+    void benchServerStatusFromJson();
+    void benchServerStatusToJson();
+    void benchServerStatusDataStream();
+    void benchUsersDataStream();
+    void benchUsersSnapshotWrite();
+    void benchUsersSnapshotRead();
+    void benchUsersJson();
+    void benchUsersCbor();
+
+private:
+    QVector<UserData> createUsers(int count) const;
+
+    QJsonDocument m_userJson;
+    QJsonDocument m_statusJson;
+};
+
+SerializationBenchmark::SerializationBenchmark(QObject *parent) : QObject(parent)
+{
+
+}
+
+SerializationBenchmark::~SerializationBenchmark() = default;
+
+void SerializationBenchmark::initTestCase()
+{
+    QJsonParseError jsonError;
+    m_userJson = QJsonDocument::fromJson(QByteArrayLiteral("{\"ocs\":{\"meta\":{\"status\":\"ok\",\"statuscode\":100,\"message\":\"OK\",\"totalitems\":\"\",\"itemsperpage\":\"\"},\"data\":{\"enabled\":true,\"storageLocation\":\"/srv/www/nextcloud/data/tester\",\"id\":\"tester\",\"lastLogin\":1611134157000,\"backend\":\"Database\",\"subadmin\":[\"group1\"],\"quota\":{\"free\":209639130,\"used\":76070,\"total\":209715200,\"relative\":0.04,\"quota\":209715200},\"email\":\"tester@example.net\",\"displayname\":\"Tester\",\"phone\":\"+49123456789\",\"address\":\"Somewhere over the rainbow\",\"website\":\"https://example.net\",\"twitter\":\"@tester\",\"groups\":[\"group1\",\"group2\"],\"language\":\"de_DE\",\"locale\":\"de_DE\",\"backendCapabilities\":{\"setDisplayName\":false,\"setPassword\":true}}}}"), &jsonError);
+    QCOMPARE(jsonError.error, QJsonParseError::NoError);
+
+    m_statusJson = QJsonDocument::fromJson(QByteArrayLiteral("{\"installed\":true,\"maintenance\":false,\"needsDbUpgrade\":false,\"version\":\"20.0.5.2\",\"versionstring\":\"20.0.5\",\"edition\":\"\",\"productname\":\"Nextcloud\",\"extendedSupport\":false}"), &jsonError);
+    QCOMPARE(jsonError.error, QJsonParseError::NoError);
+}
+
+void SerializationBenchmark::benchUserFromJson()
+{
+    QBENCHMARK {
+        User *u = User::fromJson(m_userJson);
+        delete u;
+    }
+}
+
+void SerializationBenchmark::benchUserToJson()
+{
+    std::unique_ptr<User> u(User::fromJson(m_userJson));
+    QVERIFY(!u->isEmpty());
+
+    QJsonObject json;
+    QBENCHMARK {
+        json = u->toJson();
+    }
+    QVERIFY(!json.isEmpty());
+}
+
+void SerializationBenchmark::benchUserDataStream()
+{
+    std::unique_ptr<User> u1(User::fromJson(m_userJson));
+    User u2;
+
+    QBENCHMARK {
+        QByteArray ba;
+        QDataStream out(&ba, QIODevice::WriteOnly);
+        out << *u1;
+        QDataStream in(ba);
+        in >> u2;
+    }
+    QCOMPARE(u2.id(), u1->id());
+}
+
+void SerializationBenchmark::benchUserToCbor()
+{
+#if QT_VERSION >= QT_VERSION_CHECK(5, 12, 0)
+    const UserData u = UserData::fromJson(m_userJson);
+
+    QByteArray cbor;
+    QBENCHMARK {
+        cbor = u.toCbor();
+    }
+    QVERIFY(!cbor.isEmpty());
+#else
+    QSKIP("CBOR support requires Qt 5.12 or newer.");
+#endif
+}
+
+void SerializationBenchmark::benchUserFromCbor()
+{
+#if QT_VERSION >= QT_VERSION_CHECK(5, 12, 0)
+    const QByteArray cbor = UserData::fromJson(m_userJson).toCbor();
+
+    UserData u;
+    QBENCHMARK {
+        u = UserData::fromCbor(cbor);
+    }
+    QVERIFY(!u.isEmpty());
+#else
+    QSKIP("CBOR support requires Qt 5.12 or newer.");
+#endif
+}
+
+void SerializationBenchmark::benchQuotaFromJson()
+{
+    const QJsonObject json = m_userJson.object().value(QStringLiteral("ocs")).toObject().value(QStringLiteral("data")).toObject().value(QStringLiteral("quota")).toObject();
+
+    Quota q;
+    QBENCHMARK {
+        q = Quota::fromJson(json);
+    }
+    QVERIFY(!q.isNull());
+}
+
+void SerializationBenchmark::benchServerStatusFromJson()
+{
+    QBENCHMARK {
+        ServerStatus *s = ServerStatus::fromJson(m_statusJson);
+        delete s;
+    }
+}
+
+void SerializationBenchmark::benchServerStatusToJson()
+{
+    std::unique_ptr<ServerStatus> s(ServerStatus::fromJson(m_statusJson));
+    QVERIFY(!s->isEmpty());
+
+    QJsonObject json;
+    QBENCHMARK {
+        json = s->toJson();
+    }
+    QVERIFY(!json.isEmpty());
+}
+
+void SerializationBenchmark::benchServerStatusDataStream()
+{
+    std::unique_ptr<ServerStatus> s1(ServerStatus::fromJson(m_statusJson));
+    ServerStatus s2;
+
+    QBENCHMARK {
+        QByteArray ba;
+        QDataStream out(&ba, QIODevice::WriteOnly);
+        out << *s1;
+        QDataStream in(ba);
+        in >> s2;
+    }
+    QCOMPARE(s2.version(), s1->version());
+}
+
+QVector<UserData> SerializationBenchmark::createUsers(int count) const
+{
+    const UserData user = UserData::fromJson(m_userJson);
+    QVector<UserData> users;
+    users.reserve(count);
+    for (int i = 0; i < count; ++i) {
+        UserData u = user;
+        u.setId(QStringLiteral("user%1").arg(i));
+        u.setEmail(QStringLiteral("user%1@example.net").arg(i));
+        u.setDisplayname(QStringLiteral("User %1").arg(i));
+        u.setGroups(QStringList({QStringLiteral("group%1").arg(i % 20), QStringLiteral("everyone")}));
+        users.append(u);
+    }
+    return users;
+}
+
+void SerializationBenchmark::benchUsersDataStream()
+{
+    const QVector<UserData> users = createUsers(10000);
+    QVector<UserData> read;
+
+    QBENCHMARK {
+        QByteArray ba;
+        QDataStream out(&ba, QIODevice::WriteOnly);
+        out << users;
+        QDataStream in(ba);
+        in >> read;
+    }
+    QCOMPARE(read.size(), users.size());
+}
+
+void SerializationBenchmark::benchUsersSnapshotWrite()
+{
+    const QVector<UserData> users = createUsers(10000);
+    QByteArray data;
+
+    QBENCHMARK {
+        SnapshotWriter writer;
+        writer.addUsers(users);
+        data = writer.toByteArray();
+    }
+    QVERIFY(!data.isEmpty());
+}
+
+void SerializationBenchmark::benchUsersSnapshotRead()
+{
+    SnapshotWriter writer;
+    writer.addUsers(createUsers(10000));
+    const QByteArray data = writer.toByteArray();
+    QVector<UserData> read;
+
+    QBENCHMARK {
+        SnapshotReader reader(data);
+        read = reader.users();
+    }
+    QCOMPARE(read.size(), 10000);
+}
+
+void SerializationBenchmark::benchUsersJson()
+{
+    const QVector<UserData> users = createUsers(10000);
+    QVector<UserData> read;
+
+    QBENCHMARK {
+        QJsonArray array;
+        for (const UserData &u : users) {
+            array.append(u.toJson());
+        }
+        const QByteArray ba = QJsonDocument(array).toJson(QJsonDocument::Compact);
+
+        read.clear();
+        const QJsonArray in = QJsonDocument::fromJson(ba).array();
+        read.reserve(in.size());
+        for (const QJsonValue &v : in) {
+            read.append(UserData::fromJson(v.toObject()));
+        }
+    }
+    QCOMPARE(read.size(), users.size());
+}
+
+void SerializationBenchmark::benchUsersCbor()
+{
+#if QT_VERSION >= QT_VERSION_CHECK(5, 12, 0)
+    const QVector<UserData> users = createUsers(10000);
+    QVector<UserData> read;
+
+    QBENCHMARK {
+        QByteArray ba;
+        QCborStreamWriter writer(&ba);
+        writer.startArray(static_cast<quint64>(users.size()));
+        for (const UserData &u : users) {
+            u.toCbor(writer);
+        }
+        writer.endArray();
+
+        read.clear();
+        QCborStreamReader reader(ba);
+        if (reader.isArray() && reader.enterContainer()) {
+            read.reserve(users.size());
+            while (reader.lastError() == QCborError::NoError && reader.hasNext()) {
+                read.append(UserData::fromCbor(reader));
+            }
+            reader.leaveContainer();
+        }
+    }
+    QCOMPARE(read.size(), users.size());
+#else
+    QSKIP("CBOR support requires Qt 5.12 or newer.");
+#endif
+}
+
+QTEST_MAIN(SerializationBenchmark)
+
+#include "benchserialization.moc"
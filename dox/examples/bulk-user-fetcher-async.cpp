@@ -0,0 +1,26 @@
+void MyClass::getUsers(const QStringList &ids)
+{
+    auto fetcher = new BulkUserFetcher(ids, this);
+    fetcher->setMaxConcurrentRequests(8);
+    connect(fetcher, &BulkUserFetcher::userReceived, this, &MyClass::onGotUser);
+    connect(fetcher, &BulkUserFetcher::userFailed, this, &MyClass::onGotUserFailed);
+    connect(fetcher, &WJob::result, this, &MyClass::onGotAllUsers);
+    fetcher->start(); // start the API requests asynchronously
+}
+
+void MyClass::onGotUser(const UserData &user)
+{
+    // handle a single user as soon as it has been received
+}
+
+void MyClass::onGotUserFailed(const QString &id, int errorCode, const QString &errorString)
+{
+    // handle a user that could not be received
+}
+
+void MyClass::onGotAllUsers(WJob *job)
+{
+    auto fetcher = qobject_cast<BulkUserFetcher*>(job);
+    const BulkUserFetcher::Statistics stats = fetcher->statistics();
+    qDebug() << stats.usersPerSecond << "users/s, p95 latency:" << stats.latencyP95 << "ms";
+}
@@ -0,0 +1,26 @@
+void MyClass::getAllUsers()
+{
+    auto job = new GetUserDetailsListJob(this);
+    job->setFetchAllPages(true);
+    connect(job, &GetUserDetailsListJob::userReceived, this, &MyClass::onGotUser);
+    connect(job, &GetUserDetailsListJob::succeeded, this, &MyClass::onGotAllUsers);
+    connect(job, &GetUserDetailsListJob::failed, this, &MyClass::onGotUsersFailed);
+    job->start(); // start the API requests asynchronously
+}
+
+void MyClass::onGotUser(const UserData &user)
+{
+    // handle a single user as soon as it has been received
+}
+
+void MyClass::onGotAllUsers()
+{
+    auto job = qobject_cast<GetUserDetailsListJob*>(sender());
+    const QVector<UserData> users = job->users();
+    // handle the complete list
+}
+
+void MyClass::onGotUsersFailed(int errorCode, const QString &errorString)
+{
+    // handle errors
+}
@@ -0,0 +1,725 @@
+/*
+ * SPDX-FileCopyrightText: (C) 2021 Matthias Fehring / www.huessenbergnetz.de
+ * SPDX-License-Identifier: LGPL-3.0-or-later
+ */
+
+#include "mockserver.h"
+#include <QTcpSocket>
+#include <QTimer>
+#include <QUrl>
+#include <QUrlQuery>
+#include <QJsonDocument>
+#include <QJsonArray>
+#include <QCryptographicHash>
+#include <Wolkanlin/GetUserJob>
+
+MockServer::MockServer(QObject *parent)
+    : QTcpServer(parent), m_serverVersion(QStringLiteral("20.0.5.2"))
+{
+
+}
+
+MockServer::~MockServer() = default;
+
+bool MockServer::start(quint16 port)
+{
+    if (!listen(QHostAddress::LocalHost, port)) {
+        qWarning("Failed to start mock server: %s", qUtf8Printable(errorString()));
+        return false;
+    }
+    return true;
+}
+
+void MockServer::setCredentials(const QString &username, const QString &password)
+{
+    m_username = username;
+    m_password = password;
+}
+
+QString MockServer::username() const
+{
+    return m_username;
+}
+
+QString MockServer::password() const
+{
+    return m_password;
+}
+
+void MockServer::configure(Wolkanlin::AbstractConfiguration *config) const
+{
+    config->setHost(QStringLiteral("127.0.0.1"));
+    config->setPort(serverPort());
+    config->setUseSsl(false);
+}
+
+bool MockServer::runJobs(Wolkanlin::AbstractConfiguration *config, QNetworkAccessManager *nam, int count)
+{
+    for (int i = 0; i < count; ++i) {
+        auto job = new Wolkanlin::GetUserJob(userId(i));
+        job->setConfiguration(config);
+        job->setNetworkAccessManager(nam);
+        if (!job->exec()) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void MockServer::setUserCount(int count)
+{
+    m_userCount = qMax(count, 0);
+}
+
+int MockServer::userCount() const
+{
+    return m_userCount;
+}
+
+QString MockServer::userId(int index)
+{
+    return QStringLiteral("user%1").arg(index, 6, 10, QLatin1Char('0'));
+}
+
+QJsonObject MockServer::userData(int index)
+{
+    const QString id = userId(index);
+    const qint64 total = 1073741824;
+    const qint64 used = (static_cast<qint64>(index) * 7919 * 4096) % total;
+
+    QJsonObject quota;
+    quota.insert(QStringLiteral("free"), static_cast<double>(total - used));
+    quota.insert(QStringLiteral("used"), static_cast<double>(used));
+    quota.insert(QStringLiteral("total"), static_cast<double>(total));
+    quota.insert(QStringLiteral("relative"), static_cast<double>(used * 10000 / total) / 100.0);
+    quota.insert(QStringLiteral("quota"), static_cast<double>(total));
+
+    QJsonObject caps;
+    caps.insert(QStringLiteral("setDisplayName"), true);
+    caps.insert(QStringLiteral("setPassword"), true);
+
+    QJsonObject user;
+    user.insert(QStringLiteral("enabled"), index % 50 != 0);
+    user.insert(QStringLiteral("storageLocation"), QStringLiteral("/srv/www/nextcloud/data/") + id);
+    user.insert(QStringLiteral("id"), id);
+    user.insert(QStringLiteral("lastLogin"), 1611134157000.0 + index * 60000.0);
+    user.insert(QStringLiteral("backend"), QStringLiteral("Database"));
+    user.insert(QStringLiteral("subadmin"), QJsonArray());
+    user.insert(QStringLiteral("quota"), quota);
+    user.insert(QStringLiteral("email"), id + QStringLiteral("@example.net"));
+    user.insert(QStringLiteral("displayname"), QStringLiteral("Synthetic User %1").arg(index));
+    user.insert(QStringLiteral("phone"), QString());
+    user.insert(QStringLiteral("address"), QString());
+    user.insert(QStringLiteral("website"), QString());
+    user.insert(QStringLiteral("twitter"), QString());
+    user.insert(QStringLiteral("groups"), QJsonArray({QStringLiteral("users"), QStringLiteral("group%1").arg(index % 10)}));
+    user.insert(QStringLiteral("language"), QStringLiteral("de"));
+    user.insert(QStringLiteral("locale"), QStringLiteral("de_DE"));
+    user.insert(QStringLiteral("backendCapabilities"), caps);
+    return user;
+}
+
+void MockServer::setUserUsed(int index, qint64 used)
+{
+    if (used < 0) {
+        m_usedOverrides.remove(index);
+    } else {
+        m_usedOverrides.insert(index, used);
+    }
+}
+
+QJsonObject MockServer::currentUserData(int index) const
+{
+    QJsonObject user = userData(index);
+    const auto it = m_usedOverrides.constFind(index);
+    if (it != m_usedOverrides.constEnd()) {
+        QJsonObject quota = user.value(QStringLiteral("quota")).toObject();
+        const qint64 total = static_cast<qint64>(quota.value(QStringLiteral("total")).toDouble());
+        const qint64 used = qMin(it.value(), total);
+        quota.insert(QStringLiteral("free"), static_cast<double>(total - used));
+        quota.insert(QStringLiteral("used"), static_cast<double>(used));
+        quota.insert(QStringLiteral("relative"), static_cast<double>(used * 10000 / total) / 100.0);
+        user.insert(QStringLiteral("quota"), quota);
+    }
+    return user;
+}
+
+void MockServer::setServerVersion(const QString &version)
+{
+    m_serverVersion = version;
+}
+
+void MockServer::setMaintenance(bool maintenance)
+{
+    m_maintenance = maintenance;
+}
+
+void MockServer::setNeedsDbUpgrade(bool needsDbUpgrade)
+{
+    m_needsDbUpgrade = needsDbUpgrade;
+}
+
+void MockServer::setEntityTags(bool entityTags)
+{
+    m_entityTags = entityTags;
+}
+
+void MockServer::setSessions(bool sessions)
+{
+    m_sessionsEnabled = sessions;
+}
+
+void MockServer::expireSessions()
+{
+    m_sessions.clear();
+}
+
+void MockServer::setWipeTokens(const QStringList &tokens)
+{
+    m_wipeTokens.clear();
+    for (const QString &token : tokens) {
+        m_wipeTokens.insert(token);
+    }
+}
+
+QStringList MockServer::appPasswords() const
+{
+    return m_appPasswords.values();
+}
+
+void MockServer::setLatency(int latency, int jitter)
+{
+    m_latency = qMax(latency, 0);
+    m_jitter = qMax(jitter, 0);
+}
+
+void MockServer::setFailEveryNthRequest(int n)
+{
+    m_failEveryNth = qMax(n, 0);
+}
+
+void MockServer::setErrorStatusCode(int statusCode)
+{
+    m_errorStatusCode = statusCode;
+}
+
+void MockServer::failNextRequests(int count, int statusCode)
+{
+    m_failNext = qMax(count, 0);
+    m_failNextStatusCode = statusCode;
+}
+
+void MockServer::setMaxRequestsPerSecond(int maxRequestsPerSecond)
+{
+    m_maxRequestsPerSecond = qMax(maxRequestsPerSecond, 0);
+    m_throttleWindowRequests = 0;
+    m_throttleTimer.invalidate();
+}
+
+void MockServer::setKeepAlive(bool keepAlive)
+{
+    m_keepAlive = keepAlive;
+}
+
+int MockServer::requestCount() const
+{
+    return m_requestCount;
+}
+
+int MockServer::connectionCount() const
+{
+    return m_connectionCount;
+}
+
+int MockServer::failedRequestCount() const
+{
+    return m_failedRequestCount;
+}
+
+int MockServer::throttledRequestCount() const
+{
+    return m_throttledRequestCount;
+}
+
+int MockServer::notModifiedCount() const
+{
+    return m_notModifiedCount;
+}
+
+int MockServer::passwordCheckCount() const
+{
+    return m_passwordCheckCount;
+}
+
+int MockServer::sessionRequestCount() const
+{
+    return m_sessionRequestCount;
+}
+
+QMap<QByteArray,int> MockServer::requestsByPath() const
+{
+    return m_requestsByPath;
+}
+
+void MockServer::resetStatistics()
+{
+    m_requestCount = 0;
+    m_connectionCount = 0;
+    m_failedRequestCount = 0;
+    m_throttledRequestCount = 0;
+    m_notModifiedCount = 0;
+    m_passwordCheckCount = 0;
+    m_sessionRequestCount = 0;
+    m_requestsByPath.clear();
+}
+
+void MockServer::incomingConnection(qintptr socketDescriptor)
+{
+    auto socket = new QTcpSocket(this);
+    if (!socket->setSocketDescriptor(socketDescriptor)) {
+        delete socket;
+        return;
+    }
+
+    m_connectionCount++;
+    m_buffers.insert(socket, QByteArray());
+
+    connect(socket, &QTcpSocket::readyRead, this, [this, socket](){
+        readRequests(socket);
+    });
+    connect(socket, &QTcpSocket::disconnected, this, [this, socket](){
+        m_buffers.remove(socket);
+        socket->deleteLater();
+    });
+}
+
+void MockServer::readRequests(QTcpSocket *socket)
+{
+    QByteArray &buffer = m_buffers[socket];
+    buffer.append(socket->readAll());
+
+    Request request;
+    while (parseRequest(buffer, request)) {
+        m_requestCount++;
+        m_requestsByPath[request.path]++;
+        Q_EMIT requestReceived(request.method, request.path);
+
+        const Response response = handleRequest(request);
+        const bool close = !m_keepAlive || request.headers.value(QByteArrayLiteral("connection")).toLower() == "close";
+
+        int delay = m_latency;
+        if (m_jitter > 0) {
+            // simple linear congruential generator to get reproducible jitter values
+            m_jitterSeed = m_jitterSeed * 1103515245u + 12345u;
+            delay += static_cast<int>((m_jitterSeed >> 16) % static_cast<quint32>(m_jitter + 1));
+        }
+
+        if (delay > 0) {
+            QTimer::singleShot(delay, socket, [this, socket, response, close](){
+                sendResponse(socket, response, close);
+            });
+        } else {
+            sendResponse(socket, response, close);
+        }
+
+        request = Request();
+    }
+}
+
+bool MockServer::parseRequest(QByteArray &buffer, Request &request) const
+{
+    const int headerEnd = buffer.indexOf("\r\n\r\n");
+    if (headerEnd < 0) {
+        return false;
+    }
+
+    const QList<QByteArray> lines = buffer.left(headerEnd).split('\n');
+    if (lines.empty()) {
+        return false;
+    }
+
+    const QList<QByteArray> requestLine = lines.first().trimmed().split(' ');
+    if (requestLine.size() < 2) {
+        buffer.clear();
+        return false;
+    }
+
+    for (int i = 1; i < lines.size(); ++i) {
+        const QByteArray &line = lines.at(i);
+        const int colon = line.indexOf(':');
+        if (colon > 0) {
+            request.headers.insert(line.left(colon).trimmed().toLower(), line.mid(colon + 1).trimmed());
+        }
+    }
+
+    const int contentLength = request.headers.value(QByteArrayLiteral("content-length")).toInt();
+    const int requestSize = headerEnd + 4 + contentLength;
+    if (buffer.size() < requestSize) {
+        return false;
+    }
+
+    request.method = requestLine.at(0);
+    const QByteArray target = requestLine.at(1);
+    const int queryStart = target.indexOf('?');
+    request.path = queryStart < 0 ? target : target.left(queryStart);
+    request.query = queryStart < 0 ? QByteArray() : target.mid(queryStart + 1);
+    request.body = buffer.mid(headerEnd + 4, contentLength);
+
+    buffer.remove(0, requestSize);
+
+    return true;
+}
+
+MockServer::Response MockServer::handleRequest(const Request &request)
+{
+    if (m_failNext > 0) {
+        m_failNext--;
+        m_failedRequestCount++;
+        return errorResponse(m_failNextStatusCode);
+    }
+
+    if (m_failEveryNth > 0 && (m_requestCount % m_failEveryNth) == 0) {
+        m_failedRequestCount++;
+        return errorResponse(m_errorStatusCode);
+    }
+
+    if (isThrottled()) {
+        m_throttledRequestCount++;
+        Response response = errorResponse(429);
+        response.headers.append(qMakePair(QByteArrayLiteral("Retry-After"), QByteArrayLiteral("1")));
+        return response;
+    }
+
+    const QString path = QUrl::fromPercentEncoding(request.path);
+    const QUrlQuery query(QString::fromUtf8(request.query));
+
+    if (request.method == "GET" && path.endsWith(QLatin1String("/status.php"))) {
+        return statusResponse(request);
+    }
+
+    if (request.method == "POST" && path.endsWith(QLatin1String("/index.php/core/wipe/check"))) {
+        return wipeCheckResponse(request);
+    }
+
+    // credentials are always verified if they are sent
+    if (request.headers.contains(QByteArrayLiteral("authorization"))) {
+        m_passwordCheckCount++;
+    } else if (m_sessionsEnabled && hasSession(request)) {
+        m_sessionRequestCount++;
+        return authenticatedResponse(request, path, query);
+    }
+
+    if (!isAuthenticated(request)) {
+        return errorResponse(401);
+    }
+
+    Response response = authenticatedResponse(request, path, query);
+    if (m_sessionsEnabled) {
+        const QByteArray session = QCryptographicHash::hash(QByteArray::number(++m_sessionCounter) + m_username.toUtf8(), QCryptographicHash::Sha1).toHex();
+        m_sessions.insert(session);
+        response.headers.append(qMakePair(QByteArrayLiteral("Set-Cookie"), QByteArrayLiteral("nc_session_id=") + session + QByteArrayLiteral("; path=/; HttpOnly")));
+    }
+    return response;
+}
+
+MockServer::Response MockServer::authenticatedResponse(const Request &request, const QString &path, const QUrlQuery &query)
+{
+    if (request.method == "GET" && path.endsWith(QLatin1String("/ocs/v1.php/cloud/users"))) {
+        return userListResponse(query, false);
+    }
+
+    if (request.method == "GET" && path.endsWith(QLatin1String("/ocs/v2.php/cloud/users/details"))) {
+        return userListResponse(query, true);
+    }
+
+    const QString userPath = QStringLiteral("/ocs/v1.php/cloud/users/");
+    const int userPathIdx = path.indexOf(userPath);
+    if (request.method == "GET" && userPathIdx > -1) {
+        return userResponse(path.mid(userPathIdx + userPath.size()));
+    }
+
+    if (request.method == "GET" && path.endsWith(QLatin1String("/ocs/v2.php/core/getapppassword"))) {
+        return getAppPasswordResponse(request);
+    }
+
+    if (request.method == "DELETE" && path.endsWith(QLatin1String("/ocs/v2.php/core/apppassword"))) {
+        return deleteAppPasswordResponse(request);
+    }
+
+    return errorResponse(404);
+}
+
+void MockServer::sendResponse(QTcpSocket *socket, const Response &response, bool close)
+{
+    if (socket->state() != QAbstractSocket::ConnectedState) {
+        return;
+    }
+
+    QByteArray out;
+    out.reserve(response.body.size() + 256);
+    out.append("HTTP/1.1 ");
+    out.append(QByteArray::number(response.statusCode));
+    out.append(' ');
+    out.append(reasonPhrase(response.statusCode));
+    out.append("\r\nContent-Type: ");
+    out.append(response.contentType);
+    out.append("\r\nContent-Length: ");
+    out.append(QByteArray::number(response.body.size()));
+    out.append(close ? "\r\nConnection: close" : "\r\nConnection: keep-alive");
+    for (const auto &header : response.headers) {
+        out.append("\r\n");
+        out.append(header.first);
+        out.append(": ");
+        out.append(header.second);
+    }
+    out.append("\r\n\r\n");
+    out.append(response.body);
+
+    socket->write(out);
+
+    if (close) {
+        socket->disconnectFromHost();
+    }
+}
+
+bool MockServer::isAuthenticated(const Request &request, QString *password) const
+{
+    const QByteArray auth = request.headers.value(QByteArrayLiteral("authorization"));
+    if (!auth.startsWith("Basic ")) {
+        return m_username.isEmpty();
+    }
+
+    const QString credentials = QString::fromUtf8(QByteArray::fromBase64(auth.mid(6)));
+    const int colon = credentials.indexOf(QLatin1Char(':'));
+    const QString user = credentials.left(colon);
+    const QString pass = colon < 0 ? QString() : credentials.mid(colon + 1);
+
+    if (password) {
+        *password = pass;
+    }
+
+    if (m_username.isEmpty()) {
+        return true;
+    }
+
+    return user == m_username && (pass == m_password || m_appPasswords.contains(pass));
+}
+
+bool MockServer::hasSession(const Request &request) const
+{
+    const QList<QByteArray> cookies = request.headers.value(QByteArrayLiteral("cookie")).split(';');
+    for (const QByteArray &cookie : cookies) {
+        const QByteArray c = cookie.trimmed();
+        if (c.startsWith("nc_session_id=") && m_sessions.contains(c.mid(14))) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool MockServer::isThrottled()
+{
+    if (m_maxRequestsPerSecond <= 0) {
+        return false;
+    }
+
+    if (!m_throttleTimer.isValid() || m_throttleTimer.elapsed() >= 1000) {
+        m_throttleTimer.start();
+        m_throttleWindowRequests = 0;
+    }
+
+    m_throttleWindowRequests++;
+
+    return m_throttleWindowRequests > m_maxRequestsPerSecond;
+}
+
+MockServer::Response MockServer::statusResponse(const Request &request)
+{
+    const QStringList versionParts = m_serverVersion.split(QLatin1Char('.'));
+
+    QJsonObject status;
+    status.insert(QStringLiteral("installed"), true);
+    status.insert(QStringLiteral("maintenance"), m_maintenance);
+    status.insert(QStringLiteral("needsDbUpgrade"), m_needsDbUpgrade);
+    status.insert(QStringLiteral("version"), m_serverVersion);
+    status.insert(QStringLiteral("versionstring"), QStringList(versionParts.mid(0, 3)).join(QLatin1Char('.')));
+    status.insert(QStringLiteral("edition"), QString());
+    status.insert(QStringLiteral("productname"), QStringLiteral("Nextcloud"));
+    status.insert(QStringLiteral("extendedSupport"), false);
+
+    Response response;
+    response.body = QJsonDocument(status).toJson(QJsonDocument::Compact);
+
+    if (m_entityTags) {
+        const QByteArray etag = '"' + QCryptographicHash::hash(response.body, QCryptographicHash::Md5).toHex() + '"';
+        if (request.headers.value(QByteArrayLiteral("if-none-match")) == etag) {
+            m_notModifiedCount++;
+            response.statusCode = 304;
+            response.body.clear();
+        }
+        response.headers.append(qMakePair(QByteArrayLiteral("ETag"), etag));
+    }
+
+    return response;
+}
+
+MockServer::Response MockServer::userListResponse(const QUrlQuery &query, bool details) const
+{
+    const QString search = query.queryItemValue(QStringLiteral("search"), QUrl::FullyDecoded);
+    const int limit = query.hasQueryItem(QStringLiteral("limit")) ? query.queryItemValue(QStringLiteral("limit")).toInt() : -1;
+    const int offset = qMax(query.queryItemValue(QStringLiteral("offset")).toInt(), 0);
+
+    QJsonArray ids;
+    QJsonObject users;
+    int skipped = 0;
+    int added = 0;
+
+    for (int i = 0; i < m_userCount && (limit < 0 || added < limit); ++i) {
+        const QString id = userId(i);
+        if (!search.isEmpty() && !id.contains(search, Qt::CaseInsensitive)) {
+            continue;
+        }
+        if (skipped < offset) {
+            skipped++;
+            continue;
+        }
+        if (details) {
+            users.insert(id, currentUserData(i));
+        } else {
+            ids.append(id);
+        }
+        added++;
+    }
+
+    QJsonObject data;
+    if (details) {
+        // like the real server an empty list is returned as array
+        data.insert(QStringLiteral("users"), users.isEmpty() ? QJsonValue(QJsonArray()) : QJsonValue(users));
+    } else {
+        data.insert(QStringLiteral("users"), ids);
+    }
+
+    return ocsResponse(data, details);
+}
+
+MockServer::Response MockServer::userResponse(const QString &id) const
+{
+    bool ok = false;
+    const int index = id.startsWith(QLatin1String("user")) ? id.mid(4).toInt(&ok) : -1;
+    if (!ok || index < 0 || index >= m_userCount || userId(index) != id) {
+        return ocsResponse(QJsonArray(), false, 404, QStringLiteral("User does not exist"));
+    }
+
+    return ocsResponse(currentUserData(index), false);
+}
+
+MockServer::Response MockServer::getAppPasswordResponse(const Request &request)
+{
+    QString password;
+    isAuthenticated(request, &password);
+
+    if (m_appPasswords.contains(password)) {
+        return ocsResponse(QJsonArray(), true, 403, QStringLiteral("Application password already in use"));
+    }
+
+    const QString appPassword = QStringLiteral("AppPassword-%1-%2").arg(m_appPasswords.size() + 1).arg(QString::fromLatin1(QByteArray::number(m_requestCount).toHex()));
+    m_appPasswords.insert(appPassword);
+
+    QJsonObject data;
+    data.insert(QStringLiteral("apppassword"), appPassword);
+    return ocsResponse(data, true);
+}
+
+MockServer::Response MockServer::deleteAppPasswordResponse(const Request &request)
+{
+    QString password;
+    isAuthenticated(request, &password);
+
+    if (!m_appPasswords.remove(password)) {
+        return ocsResponse(QJsonArray(), true, 403, QStringLiteral("Password is not an application password"));
+    }
+
+    return ocsResponse(QJsonArray(), true);
+}
+
+MockServer::Response MockServer::wipeCheckResponse(const Request &request) const
+{
+    const QUrlQuery form(QString::fromUtf8(request.body));
+    const QString token = form.queryItemValue(QStringLiteral("token"), QUrl::FullyDecoded);
+
+    if (!m_wipeTokens.contains(token)) {
+        Response response;
+        response.statusCode = 404;
+        response.body = QByteArrayLiteral("[]");
+        return response;
+    }
+
+    QJsonObject wipe;
+    wipe.insert(QStringLiteral("wipe"), true);
+
+    Response response;
+    response.body = QJsonDocument(wipe).toJson(QJsonDocument::Compact);
+    return response;
+}
+
+MockServer::Response MockServer::ocsResponse(const QJsonValue &data, bool v2, int statusCode, const QString &message)
+{
+    const bool failed = statusCode > 0;
+
+    QJsonObject meta;
+    meta.insert(QStringLiteral("status"), failed ? QStringLiteral("failure") : QStringLiteral("ok"));
+    meta.insert(QStringLiteral("statuscode"), failed ? statusCode : (v2 ? 200 : 100));
+    meta.insert(QStringLiteral("message"), failed ? message : QStringLiteral("OK"));
+    meta.insert(QStringLiteral("totalitems"), QString());
+    meta.insert(QStringLiteral("itemsperpage"), QString());
+
+    QJsonObject ocs;
+    ocs.insert(QStringLiteral("meta"), meta);
+    ocs.insert(QStringLiteral("data"), data);
+
+    QJsonObject root;
+    root.insert(QStringLiteral("ocs"), ocs);
+
+    Response response;
+    // OCS v1 always returns 200, v2 uses the HTTP status code
+    response.statusCode = (failed && v2) ? statusCode : 200;
+    response.body = QJsonDocument(root).toJson(QJsonDocument::Compact);
+    return response;
+}
+
+MockServer::Response MockServer::errorResponse(int statusCode)
+{
+    Response response;
+    response.statusCode = statusCode;
+    response.contentType = QByteArrayLiteral("text/plain; charset=utf-8");
+    response.body = reasonPhrase(statusCode);
+    return response;
+}
+
+QByteArray MockServer::reasonPhrase(int statusCode)
+{
+    switch (statusCode) {
+    case 200:
+        return QByteArrayLiteral("OK");
+    case 304:
+        return QByteArrayLiteral("Not Modified");
+    case 401:
+        return QByteArrayLiteral("Unauthorized");
+    case 403:
+        return QByteArrayLiteral("Forbidden");
+    case 404:
+        return QByteArrayLiteral("Not Found");
+    case 429:
+        return QByteArrayLiteral("Too Many Requests");
+    case 500:
+        return QByteArrayLiteral("Internal Server Error");
+    case 502:
+        return QByteArrayLiteral("Bad Gateway");
+    case 503:
+        return QByteArrayLiteral("Service Unavailable");
+    default:
+        return QByteArrayLiteral("Unknown");
+    }
+}
+
+#include "moc_mockserver.cpp"
@@ -0,0 +1,200 @@
+/*
+ * SPDX-FileCopyrightText: (C) 2021 Matthias Fehring / www.huessenbergnetz.de
+ * SPDX-License-Identifier: LGPL-3.0-or-later
+ */
+
+#ifndef WOLKANLIN_MOCKSERVER_H
+#define WOLKANLIN_MOCKSERVER_H
+
+#include <QTcpServer>
+#include <QHash>
+#include <QSet>
+#include <QStringList>
+#include <QMap>
+#include <QElapsedTimer>
+#include <QJsonObject>
+#include <QJsonValue>
+#include <QList>
+#include <QPair>
+
+class QTcpSocket;
+class QUrlQuery;
+class QNetworkAccessManager;
+class TestConfig;
+
+namespace Wolkanlin {
+class AbstractConfiguration;
+}
+
+/*!
+ * Local HTTP server that mimics the parts of the Nextcloud API used by the library.
+ *
+ * Serves status.php, the OCS user list, user details list and single user endpoints,
+ * the application password endpoints and the remote wipe check. The user directory is
+ * generated synthetically with setUserCount(). Connections are kept alive like on a real
+ * server, so connection reuse of the network access manager can be measured.
+ *
+ * Latency, error injection and throttling can be configured to test the behavior of the
+ * jobs under load without a real server.
+ */
+class MockServer : public QTcpServer
+{
+    Q_OBJECT
+public:
+    struct Request {
+        QByteArray method;
+        QByteArray path;
+        QByteArray query;
+        QHash<QByteArray, QByteArray> headers;
+        QByteArray body;
+    };
+
+    explicit MockServer(QObject *parent = nullptr);
+    ~MockServer() override;
+
+    // starts listening on the loopback interface, a port of 0 chooses a free port
+    bool start(quint16 port = 0);
+
+    // credentials that are accepted for authenticated requests, an empty
+    // username accepts every request
+    void setCredentials(const QString &username, const QString &password);
+    QString username() const;
+    QString password() const;
+
+    // points config to this server at 127.0.0.1 without SSL, credentials are not touched
+    void configure(Wolkanlin::AbstractConfiguration *config) const;
+    // creates a configuration pointing to this server that uses the credentials set with setCredentials(),
+    // only available to the tests and benchmarks that build mockserverconfig.cpp and testconfig.cpp
+    TestConfig *createConfig(QObject *parent = nullptr) const;
+
+    // executes a GetUserJob for each of the first count users, returns false on the first failed job
+    static bool runJobs(Wolkanlin::AbstractConfiguration *config, QNetworkAccessManager *nam, int count);
+
+    // number of users in the synthetic user directory
+    void setUserCount(int count);
+    int userCount() const;
+    static QString userId(int index);
+    static QJsonObject userData(int index);
+
+    // overrides the used space of the user at index, a negative value restores the generated value
+    void setUserUsed(int index, qint64 used);
+
+    // values returned by status.php
+    void setServerVersion(const QString &version);
+    void setMaintenance(bool maintenance);
+    void setNeedsDbUpgrade(bool needsDbUpgrade);
+
+    // status.php sends an ETag header and answers matching If-None-Match headers with 304
+    void setEntityTags(bool entityTags);
+
+    // requests authenticated with credentials get an nc_session_id cookie that
+    // authenticates following requests that do not send credentials
+    void setSessions(bool sessions);
+    void expireSessions();
+
+    // tokens that will be reported as to be wiped by wipe/check
+    void setWipeTokens(const QStringList &tokens);
+    QStringList appPasswords() const;
+
+    // every request is answered after latency milliseconds plus up to jitter milliseconds
+    void setLatency(int latency, int jitter = 0);
+
+    // every nth request is answered with errorStatusCode, 0 disables the error injection
+    void setFailEveryNthRequest(int n);
+    void setErrorStatusCode(int statusCode);
+
+    // the next count requests are answered with statusCode
+    void failNextRequests(int count, int statusCode = 500);
+
+    // requests above maxRequestsPerSecond are answered with 429 and a Retry-After header, 0 disables throttling
+    void setMaxRequestsPerSecond(int maxRequestsPerSecond);
+
+    // requests are answered with Connection: close if keepAlive is false
+    void setKeepAlive(bool keepAlive);
+
+    int requestCount() const;
+    int connectionCount() const;
+    int failedRequestCount() const;
+    int throttledRequestCount() const;
+    int notModifiedCount() const;
+    // number of requests that had to verify the credentials
+    int passwordCheckCount() const;
+    int sessionRequestCount() const;
+    QMap<QByteArray,int> requestsByPath() const;
+    void resetStatistics();
+
+Q_SIGNALS:
+    void requestReceived(const QByteArray &method, const QByteArray &path);
+
+protected:
+    void incomingConnection(qintptr socketDescriptor) override;
+
+private:
+    struct Response {
+        int statusCode = 200;
+        QByteArray contentType = QByteArrayLiteral("application/json; charset=utf-8");
+        QByteArray body;
+        QList<QPair<QByteArray,QByteArray>> headers;
+    };
+
+    void readRequests(QTcpSocket *socket);
+    bool parseRequest(QByteArray &buffer, Request &request) const;
+    Response handleRequest(const Request &request);
+    Response authenticatedResponse(const Request &request, const QString &path, const QUrlQuery &query);
+    void sendResponse(QTcpSocket *socket, const Response &response, bool close);
+
+    bool isAuthenticated(const Request &request, QString *password = nullptr) const;
+    bool hasSession(const Request &request) const;
+    bool isThrottled();
+
+    QJsonObject currentUserData(int index) const;
+
+    Response statusResponse(const Request &request);
+    Response userListResponse(const QUrlQuery &query, bool details) const;
+    Response userResponse(const QString &id) const;
+    Response getAppPasswordResponse(const Request &request);
+    Response deleteAppPasswordResponse(const Request &request);
+    Response wipeCheckResponse(const Request &request) const;
+
+    static Response ocsResponse(const QJsonValue &data, bool v2, int statusCode = 0, const QString &message = QString());
+    static Response errorResponse(int statusCode);
+    static QByteArray reasonPhrase(int statusCode);
+
+    QHash<QTcpSocket*, QByteArray> m_buffers;
+    QSet<QString> m_appPasswords;
+    QSet<QString> m_wipeTokens;
+    QSet<QByteArray> m_sessions;
+    QMap<QByteArray,int> m_requestsByPath;
+    QHash<int,qint64> m_usedOverrides;
+    QElapsedTimer m_throttleTimer;
+    QString m_username;
+    QString m_password;
+    QString m_serverVersion;
+    int m_userCount = 100;
+    int m_latency = 0;
+    int m_jitter = 0;
+    int m_failEveryNth = 0;
+    int m_errorStatusCode = 500;
+    int m_failNext = 0;
+    int m_failNextStatusCode = 500;
+    int m_maxRequestsPerSecond = 0;
+    int m_throttleWindowRequests = 0;
+    int m_requestCount = 0;
+    int m_connectionCount = 0;
+    int m_failedRequestCount = 0;
+    int m_throttledRequestCount = 0;
+    int m_notModifiedCount = 0;
+    int m_passwordCheckCount = 0;
+    int m_sessionRequestCount = 0;
+    int m_sessionCounter = 0;
+    quint32 m_jitterSeed = 1;
+    bool m_maintenance = false;
+    bool m_needsDbUpgrade = false;
+    bool m_entityTags = true;
+    bool m_keepAlive = true;
+    bool m_sessionsEnabled = false;
+
+    Q_DISABLE_COPY(MockServer)
+};
+
+#endif // WOLKANLIN_MOCKSERVER_H
@@ -0,0 +1,19 @@
+/*
+ * SPDX-FileCopyrightText: (C) 2021 Matthias Fehring / www.huessenbergnetz.de
+ * SPDX-License-Identifier: LGPL-3.0-or-later
+ */
+
+#include "mockserver.h"
+#include "testconfig.h"
+
+// kept apart from mockserver.cpp, that is also used by the wolkanlin-bench tool without TestConfig
+TestConfig *MockServer::createConfig(QObject *parent) const
+{
+    auto conf = new TestConfig(true, parent);
+    configure(conf);
+    if (!username().isEmpty()) {
+        conf->setUsername(username());
+        conf->setPassword(password());
+    }
+    return conf;
+}
@@ -0,0 +1,200 @@
+/*
+ * SPDX-FileCopyrightText: (C) 2021 Matthias Fehring / www.huessenbergnetz.de
+ * SPDX-License-Identifier: LGPL-3.0-or-later
+ */
+
+#include "testconfig.h"
+#include "mockserver.h"
+#include <QTest>
+#include <QObject>
+#include <QSignalSpy>
+#include <QTimer>
+#include <QNetworkAccessManager>
+#include <Wolkanlin/AbstractCredentialProvider>
+
+using namespace Wolkanlin;
+
+class TestProvider : public AbstractCredentialProvider
+{
+    Q_OBJECT
+public:
+    explicit TestProvider(QObject *parent = nullptr) : AbstractCredentialProvider(parent) {}
+
+    ~TestProvider() override = default;
+
+protected:
+    void doFetch() override
+    {
+        QTimer::singleShot(0, this, [this](){
+            setCredentials(QStringLiteral("admin"), QStringLiteral("secret"));
+        });
+    }
+};
+
+class AppPasswordConversionTest : public QObject
+{
+    Q_OBJECT
+public:
+    AppPasswordConversionTest(QObject *parent = nullptr) : QObject(parent) {}
+
+    ~AppPasswordConversionTest() override = default;
+
+private slots:
+    void initTestCase();
+    void init();
+
+    void testDefaultValues();
+    void testDisabled();
+    void testConversion();
+    void testAlreadyAppPassword();
+    void testWithSession();
+    void testWithCredentialProvider();
+
+private:
+    int appPasswordRequests() const;
+
+    MockServer *m_server = nullptr;
+    QNetworkAccessManager *m_nam = nullptr;
+};
+
+void AppPasswordConversionTest::initTestCase()
+{
+    m_server = new MockServer(this);
+    QVERIFY(m_server->start());
+    m_server->setCredentials(QStringLiteral("admin"), QStringLiteral("secret"));
+    m_nam = new QNetworkAccessManager(this);
+}
+
+void AppPasswordConversionTest::init()
+{
+    m_server->setSessions(false);
+    m_server->resetStatistics();
+}
+
+int AppPasswordConversionTest::appPasswordRequests() const
+{
+    return m_server->requestsByPath().value(QByteArrayLiteral("/ocs/v2.php/core/getapppassword"));
+}
+
+void AppPasswordConversionTest::testDefaultValues()
+{
+    TestConfig conf;
+    QVERIFY(!conf.autoConvertAppPassword());
+}
+
+void AppPasswordConversionTest::testDisabled()
+{
+    auto conf = m_server->createConfig(this);
+    QVERIFY(MockServer::runJobs(conf, m_nam, 3));
+    QCOMPARE(appPasswordRequests(), 0);
+    QCOMPARE(conf->password(), QStringLiteral("secret"));
+}
+
+void AppPasswordConversionTest::testConversion()
+{
+    auto conf = m_server->createConfig(this);
+    conf->setAutoConvertAppPassword(true);
+    QSignalSpy convertedSpy(conf, &AbstractConfiguration::appPasswordConverted);
+    QSignalSpy credentialsSpy(conf, &AbstractConfiguration::credentialsChanged);
+    const int appPasswords = m_server->appPasswords().size();
+
+    QVERIFY(MockServer::runJobs(conf, m_nam, 1));
+    if (convertedSpy.isEmpty()) {
+        QVERIFY(convertedSpy.wait());
+    }
+    QCOMPARE(credentialsSpy.count(), 1);
+    QCOMPARE(appPasswordRequests(), 1);
+    QCOMPARE(m_server->appPasswords().size(), appPasswords + 1);
+    QVERIFY(m_server->appPasswords().contains(conf->password()));
+
+    // all following jobs use the application password and do not convert again
+    QVERIFY(MockServer::runJobs(conf, m_nam, 5));
+    QCOMPARE(appPasswordRequests(), 1);
+    QCOMPARE(convertedSpy.count(), 1);
+    QCOMPARE(m_server->appPasswords().size(), appPasswords + 1);
+}
+
+void AppPasswordConversionTest::testAlreadyAppPassword()
+{
+    // get an application password from the server
+    auto converted = m_server->createConfig(this);
+    converted->setAutoConvertAppPassword(true);
+    QSignalSpy convertedSpy(converted, &AbstractConfiguration::appPasswordConverted);
+    QVERIFY(MockServer::runJobs(converted, m_nam, 1));
+    if (convertedSpy.isEmpty()) {
+        QVERIFY(convertedSpy.wait());
+    }
+    const QString appPassword = converted->password();
+    m_server->resetStatistics();
+
+    auto conf = m_server->createConfig(this);
+    conf->setPassword(appPassword);
+    conf->setAutoConvertAppPassword(true);
+    QSignalSpy credentialsSpy(conf, &AbstractConfiguration::credentialsChanged);
+    QVERIFY(MockServer::runJobs(conf, m_nam, 1));
+    QTRY_COMPARE(appPasswordRequests(), 1);
+
+    // the server rejects the conversion, the configuration stays untouched
+    QVERIFY(MockServer::runJobs(conf, m_nam, 5));
+    QCOMPARE(appPasswordRequests(), 1);
+    QCOMPARE(conf->password(), appPassword);
+    QCOMPARE(credentialsSpy.count(), 0);
+
+    // changed credentials are checked again
+    conf->setPassword(QStringLiteral("secret"));
+    QSignalSpy confConvertedSpy(conf, &AbstractConfiguration::appPasswordConverted);
+    QVERIFY(MockServer::runJobs(conf, m_nam, 1));
+    if (confConvertedSpy.isEmpty()) {
+        QVERIFY(confConvertedSpy.wait());
+    }
+    QCOMPARE(appPasswordRequests(), 2);
+    QVERIFY(conf->password() != appPassword);
+}
+
+void AppPasswordConversionTest::testWithSession()
+{
+    m_server->setSessions(true);
+    auto conf = m_server->createConfig(this);
+    conf->setUseSessionCookies(true);
+    conf->setAutoConvertAppPassword(true);
+    QSignalSpy convertedSpy(conf, &AbstractConfiguration::appPasswordConverted);
+
+    QVERIFY(MockServer::runJobs(conf, m_nam, 1));
+    if (convertedSpy.isEmpty()) {
+        QVERIFY(convertedSpy.wait());
+    }
+    QCOMPARE(appPasswordRequests(), 1);
+    QVERIFY(m_server->appPasswords().contains(conf->password()));
+
+    // the session of the login password has been dropped
+    m_server->resetStatistics();
+    QVERIFY(MockServer::runJobs(conf, m_nam, 3));
+    QCOMPARE(m_server->passwordCheckCount(), 1);
+    QCOMPARE(m_server->sessionRequestCount(), 2);
+    QCOMPARE(appPasswordRequests(), 0);
+}
+
+void AppPasswordConversionTest::testWithCredentialProvider()
+{
+    auto provider = new TestProvider(this);
+    auto conf = m_server->createConfig(this);
+    conf->setCredentialProvider(provider);
+    conf->setAutoConvertAppPassword(true);
+    QSignalSpy convertedSpy(conf, &AbstractConfiguration::appPasswordConverted);
+    QSignalSpy credentialsSpy(conf, &AbstractConfiguration::credentialsChanged);
+    const int appPasswords = m_server->appPasswords().size();
+
+    // the credentials of the provider are not converted
+    QVERIFY(MockServer::runJobs(conf, m_nam, 3));
+    QTest::qWait(50);
+    QCOMPARE(appPasswordRequests(), 0);
+    QVERIFY(convertedSpy.isEmpty());
+    QVERIFY(credentialsSpy.isEmpty());
+    QCOMPARE(m_server->appPasswords().size(), appPasswords);
+    QVERIFY(provider->hasCredentials());
+    QCOMPARE(conf->password(), QStringLiteral("secret"));
+}
+
+QTEST_MAIN(AppPasswordConversionTest)
+
+#include "testapppasswordconversion.moc"
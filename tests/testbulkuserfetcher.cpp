@@ -0,0 +1,191 @@
+/*
+ * SPDX-FileCopyrightText: (C) 2021 Matthias Fehring / www.huessenbergnetz.de
+ * SPDX-License-Identifier: LGPL-3.0-or-later
+ */
+
+#include "testconfig.h"
+#include "mockserver.h"
+#include <QTest>
+#include <QObject>
+#include <QSignalSpy>
+#include <QNetworkAccessManager>
+#include <Wolkanlin/BulkUserFetcher>
+#include <Wolkanlin/UserData>
+
+using namespace Wolkanlin;
+
+class BulkUserFetcherTest : public QObject
+{
+    Q_OBJECT
+public:
+    BulkUserFetcherTest(QObject *parent = nullptr) : QObject(parent) {}
+
+    ~BulkUserFetcherTest() override = default;
+
+private slots:
+    void initTestCase();
+    void init();
+
+    void testDefaultValues();
+    void testFetch();
+    void testStreaming();
+    void testRetries();
+    void testRetriesExhausted();
+    void testPermanentErrors();
+
+private:
+    BulkUserFetcher *createFetcher(const QStringList &ids);
+    static QStringList userIds(int count);
+
+    MockServer *m_server = nullptr;
+    QNetworkAccessManager *m_nam = nullptr;
+    TestConfig *m_config = nullptr;
+};
+
+void BulkUserFetcherTest::initTestCase()
+{
+    m_server = new MockServer(this);
+    QVERIFY(m_server->start());
+    m_server->setCredentials(QStringLiteral("admin"), QStringLiteral("secret"));
+    m_nam = new QNetworkAccessManager(this);
+
+    m_config = m_server->createConfig(this);
+}
+
+void BulkUserFetcherTest::init()
+{
+    m_server->setUserCount(100);
+    m_server->setLatency(0);
+    m_server->setFailEveryNthRequest(0);
+    m_server->setErrorStatusCode(500);
+    m_server->failNextRequests(0);
+    m_server->resetStatistics();
+}
+
+BulkUserFetcher *BulkUserFetcherTest::createFetcher(const QStringList &ids)
+{
+    auto fetcher = new BulkUserFetcher(ids, this);
+    fetcher->setConfiguration(m_config);
+    fetcher->setNetworkAccessManager(m_nam);
+    fetcher->setRetryDelay(10);
+    return fetcher;
+}
+
+QStringList BulkUserFetcherTest::userIds(int count)
+{
+    QStringList ids;
+    ids.reserve(count);
+    for (int i = 0; i < count; ++i) {
+        ids << MockServer::userId(i);
+    }
+    return ids;
+}
+
+void BulkUserFetcherTest::testDefaultValues()
+{
+    BulkUserFetcher fetcher;
+    QVERIFY(fetcher.ids().empty());
+    QCOMPARE(fetcher.maxConcurrentRequests(), 6);
+    QCOMPARE(fetcher.maxRetries(), 2);
+    QCOMPARE(fetcher.retryDelay(), 500);
+    QVERIFY(!fetcher.configuration());
+}
+
+void BulkUserFetcherTest::testFetch()
+{
+    m_server->setLatency(2);
+
+    // duplicates are only requested once
+    auto fetcher = createFetcher(userIds(50) + userIds(10));
+    fetcher->setMaxConcurrentRequests(4);
+    QSignalSpy receivedSpy(fetcher, &BulkUserFetcher::userReceived);
+    QVERIFY(fetcher->exec());
+
+    QCOMPARE(receivedSpy.count(), 50);
+    QCOMPARE(fetcher->users().size(), 50);
+    QVERIFY(fetcher->failedIds().empty());
+    QCOMPARE(m_server->requestCount(), 50);
+
+    const BulkUserFetcher::Statistics stats = fetcher->statistics();
+    QCOMPARE(stats.requested, 50);
+    QCOMPARE(stats.received, 50);
+    QCOMPARE(stats.failed, 0);
+    QCOMPARE(stats.retries, 0);
+    QVERIFY(stats.elapsed > 0);
+    QVERIFY(stats.usersPerSecond > 0.0);
+    QVERIFY(stats.latencyP50 >= 2);
+    QVERIFY(stats.latencyP50 <= stats.latencyP95);
+    QVERIFY(stats.latencyP95 <= stats.latencyP99);
+}
+
+void BulkUserFetcherTest::testStreaming()
+{
+    m_server->setLatency(20);
+
+    auto fetcher = createFetcher(userIds(6));
+    fetcher->setAutoDelete(false);
+    fetcher->setMaxConcurrentRequests(2);
+    QSignalSpy receivedSpy(fetcher, &BulkUserFetcher::userReceived);
+    QSignalSpy resultSpy(fetcher, &WJob::result);
+    fetcher->start();
+
+    // users are emitted as soon as they arrive, not all at the end
+    QVERIFY(receivedSpy.wait());
+    QVERIFY(resultSpy.isEmpty());
+    QVERIFY(receivedSpy.count() < 6);
+
+    QVERIFY(resultSpy.wait());
+    QCOMPARE(receivedSpy.count(), 6);
+    QCOMPARE(fetcher->error(), 0);
+    delete fetcher;
+}
+
+void BulkUserFetcherTest::testRetries()
+{
+    m_server->failNextRequests(3, 500);
+
+    auto fetcher = createFetcher(userIds(5));
+    fetcher->setMaxConcurrentRequests(1);
+    QSignalSpy failedSpy(fetcher, &BulkUserFetcher::userFailed);
+    QVERIFY(fetcher->exec());
+
+    QCOMPARE(fetcher->users().size(), 5);
+    QVERIFY(failedSpy.isEmpty());
+    QCOMPARE(fetcher->statistics().retries, 3);
+    QCOMPARE(m_server->requestCount(), 8);
+}
+
+void BulkUserFetcherTest::testRetriesExhausted()
+{
+    m_server->setFailEveryNthRequest(1);
+
+    auto fetcher = createFetcher(userIds(2));
+    fetcher->setMaxRetries(1);
+    QSignalSpy failedSpy(fetcher, &BulkUserFetcher::userFailed);
+    QVERIFY(!fetcher->exec());
+
+    QCOMPARE(fetcher->error(), static_cast<int>(NetworkError));
+    QCOMPARE(failedSpy.count(), 2);
+    QCOMPARE(fetcher->failedIds().size(), 2);
+    QCOMPARE(fetcher->statistics().retries, 2);
+    QCOMPARE(fetcher->statistics().failed, 2);
+    QCOMPARE(m_server->requestCount(), 4);
+}
+
+void BulkUserFetcherTest::testPermanentErrors()
+{
+    auto fetcher = createFetcher({MockServer::userId(0), QStringLiteral("unknown"), MockServer::userId(1)});
+    QSignalSpy failedSpy(fetcher, &BulkUserFetcher::userFailed);
+    QVERIFY(fetcher->exec());
+
+    QCOMPARE(fetcher->users().size(), 2);
+    QCOMPARE(fetcher->failedIds(), QStringList({QStringLiteral("unknown")}));
+    QCOMPARE(failedSpy.count(), 1);
+    QCOMPARE(failedSpy.at(0).at(1).toInt(), static_cast<int>(NotFound));
+    QCOMPARE(fetcher->statistics().retries, 0);
+    QCOMPARE(m_server->requestCount(), 3);
+}
+
+QTEST_MAIN(BulkUserFetcherTest)
+
+#include "testbulkuserfetcher.moc"
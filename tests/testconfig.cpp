@@ -8,7 +8,8 @@
 TestConfig::TestConfig(bool useAdmin, QObject *parent)
     : Wolkanlin::AbstractConfiguration(parent), m_useAdmin(useAdmin)
 {
-
+    // all setters notify their changes
+    setSnapshotCachingEnabled(true);
 }
 
 TestConfig::~TestConfig() = default;
@@ -21,6 +22,7 @@ QString TestConfig::username() const
 void TestConfig::setUsername(const QString &username)
 {
     m_username = username;
+    notifyCredentialsChanged();
 }
 
 QString TestConfig::password() const
@@ -31,6 +33,7 @@ QString TestConfig::password() const
 void TestConfig::setPassword(const QString &password)
 {
     m_password = password;
+    notifyCredentialsChanged();
 }
 
 QString TestConfig::host() const
@@ -41,6 +44,7 @@ QString TestConfig::host() const
 void TestConfig::setHost(const QString &host)
 {
     m_host = host;
+    notifyEndpointChanged();
 }
 
 int TestConfig::port() const
@@ -51,6 +55,7 @@ int TestConfig::port() const
 void TestConfig::setPort(int port)
 {
     m_port = port;
+    notifyEndpointChanged();
 }
 
 QString TestConfig::installPath() const
@@ -61,6 +66,7 @@ QString TestConfig::installPath() const
 void TestConfig::setInstallPath(const QString &installPath)
 {
     m_installPath = installPath;
+    notifyEndpointChanged();
 }
 
 bool TestConfig::useSsl() const
@@ -71,6 +77,7 @@ bool TestConfig::useSsl() const
 void TestConfig::setUseSsl(bool useSsl)
 {
     m_useSsl = useSsl;
+    notifyEndpointChanged();
 }
 
 bool TestConfig::ignoreSslErrors() const
@@ -81,6 +88,7 @@ bool TestConfig::ignoreSslErrors() const
 void TestConfig::setIgnoreSslErrors(bool ignoreSslErrors)
 {
     m_ignoreSslErrors = ignoreSslErrors;
+    invalidateSnapshot();
 }
 
 QString TestConfig::userAgent() const
@@ -0,0 +1,263 @@
+/*
+ * SPDX-FileCopyrightText: (C) 2021 Matthias Fehring / www.huessenbergnetz.de
+ * SPDX-License-Identifier: LGPL-3.0-or-later
+ */
+
+#include "testconfig.h"
+#include "mockserver.h"
+#include <QTest>
+#include <QObject>
+#include <QUrl>
+#include <QSignalSpy>
+#include <QJsonObject>
+#include <QNetworkAccessManager>
+#include <Wolkanlin/ConfigurationSnapshot>
+#include <Wolkanlin/GetUserJob>
+
+using namespace Wolkanlin;
+
+// counts the calls to the getters that are expensive in real configurations
+class CountingConfig : public TestConfig
+{
+    Q_OBJECT
+public:
+    explicit CountingConfig(QObject *parent = nullptr) : TestConfig(true, parent) {}
+
+    ~CountingConfig() override = default;
+
+    QString username() const override
+    {
+        ++usernameCalls;
+        return TestConfig::username();
+    }
+
+    QString password() const override
+    {
+        ++passwordCalls;
+        return TestConfig::password();
+    }
+
+    mutable int usernameCalls = 0;
+    mutable int passwordCalls = 0;
+};
+
+// does not notify changes, like configurations written before the snapshots existed
+class SilentConfig : public AbstractConfiguration
+{
+    Q_OBJECT
+public:
+    explicit SilentConfig(QObject *parent = nullptr) : AbstractConfiguration(parent) {}
+
+    ~SilentConfig() override = default;
+
+    QString username() const override { return m_username; }
+    void setUsername(const QString &username) override { m_username = username; }
+    QString password() const override { return m_password; }
+    void setPassword(const QString &password) override { m_password = password; }
+    QString host() const override { return m_host; }
+    void setHost(const QString &host) override { m_host = host; }
+    int port() const override { return -1; }
+
+private:
+    QString m_username;
+    QString m_password;
+    QString m_host;
+};
+
+class ConfigurationSnapshotTest : public QObject
+{
+    Q_OBJECT
+public:
+    ConfigurationSnapshotTest(QObject *parent = nullptr) : QObject(parent) {}
+
+    ~ConfigurationSnapshotTest() override = default;
+
+private slots:
+    void initTestCase();
+
+    void testNullSnapshot();
+    void testValues();
+    void testCaching();
+    void testWithoutCaching();
+    void testJobsUseSnapshot();
+    void testChangeNotification();
+
+private:
+    MockServer *m_server = nullptr;
+    QNetworkAccessManager *m_nam = nullptr;
+};
+
+void ConfigurationSnapshotTest::initTestCase()
+{
+    m_server = new MockServer(this);
+    QVERIFY(m_server->start());
+    m_server->setCredentials(QStringLiteral("admin"), QStringLiteral("secret"));
+    m_nam = new QNetworkAccessManager(this);
+}
+
+void ConfigurationSnapshotTest::testNullSnapshot()
+{
+    ConfigurationSnapshot snapshot;
+    QVERIFY(snapshot.isNull());
+    QVERIFY(snapshot.username().isEmpty());
+    QVERIFY(snapshot.password().isEmpty());
+    QVERIFY(snapshot.host().isEmpty());
+    QCOMPARE(snapshot.port(), 0);
+    QVERIFY(snapshot.installPath().isEmpty());
+    QVERIFY(snapshot.useSsl());
+    QVERIFY(!snapshot.ignoreSslErrors());
+    QVERIFY(snapshot.userAgent().isEmpty());
+    QVERIFY(snapshot.serverUrl().isEmpty());
+    QVERIFY(snapshot.authorizationHeader().isEmpty());
+
+    QVERIFY(ConfigurationSnapshot(nullptr).isNull());
+}
+
+void ConfigurationSnapshotTest::testValues()
+{
+    TestConfig conf;
+    QVERIFY(conf.setServerUrl(QStringLiteral("http://cloud.example.com:8080/nextcloud/")));
+    conf.setUsername(QStringLiteral("admin"));
+    conf.setPassword(QStringLiteral("secret"));
+    conf.setIgnoreSslErrors(true);
+
+    const ConfigurationSnapshot snapshot = conf.snapshot();
+    QVERIFY(!snapshot.isNull());
+    QCOMPARE(snapshot.username(), QStringLiteral("admin"));
+    QCOMPARE(snapshot.password(), QStringLiteral("secret"));
+    QCOMPARE(snapshot.host(), QStringLiteral("cloud.example.com"));
+    QCOMPARE(snapshot.port(), 8080);
+    QCOMPARE(snapshot.installPath(), QStringLiteral("/nextcloud"));
+    QVERIFY(!snapshot.useSsl());
+    QVERIFY(snapshot.ignoreSslErrors());
+    QCOMPARE(snapshot.userAgent(), conf.userAgent());
+    QCOMPARE(snapshot.serverUrl(), QUrl(QStringLiteral("http://cloud.example.com:8080/nextcloud")));
+    QCOMPARE(snapshot.authorizationHeader(), QByteArrayLiteral("Basic ") + QByteArrayLiteral("admin:secret").toBase64());
+
+    // copies are independent of later changes
+    conf.setHost(QStringLiteral("other.example.com"));
+    QCOMPARE(snapshot.host(), QStringLiteral("cloud.example.com"));
+    QCOMPARE(conf.snapshot().host(), QStringLiteral("other.example.com"));
+}
+
+void ConfigurationSnapshotTest::testCaching()
+{
+    CountingConfig conf;
+    conf.setHost(QStringLiteral("cloud.example.com"));
+    conf.setUsername(QStringLiteral("admin"));
+    conf.setPassword(QStringLiteral("secret"));
+
+    for (int i = 0; i < 10; ++i) {
+        QCOMPARE(conf.snapshot().password(), QStringLiteral("secret"));
+    }
+    QCOMPARE(conf.passwordCalls, 1);
+
+    conf.setPassword(QStringLiteral("changed"));
+    QCOMPARE(conf.snapshot().password(), QStringLiteral("changed"));
+    QCOMPARE(conf.passwordCalls, 2);
+
+    QVERIFY(conf.setServerUrl(QStringLiteral("https://cloud.example.net")));
+    QCOMPARE(conf.snapshot().host(), QStringLiteral("cloud.example.net"));
+    QCOMPARE(conf.passwordCalls, 3);
+}
+
+void ConfigurationSnapshotTest::testWithoutCaching()
+{
+    SilentConfig conf;
+    conf.setHost(QStringLiteral("cloud.example.com"));
+    conf.setUsername(QStringLiteral("admin"));
+    conf.setPassword(QStringLiteral("secret"));
+    QCOMPARE(conf.snapshot().password(), QStringLiteral("secret"));
+
+    // changes are used without any notification
+    conf.setHost(QStringLiteral("other.example.com"));
+    conf.setPassword(QStringLiteral("changed"));
+    QCOMPARE(conf.snapshot().host(), QStringLiteral("other.example.com"));
+    QCOMPARE(conf.snapshot().password(), QStringLiteral("changed"));
+    QCOMPARE(conf.generation(), static_cast<quint64>(0));
+}
+
+void ConfigurationSnapshotTest::testJobsUseSnapshot()
+{
+    auto conf = new CountingConfig(this);
+    m_server->configure(conf);
+    conf->setUsername(m_server->username());
+    conf->setPassword(m_server->password());
+
+    QVERIFY(MockServer::runJobs(conf, m_nam, 20));
+
+    QCOMPARE(conf->usernameCalls, 1);
+    QCOMPARE(conf->passwordCalls, 1);
+
+    // a changed password is used by the next job
+    conf->setPassword(QStringLiteral("wrong"));
+    auto job = new GetUserJob(MockServer::userId(0), this);
+    job->setConfiguration(conf);
+    job->setNetworkAccessManager(m_nam);
+    QVERIFY(!job->exec());
+    QCOMPARE(job->error(), static_cast<int>(AuthNFailed));
+    QCOMPARE(conf->passwordCalls, 2);
+}
+
+void ConfigurationSnapshotTest::testChangeNotification()
+{
+    TestConfig conf;
+    QSignalSpy credentialsSpy(&conf, &AbstractConfiguration::credentialsChanged);
+    QSignalSpy endpointSpy(&conf, &AbstractConfiguration::endpointChanged);
+    QCOMPARE(conf.generation(), static_cast<quint64>(0));
+
+    conf.setHost(QStringLiteral("cloud.example.com"));
+    QCOMPARE(endpointSpy.count(), 1);
+    QCOMPARE(credentialsSpy.count(), 0);
+    quint64 generation = conf.generation();
+    QVERIFY(generation > 0);
+    QCOMPARE(conf.snapshot().generation(), generation);
+
+    // multiple setters, but only one signal
+    QVERIFY(conf.setServerUrl(QStringLiteral("https://cloud.example.net:8443/nextcloud")));
+    QCOMPARE(endpointSpy.count(), 2);
+    QCOMPARE(credentialsSpy.count(), 0);
+    QVERIFY(conf.generation() > generation);
+    generation = conf.generation();
+
+    // invalid data changes nothing
+    QVERIFY(!conf.setServerUrl(QStringLiteral("ftp://cloud.example.net")));
+    QCOMPARE(endpointSpy.count(), 2);
+    QCOMPARE(conf.generation(), generation);
+
+    conf.setLoginFlowCredentials(QJsonObject({
+                                                 {QStringLiteral("server"), QStringLiteral("https://cloud.example.org")},
+                                                 {QStringLiteral("loginName"), QStringLiteral("admin")},
+                                                 {QStringLiteral("appPassword"), QStringLiteral("app-password")}
+                                             }));
+    QCOMPARE(endpointSpy.count(), 3);
+    QCOMPARE(credentialsSpy.count(), 1);
+    QCOMPARE(conf.snapshot().host(), QStringLiteral("cloud.example.org"));
+    QCOMPARE(conf.snapshot().password(), QStringLiteral("app-password"));
+
+    const QJsonObject appPassword({
+                                      {QStringLiteral("ocs"), QJsonObject({
+                                           {QStringLiteral("data"), QJsonObject({
+                                                {QStringLiteral("apppassword"), QStringLiteral("other-app-password")}
+                                            })}
+                                       })}
+                                  });
+    QVERIFY(conf.setApplicationPassword(appPassword));
+    QCOMPARE(endpointSpy.count(), 3);
+    QCOMPARE(credentialsSpy.count(), 2);
+    QCOMPARE(conf.snapshot().password(), QStringLiteral("other-app-password"));
+
+    // other values only change the generation
+    generation = conf.generation();
+    const ConfigurationSnapshot outdated = conf.snapshot();
+    conf.setIgnoreSslErrors(true);
+    QVERIFY(conf.generation() > generation);
+    QVERIFY(outdated.generation() < conf.generation());
+    QVERIFY(conf.snapshot().ignoreSslErrors());
+    QCOMPARE(endpointSpy.count(), 3);
+    QCOMPARE(credentialsSpy.count(), 2);
+}
+
+QTEST_MAIN(ConfigurationSnapshotTest)
+
+#include "testconfigurationsnapshot.moc"
@@ -0,0 +1,252 @@
+/*
+ * SPDX-FileCopyrightText: (C) 2021 Matthias Fehring / www.huessenbergnetz.de
+ * SPDX-License-Identifier: LGPL-3.0-or-later
+ */
+
+#include "testconfig.h"
+#include "mockserver.h"
+#include <QTest>
+#include <QObject>
+#include <QSignalSpy>
+#include <QTimer>
+#include <QNetworkAccessManager>
+#include <Wolkanlin/AbstractCredentialProvider>
+#include <Wolkanlin/GetUserJob>
+
+using namespace Wolkanlin;
+
+// answers after a delay like a secret service would do
+class TestProvider : public AbstractCredentialProvider
+{
+    Q_OBJECT
+public:
+    explicit TestProvider(QObject *parent = nullptr) : AbstractCredentialProvider(parent) {}
+
+    ~TestProvider() override = default;
+
+    QString password = QStringLiteral("secret");
+    QString errorString;
+    int fetchCount = 0;
+
+protected:
+    void doFetch() override
+    {
+        ++fetchCount;
+        QTimer::singleShot(50, this, [this](){
+            if (errorString.isEmpty()) {
+                setCredentials(QStringLiteral("admin"), password);
+            } else {
+                setFetchFailed(errorString);
+            }
+        });
+    }
+};
+
+// the synchronous getters must not be used if there is a provider
+class BlockingConfig : public TestConfig
+{
+    Q_OBJECT
+public:
+    explicit BlockingConfig(QObject *parent = nullptr) : TestConfig(true, parent) {}
+
+    ~BlockingConfig() override = default;
+
+    QString password() const override
+    {
+        ++passwordCalls;
+        return TestConfig::password();
+    }
+
+    mutable int passwordCalls = 0;
+};
+
+class CredentialProviderTest : public QObject
+{
+    Q_OBJECT
+public:
+    CredentialProviderTest(QObject *parent = nullptr) : QObject(parent) {}
+
+    ~CredentialProviderTest() override = default;
+
+private slots:
+    void initTestCase();
+
+    void testProvider();
+    void testConcurrentJobs();
+    void testFetchFailed();
+    void testRejectedCredentials();
+    void testKillWhileWaiting();
+
+private:
+    BlockingConfig *createConfig(TestProvider *provider);
+    GetUserJob *createJob(BlockingConfig *config, int user = 0);
+
+    MockServer *m_server = nullptr;
+    QNetworkAccessManager *m_nam = nullptr;
+};
+
+void CredentialProviderTest::initTestCase()
+{
+    m_server = new MockServer(this);
+    QVERIFY(m_server->start());
+    m_server->setCredentials(QStringLiteral("admin"), QStringLiteral("secret"));
+    m_nam = new QNetworkAccessManager(this);
+}
+
+BlockingConfig *CredentialProviderTest::createConfig(TestProvider *provider)
+{
+    auto conf = new BlockingConfig(this);
+    m_server->configure(conf);
+    conf->setCredentialProvider(provider);
+    return conf;
+}
+
+GetUserJob *CredentialProviderTest::createJob(BlockingConfig *config, int user)
+{
+    auto job = new GetUserJob(MockServer::userId(user), this);
+    job->setConfiguration(config);
+    job->setNetworkAccessManager(m_nam);
+    return job;
+}
+
+void CredentialProviderTest::testProvider()
+{
+    TestProvider provider;
+    QSignalSpy changedSpy(&provider, &AbstractCredentialProvider::credentialsChanged);
+    QVERIFY(!provider.hasCredentials());
+    QVERIFY(!provider.isFetching());
+
+    provider.fetch();
+    provider.fetch();
+    QVERIFY(provider.isFetching());
+    QVERIFY(changedSpy.wait());
+    QCOMPARE(provider.fetchCount, 1);
+    QVERIFY(provider.hasCredentials());
+    QVERIFY(!provider.isFetching());
+    QCOMPARE(provider.username(), QStringLiteral("admin"));
+    QCOMPARE(provider.password(), QStringLiteral("secret"));
+
+    provider.clear();
+    QVERIFY(!provider.hasCredentials());
+    QVERIFY(provider.password().isEmpty());
+    QCOMPARE(changedSpy.count(), 2);
+}
+
+void CredentialProviderTest::testConcurrentJobs()
+{
+    auto provider = new TestProvider(this);
+    auto conf = createConfig(provider);
+    m_server->resetStatistics();
+
+    const int count = 10;
+    QVector<GetUserJob*> jobs;
+    QVector<QSignalSpy*> spies;
+    for (int i = 0; i < count; ++i) {
+        GetUserJob *job = createJob(conf, i);
+        job->setAutoDelete(false);
+        spies.append(new QSignalSpy(job, &WJob::result));
+        jobs.append(job);
+        job->start();
+    }
+
+    for (int i = 0; i < count; ++i) {
+        if (spies.at(i)->isEmpty()) {
+            QVERIFY(spies.at(i)->wait());
+        }
+        QCOMPARE(jobs.at(i)->error(), 0);
+    }
+    qDeleteAll(spies);
+    qDeleteAll(jobs);
+
+    // one fetch for the whole burst and no blocking getter calls
+    QCOMPARE(provider->fetchCount, 1);
+    QCOMPARE(conf->passwordCalls, 0);
+    QCOMPARE(m_server->requestCount(), count);
+
+    // the credentials are cached for the next jobs
+    QVERIFY(createJob(conf)->exec());
+    QCOMPARE(provider->fetchCount, 1);
+
+    // changed credentials in the configuration clear the cache
+    conf->setPassword(QStringLiteral("ignored"));
+    QVERIFY(!provider->hasCredentials());
+    QVERIFY(createJob(conf)->exec());
+    QCOMPARE(provider->fetchCount, 2);
+    QCOMPARE(conf->passwordCalls, 0);
+}
+
+void CredentialProviderTest::testFetchFailed()
+{
+    auto provider = new TestProvider(this);
+    provider->errorString = QStringLiteral("secret service not available");
+    auto conf = createConfig(provider);
+
+    auto job = createJob(conf);
+    QSignalSpy failedSpy(job, &Job::failed);
+    QVERIFY(!job->exec());
+    QCOMPARE(job->error(), static_cast<int>(MissingPassword));
+    QCOMPARE(job->errorText(), provider->errorString);
+    QCOMPARE(failedSpy.count(), 1);
+    QVERIFY(!provider->hasCredentials());
+    QVERIFY(!provider->isFetching());
+}
+
+void CredentialProviderTest::testRejectedCredentials()
+{
+    auto provider = new TestProvider(this);
+    provider->password = QStringLiteral("outdated");
+    auto conf = createConfig(provider);
+
+    auto job = createJob(conf);
+    QVERIFY(!job->exec());
+    QCOMPARE(job->error(), static_cast<int>(AuthNFailed));
+
+    // the rejected credentials are not used again
+    QVERIFY(!provider->hasCredentials());
+    provider->password = QStringLiteral("secret");
+    QVERIFY(createJob(conf)->exec());
+    QCOMPARE(provider->fetchCount, 2);
+}
+
+void CredentialProviderTest::testKillWhileWaiting()
+{
+    auto provider = new TestProvider(this);
+    provider->errorString = QStringLiteral("secret service not available");
+    auto conf = createConfig(provider);
+    m_server->resetStatistics();
+
+    auto failingJob = createJob(conf);
+    failingJob->setAutoDelete(false);
+    QSignalSpy failingResultSpy(failingJob, &WJob::result);
+    QSignalSpy failedSpy(failingJob, &Job::failed);
+    failingJob->start();
+    QTRY_VERIFY(provider->isFetching());
+    QVERIFY(failingJob->kill(WJob::Quietly));
+
+    // the failed fetch does not finish the killed job again
+    QSignalSpy fetchFailedSpy(provider, &AbstractCredentialProvider::fetchFailed);
+    QVERIFY(fetchFailedSpy.wait());
+    QCOMPARE(failingResultSpy.count(), 0);
+    QCOMPARE(failedSpy.count(), 0);
+    delete failingJob;
+
+    provider->errorString.clear();
+    auto job = createJob(conf);
+    job->setAutoDelete(false);
+    QSignalSpy resultSpy(job, &WJob::result);
+    job->start();
+    QTRY_VERIFY(provider->isFetching());
+    QVERIFY(job->kill(WJob::Quietly));
+
+    // the fetched credentials do not send the request of the killed job
+    QSignalSpy changedSpy(provider, &AbstractCredentialProvider::credentialsChanged);
+    QVERIFY(changedSpy.wait());
+    QTest::qWait(20);
+    QCOMPARE(resultSpy.count(), 0);
+    QCOMPARE(m_server->requestCount(), 0);
+    delete job;
+}
+
+QTEST_MAIN(CredentialProviderTest)
+
+#include "testcredentialprovider.moc"
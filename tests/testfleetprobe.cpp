@@ -0,0 +1,208 @@
+/*
+ * SPDX-FileCopyrightText: (C) 2021 Matthias Fehring / www.huessenbergnetz.de
+ * SPDX-License-Identifier: LGPL-3.0-or-later
+ */
+
+#include "mockserver.h"
+#include <QTest>
+#include <QObject>
+#include <QSignalSpy>
+#include <QElapsedTimer>
+#include <QNetworkAccessManager>
+#include <Wolkanlin/FleetProbe>
+
+using namespace Wolkanlin;
+
+class FleetProbeTest : public QObject
+{
+    Q_OBJECT
+public:
+    FleetProbeTest(QObject *parent = nullptr) : QObject(parent) {}
+
+    ~FleetProbeTest() override = default;
+
+private slots:
+    void initTestCase();
+    void init();
+
+    void testDefaultValues();
+    void testEmptyUrls();
+    void testProbe();
+    void testTimeout();
+    void testConcurrency();
+
+private:
+    QString url(MockServer *server, const QString &path = QString()) const;
+
+    MockServer *m_server = nullptr;
+    MockServer *m_maintenanceServer = nullptr;
+    MockServer *m_slowServer = nullptr;
+    QNetworkAccessManager *m_nam = nullptr;
+};
+
+void FleetProbeTest::initTestCase()
+{
+    qRegisterMetaType<Wolkanlin::FleetProbe::Result>();
+
+    m_server = new MockServer(this);
+    QVERIFY(m_server->start());
+    m_server->setServerVersion(QStringLiteral("21.0.1.1"));
+
+    m_maintenanceServer = new MockServer(this);
+    QVERIFY(m_maintenanceServer->start());
+    m_maintenanceServer->setServerVersion(QStringLiteral("20.0.9.1"));
+    m_maintenanceServer->setMaintenance(true);
+    m_maintenanceServer->setNeedsDbUpgrade(true);
+
+    m_slowServer = new MockServer(this);
+    QVERIFY(m_slowServer->start());
+    m_slowServer->setLatency(2000);
+
+    m_nam = new QNetworkAccessManager(this);
+}
+
+void FleetProbeTest::init()
+{
+    m_server->setLatency(0);
+    m_server->resetStatistics();
+    m_maintenanceServer->resetStatistics();
+    m_slowServer->resetStatistics();
+}
+
+QString FleetProbeTest::url(MockServer *server, const QString &path) const
+{
+    return QStringLiteral("http://127.0.0.1:%1%2").arg(server->serverPort()).arg(path);
+}
+
+void FleetProbeTest::testDefaultValues()
+{
+    FleetProbe probe;
+    QVERIFY(!probe.configuration());
+    QVERIFY(probe.urls().isEmpty());
+    QCOMPARE(probe.maxConcurrentRequests(), 32);
+    QCOMPARE(probe.timeout(), 5000);
+    QVERIFY(!probe.networkAccessManager());
+    QVERIFY(probe.results().isEmpty());
+
+    probe.setMaxConcurrentRequests(0);
+    QCOMPARE(probe.maxConcurrentRequests(), 1);
+    probe.setTimeout(-1);
+    QCOMPARE(probe.timeout(), 1);
+}
+
+void FleetProbeTest::testEmptyUrls()
+{
+    auto probe = new FleetProbe(this);
+    QVERIFY(!probe->exec());
+    QCOMPARE(probe->error(), static_cast<int>(MissingHost));
+}
+
+void FleetProbeTest::testProbe()
+{
+    // a port that is not listening anymore
+    auto closed = new MockServer(this);
+    QVERIFY(closed->start());
+    const QString closedUrl = url(closed);
+    delete closed;
+
+    const QStringList urls({
+                               url(m_server),
+                               url(m_maintenanceServer, QStringLiteral("/nextcloud/")),
+                               QStringLiteral("ftp://example.com"),
+                               closedUrl,
+                               url(m_server)
+                           });
+
+    auto probe = new FleetProbe(urls, this);
+    probe->setNetworkAccessManager(m_nam);
+    QSignalSpy probedSpy(probe, &FleetProbe::probed);
+    QVERIFY(probe->exec());
+    QCOMPARE(probedSpy.count(), urls.size());
+
+    const QVector<FleetProbe::Result> results = probe->results();
+    QCOMPARE(results.size(), urls.size());
+
+    QCOMPARE(results.at(0).url, urls.at(0));
+    QCOMPARE(results.at(0).host, QStringLiteral("127.0.0.1"));
+    QVERIFY(results.at(0).isValid());
+    QCOMPARE(results.at(0).version, QStringLiteral("21.0.1.1"));
+    QCOMPARE(results.at(0).versionstring, QStringLiteral("21.0.1"));
+    QVERIFY(results.at(0).installed);
+    QVERIFY(!results.at(0).maintenance);
+    QVERIFY(!results.at(0).needsDbUpgrade);
+    QVERIFY(results.at(0).latency >= 0);
+
+    QVERIFY(results.at(1).isValid());
+    QCOMPARE(results.at(1).version, QStringLiteral("20.0.9.1"));
+    QVERIFY(results.at(1).maintenance);
+    QVERIFY(results.at(1).needsDbUpgrade);
+    QCOMPARE(m_maintenanceServer->requestsByPath().value(QByteArrayLiteral("/nextcloud/status.php")), 1);
+
+    QVERIFY(!results.at(2).isValid());
+    QCOMPARE(results.at(2).error, static_cast<int>(InvalidRequestUrl));
+
+    QVERIFY(!results.at(3).isValid());
+    QCOMPARE(results.at(3).error, static_cast<int>(NetworkError));
+
+    // the duplicate is only requested once but reported for its own URL
+    QVERIFY(results.at(4).isValid());
+    QCOMPARE(results.at(4).url, urls.at(4));
+    QCOMPARE(results.at(4).version, results.at(0).version);
+    QCOMPARE(m_server->requestCount(), 1);
+}
+
+void FleetProbeTest::testTimeout()
+{
+    auto probe = new FleetProbe({url(m_slowServer), url(m_server)}, this);
+    probe->setNetworkAccessManager(m_nam);
+    probe->setTimeout(200);
+
+    QElapsedTimer timer;
+    timer.start();
+    QVERIFY(probe->exec());
+    QVERIFY(timer.elapsed() < 2000);
+
+    const QVector<FleetProbe::Result> results = probe->results();
+    QCOMPARE(results.at(0).error, static_cast<int>(RequestTimedOut));
+    QVERIFY(results.at(0).latency >= 150);
+    QVERIFY(results.at(1).isValid());
+}
+
+void FleetProbeTest::testConcurrency()
+{
+    // every install path is a different server for the probe
+    const int count = 200;
+    const int latency = 20;
+    m_server->setLatency(latency);
+
+    QStringList urls;
+    urls.reserve(count);
+    for (int i = 0; i < count; ++i) {
+        urls.append(url(m_server, QStringLiteral("/cloud%1").arg(i)));
+    }
+
+    auto probe = new FleetProbe(urls, this);
+    probe->setNetworkAccessManager(m_nam);
+
+    QElapsedTimer timer;
+    timer.start();
+    QVERIFY(probe->exec());
+    const qint64 elapsed = timer.elapsed();
+
+    const QVector<FleetProbe::Result> results = probe->results();
+    QCOMPARE(results.size(), count);
+    for (const FleetProbe::Result &r : results) {
+        QVERIFY(r.isValid());
+    }
+    QCOMPARE(m_server->requestCount(), count);
+
+    // serial requests would take at least count * latency
+    QVERIFY(elapsed < count * latency);
+
+    // the connections to the host are reused by the shared network access manager
+    QVERIFY(m_server->connectionCount() < count);
+}
+
+QTEST_MAIN(FleetProbeTest)
+
+#include "testfleetprobe.moc"
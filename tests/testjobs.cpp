@@ -8,7 +8,10 @@
 #include <QObject>
 #include <QSignalSpy>
 #include <Wolkanlin/GetUserJob>
+#include <Wolkanlin/GetUserListJob>
+#include <Wolkanlin/GetUserDetailsListJob>
 #include <Wolkanlin/GetWipeStatusJob>
+#include <Wolkanlin/BulkUserFetcher>
 
 using namespace Wolkanlin;
 
@@ -28,8 +31,12 @@ private slots:
     void testMissingHost();
     void testMissingUsername();
     void testMissingPassword();
+    void testTimings();
     void testGetUserJob();
+    void testGetUserListJob();
+    void testGetUserDetailsListJob();
     void testGetWipeStatusJob();
+    void testBulkUserFetcher();
 
 private:
     TestConfig *m_config = nullptr;
@@ -119,6 +126,45 @@ void JobsTest::testMissingPassword()
     QCOMPARE(resultSpy.count(), 1);
 }
 
+void JobsTest::testTimings()
+{
+    qRegisterMetaType<JobTimings>();
+
+    JobTimings empty;
+    QVERIFY(empty.isEmpty());
+    QCOMPARE(empty.totalDuration(), static_cast<qint64>(-1));
+
+    auto job = new GetUserJob(QStringLiteral("user"), this);
+    auto conf = new TestConfig(false, this);
+    conf->setUsername(QStringLiteral("user"));
+    conf->setPassword(QStringLiteral("password"));
+    job->setConfiguration(conf);
+    job->setAutoDelete(false);
+    QVERIFY(job->timings().isEmpty());
+
+    QSignalSpy timingsSpy(job, &Job::timingsAvailable);
+    QVERIFY(!job->exec()); // fails because of the missing host
+    QCOMPARE(timingsSpy.count(), 1);
+
+    const JobTimings timings = job->timings();
+    QVERIFY(!timings.isEmpty());
+    QCOMPARE(timings.queued, static_cast<qint64>(0));
+    QVERIFY(timings.setupStarted >= 0);
+    QCOMPARE(timings.requestSent, static_cast<qint64>(-1));
+    QCOMPARE(timings.lastByte, static_cast<qint64>(-1));
+    QVERIFY(timings.finished >= timings.setupStarted);
+    QVERIFY(timings.queueDuration() >= 0);
+    QCOMPARE(timings.waitDuration(), static_cast<qint64>(-1));
+    QCOMPARE(timings.totalDuration(), timings.finished);
+    QCOMPARE(timingsSpy.at(0).at(0).value<JobTimings>().finished, timings.finished);
+
+    // deleting a job that has never been started does not finish the timings
+    auto unstarted = new GetUserJob(QStringLiteral("user"), this);
+    QSignalSpy unstartedSpy(unstarted, &Job::timingsAvailable);
+    delete unstarted;
+    QCOMPARE(unstartedSpy.count(), 0);
+}
+
 void JobsTest::testGetUserJob()
 {
     // test constructor
@@ -152,6 +198,129 @@ void JobsTest::testGetUserJob()
     }
 }
 
+void JobsTest::testGetUserListJob()
+{
+    auto job = new GetUserListJob(this);
+    QVERIFY(job->capabilities().testFlag(WJob::Killable));
+    QVERIFY(job->ids().empty());
+
+    // test search property
+    {
+        const QString search = QStringLiteral("tester");
+        QSignalSpy spy(job, &GetUserListJob::searchChanged);
+        QVERIFY(job->search().isEmpty()); // default value
+        job->setSearch(search);
+        QCOMPARE(job->search(), search);
+        QCOMPARE(spy.count(), 1);
+        QCOMPARE(spy.at(0).at(0).toString(), search);
+    }
+
+    // test limit property
+    {
+        QSignalSpy spy(job, &GetUserListJob::limitChanged);
+        QCOMPARE(job->limit(), -1); // default value
+        job->setLimit(50);
+        QCOMPARE(job->limit(), 50);
+        QCOMPARE(spy.count(), 1);
+        QCOMPARE(spy.at(0).at(0).toInt(), 50);
+    }
+
+    // test offset property
+    {
+        QSignalSpy spy(job, &GetUserListJob::offsetChanged);
+        QCOMPARE(job->offset(), 0); // default value
+        job->setOffset(100);
+        QCOMPARE(job->offset(), 100);
+        QCOMPARE(spy.count(), 1);
+        QCOMPARE(spy.at(0).at(0).toInt(), 100);
+        job->setOffset(-5);
+        QCOMPARE(job->offset(), 0);
+    }
+
+    // test fetchAllPages property
+    {
+        QSignalSpy spy(job, &GetUserListJob::fetchAllPagesChanged);
+        QVERIFY(!job->fetchAllPages()); // default value
+        job->setFetchAllPages(true);
+        QVERIFY(job->fetchAllPages());
+        QCOMPARE(spy.count(), 1);
+        QVERIFY(spy.at(0).at(0).toBool());
+    }
+
+    // test pageSize property
+    {
+        QSignalSpy spy(job, &GetUserListJob::pageSizeChanged);
+        QCOMPARE(job->pageSize(), 500); // default value
+        job->setPageSize(200);
+        QCOMPARE(job->pageSize(), 200);
+        QCOMPARE(spy.count(), 1);
+        QCOMPARE(spy.at(0).at(0).toInt(), 200);
+        job->setPageSize(0);
+        QCOMPARE(job->pageSize(), 1);
+    }
+
+    // test maxConcurrentPages property
+    {
+        QSignalSpy spy(job, &GetUserListJob::maxConcurrentPagesChanged);
+        QCOMPARE(job->maxConcurrentPages(), 4); // default value
+        job->setMaxConcurrentPages(8);
+        QCOMPARE(job->maxConcurrentPages(), 8);
+        QCOMPARE(spy.count(), 1);
+        QCOMPARE(spy.at(0).at(0).toInt(), 8);
+    }
+
+    // test killing a not yet finished job
+    {
+        auto killJob = new GetUserListJob(this);
+        killJob->setAutoDelete(false);
+        QSignalSpy resultSpy(killJob, &WJob::result);
+        killJob->setConfiguration(m_config);
+        killJob->start();
+        QVERIFY(killJob->kill(WJob::EmitResult));
+        QCOMPARE(resultSpy.count(), 1);
+        QCOMPARE(killJob->error(), static_cast<int>(WJob::KilledJobError));
+    }
+}
+
+void JobsTest::testGetUserDetailsListJob()
+{
+    auto job = new GetUserDetailsListJob(this);
+    QVERIFY(job->capabilities().testFlag(WJob::Killable));
+    QVERIFY(job->users().empty());
+
+    // test default values
+    QVERIFY(job->search().isEmpty());
+    QCOMPARE(job->limit(), -1);
+    QCOMPARE(job->offset(), 0);
+    QVERIFY(!job->fetchAllPages());
+    QCOMPARE(job->maxConcurrentPages(), 4);
+
+    // test pageSize property
+    {
+        QSignalSpy spy(job, &GetUserDetailsListJob::pageSizeChanged);
+        QCOMPARE(job->pageSize(), 100); // default value
+        job->setPageSize(50);
+        QCOMPARE(job->pageSize(), 50);
+        QCOMPARE(spy.count(), 1);
+        QCOMPARE(spy.at(0).at(0).toInt(), 50);
+        job->setPageSize(-1);
+        QCOMPARE(job->pageSize(), 1);
+    }
+
+    // test killing a not yet finished job
+    {
+        auto killJob = new GetUserDetailsListJob(this);
+        killJob->setAutoDelete(false);
+        QSignalSpy resultSpy(killJob, &WJob::result);
+        killJob->setConfiguration(m_config);
+        killJob->setFetchAllPages(true);
+        killJob->start();
+        QVERIFY(killJob->kill(WJob::EmitResult));
+        QCOMPARE(resultSpy.count(), 1);
+        QCOMPARE(killJob->error(), static_cast<int>(WJob::KilledJobError));
+    }
+}
+
 void JobsTest::testGetWipeStatusJob()
 {
     // test constructor
@@ -187,6 +356,79 @@ void JobsTest::testGetWipeStatusJob()
     }
 }
 
+void JobsTest::testBulkUserFetcher()
+{
+    auto fetcher = new BulkUserFetcher(this);
+    QVERIFY(fetcher->capabilities().testFlag(WJob::Killable));
+    QVERIFY(fetcher->ids().empty());
+    QVERIFY(fetcher->users().empty());
+    QVERIFY(fetcher->failedIds().empty());
+    QCOMPARE(fetcher->statistics().requested, 0);
+
+    // test constructor
+    {
+        const QStringList ids({QStringLiteral("user1"), QStringLiteral("user2")});
+        auto f = new BulkUserFetcher(ids, this);
+        QCOMPARE(f->ids(), ids);
+    }
+
+    // test maxConcurrentRequests property
+    {
+        QSignalSpy spy(fetcher, &BulkUserFetcher::maxConcurrentRequestsChanged);
+        QCOMPARE(fetcher->maxConcurrentRequests(), 6); // default value
+        fetcher->setMaxConcurrentRequests(10);
+        QCOMPARE(fetcher->maxConcurrentRequests(), 10);
+        QCOMPARE(spy.count(), 1);
+        QCOMPARE(spy.at(0).at(0).toInt(), 10);
+        fetcher->setMaxConcurrentRequests(0);
+        QCOMPARE(fetcher->maxConcurrentRequests(), 1);
+    }
+
+    // test maxRetries property
+    {
+        QSignalSpy spy(fetcher, &BulkUserFetcher::maxRetriesChanged);
+        QCOMPARE(fetcher->maxRetries(), 2); // default value
+        fetcher->setMaxRetries(0);
+        QCOMPARE(fetcher->maxRetries(), 0);
+        QCOMPARE(spy.count(), 1);
+        fetcher->setMaxRetries(-1);
+        QCOMPARE(fetcher->maxRetries(), 0);
+        QCOMPARE(spy.count(), 1);
+    }
+
+    // test retryDelay property
+    {
+        QSignalSpy spy(fetcher, &BulkUserFetcher::retryDelayChanged);
+        QCOMPARE(fetcher->retryDelay(), 500); // default value
+        fetcher->setRetryDelay(100);
+        QCOMPARE(fetcher->retryDelay(), 100);
+        QCOMPARE(spy.count(), 1);
+        QCOMPARE(spy.at(0).at(0).toInt(), 100);
+    }
+
+    // test empty list of ids
+    {
+        auto f = new BulkUserFetcher(QStringList({QString()}), this);
+        f->setConfiguration(m_config);
+        QSignalSpy resultSpy(f, &WJob::result);
+        QVERIFY(!f->exec());
+        QCOMPARE(f->error(), static_cast<int>(Wolkanlin::EmptyUser));
+        QCOMPARE(resultSpy.count(), 1);
+    }
+
+    // test killing a not yet finished fetcher
+    {
+        auto killFetcher = new BulkUserFetcher(QStringList({QStringLiteral("user1")}), this);
+        killFetcher->setAutoDelete(false);
+        QSignalSpy resultSpy(killFetcher, &WJob::result);
+        killFetcher->setConfiguration(m_config);
+        killFetcher->start();
+        QVERIFY(killFetcher->kill(WJob::EmitResult));
+        QCOMPARE(resultSpy.count(), 1);
+        QCOMPARE(killFetcher->error(), static_cast<int>(WJob::KilledJobError));
+    }
+}
+
 QTEST_MAIN(JobsTest)
 
 #include "testjobs.moc"
@@ -0,0 +1,164 @@
+/*
+ * SPDX-FileCopyrightText: (C) 2021 Matthias Fehring / www.huessenbergnetz.de
+ * SPDX-License-Identifier: LGPL-3.0-or-later
+ */
+
+#include "testconfig.h"
+#include <QTest>
+#include <QObject>
+#include <Wolkanlin/MetricsRegistry>
+#include <Wolkanlin/GetUserJob>
+
+using namespace Wolkanlin;
+
+class MetricsRegistryTest : public QObject
+{
+    Q_OBJECT
+public:
+    MetricsRegistryTest(QObject *parent = nullptr);
+    ~MetricsRegistryTest() override;
+
+private slots:
+    void testDefaultConstructor();
+    void testRecordRequest();
+    void testRetriesAndCacheHits();
+    void testDisabled();
+    void testPrometheus();
+    void testJobRecording();
+};
+
+MetricsRegistryTest::MetricsRegistryTest(QObject *parent) : QObject(parent)
+{
+
+}
+
+MetricsRegistryTest::~MetricsRegistryTest() = default;
+
+void MetricsRegistryTest::testDefaultConstructor()
+{
+    MetricsRegistry reg;
+    QVERIFY(reg.isEnabled());
+    QVERIFY(reg.metrics().empty());
+    QVERIFY(reg.toPrometheus().isEmpty());
+
+    const MetricsRegistry::EndpointMetrics m = reg.metrics(QStringLiteral("GetUserJob"), QStringLiteral("localhost"));
+    QCOMPARE(m.endpoint, QStringLiteral("GetUserJob"));
+    QCOMPARE(m.host, QStringLiteral("localhost"));
+    QCOMPARE(m.requests, static_cast<qint64>(0));
+    QCOMPARE(m.latencyCounts.size(), MetricsRegistry::latencyBuckets().size() + 1);
+}
+
+void MetricsRegistryTest::testRecordRequest()
+{
+    MetricsRegistry reg;
+    const QString endpoint = QStringLiteral("GetUserJob");
+    const QString host = QStringLiteral("localhost");
+
+    reg.recordRequest(endpoint, host, 0, 3000000, 0, 100);           // 3ms
+    reg.recordRequest(endpoint, host, 0, 75000000, 10, 200);         // 75ms
+    reg.recordRequest(endpoint, host, 16, 20000000000, 0, 0);        // 20s
+    reg.recordRequest(endpoint, host, 16, -1, 0, 0);
+    reg.recordRequest(QStringLiteral("GetUserListJob"), host, 0, 1000000, 0, 50);
+
+    QCOMPARE(reg.metrics().size(), 2);
+
+    const MetricsRegistry::EndpointMetrics m = reg.metrics(endpoint, host);
+    QCOMPARE(m.requests, static_cast<qint64>(4));
+    QCOMPARE(m.failures, static_cast<qint64>(2));
+    QCOMPARE(m.errors.value(16), static_cast<qint64>(2));
+    QCOMPARE(m.bytesSent, static_cast<qint64>(10));
+    QCOMPARE(m.bytesReceived, static_cast<qint64>(300));
+    QCOMPARE(m.latencyCount, static_cast<qint64>(3));
+    QCOMPARE(m.latencyCounts.at(0), static_cast<qint64>(1));
+    QCOMPARE(m.latencyCounts.at(4), static_cast<qint64>(1));
+    QCOMPARE(m.latencyCounts.last(), static_cast<qint64>(1));
+    QVERIFY(qAbs(m.latencySum - 20.078) < 0.0001);
+
+    reg.clear();
+    QVERIFY(reg.metrics().empty());
+}
+
+void MetricsRegistryTest::testRetriesAndCacheHits()
+{
+    MetricsRegistry reg;
+    const QString endpoint = QStringLiteral("GetUserJob");
+    const QString host = QStringLiteral("localhost");
+
+    reg.recordRetry(endpoint, host);
+    reg.recordRetry(endpoint, host, 2);
+    reg.recordRetry(endpoint, host, 0);
+    reg.recordCacheHit(endpoint, host, 5);
+
+    const MetricsRegistry::EndpointMetrics m = reg.metrics(endpoint, host);
+    QCOMPARE(m.retries, static_cast<qint64>(3));
+    QCOMPARE(m.cacheHits, static_cast<qint64>(5));
+    QCOMPARE(m.requests, static_cast<qint64>(0));
+}
+
+void MetricsRegistryTest::testDisabled()
+{
+    MetricsRegistry reg;
+    reg.setEnabled(false);
+    QVERIFY(!reg.isEnabled());
+    reg.recordRequest(QStringLiteral("GetUserJob"), QStringLiteral("localhost"), 0, 1000, 0, 0);
+    reg.recordRetry(QStringLiteral("GetUserJob"), QStringLiteral("localhost"));
+    QVERIFY(reg.metrics().empty());
+    reg.setEnabled(true);
+    QVERIFY(reg.isEnabled());
+}
+
+void MetricsRegistryTest::testPrometheus()
+{
+    MetricsRegistry reg;
+    reg.recordRequest(QStringLiteral("GetUserJob"), QStringLiteral("cloud.example.com"), 0, 30000000, 0, 512);
+    reg.recordRequest(QStringLiteral("GetUserJob"), QStringLiteral("cloud.example.com"), 17, 300000000, 0, 0);
+    reg.recordRetry(QStringLiteral("GetUserJob"), QStringLiteral("cloud.example.com"));
+    reg.recordRequest(QStringLiteral("Get\"Job"), QStringLiteral("host"), 0, 0, 0, 0);
+
+    const QByteArray out = reg.toPrometheus();
+    const QByteArray labels = QByteArrayLiteral("endpoint=\"GetUserJob\",host=\"cloud.example.com\"");
+
+    QVERIFY(out.contains(QByteArrayLiteral("# TYPE wolkanlin_requests_total counter\n")));
+    QVERIFY(out.contains(QByteArrayLiteral("# TYPE wolkanlin_request_duration_seconds histogram\n")));
+    QVERIFY(out.contains(QByteArrayLiteral("wolkanlin_requests_total{") + labels + QByteArrayLiteral("} 2\n")));
+    QVERIFY(out.contains(QByteArrayLiteral("wolkanlin_request_errors_total{") + labels + QByteArrayLiteral(",code=\"17\"} 1\n")));
+    QVERIFY(out.contains(QByteArrayLiteral("wolkanlin_bytes_received_total{") + labels + QByteArrayLiteral("} 512\n")));
+    QVERIFY(out.contains(QByteArrayLiteral("wolkanlin_retries_total{") + labels + QByteArrayLiteral("} 1\n")));
+    QVERIFY(out.contains(QByteArrayLiteral("wolkanlin_request_duration_seconds_bucket{") + labels + QByteArrayLiteral(",le=\"0.025\"} 0\n")));
+    QVERIFY(out.contains(QByteArrayLiteral("wolkanlin_request_duration_seconds_bucket{") + labels + QByteArrayLiteral(",le=\"0.05\"} 1\n")));
+    QVERIFY(out.contains(QByteArrayLiteral("wolkanlin_request_duration_seconds_bucket{") + labels + QByteArrayLiteral(",le=\"0.5\"} 2\n")));
+    QVERIFY(out.contains(QByteArrayLiteral("wolkanlin_request_duration_seconds_bucket{") + labels + QByteArrayLiteral(",le=\"+Inf\"} 2\n")));
+    QVERIFY(out.contains(QByteArrayLiteral("wolkanlin_request_duration_seconds_count{") + labels + QByteArrayLiteral("} 2\n")));
+    QVERIFY(out.contains(QByteArrayLiteral("wolkanlin_requests_total{endpoint=\"Get\\\"Job\",host=\"host\"} 1\n")));
+}
+
+void MetricsRegistryTest::testJobRecording()
+{
+    MetricsRegistry *reg = MetricsRegistry::global();
+    reg->clear();
+
+    auto conf = new TestConfig(false, this);
+    conf->setUsername(QStringLiteral("user"));
+    conf->setPassword(QStringLiteral("password"));
+
+    auto job = new GetUserJob(QStringLiteral("user"), this);
+    job->setConfiguration(conf);
+    QVERIFY(!job->exec()); // fails because of the missing host
+
+    const MetricsRegistry::EndpointMetrics m = reg->metrics(QStringLiteral("GetUserJob"), QString());
+    QCOMPARE(m.requests, static_cast<qint64>(1));
+    QCOMPARE(m.failures, static_cast<qint64>(1));
+    QCOMPARE(m.errors.value(static_cast<int>(Wolkanlin::MissingHost)), static_cast<qint64>(1));
+    QCOMPARE(m.latencyCount, static_cast<qint64>(1));
+
+    reg->setEnabled(false);
+    auto job2 = new GetUserJob(QStringLiteral("user"), this);
+    job2->setConfiguration(conf);
+    QVERIFY(!job2->exec());
+    QCOMPARE(reg->metrics(QStringLiteral("GetUserJob"), QString()).requests, static_cast<qint64>(1));
+    reg->setEnabled(true);
+}
+
+QTEST_MAIN(MetricsRegistryTest)
+
+#include "testmetricsregistry.moc"
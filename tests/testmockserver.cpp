@@ -0,0 +1,312 @@
+/*
+ * SPDX-FileCopyrightText: (C) 2021 Matthias Fehring / www.huessenbergnetz.de
+ * SPDX-License-Identifier: LGPL-3.0-or-later
+ */
+
+#include "testconfig.h"
+#include "mockserver.h"
+#include <QTest>
+#include <QObject>
+#include <QNetworkAccessManager>
+#include <QJsonObject>
+#include <Wolkanlin/GetServerStatusJob>
+#include <Wolkanlin/ServerStatus>
+#include <Wolkanlin/GetUserJob>
+#include <Wolkanlin/GetUserListJob>
+#include <Wolkanlin/GetUserDetailsListJob>
+#include <Wolkanlin/GetAppPasswordJob>
+#include <Wolkanlin/DeleteAppPasswordJob>
+#include <Wolkanlin/GetWipeStatusJob>
+#include <memory>
+
+using namespace Wolkanlin;
+
+class MockServerTest : public QObject
+{
+    Q_OBJECT
+public:
+    MockServerTest(QObject *parent = nullptr) : QObject(parent) {}
+
+    ~MockServerTest() override = default;
+
+private slots:
+    void initTestCase();
+    void init();
+
+    void testServerStatus();
+    void testGetUser();
+    void testUserNotFound();
+    void testAuthenticationFailed();
+    void testUserList();
+    void testUserDetailsList();
+    void testAppPassword();
+    void testWipeStatus();
+    void testErrorInjection();
+    void testThrottling();
+    void testLatency();
+    void testConnectionReuse();
+
+private:
+
+    MockServer *m_server = nullptr;
+    QNetworkAccessManager *m_nam = nullptr;
+};
+
+void MockServerTest::initTestCase()
+{
+    m_server = new MockServer(this);
+    QVERIFY(m_server->start());
+    m_server->setCredentials(QStringLiteral("admin"), QStringLiteral("password"));
+    m_nam = new QNetworkAccessManager(this);
+}
+
+void MockServerTest::init()
+{
+    m_server->setUserCount(100);
+    m_server->setLatency(0);
+    m_server->setFailEveryNthRequest(0);
+    m_server->failNextRequests(0);
+    m_server->setMaxRequestsPerSecond(0);
+    m_server->setKeepAlive(true);
+    m_server->resetStatistics();
+}
+
+void MockServerTest::testServerStatus()
+{
+    m_server->setServerVersion(QStringLiteral("21.0.1.1"));
+
+    auto job = new GetServerStatusJob(this);
+    job->setConfiguration(m_server->createConfig(this));
+    job->setNetworkAccessManager(m_nam);
+    QVERIFY(job->exec());
+
+    std::unique_ptr<ServerStatus> status(ServerStatus::fromJson(job->replyData()));
+    QCOMPARE(status->version(), QStringLiteral("21.0.1.1"));
+    QCOMPARE(status->versionstring(), QStringLiteral("21.0.1"));
+    QVERIFY(status->isInstalled());
+    QCOMPARE(m_server->requestCount(), 1);
+}
+
+void MockServerTest::testGetUser()
+{
+    auto job = new GetUserJob(MockServer::userId(42), this);
+    job->setConfiguration(m_server->createConfig(this));
+    job->setNetworkAccessManager(m_nam);
+    QVERIFY(job->exec());
+
+    const QJsonObject data = job->replyData().object().value(QStringLiteral("ocs")).toObject().value(QStringLiteral("data")).toObject();
+    QCOMPARE(data, MockServer::userData(42));
+}
+
+void MockServerTest::testUserNotFound()
+{
+    auto job = new GetUserJob(QStringLiteral("unknown"), this);
+    job->setConfiguration(m_server->createConfig(this));
+    job->setNetworkAccessManager(m_nam);
+    QVERIFY(!job->exec());
+    QCOMPARE(job->error(), static_cast<int>(Wolkanlin::NotFound));
+}
+
+void MockServerTest::testAuthenticationFailed()
+{
+    auto conf = m_server->createConfig(this);
+    conf->setPassword(QStringLiteral("wrong"));
+    auto job = new GetUserJob(MockServer::userId(1), this);
+    job->setConfiguration(conf);
+    job->setNetworkAccessManager(m_nam);
+    QVERIFY(!job->exec());
+    QCOMPARE(job->error(), static_cast<int>(Wolkanlin::AuthNFailed));
+}
+
+void MockServerTest::testUserList()
+{
+    m_server->setUserCount(250);
+
+    auto job = new GetUserListJob(this);
+    job->setConfiguration(m_server->createConfig(this));
+    job->setNetworkAccessManager(m_nam);
+    job->setFetchAllPages(true);
+    job->setPageSize(100);
+    QVERIFY(job->exec());
+
+    const QStringList ids = job->ids();
+    QCOMPARE(ids.size(), 250);
+    QCOMPARE(ids.first(), MockServer::userId(0));
+    QCOMPARE(ids.last(), MockServer::userId(249));
+
+    // the limit is respected when fetching all pages
+    m_server->resetStatistics();
+    job = new GetUserListJob(this);
+    job->setConfiguration(m_server->createConfig(this));
+    job->setNetworkAccessManager(m_nam);
+    job->setFetchAllPages(true);
+    job->setPageSize(100);
+    job->setOffset(20);
+    job->setLimit(200);
+    QVERIFY(job->exec());
+    QCOMPARE(job->ids().size(), 200);
+    QCOMPARE(job->ids().first(), MockServer::userId(20));
+    QCOMPARE(job->ids().last(), MockServer::userId(219));
+    QCOMPARE(m_server->requestCount(), 2);
+
+    job = new GetUserListJob(this);
+    job->setConfiguration(m_server->createConfig(this));
+    job->setNetworkAccessManager(m_nam);
+    job->setFetchAllPages(true);
+    job->setPageSize(100);
+    job->setLimit(130);
+    QVERIFY(job->exec());
+    QCOMPARE(job->ids().size(), 130);
+    QCOMPARE(job->ids().last(), MockServer::userId(129));
+}
+
+void MockServerTest::testUserDetailsList()
+{
+    m_server->setUserCount(120);
+
+    auto job = new GetUserDetailsListJob(this);
+    job->setConfiguration(m_server->createConfig(this));
+    job->setNetworkAccessManager(m_nam);
+    job->setFetchAllPages(true);
+    job->setPageSize(50);
+    QVERIFY(job->exec());
+    QCOMPARE(job->users().size(), 120);
+
+    m_server->setUserCount(0);
+    job = new GetUserDetailsListJob(this);
+    job->setConfiguration(m_server->createConfig(this));
+    job->setNetworkAccessManager(m_nam);
+    QVERIFY(job->exec());
+    QVERIFY(job->users().empty());
+}
+
+void MockServerTest::testAppPassword()
+{
+    auto getJob = new GetAppPasswordJob(this);
+    getJob->setConfiguration(m_server->createConfig(this));
+    getJob->setNetworkAccessManager(m_nam);
+    QVERIFY(getJob->exec());
+
+    const QString appPassword = getJob->replyData().object().value(QStringLiteral("ocs")).toObject().value(QStringLiteral("data")).toObject().value(QStringLiteral("apppassword")).toString();
+    QVERIFY(!appPassword.isEmpty());
+    QVERIFY(m_server->appPasswords().contains(appPassword));
+
+    auto appPasswordConf = m_server->createConfig(this);
+    appPasswordConf->setPassword(appPassword);
+
+    getJob = new GetAppPasswordJob(this);
+    getJob->setConfiguration(appPasswordConf);
+    getJob->setNetworkAccessManager(m_nam);
+    QVERIFY(!getJob->exec());
+    QCOMPARE(getJob->error(), static_cast<int>(Wolkanlin::AlreadyAppPassword));
+
+    auto delJob = new DeleteAppPasswordJob(this);
+    delJob->setConfiguration(appPasswordConf);
+    delJob->setNetworkAccessManager(m_nam);
+    QVERIFY(delJob->exec());
+    QVERIFY(!m_server->appPasswords().contains(appPassword));
+}
+
+void MockServerTest::testWipeStatus()
+{
+    m_server->setWipeTokens({QStringLiteral("wipe-me")});
+
+    auto job = new GetWipeStatusJob(QStringLiteral("wipe-me"), this);
+    job->setConfiguration(m_server->createConfig(this));
+    job->setNetworkAccessManager(m_nam);
+    QVERIFY(job->exec());
+    QVERIFY(job->replyData().object().value(QStringLiteral("wipe")).toBool());
+
+    job = new GetWipeStatusJob(QStringLiteral("keep-me"), this);
+    job->setConfiguration(m_server->createConfig(this));
+    job->setNetworkAccessManager(m_nam);
+    QVERIFY(job->exec());
+    QVERIFY(!job->replyData().object().value(QStringLiteral("wipe")).toBool());
+}
+
+void MockServerTest::testErrorInjection()
+{
+    m_server->failNextRequests(1, 503);
+
+    auto job = new GetServerStatusJob(this);
+    job->setConfiguration(m_server->createConfig(this));
+    job->setNetworkAccessManager(m_nam);
+    QVERIFY(!job->exec());
+    QCOMPARE(job->error(), static_cast<int>(Wolkanlin::NetworkError));
+
+    job = new GetServerStatusJob(this);
+    job->setConfiguration(m_server->createConfig(this));
+    job->setNetworkAccessManager(m_nam);
+    QVERIFY(job->exec());
+
+    m_server->setFailEveryNthRequest(2);
+    m_server->resetStatistics();
+    int failed = 0;
+    for (int i = 0; i < 4; ++i) {
+        job = new GetServerStatusJob(this);
+        job->setConfiguration(m_server->createConfig(this));
+        job->setNetworkAccessManager(m_nam);
+        if (!job->exec()) {
+            failed++;
+        }
+    }
+    QCOMPARE(failed, 2);
+    QCOMPARE(m_server->failedRequestCount(), 2);
+}
+
+void MockServerTest::testThrottling()
+{
+    m_server->setMaxRequestsPerSecond(2);
+
+    int failed = 0;
+    for (int i = 0; i < 3; ++i) {
+        auto job = new GetServerStatusJob(this);
+        job->setConfiguration(m_server->createConfig(this));
+        job->setNetworkAccessManager(m_nam);
+        if (!job->exec()) {
+            failed++;
+        }
+    }
+    QCOMPARE(failed, 1);
+    QCOMPARE(m_server->throttledRequestCount(), 1);
+}
+
+void MockServerTest::testLatency()
+{
+    m_server->setLatency(50);
+
+    auto job = new GetServerStatusJob(this);
+    job->setConfiguration(m_server->createConfig(this));
+    job->setNetworkAccessManager(m_nam);
+    job->setAutoDelete(false);
+    QVERIFY(job->exec());
+    QVERIFY(job->timings().waitDuration() >= 50000000);
+    delete job;
+}
+
+void MockServerTest::testConnectionReuse()
+{
+    auto nam = new QNetworkAccessManager(this);
+    for (int i = 0; i < 5; ++i) {
+        auto job = new GetServerStatusJob(this);
+        job->setConfiguration(m_server->createConfig(this));
+        job->setNetworkAccessManager(nam);
+        QVERIFY(job->exec());
+    }
+    QCOMPARE(m_server->requestCount(), 5);
+    QCOMPARE(m_server->connectionCount(), 1);
+
+    m_server->setKeepAlive(false);
+    m_server->resetStatistics();
+    for (int i = 0; i < 3; ++i) {
+        auto job = new GetServerStatusJob(this);
+        job->setConfiguration(m_server->createConfig(this));
+        job->setNetworkAccessManager(nam);
+        QVERIFY(job->exec());
+    }
+    QCOMPARE(m_server->connectionCount(), 3);
+}
+
+QTEST_MAIN(MockServerTest)
+
+#include "testmockserver.moc"
@@ -0,0 +1,266 @@
+/*
+ * SPDX-FileCopyrightText: (C) 2021 Matthias Fehring / www.huessenbergnetz.de
+ * SPDX-License-Identifier: LGPL-3.0-or-later
+ */
+
+#include "testconfig.h"
+#include "mockserver.h"
+#include <QTest>
+#include <QObject>
+#include <QSignalSpy>
+#include <QNetworkAccessManager>
+#include <Wolkanlin/QuotaMonitor>
+#include <Wolkanlin/Quota>
+
+using namespace Wolkanlin;
+
+class QuotaMonitorTest : public QObject
+{
+    Q_OBJECT
+public:
+    QuotaMonitorTest(QObject *parent = nullptr) : QObject(parent) {}
+
+    ~QuotaMonitorTest() override = default;
+
+private slots:
+    void initTestCase();
+    void init();
+
+    void testDefaultValues();
+    void testIntervals();
+    void testThresholds();
+    void testFastChangingUsage();
+    void testRequestBudget();
+    void testFailureBackoff();
+
+private:
+    QuotaMonitor *createMonitor(const QString &password = QStringLiteral("password"));
+
+    static constexpr qint64 total = 1073741824;
+
+    MockServer *m_server = nullptr;
+    QNetworkAccessManager *m_nam = nullptr;
+};
+
+constexpr qint64 QuotaMonitorTest::total;
+
+void QuotaMonitorTest::initTestCase()
+{
+    qRegisterMetaType<Wolkanlin::Quota>();
+
+    m_server = new MockServer(this);
+    QVERIFY(m_server->start());
+    m_server->setCredentials(QStringLiteral("admin"), QStringLiteral("password"));
+    m_nam = new QNetworkAccessManager(this);
+}
+
+void QuotaMonitorTest::init()
+{
+    m_server->setUserCount(100);
+    for (int i = 0; i < 4; ++i) {
+        m_server->setUserUsed(i, -1);
+    }
+    m_server->resetStatistics();
+}
+
+QuotaMonitor *QuotaMonitorTest::createMonitor(const QString &password)
+{
+    auto conf = m_server->createConfig(this);
+    conf->setPassword(password);
+
+    auto monitor = new QuotaMonitor(this);
+    monitor->setConfiguration(conf);
+    monitor->setNetworkAccessManager(m_nam);
+    monitor->setRequestsPerMinute(6000);
+    monitor->setMinInterval(50);
+    monitor->setMaxInterval(10000);
+    return monitor;
+}
+
+void QuotaMonitorTest::testDefaultValues()
+{
+    QuotaMonitor monitor;
+    QVERIFY(!monitor.configuration());
+    QVERIFY(monitor.ids().isEmpty());
+    QCOMPARE(monitor.requestsPerMinute(), 60);
+    QCOMPARE(monitor.minInterval(), 60000);
+    QCOMPARE(monitor.maxInterval(), 86400000);
+    QVERIFY(!monitor.isRunning());
+    QCOMPARE(monitor.thresholds(), QList<double>({80.0, 90.0, 100.0}));
+    QVERIFY(!monitor.networkAccessManager());
+    QVERIFY(monitor.quota(QStringLiteral("user000000")).isNull());
+    QCOMPARE(monitor.interval(QStringLiteral("user000000")), static_cast<qint64>(0));
+
+    monitor.setRequestsPerMinute(0);
+    QCOMPARE(monitor.requestsPerMinute(), 1);
+    monitor.setMaxInterval(1000);
+    QCOMPARE(monitor.maxInterval(), 60000);
+    monitor.setMinInterval(100000);
+    QCOMPARE(monitor.maxInterval(), 100000);
+    monitor.setThresholds({95.0, 50.0, 95.0});
+    QCOMPARE(monitor.thresholds(), QList<double>({50.0, 95.0}));
+}
+
+void QuotaMonitorTest::testIntervals()
+{
+    auto monitor = createMonitor();
+    const QString empty = MockServer::userId(0);
+    const QString half = MockServer::userId(1);
+    const QString full = MockServer::userId(2);
+    m_server->setUserUsed(1, total / 2);
+    m_server->setUserUsed(2, total / 100 * 95);
+
+    QSignalSpy updatedSpy(monitor, &QuotaMonitor::quotaUpdated);
+    QSignalSpy runningSpy(monitor, &QuotaMonitor::isRunningChanged);
+    monitor->setIds({empty, half, full, empty});
+    monitor->start();
+    QVERIFY(monitor->isRunning());
+    QCOMPARE(runningSpy.count(), 1);
+
+    while (updatedSpy.count() < 3) {
+        QVERIFY(updatedSpy.wait());
+    }
+
+    QCOMPARE(monitor->quota(empty).used(), static_cast<qint64>(0));
+    QCOMPARE(monitor->quota(half).used(), total / 2);
+
+    // the interval shrinks quadratically with the relative usage
+    QCOMPARE(monitor->interval(empty), static_cast<qint64>(10000));
+    QCOMPARE(monitor->interval(half), static_cast<qint64>(2500));
+    QCOMPARE(monitor->interval(full), static_cast<qint64>(50));
+
+    monitor->stop();
+    QVERIFY(!monitor->isRunning());
+    QCOMPARE(runningSpy.count(), 2);
+
+    // the duplicate id is only requested once
+    QCOMPARE(m_server->requestCount(), 3);
+}
+
+void QuotaMonitorTest::testThresholds()
+{
+    auto monitor = createMonitor();
+    const QString id = MockServer::userId(1);
+    monitor->setThresholds({50.0, 90.0});
+    m_server->setUserUsed(1, total / 100 * 95);
+
+    QSignalSpy updatedSpy(monitor, &QuotaMonitor::quotaUpdated);
+    QSignalSpy thresholdSpy(monitor, &QuotaMonitor::thresholdCrossed);
+    monitor->setIds({id});
+    monitor->start();
+    QVERIFY(updatedSpy.wait());
+
+    // the first quota is compared against an empty storage
+    QCOMPARE(thresholdSpy.count(), 2);
+    QCOMPARE(thresholdSpy.at(0).at(0).toString(), id);
+    QCOMPARE(thresholdSpy.at(0).at(1).toDouble(), 50.0);
+    QCOMPARE(thresholdSpy.at(0).at(2).toBool(), true);
+    QCOMPARE(thresholdSpy.at(1).at(1).toDouble(), 90.0);
+    QCOMPARE(thresholdSpy.at(1).at(2).toBool(), true);
+    thresholdSpy.clear();
+
+    m_server->setUserUsed(1, total / 4 * 3);
+    monitor->refresh(id);
+    QVERIFY(updatedSpy.wait());
+    QCOMPARE(thresholdSpy.count(), 1);
+    QCOMPARE(thresholdSpy.at(0).at(1).toDouble(), 90.0);
+    QCOMPARE(thresholdSpy.at(0).at(2).toBool(), false);
+    QCOMPARE(thresholdSpy.at(0).at(3).value<Quota>().relative(), 75.0);
+    thresholdSpy.clear();
+
+    // no threshold crossed
+    m_server->setUserUsed(1, total / 8 * 5);
+    monitor->refresh(id);
+    QVERIFY(updatedSpy.wait());
+    QCOMPARE(thresholdSpy.count(), 0);
+
+    m_server->setUserUsed(1, -1);
+    monitor->refresh(id);
+    QVERIFY(updatedSpy.wait());
+    QCOMPARE(thresholdSpy.count(), 1);
+    QCOMPARE(thresholdSpy.at(0).at(1).toDouble(), 50.0);
+    QCOMPARE(thresholdSpy.at(0).at(2).toBool(), false);
+
+    // removed users are dropped
+    monitor->setIds(QStringList());
+    QVERIFY(monitor->quota(id).isNull());
+    QCOMPARE(monitor->interval(id), static_cast<qint64>(0));
+}
+
+void QuotaMonitorTest::testFastChangingUsage()
+{
+    auto monitor = createMonitor();
+    monitor->setMaxInterval(100000);
+    const QString id = MockServer::userId(0);
+
+    QSignalSpy updatedSpy(monitor, &QuotaMonitor::quotaUpdated);
+    monitor->setIds({id});
+    monitor->start();
+    QVERIFY(updatedSpy.wait());
+    QCOMPARE(monitor->interval(id), static_cast<qint64>(100000));
+
+    // a fast growing usage is requested more often than the relative usage alone requires
+    m_server->setUserUsed(0, total / 5);
+    monitor->refresh(id);
+    QVERIFY(updatedSpy.wait());
+    QVERIFY(monitor->interval(id) < 64000);
+    QCOMPARE(monitor->interval(id), static_cast<qint64>(50));
+
+    monitor->stop();
+}
+
+void QuotaMonitorTest::testRequestBudget()
+{
+    auto monitor = createMonitor();
+    // every user wants to be requested every 50ms, but the budget only allows a request every 100ms
+    monitor->setMaxInterval(50);
+    monitor->setRequestsPerMinute(600);
+
+    QStringList ids;
+    for (int i = 0; i < 20; ++i) {
+        ids.append(MockServer::userId(i));
+    }
+
+    QSignalSpy updatedSpy(monitor, &QuotaMonitor::quotaUpdated);
+    monitor->setIds(ids);
+    monitor->start();
+    QTest::qWait(1050);
+    monitor->stop();
+
+    QVERIFY(m_server->requestCount() >= 5);
+    QVERIFY(m_server->requestCount() <= 12);
+
+    // users are requested in the order of the list
+    QVERIFY(!updatedSpy.isEmpty());
+    QCOMPARE(updatedSpy.at(0).at(0).toString(), ids.at(0));
+}
+
+void QuotaMonitorTest::testFailureBackoff()
+{
+    auto monitor = createMonitor(QStringLiteral("wrong"));
+    const QString id = MockServer::userId(0);
+
+    QSignalSpy failedSpy(monitor, &QuotaMonitor::requestFailed);
+    QSignalSpy updatedSpy(monitor, &QuotaMonitor::quotaUpdated);
+    monitor->setIds({id});
+    monitor->start();
+
+    QVERIFY(failedSpy.wait());
+    QCOMPARE(failedSpy.at(0).at(0).toString(), id);
+    QCOMPARE(monitor->interval(id), static_cast<qint64>(50));
+
+    QVERIFY(failedSpy.wait());
+    QCOMPARE(monitor->interval(id), static_cast<qint64>(100));
+
+    QVERIFY(failedSpy.wait());
+    QCOMPARE(monitor->interval(id), static_cast<qint64>(200));
+
+    QVERIFY(updatedSpy.isEmpty());
+    QVERIFY(monitor->quota(id).isNull());
+
+    monitor->stop();
+}
+
+QTEST_MAIN(QuotaMonitorTest)
+
+#include "testquotamonitor.moc"
@@ -6,6 +6,7 @@
 #include <QTest>
 #include <QObject>
 #include <QDataStream>
+#include <QJsonDocument>
 #include <Wolkanlin/Quota>
 
 using namespace Wolkanlin;
@@ -24,6 +25,7 @@ private slots:
     void testMove();
     void testDataStream();
     void testJsonConvert();
+    void testCborConvert();
 };
 
 QuotaObjectTest::QuotaObjectTest(QObject *parent) : QObject(parent)
@@ -156,6 +158,29 @@ void QuotaObjectTest::testJsonConvert()
     QVERIFY(q4.isNull());
 }
 
+void QuotaObjectTest::testCborConvert()
+{
+#if QT_VERSION >= QT_VERSION_CHECK(5, 12, 0)
+    const Quota q1(2068694953984, 78805623983, -3, 2147500577967, 3.67);
+    const QByteArray cbor = q1.toCbor();
+    QVERIFY(cbor.size() < QJsonDocument(q1.toJson()).toJson(QJsonDocument::Compact).size());
+    QCOMPARE(Quota::fromCbor(cbor), q1);
+
+    // a quota with all values set to 0 is not null
+    const Quota q2(0, 0, 0, 0, 0.0);
+    const Quota q3 = Quota::fromCbor(q2.toCbor());
+    QVERIFY(!q3.isNull());
+    QCOMPARE(q3, q2);
+
+    const Quota q4;
+    QVERIFY(Quota::fromCbor(q4.toCbor()).isNull());
+    QVERIFY(Quota::fromCbor(QByteArray()).isNull());
+    QVERIFY(Quota::fromCbor(cbor.left(5)).isNull());
+#else
+    QSKIP("CBOR support requires Qt 5.12 or newer.");
+#endif
+}
+
 QTEST_MAIN(QuotaObjectTest)
 
 #include "testquotaobject.moc"
@@ -0,0 +1,187 @@
+/*
+ * SPDX-FileCopyrightText: (C) 2021 Matthias Fehring / www.huessenbergnetz.de
+ * SPDX-License-Identifier: LGPL-3.0-or-later
+ */
+
+#include <QTest>
+#include <QObject>
+#include <QVector>
+#include <Wolkanlin/QuotaTable>
+#include <Wolkanlin/Quota>
+#include <Wolkanlin/UserData>
+
+using namespace Wolkanlin;
+
+class QuotaTableTest : public QObject
+{
+    Q_OBJECT
+public:
+    QuotaTableTest(QObject *parent = nullptr) : QObject(parent) {}
+
+    ~QuotaTableTest() override = default;
+
+private slots:
+    void testDefaultValues();
+    void testAppend();
+    void testSum();
+    void testPercentile();
+    void testHistogram();
+    void testTopByUsage();
+    void testTopByQuotaUsage();
+    void testLargeTable();
+
+private:
+    void fillTable(QuotaTable &table) const;
+};
+
+void QuotaTableTest::fillTable(QuotaTable &table) const
+{
+    // id, free, used, quota, total, relative
+    table.append(QStringLiteral("alice"), Quota(900, 100, 1000, 1000, 10.0));
+    table.append(QStringLiteral("bob"), Quota(50, 950, 1000, 1000, 95.0));
+    table.append(QStringLiteral("carol"), Quota(10000, 5000, -3, 15000, 33.3));
+    table.append(QStringLiteral("dave"), Quota(0, 600, 500, 600, 100.0));
+    table.append(QStringLiteral("eve"), Quota(1000, 0, 0, 1000, 0.0));
+}
+
+void QuotaTableTest::testDefaultValues()
+{
+    QuotaTable table;
+    QVERIFY(table.isEmpty());
+    QCOMPARE(table.size(), 0);
+    QVERIFY(table.id(0).isEmpty());
+    QVERIFY(table.quota(0).isNull());
+    QCOMPARE(table.sum(QuotaTable::UsedColumn), static_cast<qint64>(0));
+    QCOMPARE(table.average(QuotaTable::UsedColumn), 0.0);
+    QCOMPARE(table.averageRelative(), 0.0);
+    QCOMPARE(table.percentile(QuotaTable::UsedColumn, 50.0), static_cast<qint64>(0));
+    QCOMPARE(table.relativePercentile(50.0), 0.0);
+    QCOMPARE(table.relativeHistogram(4), QVector<int>({0, 0, 0, 0}));
+    QVERIFY(table.relativeHistogram(0).isEmpty());
+    QVERIFY(table.topByUsage(10).isEmpty());
+    QVERIFY(table.topByQuotaUsage(10).isEmpty());
+}
+
+void QuotaTableTest::testAppend()
+{
+    QuotaTable table;
+    QCOMPARE(table.append(QStringLiteral("alice"), Quota(900, 100, 1000, 1000, 10.0)), 0);
+    QCOMPARE(table.append(QStringLiteral("nobody"), Quota()), -1);
+
+    UserData user;
+    user.setId(QStringLiteral("bob"));
+    user.setQuota(Quota(50, 950, 1000, 1000, 95.0));
+    UserData withoutQuota;
+    withoutQuota.setId(QStringLiteral("carol"));
+    table.append(QVector<UserData>({user, withoutQuota, user}));
+
+    QCOMPARE(table.size(), 3);
+    QCOMPARE(table.ids(), QStringList({QStringLiteral("alice"), QStringLiteral("bob"), QStringLiteral("bob")}));
+    QCOMPARE(table.id(1), QStringLiteral("bob"));
+    QCOMPARE(table.quota(1), user.quota());
+    QCOMPARE(table.quota(0), Quota(900, 100, 1000, 1000, 10.0));
+    QVERIFY(table.quota(3).isNull());
+    QCOMPARE(table.column(QuotaTable::UsedColumn), QVector<qint64>({100, 950, 950}));
+    QCOMPARE(table.relativeColumn(), QVector<double>({10.0, 95.0, 95.0}));
+
+    table.clear();
+    QVERIFY(table.isEmpty());
+    QVERIFY(table.column(QuotaTable::UsedColumn).isEmpty());
+}
+
+void QuotaTableTest::testSum()
+{
+    QuotaTable table;
+    fillTable(table);
+
+    QCOMPARE(table.sum(QuotaTable::FreeColumn), static_cast<qint64>(11950));
+    QCOMPARE(table.sum(QuotaTable::UsedColumn), static_cast<qint64>(6650));
+    QCOMPARE(table.sum(QuotaTable::TotalColumn), static_cast<qint64>(18600));
+    // the unlimited quota of carol is not summed up
+    QCOMPARE(table.sum(QuotaTable::QuotaColumn), static_cast<qint64>(2500));
+    QCOMPARE(table.average(QuotaTable::UsedColumn), 1330.0);
+    QCOMPARE(table.averageRelative(), 238.3 / 5.0);
+}
+
+void QuotaTableTest::testPercentile()
+{
+    QuotaTable table;
+    fillTable(table);
+
+    QCOMPARE(table.percentile(QuotaTable::UsedColumn, 0.0), static_cast<qint64>(0));
+    QCOMPARE(table.percentile(QuotaTable::UsedColumn, 50.0), static_cast<qint64>(600));
+    QCOMPARE(table.percentile(QuotaTable::UsedColumn, 80.0), static_cast<qint64>(950));
+    QCOMPARE(table.percentile(QuotaTable::UsedColumn, 100.0), static_cast<qint64>(5000));
+    QCOMPARE(table.percentile(QuotaTable::UsedColumn, 150.0), static_cast<qint64>(5000));
+    QCOMPARE(table.relativePercentile(50.0), 33.3);
+    QCOMPARE(table.relativePercentile(90.0), 100.0);
+
+    // the table itself stays unsorted
+    QCOMPARE(table.column(QuotaTable::UsedColumn), QVector<qint64>({100, 950, 5000, 600, 0}));
+}
+
+void QuotaTableTest::testHistogram()
+{
+    QuotaTable table;
+    fillTable(table);
+
+    QCOMPARE(table.relativeHistogram(4), QVector<int>({2, 1, 0, 2}));
+    QCOMPARE(table.relativeHistogram(1), QVector<int>({5}));
+    QCOMPARE(table.relativeHistogram(10), QVector<int>({1, 1, 0, 1, 0, 0, 0, 0, 0, 2}));
+}
+
+void QuotaTableTest::testTopByUsage()
+{
+    QuotaTable table;
+    fillTable(table);
+
+    QCOMPARE(table.topByUsage(2), QVector<int>({2, 1}));
+    QCOMPARE(table.topByUsage(10), QVector<int>({2, 1, 3, 0, 4}));
+    QCOMPARE(table.topByUsage(2, QuotaTable::FreeColumn), QVector<int>({2, 4}));
+    QVERIFY(table.topByUsage(0).isEmpty());
+    QVERIFY(table.topByUsage(-1).isEmpty());
+
+    // equal values are sorted by row
+    table.append(QStringLiteral("frank"), Quota(0, 5000, -3, 5000, 100.0));
+    QCOMPARE(table.topByUsage(3), QVector<int>({2, 5, 1}));
+}
+
+void QuotaTableTest::testTopByQuotaUsage()
+{
+    QuotaTable table;
+    fillTable(table);
+
+    // dave uses more than the set quota, carol and eve have no limited quota
+    QCOMPARE(table.topByQuotaUsage(10), QVector<int>({3, 1, 0}));
+    QCOMPARE(table.topByQuotaUsage(1), QVector<int>({3}));
+}
+
+void QuotaTableTest::testLargeTable()
+{
+    const int count = 100000;
+    QuotaTable table;
+    table.reserve(count);
+    for (int i = 0; i < count; ++i) {
+        const qint64 used = static_cast<qint64>(i) * 1000;
+        const qint64 quota = 100000000;
+        table.append(QStringLiteral("user%1").arg(i), Quota(quota - used, used, quota, quota, static_cast<double>(i % 100)));
+    }
+
+    QCOMPARE(table.size(), count);
+    QCOMPARE(table.sum(QuotaTable::UsedColumn), static_cast<qint64>(count) * static_cast<qint64>(count - 1) / 2 * 1000);
+    QCOMPARE(table.percentile(QuotaTable::UsedColumn, 50.0), static_cast<qint64>(49999000));
+    QCOMPARE(table.topByUsage(3), QVector<int>({99999, 99998, 99997}));
+    QCOMPARE(table.topByQuotaUsage(1), QVector<int>({99999}));
+
+    const QVector<int> histogram = table.relativeHistogram(10);
+    int total = 0;
+    for (int bin : histogram) {
+        QCOMPARE(bin, 10000);
+        total += bin;
+    }
+    QCOMPARE(total, count);
+}
+
+QTEST_MAIN(QuotaTableTest)
+
+#include "testquotatable.moc"
@@ -3,8 +3,11 @@
  * SPDX-License-Identifier: LGPL-3.0-or-later
  */
 
+#include "testconfig.h"
+#include "mockserver.h"
 #include <QTest>
 #include <QObject>
+#include <QSignalSpy>
 #include <QDataStream>
 #include <QJsonObject>
 #include <QJsonDocument>
@@ -26,9 +29,12 @@ private slots:
     void testDefaultConstructor();
     void testJsonConverters();
     void testDataStreamConverters();
+    void testCborConverters();
+    void testChangedSignal();
 
 private:
     QJsonDocument m_json;
+    MockServer *m_server = nullptr;
 };
 
 ServerStatusObjectTest::ServerStatusObjectTest(QObject *parent) : QObject(parent)
@@ -43,6 +49,9 @@ void ServerStatusObjectTest::initTestCase()
     QJsonParseError jsonError;
     m_json = QJsonDocument::fromJson(QByteArrayLiteral("{\"installed\":true,\"maintenance\":true,\"needsDbUpgrade\":true,\"version\":\"20.0.5.2\",\"versionstring\":\"20.0.5\",\"edition\":\"Test edition\",\"productname\":\"My little cloud\",\"extendedSupport\":true}"), &jsonError);
     QCOMPARE(jsonError.error, QJsonParseError::NoError);
+
+    m_server = new MockServer(this);
+    QVERIFY(m_server->start());
 }
 
 void ServerStatusObjectTest::testDefaultConstructor()
@@ -105,6 +114,76 @@ void ServerStatusObjectTest::testDataStreamConverters()
     QCOMPARE(s1->hasExtendedSupport(), s2->hasExtendedSupport());
 }
 
+void ServerStatusObjectTest::testCborConverters()
+{
+#if QT_VERSION >= QT_VERSION_CHECK(5, 12, 0)
+    auto s1 = ServerStatus::fromJson(m_json, this);
+
+    const QByteArray cbor = s1->toCbor();
+    QVERIFY(cbor.size() < QJsonDocument(s1->toJson()).toJson(QJsonDocument::Compact).size());
+
+    auto s2 = ServerStatus::fromCbor(cbor, this);
+    QCOMPARE(s2->parent(), this);
+    QCOMPARE(s2->toJson(), s1->toJson());
+
+    auto s3 = ServerStatus::fromCbor(QByteArray(), this);
+    QVERIFY(s3->isEmpty());
+
+    auto s4 = ServerStatus::fromCbor(cbor.left(cbor.size() - 3), this);
+    QVERIFY(s4->isEmpty());
+
+    auto s5 = new ServerStatus(this);
+    auto s6 = ServerStatus::fromCbor(s5->toCbor(), this);
+    QVERIFY(s6->isEmpty());
+#else
+    QSKIP("CBOR support requires Qt 5.12 or newer.");
+#endif
+}
+
+void ServerStatusObjectTest::testChangedSignal()
+{
+    auto conf = m_server->createConfig(this);
+
+    m_server->setServerVersion(QStringLiteral("20.0.5.2"));
+    m_server->setMaintenance(false);
+    m_server->setNeedsDbUpgrade(false);
+
+    auto s = new ServerStatus(this);
+    QSignalSpy changedSpy(s, &ServerStatus::changed);
+    QSignalSpy installedSpy(s, &ServerStatus::installedChanged);
+    QSignalSpy maintenanceSpy(s, &ServerStatus::maintenanceChanged);
+    QSignalSpy versionSpy(s, &ServerStatus::versionChanged);
+    QSignalSpy versionstringSpy(s, &ServerStatus::versionstringChanged);
+    QSignalSpy editionSpy(s, &ServerStatus::editionChanged);
+
+    // all changed fields are reported together in a single notification
+    QVERIFY(s->get(false, conf));
+    QCOMPARE(changedSpy.count(), 1);
+    QCOMPARE(changedSpy.at(0).at(0).value<ServerStatus::Fields>(), ServerStatus::InstalledField|ServerStatus::VersionField|ServerStatus::VersionstringField|ServerStatus::ProductnameField);
+    QCOMPARE(installedSpy.count(), 1);
+    QCOMPARE(versionSpy.count(), 1);
+    QCOMPARE(versionstringSpy.count(), 1);
+    QCOMPARE(maintenanceSpy.count(), 0);
+    QCOMPARE(editionSpy.count(), 0);
+
+    m_server->setServerVersion(QStringLiteral("20.0.6.1"));
+    m_server->setMaintenance(true);
+    QVERIFY(s->get(false, conf));
+    QCOMPARE(changedSpy.count(), 2);
+    QCOMPARE(changedSpy.at(1).at(0).value<ServerStatus::Fields>(), ServerStatus::MaintenanceField|ServerStatus::VersionField|ServerStatus::VersionstringField);
+    QCOMPARE(installedSpy.count(), 1);
+    QCOMPARE(maintenanceSpy.count(), 1);
+    QCOMPARE(versionSpy.count(), 2);
+    QCOMPARE(versionstringSpy.count(), 2);
+    QCOMPARE(s->version(), QStringLiteral("20.0.6.1"));
+    QVERIFY(s->isInMaintenance());
+
+    // unchanged values do not notify at all
+    QVERIFY(s->get(false, conf));
+    QCOMPARE(changedSpy.count(), 2);
+    QCOMPARE(versionSpy.count(), 2);
+}
+
 QTEST_MAIN(ServerStatusObjectTest)
 
 #include "testserverstatusobject.moc"
@@ -0,0 +1,230 @@
+/*
+ * SPDX-FileCopyrightText: (C) 2021 Matthias Fehring / www.huessenbergnetz.de
+ * SPDX-License-Identifier: LGPL-3.0-or-later
+ */
+
+#include "testconfig.h"
+#include "mockserver.h"
+#include <QTest>
+#include <QObject>
+#include <QSignalSpy>
+#include <QNetworkAccessManager>
+#include <Wolkanlin/ServerStatusWatcher>
+#include <Wolkanlin/ServerStatus>
+#include <Wolkanlin/GetServerStatusJob>
+
+using namespace Wolkanlin;
+
+class ServerStatusWatcherTest : public QObject
+{
+    Q_OBJECT
+public:
+    ServerStatusWatcherTest(QObject *parent = nullptr) : QObject(parent) {}
+
+    ~ServerStatusWatcherTest() override = default;
+
+private slots:
+    void initTestCase();
+    void init();
+
+    void testDefaultValues();
+    void testConditionalJob();
+    void testBackoff();
+    void testTransitions();
+    void testReachability();
+    void testWithoutEntityTags();
+
+private:
+    ServerStatusWatcher *createWatcher();
+
+    MockServer *m_server = nullptr;
+    QNetworkAccessManager *m_nam = nullptr;
+};
+
+void ServerStatusWatcherTest::initTestCase()
+{
+    m_server = new MockServer(this);
+    QVERIFY(m_server->start());
+    m_nam = new QNetworkAccessManager(this);
+}
+
+void ServerStatusWatcherTest::init()
+{
+    m_server->setMaintenance(false);
+    m_server->setNeedsDbUpgrade(false);
+    m_server->setEntityTags(true);
+    m_server->resetStatistics();
+}
+
+ServerStatusWatcher *ServerStatusWatcherTest::createWatcher()
+{
+    auto watcher = new ServerStatusWatcher(this);
+    watcher->setConfiguration(m_server->createConfig(this));
+    watcher->setNetworkAccessManager(m_nam);
+    watcher->setMinInterval(20);
+    watcher->setMaxInterval(160);
+    return watcher;
+}
+
+void ServerStatusWatcherTest::testDefaultValues()
+{
+    ServerStatusWatcher watcher;
+    QVERIFY(!watcher.configuration());
+    QCOMPARE(watcher.minInterval(), 5000);
+    QCOMPARE(watcher.maxInterval(), 300000);
+    QCOMPARE(watcher.interval(), 5000);
+    QVERIFY(!watcher.isReachable());
+    QVERIFY(!watcher.isRunning());
+    QVERIFY(watcher.status());
+    QVERIFY(watcher.status()->isEmpty());
+    QVERIFY(!watcher.networkAccessManager());
+
+    watcher.setMinInterval(0);
+    QCOMPARE(watcher.minInterval(), 1);
+    watcher.setMaxInterval(0);
+    QCOMPARE(watcher.maxInterval(), 1);
+    watcher.setMinInterval(1000);
+    QCOMPARE(watcher.maxInterval(), 1000);
+}
+
+void ServerStatusWatcherTest::testConditionalJob()
+{
+    auto job = new GetServerStatusJob(this);
+    job->setConfiguration(m_server->createConfig(this));
+    job->setNetworkAccessManager(m_nam);
+    QVERIFY(job->exec());
+    QVERIFY(!job->isNotModified());
+    QVERIFY(!job->replyData().isEmpty());
+    const QByteArray etag = job->entityTag();
+    QVERIFY(!etag.isEmpty());
+
+    job = new GetServerStatusJob(this);
+    job->setConfiguration(m_server->createConfig(this));
+    job->setNetworkAccessManager(m_nam);
+    job->setEntityTag(etag);
+    QVERIFY(job->exec());
+    QVERIFY(job->isNotModified());
+    QVERIFY(job->replyData().isEmpty());
+    QCOMPARE(job->entityTag(), etag);
+    QCOMPARE(m_server->notModifiedCount(), 1);
+
+    m_server->setMaintenance(true);
+    job = new GetServerStatusJob(this);
+    job->setConfiguration(m_server->createConfig(this));
+    job->setNetworkAccessManager(m_nam);
+    job->setEntityTag(etag);
+    QVERIFY(job->exec());
+    QVERIFY(!job->isNotModified());
+    QVERIFY(job->entityTag() != etag);
+    QCOMPARE(m_server->notModifiedCount(), 1);
+}
+
+void ServerStatusWatcherTest::testBackoff()
+{
+    auto watcher = createWatcher();
+    QSignalSpy changedSpy(watcher->status(), &ServerStatus::changed);
+    QSignalSpy reachableSpy(watcher, &ServerStatusWatcher::reachableChanged);
+
+    watcher->start();
+    QVERIFY(watcher->isRunning());
+    QVERIFY(changedSpy.wait());
+    QVERIFY(watcher->isReachable());
+    QCOMPARE(reachableSpy.count(), 1);
+    QVERIFY(!watcher->status()->isEmpty());
+
+    QTest::qWait(1000);
+    watcher->stop();
+
+    // a stable server does not cause any further signal
+    QCOMPARE(changedSpy.count(), 1);
+    QCOMPARE(reachableSpy.count(), 1);
+
+    // 20, 40, 80, 160, 160, ... instead of one request every 20ms
+    QCOMPARE(watcher->interval(), 160);
+    QVERIFY(m_server->requestCount() < 15);
+    QCOMPARE(m_server->notModifiedCount(), m_server->requestCount() - 1);
+}
+
+void ServerStatusWatcherTest::testTransitions()
+{
+    auto watcher = createWatcher();
+    QSignalSpy maintenanceSpy(watcher->status(), &ServerStatus::maintenanceChanged);
+    QSignalSpy upgradeSpy(watcher->status(), &ServerStatus::needsDbUpgradeChanged);
+    QSignalSpy changedSpy(watcher->status(), &ServerStatus::changed);
+
+    watcher->start();
+    QVERIFY(changedSpy.wait());
+    QTest::qWait(400);
+    QCOMPARE(watcher->interval(), 160);
+
+    m_server->setMaintenance(true);
+    QVERIFY(maintenanceSpy.wait());
+    QCOMPARE(maintenanceSpy.count(), 1);
+    QCOMPARE(maintenanceSpy.at(0).at(0).toBool(), true);
+    QCOMPARE(watcher->interval(), 20);
+
+    m_server->setNeedsDbUpgrade(true);
+    QVERIFY(upgradeSpy.wait());
+    QCOMPARE(upgradeSpy.at(0).at(0).toBool(), true);
+    QCOMPARE(watcher->interval(), 20);
+
+    m_server->setNeedsDbUpgrade(false);
+    m_server->setMaintenance(false);
+    QVERIFY(maintenanceSpy.wait());
+    QCOMPARE(maintenanceSpy.count(), 2);
+    QCOMPARE(maintenanceSpy.at(1).at(0).toBool(), false);
+    QCOMPARE(upgradeSpy.count(), 2);
+
+    watcher->stop();
+    QVERIFY(!watcher->isRunning());
+}
+
+void ServerStatusWatcherTest::testReachability()
+{
+    auto watcher = createWatcher();
+    QSignalSpy reachableSpy(watcher, &ServerStatusWatcher::reachableChanged);
+    QSignalSpy failedSpy(watcher, &ServerStatusWatcher::failed);
+
+    watcher->start();
+    QVERIFY(reachableSpy.wait());
+    QTest::qWait(200);
+
+    m_server->failNextRequests(3, 503);
+    watcher->check();
+    QVERIFY(reachableSpy.wait());
+    QVERIFY(!watcher->isReachable());
+    QCOMPARE(failedSpy.count(), 1);
+
+    // further failures are not reported again
+    QVERIFY(reachableSpy.wait());
+    QVERIFY(watcher->isReachable());
+    QCOMPARE(failedSpy.count(), 1);
+    QCOMPARE(reachableSpy.count(), 3);
+    QCOMPARE(watcher->interval(), 20);
+
+    watcher->stop();
+}
+
+void ServerStatusWatcherTest::testWithoutEntityTags()
+{
+    m_server->setEntityTags(false);
+
+    auto watcher = createWatcher();
+    QSignalSpy changedSpy(watcher->status(), &ServerStatus::changed);
+
+    watcher->start();
+    QVERIFY(changedSpy.wait());
+    QTest::qWait(300);
+
+    // the full status is compared instead
+    QCOMPARE(changedSpy.count(), 1);
+    QVERIFY(m_server->requestCount() > 1);
+    QCOMPARE(m_server->notModifiedCount(), 0);
+    QVERIFY(watcher->interval() > 20);
+
+    watcher->stop();
+}
+
+QTEST_MAIN(ServerStatusWatcherTest)
+
+#include "testserverstatuswatcher.moc"
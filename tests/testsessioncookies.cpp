@@ -0,0 +1,157 @@
+/*
+ * SPDX-FileCopyrightText: (C) 2021 Matthias Fehring / www.huessenbergnetz.de
+ * SPDX-License-Identifier: LGPL-3.0-or-later
+ */
+
+#include "testconfig.h"
+#include "mockserver.h"
+#include <QTest>
+#include <QObject>
+#include <QFile>
+#include <QTemporaryDir>
+#include <QNetworkAccessManager>
+#include <Wolkanlin/GetUserJob>
+
+using namespace Wolkanlin;
+
+class SessionCookiesTest : public QObject
+{
+    Q_OBJECT
+public:
+    SessionCookiesTest(QObject *parent = nullptr) : QObject(parent) {}
+
+    ~SessionCookiesTest() override = default;
+
+private slots:
+    void initTestCase();
+    void init();
+
+    void testDefaultValues();
+    void testWithoutSession();
+    void testSessionReuse();
+    void testExpiredSession();
+    void testChangedCredentials();
+    void testPersistence();
+
+private:
+    TestConfig *createConfig(bool useSessionCookies, const QString &sessionFile = QString());
+
+    MockServer *m_server = nullptr;
+    QNetworkAccessManager *m_nam = nullptr;
+};
+
+void SessionCookiesTest::initTestCase()
+{
+    m_server = new MockServer(this);
+    QVERIFY(m_server->start());
+    m_server->setCredentials(QStringLiteral("admin"), QStringLiteral("secret"));
+    m_server->setSessions(true);
+    m_nam = new QNetworkAccessManager(this);
+}
+
+void SessionCookiesTest::init()
+{
+    m_server->expireSessions();
+    m_server->resetStatistics();
+}
+
+TestConfig *SessionCookiesTest::createConfig(bool useSessionCookies, const QString &sessionFile)
+{
+    auto conf = m_server->createConfig(this);
+    conf->setUseSessionCookies(useSessionCookies);
+    conf->setSessionFile(sessionFile);
+    return conf;
+}
+
+void SessionCookiesTest::testDefaultValues()
+{
+    TestConfig conf;
+    QVERIFY(!conf.useSessionCookies());
+    QVERIFY(conf.sessionFile().isEmpty());
+}
+
+void SessionCookiesTest::testWithoutSession()
+{
+    auto conf = createConfig(false);
+    QVERIFY(MockServer::runJobs(conf, m_nam, 10));
+    QCOMPARE(m_server->passwordCheckCount(), 10);
+    QCOMPARE(m_server->sessionRequestCount(), 0);
+}
+
+void SessionCookiesTest::testSessionReuse()
+{
+    auto conf = createConfig(true);
+    QVERIFY(MockServer::runJobs(conf, m_nam, 10));
+
+    // only the first request verifies the password
+    QCOMPARE(m_server->passwordCheckCount(), 1);
+    QCOMPARE(m_server->sessionRequestCount(), 9);
+}
+
+void SessionCookiesTest::testExpiredSession()
+{
+    auto conf = createConfig(true);
+    QVERIFY(MockServer::runJobs(conf, m_nam, 2));
+    QCOMPARE(m_server->passwordCheckCount(), 1);
+
+    // the job repeats the request with the credentials
+    m_server->expireSessions();
+    m_server->resetStatistics();
+    QVERIFY(MockServer::runJobs(conf, m_nam, 3));
+    QCOMPARE(m_server->requestCount(), 4);
+    QCOMPARE(m_server->passwordCheckCount(), 1);
+    QCOMPARE(m_server->sessionRequestCount(), 2);
+
+    // wrong credentials are still reported after the session has expired
+    m_server->expireSessions();
+    m_server->setCredentials(QStringLiteral("admin"), QStringLiteral("changed"));
+    auto job = new GetUserJob(MockServer::userId(0), this);
+    job->setConfiguration(conf);
+    job->setNetworkAccessManager(m_nam);
+    QVERIFY(!job->exec());
+    QCOMPARE(job->error(), static_cast<int>(AuthNFailed));
+    m_server->setCredentials(QStringLiteral("admin"), QStringLiteral("secret"));
+}
+
+void SessionCookiesTest::testChangedCredentials()
+{
+    auto conf = createConfig(true);
+    QVERIFY(MockServer::runJobs(conf, m_nam, 2));
+    QCOMPARE(m_server->passwordCheckCount(), 1);
+
+    // the session belongs to the old credentials
+    conf->setPassword(QStringLiteral("secret"));
+    QVERIFY(MockServer::runJobs(conf, m_nam, 2));
+    QCOMPARE(m_server->passwordCheckCount(), 2);
+    QCOMPARE(m_server->sessionRequestCount(), 2);
+
+    conf->clearSession();
+    QVERIFY(MockServer::runJobs(conf, m_nam, 1));
+    QCOMPARE(m_server->passwordCheckCount(), 3);
+}
+
+void SessionCookiesTest::testPersistence()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QString sessionFile = dir.filePath(QStringLiteral("session/cookies"));
+
+    auto conf = createConfig(true, sessionFile);
+    QVERIFY(MockServer::runJobs(conf, m_nam, 1));
+    QCOMPARE(m_server->passwordCheckCount(), 1);
+    QVERIFY(QFile::exists(sessionFile));
+    QCOMPARE(QFile::permissions(sessionFile) & (QFileDevice::ReadOther|QFileDevice::ReadGroup), QFileDevice::Permissions());
+
+    // a new configuration, like after a restart, reuses the stored session
+    auto restored = createConfig(true, sessionFile);
+    QVERIFY(MockServer::runJobs(restored, m_nam, 2));
+    QCOMPARE(m_server->passwordCheckCount(), 1);
+    QCOMPARE(m_server->sessionRequestCount(), 2);
+
+    restored->clearSession();
+    QVERIFY(!QFile::exists(sessionFile));
+}
+
+QTEST_MAIN(SessionCookiesTest)
+
+#include "testsessioncookies.moc"
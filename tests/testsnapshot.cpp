@@ -0,0 +1,351 @@
+/*
+ * SPDX-FileCopyrightText: (C) 2021 Matthias Fehring / www.huessenbergnetz.de
+ * SPDX-License-Identifier: LGPL-3.0-or-later
+ */
+
+#include <QTest>
+#include <QObject>
+#include <QBuffer>
+#include <QSignalSpy>
+#include <QJsonDocument>
+#include <QJsonParseError>
+#include <QVector>
+#include <QtEndian>
+#include <Wolkanlin/SnapshotWriter>
+#include <Wolkanlin/SnapshotReader>
+#include <Wolkanlin/UserData>
+#include <Wolkanlin/ServerStatus>
+#include <memory>
+#include <algorithm>
+
+using namespace Wolkanlin;
+
+class SnapshotTest : public QObject
+{
+    Q_OBJECT
+public:
+    SnapshotTest(QObject *parent = nullptr);
+    ~SnapshotTest() override;
+
+private slots:
+    void initTestCase();
+
+    void testEmpty();
+    void testUsers();
+    void testSingleUser();
+    void testSharedStrings();
+    void testIdIndex();
+    void testServerStatus();
+    void testWriteToDevice();
+    void testExternalMemory();
+    void testInvalidData();
+
+private:
+    QVector<UserData> createUsers(int count) const;
+
+    UserData m_user;
+};
+
+SnapshotTest::SnapshotTest(QObject *parent) : QObject(parent)
+{
+
+}
+
+SnapshotTest::~SnapshotTest() = default;
+
+void SnapshotTest::initTestCase()
+{
+    QJsonParseError jsonError;
+    const QJsonDocument json = QJsonDocument::fromJson(QByteArrayLiteral("{\"ocs\":{\"meta\":{\"status\":\"ok\",\"statuscode\":100,\"message\":\"OK\",\"totalitems\":\"\",\"itemsperpage\":\"\"},\"data\":{\"enabled\":true,\"storageLocation\":\"/srv/www/nextcloud/data/tester\",\"id\":\"tester\",\"lastLogin\":1611134157000,\"backend\":\"Database\",\"subadmin\":[\"group1\"],\"quota\":{\"free\":209639130,\"used\":76070,\"total\":209715200,\"relative\":0.04,\"quota\":209715200},\"email\":\"tester@example.net\",\"displayname\":\"Tester Ümläut\",\"phone\":\"+49123456789\",\"address\":\"Somewhere over the rainbow\",\"website\":\"https://example.net\",\"twitter\":\"@tester\",\"groups\":[\"group1\",\"group2\"],\"language\":\"de_DE\",\"locale\":\"de_DE\",\"backendCapabilities\":{\"setDisplayName\":false,\"setPassword\":true}}}}"), &jsonError);
+    QVERIFY(jsonError.error == QJsonParseError::NoError);
+    m_user = UserData::fromJson(json);
+    QVERIFY(!m_user.isEmpty());
+}
+
+QVector<UserData> SnapshotTest::createUsers(int count) const
+{
+    QVector<UserData> users;
+    users.reserve(count);
+    for (int i = 0; i < count; ++i) {
+        UserData u = m_user;
+        u.setId(QStringLiteral("user%1").arg(i));
+        u.setEmail(QStringLiteral("user%1@example.net").arg(i));
+        u.setEnabled(i % 3 != 0);
+        if (i % 2 == 0) {
+            u.setGroups(QStringList({QStringLiteral("group%1").arg(i % 5), QStringLiteral("everyone")}));
+        }
+        if (i % 7 == 0) {
+            u.setQuota(Quota());
+            u.setLastLogin(QDateTime());
+            u.setWebsite(QUrl());
+        }
+        users.append(u);
+    }
+    return users;
+}
+
+void SnapshotTest::testEmpty()
+{
+    SnapshotWriter writer;
+    QCOMPARE(writer.count(), 0);
+
+    SnapshotReader reader(writer.toByteArray());
+    QVERIFY(!reader.isValid());
+    QCOMPARE(reader.error(), SnapshotReader::CorruptedError);
+
+    writer.addUsers(QVector<UserData>());
+    SnapshotReader reader2(writer.toByteArray());
+    QVERIFY(reader2.isValid());
+    QCOMPARE(reader2.content(), SnapshotReader::UserContent);
+    QCOMPARE(reader2.count(), 0);
+    QVERIFY(reader2.users().empty());
+    QVERIFY(reader2.user(0).isEmpty());
+}
+
+void SnapshotTest::testUsers()
+{
+    const QVector<UserData> users = createUsers(500);
+
+    SnapshotWriter writer;
+    writer.addUsers(users);
+    QCOMPARE(writer.count(), 500);
+
+    const QDateTime before = QDateTime::currentDateTimeUtc().addSecs(-1);
+    SnapshotReader reader(writer.toByteArray());
+    QVERIFY(reader.isValid());
+    QCOMPARE(reader.error(), SnapshotReader::NoError);
+    QCOMPARE(reader.formatVersion(), SnapshotWriter::formatVersion());
+    QCOMPARE(reader.content(), SnapshotReader::UserContent);
+    QCOMPARE(reader.count(), 500);
+    QVERIFY(reader.created() >= before);
+
+    const QVector<UserData> read = reader.users();
+    QCOMPARE(read.size(), users.size());
+    for (int i = 0; i < users.size(); ++i) {
+        QCOMPARE(read.at(i), users.at(i));
+        QCOMPARE(read.at(i).quota().isNull(), users.at(i).quota().isNull());
+        QCOMPARE(read.at(i).lastLogin().isValid(), users.at(i).lastLogin().isValid());
+    }
+}
+
+void SnapshotTest::testSingleUser()
+{
+    const QVector<UserData> users = createUsers(50);
+
+    SnapshotWriter writer;
+    for (const UserData &u : users) {
+        writer.addUser(u);
+    }
+
+    SnapshotReader reader(writer.toByteArray());
+    QVERIFY(reader.isValid());
+    QCOMPARE(reader.userId(0), QStringLiteral("user0"));
+    QCOMPARE(reader.userId(49), QStringLiteral("user49"));
+    QVERIFY(reader.userId(50).isEmpty());
+    QVERIFY(reader.userId(-1).isEmpty());
+    QCOMPARE(reader.user(21), users.at(21));
+    QCOMPARE(reader.user(21).displayname(), QStringLiteral("Tester Ümläut"));
+    QVERIFY(reader.user(50).isEmpty());
+
+    ServerStatus status;
+    QVERIFY(!reader.readServerStatus(&status));
+}
+
+void SnapshotTest::testSharedStrings()
+{
+    SnapshotWriter one;
+    one.addUser(m_user);
+    const int oneSize = one.toByteArray().size();
+
+    SnapshotWriter many;
+    for (int i = 0; i < 100; ++i) {
+        many.addUser(m_user);
+    }
+    const int manySize = many.toByteArray().size();
+
+    // only the fixed width records are repeated, the strings are stored once
+    QCOMPARE(manySize - oneSize, 99 * 112);
+
+    SnapshotReader reader(many.toByteArray());
+    const QVector<UserData> users = reader.users();
+    QCOMPARE(users.size(), 100);
+    QVERIFY(users.at(0).id().constData() == users.at(99).id().constData());
+    QVERIFY(users.at(0).groups().at(1).constData() == users.at(99).groups().at(1).constData());
+}
+
+void SnapshotTest::testIdIndex()
+{
+    QVector<UserData> users = createUsers(300);
+    // unsorted input with non-ASCII IDs
+    std::reverse(users.begin(), users.end());
+    UserData special = m_user;
+    special.setId(QStringLiteral("ümläut"));
+    users.insert(100, special);
+
+    SnapshotWriter writer;
+    QVERIFY(!writer.isIdIndexEnabled());
+    writer.addUsers(users);
+    const int sizeWithoutIndex = writer.toByteArray().size();
+    {
+        SnapshotReader reader(writer.toByteArray());
+        QVERIFY(!reader.hasIdIndex());
+        QCOMPARE(reader.indexOf(QStringLiteral("user42")), 258);
+    }
+
+    writer.setIdIndexEnabled(true);
+    QVERIFY(writer.isIdIndexEnabled());
+    const QByteArray data = writer.toByteArray();
+    QVERIFY(data.size() >= sizeWithoutIndex + users.size() * 4);
+
+    SnapshotReader reader(data);
+    QVERIFY(reader.isValid());
+    QVERIFY(reader.hasIdIndex());
+    for (int i = 0; i < users.size(); ++i) {
+        QCOMPARE(reader.indexOf(users.at(i).id()), i);
+    }
+    QCOMPARE(reader.user(reader.indexOf(QStringLiteral("ümläut"))), special);
+    QCOMPARE(reader.indexOf(QStringLiteral("user")), -1);
+    QCOMPARE(reader.indexOf(QStringLiteral("user3000")), -1);
+    QCOMPARE(reader.indexOf(QStringLiteral("zzz")), -1);
+    QCOMPARE(reader.indexOf(QString()), -1);
+
+    QByteArray truncated = data;
+    truncated.chop(4);
+    SnapshotReader truncatedReader(truncated);
+    QVERIFY(!truncatedReader.isValid());
+    QCOMPARE(truncatedReader.error(), SnapshotReader::TruncatedError);
+}
+
+void SnapshotTest::testServerStatus()
+{
+    QJsonParseError jsonError;
+    const QJsonDocument json = QJsonDocument::fromJson(QByteArrayLiteral("{\"installed\":true,\"maintenance\":false,\"needsDbUpgrade\":true,\"version\":\"20.0.5.2\",\"versionstring\":\"20.0.5\",\"edition\":\"\",\"productname\":\"Nextcloud\",\"extendedSupport\":true}"), &jsonError);
+    QVERIFY(jsonError.error == QJsonParseError::NoError);
+    std::unique_ptr<ServerStatus> s1(ServerStatus::fromJson(json));
+
+    SnapshotWriter writer;
+    writer.addUser(m_user);
+    writer.setServerStatus(*s1);
+    QCOMPARE(writer.count(), 1);
+
+    SnapshotReader reader(writer.toByteArray());
+    QVERIFY(reader.isValid());
+    QCOMPARE(reader.content(), SnapshotReader::ServerStatusContent);
+    QVERIFY(reader.users().empty());
+    QVERIFY(reader.userId(0).isEmpty());
+
+    ServerStatus s2;
+    QSignalSpy changedSpy(&s2, &ServerStatus::changed);
+    QVERIFY(reader.readServerStatus(&s2));
+    QCOMPARE(changedSpy.count(), 1);
+    QCOMPARE(s2.isInstalled(), true);
+    QCOMPARE(s2.isInMaintenance(), false);
+    QCOMPARE(s2.needsDbUpgrade(), true);
+    QCOMPARE(s2.version(), QStringLiteral("20.0.5.2"));
+    QCOMPARE(s2.versionstring(), QStringLiteral("20.0.5"));
+    QVERIFY(s2.edition().isEmpty());
+    QCOMPARE(s2.productname(), QStringLiteral("Nextcloud"));
+    QCOMPARE(s2.hasExtendedSupport(), true);
+
+    QVERIFY(reader.readServerStatus(&s2));
+    QCOMPARE(changedSpy.count(), 1);
+
+    writer.clear();
+    QCOMPARE(writer.count(), 0);
+}
+
+void SnapshotTest::testWriteToDevice()
+{
+    SnapshotWriter writer;
+    writer.addUsers(createUsers(10));
+
+    QBuffer buffer;
+    QVERIFY(buffer.open(QIODevice::WriteOnly));
+    QVERIFY(writer.write(&buffer));
+    buffer.close();
+
+    SnapshotReader reader(buffer.data());
+    QVERIFY(reader.isValid());
+    QCOMPARE(reader.users(), createUsers(10));
+}
+
+void SnapshotTest::testExternalMemory()
+{
+    SnapshotWriter writer;
+    writer.addUsers(createUsers(10));
+    const QByteArray data = writer.toByteArray();
+
+    SnapshotReader reader(reinterpret_cast<const uchar *>(data.constData()), data.size());
+    QVERIFY(reader.isValid());
+    QCOMPARE(reader.count(), 10);
+    QCOMPARE(reader.user(3), createUsers(10).at(3));
+
+    SnapshotReader nullReader(nullptr, 100);
+    QVERIFY(!nullReader.isValid());
+    QCOMPARE(nullReader.error(), SnapshotReader::TruncatedError);
+}
+
+void SnapshotTest::testInvalidData()
+{
+    {
+        SnapshotReader reader(QByteArray());
+        QVERIFY(!reader.isValid());
+        QCOMPARE(reader.error(), SnapshotReader::TruncatedError);
+        QCOMPARE(reader.count(), 0);
+        QVERIFY(!reader.created().isValid());
+        QVERIFY(reader.users().empty());
+    }
+
+    {
+        SnapshotReader reader(QByteArrayLiteral("This is not a snapshot, but it is long enough to contain a complete header of a snapshot file."));
+        QVERIFY(!reader.isValid());
+        QCOMPARE(reader.error(), SnapshotReader::InvalidMagicError);
+    }
+
+    SnapshotWriter writer;
+    writer.addUsers(createUsers(10));
+    const QByteArray data = writer.toByteArray();
+
+    {
+        SnapshotReader reader(data.left(data.size() - 1));
+        QVERIFY(!reader.isValid());
+        QCOMPARE(reader.error(), SnapshotReader::TruncatedError);
+    }
+
+    {
+        SnapshotReader reader(data.left(50));
+        QVERIFY(!reader.isValid());
+        QCOMPARE(reader.error(), SnapshotReader::TruncatedError);
+    }
+
+    {
+        QByteArray newer = data;
+        qToLittleEndian<quint16>(SnapshotWriter::formatVersion() + 1, reinterpret_cast<uchar *>(newer.data() + 4));
+        SnapshotReader reader(newer);
+        QVERIFY(!reader.isValid());
+        QCOMPARE(reader.error(), SnapshotReader::UnsupportedVersionError);
+        QVERIFY(reader.user(0).isEmpty());
+    }
+
+    {
+        QByteArray corrupted = data;
+        // record size smaller than the size of a user record
+        qToLittleEndian<quint32>(16, reinterpret_cast<uchar *>(corrupted.data() + 16));
+        SnapshotReader reader(corrupted);
+        QVERIFY(!reader.isValid());
+        QCOMPARE(reader.error(), SnapshotReader::CorruptedError);
+    }
+
+    {
+        QByteArray corrupted = data;
+        // string table offset behind the end of the data
+        qToLittleEndian<quint64>(static_cast<quint64>(data.size()) + 8, reinterpret_cast<uchar *>(corrupted.data() + 56));
+        SnapshotReader reader(corrupted);
+        QVERIFY(!reader.isValid());
+        QCOMPARE(reader.error(), SnapshotReader::TruncatedError);
+    }
+}
+
+QTEST_MAIN(SnapshotTest)
+
+#include "testsnapshot.moc"
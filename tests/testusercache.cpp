@@ -0,0 +1,291 @@
+/*
+ * SPDX-FileCopyrightText: (C) 2021 Matthias Fehring / www.huessenbergnetz.de
+ * SPDX-License-Identifier: LGPL-3.0-or-later
+ */
+
+#include "testconfig.h"
+#include "mockserver.h"
+#include <QTest>
+#include <QObject>
+#include <QSignalSpy>
+#include <QTemporaryDir>
+#include <QFile>
+#include <QNetworkAccessManager>
+#include <Wolkanlin/GetUserDetailsListJob>
+#include <Wolkanlin/UserCache>
+#include <Wolkanlin/UserData>
+#include <Wolkanlin/MetricsRegistry>
+
+using namespace Wolkanlin;
+
+class UserCacheTest : public QObject
+{
+    Q_OBJECT
+public:
+    UserCacheTest(QObject *parent = nullptr) : QObject(parent) {}
+
+    ~UserCacheTest() override = default;
+
+private slots:
+    void initTestCase();
+    void init();
+
+    void testDefaultValues();
+    void testOpenMissing();
+    void testOpenInvalid();
+    void testSaveAndOpen();
+    void testLookup();
+    void testRevalidate();
+    void testRevalidateFailed();
+    void testRevalidateWriteFailed();
+
+private:
+    QVector<UserData> createUsers(int count) const;
+
+    QTemporaryDir m_dir;
+    QString m_fileName;
+    MockServer *m_server = nullptr;
+    QNetworkAccessManager *m_nam = nullptr;
+};
+
+void UserCacheTest::initTestCase()
+{
+    QVERIFY(m_dir.isValid());
+
+    m_server = new MockServer(this);
+    QVERIFY(m_server->start());
+    m_server->setCredentials(QStringLiteral("admin"), QStringLiteral("password"));
+    m_nam = new QNetworkAccessManager(this);
+}
+
+void UserCacheTest::init()
+{
+    m_fileName = m_dir.filePath(QStringLiteral("cache/%1.cache").arg(QString::fromLatin1(QTest::currentTestFunction())));
+    m_server->setUserCount(100);
+    m_server->resetStatistics();
+}
+
+QVector<UserData> UserCacheTest::createUsers(int count) const
+{
+    QVector<UserData> users;
+    users.reserve(count);
+    for (int i = 0; i < count; ++i) {
+        users.append(UserData::fromJson(MockServer::userData(i)));
+    }
+    return users;
+}
+
+void UserCacheTest::testDefaultValues()
+{
+    UserCache cache;
+    QVERIFY(cache.fileName().isEmpty());
+    QVERIFY(!cache.configuration());
+    QVERIFY(!cache.networkAccessManager());
+    QVERIFY(!cache.isOpen());
+    QVERIFY(!cache.isRevalidating());
+    QCOMPARE(cache.count(), 0);
+    QVERIFY(!cache.created().isValid());
+    QVERIFY(cache.ids().empty());
+    QVERIFY(cache.users().empty());
+    QVERIFY(!cache.contains(QStringLiteral("user000001")));
+    QVERIFY(cache.user(QStringLiteral("user000001")).isEmpty());
+    QVERIFY(!cache.open());
+    QVERIFY(!cache.save(createUsers(1)));
+}
+
+void UserCacheTest::testOpenMissing()
+{
+    UserCache cache(m_fileName);
+    QCOMPARE(cache.fileName(), m_fileName);
+    QVERIFY(!cache.open());
+    QVERIFY(!cache.isOpen());
+    QCOMPARE(cache.count(), 0);
+}
+
+void UserCacheTest::testOpenInvalid()
+{
+    const QString fn = m_dir.filePath(QStringLiteral("invalid.cache"));
+    QFile f(fn);
+    QVERIFY(f.open(QIODevice::WriteOnly));
+    QVERIFY(f.write(QByteArray(200, 'x')) == 200);
+    f.close();
+
+    UserCache cache(fn);
+    QVERIFY(!cache.open());
+    QVERIFY(!cache.isOpen());
+
+    QFile empty(m_dir.filePath(QStringLiteral("empty.cache")));
+    QVERIFY(empty.open(QIODevice::WriteOnly));
+    empty.close();
+    cache.setFileName(empty.fileName());
+    QVERIFY(!cache.open());
+}
+
+void UserCacheTest::testSaveAndOpen()
+{
+    const QVector<UserData> users = createUsers(250);
+
+    UserCache cache(m_fileName);
+    QSignalSpy countSpy(&cache, &UserCache::countChanged);
+    QVERIFY(cache.save(users));
+    QVERIFY(cache.isOpen());
+    QCOMPARE(cache.count(), 250);
+    QCOMPARE(countSpy.count(), 1);
+    QCOMPARE(countSpy.at(0).at(0).toInt(), 250);
+    QVERIFY(cache.created().isValid());
+    QCOMPARE(cache.users(), users);
+
+    QVERIFY(cache.save(users.mid(0, 100)));
+    QCOMPARE(cache.count(), 100);
+    QCOMPARE(countSpy.count(), 2);
+
+    // saving the same number of users does not change the count
+    QVERIFY(cache.save(users.mid(100, 100)));
+    QCOMPARE(countSpy.count(), 2);
+    QVERIFY(cache.contains(users.at(150).id()));
+    QVERIFY(!cache.contains(users.at(50).id()));
+
+    UserCache other(m_fileName);
+    QVERIFY(other.open());
+    QCOMPARE(other.count(), 100);
+    QCOMPARE(other.ids().first(), users.at(100).id());
+
+    cache.close();
+    QVERIFY(!cache.isOpen());
+    QCOMPARE(cache.count(), 0);
+    QCOMPARE(countSpy.count(), 3);
+
+    QSignalSpy fileNameSpy(&other, &UserCache::fileNameChanged);
+    other.setFileName(m_dir.filePath(QStringLiteral("other.cache")));
+    QCOMPARE(fileNameSpy.count(), 1);
+    QVERIFY(!other.isOpen());
+}
+
+void UserCacheTest::testLookup()
+{
+    const QVector<UserData> users = createUsers(1000);
+
+    UserCache writer(m_fileName);
+    QVERIFY(writer.save(users));
+
+    UserCache cache(m_fileName);
+    cache.setConfiguration(m_server->createConfig(this));
+    QVERIFY(cache.open());
+
+    const MetricsRegistry::EndpointMetrics before = MetricsRegistry::global()->metrics(QStringLiteral("UserCache"), QStringLiteral("127.0.0.1"));
+
+    QCOMPARE(cache.user(MockServer::userId(0)), users.at(0));
+    QCOMPARE(cache.user(MockServer::userId(512)), users.at(512));
+    QCOMPARE(cache.user(MockServer::userId(999)), users.at(999));
+    QVERIFY(cache.user(MockServer::userId(1000)).isEmpty());
+    QVERIFY(cache.user(QString()).isEmpty());
+
+    const MetricsRegistry::EndpointMetrics after = MetricsRegistry::global()->metrics(QStringLiteral("UserCache"), QStringLiteral("127.0.0.1"));
+    QCOMPARE(after.cacheHits - before.cacheHits, static_cast<qint64>(3));
+
+    // bulk reads are recorded with a single call
+    QCOMPARE(cache.users().size(), 1000);
+    QCOMPARE(MetricsRegistry::global()->metrics(QStringLiteral("UserCache"), QStringLiteral("127.0.0.1")).cacheHits - after.cacheHits, static_cast<qint64>(1000));
+
+    const QStringList ids = cache.ids();
+    QCOMPARE(ids.size(), 1000);
+    QCOMPARE(ids.at(42), MockServer::userId(42));
+}
+
+void UserCacheTest::testRevalidate()
+{
+    m_server->setUserCount(50);
+
+    UserCache cache(m_fileName);
+    cache.setConfiguration(m_server->createConfig(this));
+    cache.setNetworkAccessManager(m_nam);
+    QVERIFY(!cache.open());
+
+    QSignalSpy revalidatedSpy(&cache, &UserCache::revalidated);
+    QSignalSpy revalidatingSpy(&cache, &UserCache::isRevalidatingChanged);
+
+    cache.revalidate();
+    QVERIFY(cache.isRevalidating());
+    QVERIFY(revalidatedSpy.wait());
+    QVERIFY(!cache.isRevalidating());
+    QCOMPARE(revalidatingSpy.count(), 2);
+    QCOMPARE(revalidatedSpy.last().at(0).toInt(), 50);
+    QCOMPARE(revalidatedSpy.last().at(1).toInt(), 0);
+    QCOMPARE(revalidatedSpy.last().at(2).toInt(), 0);
+    QVERIFY(cache.isOpen());
+    QCOMPARE(cache.count(), 50);
+    QCOMPARE(cache.user(MockServer::userId(7)), UserData::fromJson(MockServer::userData(7)));
+
+    // unchanged data does not rewrite the cache file
+    const QDateTime created = cache.created();
+    QTest::qWait(5);
+    cache.revalidate();
+    QVERIFY(revalidatedSpy.wait());
+    QCOMPARE(revalidatedSpy.last().at(0).toInt(), 0);
+    QCOMPARE(revalidatedSpy.last().at(1).toInt(), 0);
+    QCOMPARE(revalidatedSpy.last().at(2).toInt(), 0);
+    QCOMPARE(cache.created(), created);
+
+    m_server->setUserCount(60);
+    cache.revalidate();
+    QVERIFY(revalidatedSpy.wait());
+    QCOMPARE(revalidatedSpy.last().at(0).toInt(), 10);
+    QCOMPARE(cache.count(), 60);
+
+    m_server->setUserCount(40);
+    cache.revalidate();
+    QVERIFY(revalidatedSpy.wait());
+    QCOMPARE(revalidatedSpy.last().at(0).toInt(), 0);
+    QCOMPARE(revalidatedSpy.last().at(1).toInt(), 20);
+    QCOMPARE(cache.count(), 40);
+    QVERIFY(!cache.contains(MockServer::userId(45)));
+}
+
+void UserCacheTest::testRevalidateFailed()
+{
+    UserCache writer(m_fileName);
+    QVERIFY(writer.save(createUsers(10)));
+
+    auto conf = m_server->createConfig(this);
+    conf->setPassword(QStringLiteral("wrong"));
+
+    UserCache cache(m_fileName);
+    cache.setConfiguration(conf);
+    cache.setNetworkAccessManager(m_nam);
+    QVERIFY(cache.open());
+
+    QSignalSpy failedSpy(&cache, &UserCache::revalidationFailed);
+    QSignalSpy revalidatedSpy(&cache, &UserCache::revalidated);
+    cache.revalidate();
+    QVERIFY(failedSpy.wait());
+    QCOMPARE(failedSpy.at(0).at(0).toInt(), static_cast<int>(Wolkanlin::AuthNFailed));
+    QCOMPARE(revalidatedSpy.count(), 0);
+    QVERIFY(!cache.isRevalidating());
+    QCOMPARE(cache.count(), 10);
+}
+
+void UserCacheTest::testRevalidateWriteFailed()
+{
+    // the directory of the cache file can not be created, because a file is in the way
+    QFile blocker(m_dir.filePath(QStringLiteral("blocker")));
+    QVERIFY(blocker.open(QIODevice::WriteOnly));
+    blocker.close();
+
+    UserCache cache(m_dir.filePath(QStringLiteral("blocker/users.cache")));
+    cache.setConfiguration(m_server->createConfig(this));
+    cache.setNetworkAccessManager(m_nam);
+
+    QSignalSpy failedSpy(&cache, &UserCache::revalidationFailed);
+    QSignalSpy revalidatedSpy(&cache, &UserCache::revalidated);
+    cache.revalidate();
+    QVERIFY(failedSpy.wait());
+    QCOMPARE(failedSpy.at(0).at(0).toInt(), static_cast<int>(Wolkanlin::WriteError));
+    QVERIFY(!failedSpy.at(0).at(1).toString().isEmpty());
+    QCOMPARE(revalidatedSpy.count(), 0);
+    QVERIFY(!cache.isRevalidating());
+    QCOMPARE(cache.count(), 0);
+}
+
+QTEST_MAIN(UserCacheTest)
+
+#include "testusercache.moc"
@@ -0,0 +1,323 @@
+/*
+ * SPDX-FileCopyrightText: (C) 2021 Matthias Fehring / www.huessenbergnetz.de
+ * SPDX-License-Identifier: LGPL-3.0-or-later
+ */
+
+#include <QTest>
+#include <QObject>
+#include <QDataStream>
+#include <QJsonObject>
+#include <QJsonDocument>
+#include <QJsonParseError>
+#include <QVector>
+#if QT_VERSION >= QT_VERSION_CHECK(5, 12, 0)
+#include <QCborStreamReader>
+#include <QCborStreamWriter>
+#endif
+#include <Wolkanlin/UserData>
+#include <Wolkanlin/User>
+#include <Wolkanlin/StringPool>
+
+using namespace Wolkanlin;
+
+class UserDataObjectTest : public QObject
+{
+    Q_OBJECT
+public:
+    UserDataObjectTest(QObject *parent = nullptr);
+    ~UserDataObjectTest() override;
+
+private slots:
+    void initTestCase();
+
+    void testDefaultConstructor();
+    void testCopyOnWrite();
+    void testCompare();
+    void testDiffAndHash();
+    void testJsonConverters();
+    void testStringPool();
+    void testDatastreamConverters();
+    void testCborConverters();
+    void testUserWrapper();
+
+private:
+    QJsonDocument m_json;
+};
+
+UserDataObjectTest::UserDataObjectTest(QObject *parent) : QObject(parent)
+{
+
+}
+
+UserDataObjectTest::~UserDataObjectTest() = default;
+
+void UserDataObjectTest::initTestCase()
+{
+    QJsonParseError jsonError;
+    m_json = QJsonDocument::fromJson(QByteArrayLiteral("{\"ocs\":{\"meta\":{\"status\":\"ok\",\"statuscode\":100,\"message\":\"OK\",\"totalitems\":\"\",\"itemsperpage\":\"\"},\"data\":{\"enabled\":true,\"storageLocation\":\"/srv/www/nextcloud/data/tester\",\"id\":\"tester\",\"lastLogin\":1611134157000,\"backend\":\"Database\",\"subadmin\":[\"group1\"],\"quota\":{\"free\":209639130,\"used\":76070,\"total\":209715200,\"relative\":0.04,\"quota\":209715200},\"email\":\"tester@example.net\",\"displayname\":\"Tester\",\"phone\":\"+49123456789\",\"address\":\"Somewhere over the rainbow\",\"website\":\"https://example.net\",\"twitter\":\"@tester\",\"groups\":[\"group1\",\"group2\"],\"language\":\"de_DE\",\"locale\":\"de_DE\",\"backendCapabilities\":{\"setDisplayName\":false,\"setPassword\":true}}}}"), &jsonError);
+    QVERIFY(jsonError.error == QJsonParseError::NoError);
+}
+
+void UserDataObjectTest::testDefaultConstructor()
+{
+    UserData u;
+    QVERIFY(u.isEmpty());
+    QVERIFY(!u.isEnabled());
+    QVERIFY(u.storageLocation().isEmpty());
+    QVERIFY(u.id().isEmpty());
+    QVERIFY(u.lastLogin().isNull());
+    QVERIFY(u.backend().isEmpty());
+    QVERIFY(u.subadmin().empty());
+    QVERIFY(u.quota().isNull());
+    QVERIFY(u.email().isEmpty());
+    QVERIFY(u.displayname().isEmpty());
+    QVERIFY(u.phone().isEmpty());
+    QVERIFY(u.address().isEmpty());
+    QVERIFY(!u.website().isValid());
+    QVERIFY(u.twitter().isEmpty());
+    QVERIFY(u.groups().empty());
+    QVERIFY(u.language().isEmpty());
+    QVERIFY(u.locale().isEmpty());
+    QVERIFY(u.backendCapabilities() == 0);
+}
+
+void UserDataObjectTest::testCopyOnWrite()
+{
+    UserData u1;
+    u1.setId(QStringLiteral("tester"));
+    u1.setEmail(QStringLiteral("tester@example.net"));
+
+    UserData u2 = u1;
+    QCOMPARE(u2.id(), u1.id());
+    QCOMPARE(u2.email(), u1.email());
+
+    u2.setEmail(QStringLiteral("other@example.net"));
+    QCOMPARE(u1.email(), QStringLiteral("tester@example.net"));
+    QCOMPARE(u2.email(), QStringLiteral("other@example.net"));
+
+    QVector<UserData> users;
+    users.append(u1);
+    users.append(u2);
+    QCOMPARE(users.at(0).email(), QStringLiteral("tester@example.net"));
+    QCOMPARE(users.at(1).email(), QStringLiteral("other@example.net"));
+}
+
+void UserDataObjectTest::testCompare()
+{
+    const UserData u1 = UserData::fromJson(m_json);
+    const UserData u2 = UserData::fromJson(m_json);
+    const UserData u3 = u1;
+    UserData u4 = u1;
+    u4.setPhone(QStringLiteral("+49987654321"));
+
+    QVERIFY(u1 == u2);
+    QVERIFY(u1 == u3);
+    QVERIFY(u1 != u4);
+    QVERIFY(UserData() == UserData());
+    QVERIFY(UserData() != u1);
+}
+
+void UserDataObjectTest::testDiffAndHash()
+{
+    const UserData u1 = UserData::fromJson(m_json);
+    const UserData u2 = UserData::fromJson(m_json);
+    UserData u3 = u1;
+    u3.setPhone(QStringLiteral("+49987654321"));
+    u3.setGroups(QStringList({QStringLiteral("group1")}));
+
+    QCOMPARE(u1.diff(u2), User::Fields(User::NoField));
+    QCOMPARE(u1.contentHash(), u2.contentHash());
+    QCOMPARE(u1.diff(u3), User::PhoneField|User::GroupsField);
+    QVERIFY(u1.contentHash() != u3.contentHash());
+    QVERIFY(UserData().contentHash() != u1.contentHash());
+
+    // moving content between adjacent fields has to change the hash
+    UserData u4 = u1;
+    UserData u5 = u1;
+    u4.setLanguage(QStringLiteral("de"));
+    u4.setLocale(QStringLiteral("_DE"));
+    u5.setLanguage(QStringLiteral("de_"));
+    u5.setLocale(QStringLiteral("DE"));
+    QVERIFY(u4.contentHash() != u5.contentHash());
+}
+
+void UserDataObjectTest::testJsonConverters()
+{
+    const UserData u1 = UserData::fromJson(m_json);
+    QVERIFY(!u1.isEmpty());
+    QVERIFY(u1.isEnabled());
+    QCOMPARE(u1.storageLocation(), QStringLiteral("/srv/www/nextcloud/data/tester"));
+    QCOMPARE(u1.id(), QStringLiteral("tester"));
+    QCOMPARE(u1.lastLogin(), QDateTime::fromMSecsSinceEpoch(1611134157000));
+    QCOMPARE(u1.backend(), QStringLiteral("Database"));
+    QCOMPARE(u1.subadmin(), QStringList{QStringLiteral("group1")});
+    QCOMPARE(u1.quota(), Quota(209639130, 76070, 209715200, 209715200, 0.04));
+    QCOMPARE(u1.email(), QStringLiteral("tester@example.net"));
+    QCOMPARE(u1.displayname(), QStringLiteral("Tester"));
+    QCOMPARE(u1.phone(), QStringLiteral("+49123456789"));
+    QCOMPARE(u1.address(), QStringLiteral("Somewhere over the rainbow"));
+    QCOMPARE(u1.website(), QUrl(QStringLiteral("https://example.net")));
+    QCOMPARE(u1.twitter(), QStringLiteral("@tester"));
+    QCOMPARE(u1.groups(), QStringList({QStringLiteral("group1"), QStringLiteral("group2")}));
+    QCOMPARE(u1.language(), QStringLiteral("de_DE"));
+    QCOMPARE(u1.locale(), QStringLiteral("de_DE"));
+    QVERIFY((u1.backendCapabilities() & User::CanSetDisplayName) != User::CanSetDisplayName);
+    QVERIFY((u1.backendCapabilities() & User::CanSetPassword) == User::CanSetPassword);
+
+    QVERIFY(UserData::fromJson(QJsonDocument()).isEmpty());
+    QVERIFY(UserData::fromJson(QJsonObject()).isEmpty());
+
+    const QJsonObject ocs = m_json.object().value(QStringLiteral("ocs")).toObject();
+    QCOMPARE(UserData::fromJson(ocs).id(), QStringLiteral("tester"));
+
+    const QJsonObject data = ocs.value(QStringLiteral("data")).toObject();
+    QCOMPARE(UserData::fromJson(data).id(), QStringLiteral("tester"));
+
+    QVERIFY(UserData::fromJson(ocs.value(QStringLiteral("meta")).toObject()).isEmpty());
+
+    QCOMPARE(u1.toJson(), data);
+}
+
+void UserDataObjectTest::testStringPool()
+{
+    StringPool pool;
+    const QJsonObject data = m_json.object().value(QStringLiteral("ocs")).toObject().value(QStringLiteral("data")).toObject();
+
+    const UserData u1 = UserData::fromJson(data, &pool);
+    QCOMPARE(u1, UserData::fromJson(data));
+    QCOMPARE(pool.size(), 4);
+
+    QJsonObject otherData = data;
+    otherData.insert(QStringLiteral("id"), QStringLiteral("tester2"));
+    const UserData u2 = UserData::fromJson(otherData, &pool);
+    QCOMPARE(u2.id(), QStringLiteral("tester2"));
+    QCOMPARE(pool.size(), 4);
+
+    QVERIFY(u1.backend().constData() == u2.backend().constData());
+    QVERIFY(u1.groups().at(1).constData() == u2.groups().at(1).constData());
+    QVERIFY(u1.subadmin().at(0).constData() == u2.groups().at(0).constData());
+    QVERIFY(u1.language().constData() == u2.locale().constData());
+
+    const StringPool::Statistics stats = pool.statistics();
+    QCOMPARE(stats.uniqueStrings, 4);
+    QCOMPARE(stats.lookups, static_cast<qint64>(12));
+    QCOMPARE(stats.hits, static_cast<qint64>(8));
+    QVERIFY(stats.savedBytes > 0);
+    QVERIFY(stats.pooledBytes > 0);
+
+    // no pool, no interning
+    const int globalSize = StringPool::global()->size();
+    const UserData u3 = UserData::fromJson(data, nullptr);
+    QCOMPARE(u3, u1);
+    QCOMPARE(StringPool::global()->size(), globalSize);
+
+    pool.clear();
+    QCOMPARE(pool.size(), 0);
+    QCOMPARE(pool.statistics().lookups, static_cast<qint64>(0));
+}
+
+void UserDataObjectTest::testDatastreamConverters()
+{
+    const UserData u1 = UserData::fromJson(m_json);
+
+    QByteArray outBa;
+    QDataStream out(&outBa, QIODevice::WriteOnly);
+    out << u1;
+
+    const QByteArray inBa = outBa;
+    QDataStream in(inBa);
+    UserData u2;
+    in >> u2;
+
+    QCOMPARE(u1, u2);
+}
+
+void UserDataObjectTest::testCborConverters()
+{
+#if QT_VERSION >= QT_VERSION_CHECK(5, 12, 0)
+    const UserData u1 = UserData::fromJson(m_json);
+
+    const QByteArray cbor = u1.toCbor();
+    QVERIFY(!cbor.isEmpty());
+    QVERIFY(cbor.size() < QJsonDocument(u1.toJson()).toJson(QJsonDocument::Compact).size());
+    QCOMPARE(UserData::fromCbor(cbor), u1);
+
+    // empty values are omitted and restored as empty values
+    UserData u2 = u1;
+    u2.setPhone(QString());
+    u2.setGroups(QStringList());
+    u2.setLastLogin(QDateTime());
+    u2.setQuota(Quota());
+    u2.setEnabled(false);
+    QVERIFY(u2.toCbor().size() < cbor.size());
+    QCOMPARE(UserData::fromCbor(u2.toCbor()), u2);
+
+    // multiple users can be streamed one after another
+    QByteArray stream;
+    {
+        QCborStreamWriter writer(&stream);
+        writer.startArray(2);
+        u1.toCbor(writer);
+        u2.toCbor(writer);
+        writer.endArray();
+    }
+    {
+        QCborStreamReader reader(stream);
+        QVERIFY(reader.isArray());
+        QVERIFY(reader.enterContainer());
+        QCOMPARE(UserData::fromCbor(reader), u1);
+        QCOMPARE(UserData::fromCbor(reader), u2);
+        QVERIFY(!reader.hasNext());
+        QVERIFY(reader.leaveContainer());
+        QVERIFY(reader.lastError() == QCborError::NoError);
+    }
+
+    // unknown keys are skipped
+    QByteArray unknown;
+    {
+        QCborStreamWriter writer(&unknown);
+        writer.startMap();
+        writer.append(static_cast<quint64>(200));
+        writer.startArray(2);
+        writer.append(static_cast<quint64>(1));
+        writer.append(QLatin1String("foo"));
+        writer.endArray();
+        writer.append(static_cast<quint64>(0));
+        writer.append(QLatin1String("tester"));
+        writer.append(QLatin1String("key"));
+        writer.append(true);
+        writer.endMap();
+    }
+    const UserData u3 = UserData::fromCbor(unknown);
+    QCOMPARE(u3.id(), QStringLiteral("tester"));
+    QVERIFY(!u3.isEnabled());
+
+    QVERIFY(UserData().toCbor().size() > 0);
+    QVERIFY(UserData::fromCbor(UserData().toCbor()).isEmpty());
+    QVERIFY(UserData::fromCbor(QByteArray()).isEmpty());
+    QVERIFY(UserData::fromCbor(cbor.left(cbor.size() / 2)).isEmpty());
+    QVERIFY(UserData::fromCbor(QByteArrayLiteral("\x83\x01\x02\x03")).isEmpty());
+#else
+    QSKIP("CBOR support requires Qt 5.12 or newer.");
+#endif
+}
+
+void UserDataObjectTest::testUserWrapper()
+{
+    const UserData u1 = UserData::fromJson(m_json);
+    auto user = new User(u1, this);
+    QCOMPARE(user->id(), u1.id());
+    QCOMPARE(user->email(), u1.email());
+    QCOMPARE(user->groups(), u1.groups());
+    QCOMPARE(user->userData(), u1);
+    QCOMPARE(user->toJson(), u1.toJson());
+#if QT_VERSION >= QT_VERSION_CHECK(5, 12, 0)
+    QCOMPARE(user->toCbor(), u1.toCbor());
+    auto user2 = User::fromCbor(user->toCbor(), this);
+    QCOMPARE(user2->userData(), u1);
+#endif
+}
+
+QTEST_MAIN(UserDataObjectTest)
+
+#include "testuserdataobject.moc"
@@ -0,0 +1,150 @@
+/*
+ * SPDX-FileCopyrightText: (C) 2021 Matthias Fehring / www.huessenbergnetz.de
+ * SPDX-License-Identifier: LGPL-3.0-or-later
+ */
+
+#include <QTest>
+#include <QObject>
+#include <QSignalSpy>
+#include <Wolkanlin/UserDirectory>
+#include <Wolkanlin/UserData>
+
+using namespace Wolkanlin;
+
+class UserDirectoryTest : public QObject
+{
+    Q_OBJECT
+public:
+    UserDirectoryTest(QObject *parent = nullptr);
+    ~UserDirectoryTest() override;
+
+private slots:
+    void testDefaultConstructor();
+    void testSync();
+    void testUnchangedSync();
+    void testClear();
+
+private:
+    static UserData createUser(const QString &id, const QString &displayname);
+};
+
+UserDirectoryTest::UserDirectoryTest(QObject *parent) : QObject(parent)
+{
+
+}
+
+UserDirectoryTest::~UserDirectoryTest() = default;
+
+UserData UserDirectoryTest::createUser(const QString &id, const QString &displayname)
+{
+    UserData user;
+    user.setId(id);
+    user.setEnabled(true);
+    user.setDisplayname(displayname);
+    user.setGroups(QStringList({QStringLiteral("group1")}));
+    return user;
+}
+
+void UserDirectoryTest::testDefaultConstructor()
+{
+    UserDirectory dir;
+    QCOMPARE(dir.count(), 0);
+    QVERIFY(!dir.isRefreshing());
+    QVERIFY(!dir.configuration());
+    QVERIFY(dir.ids().empty());
+    QVERIFY(dir.lastDelta().isEmpty());
+    QVERIFY(dir.user(QStringLiteral("user1")).isEmpty());
+}
+
+void UserDirectoryTest::testSync()
+{
+    UserDirectory dir;
+
+    QSignalSpy addedSpy(&dir, &UserDirectory::userAdded);
+    QSignalSpy removedSpy(&dir, &UserDirectory::userRemoved);
+    QSignalSpy modifiedSpy(&dir, &UserDirectory::userModified);
+    QSignalSpy syncSpy(&dir, &UserDirectory::synchronized);
+    QSignalSpy countSpy(&dir, &UserDirectory::countChanged);
+
+    UserDirectory::Delta delta = dir.sync({createUser(QStringLiteral("user1"), QStringLiteral("User 1")),
+                                           createUser(QStringLiteral("user2"), QStringLiteral("User 2")),
+                                           createUser(QStringLiteral("user3"), QStringLiteral("User 3")),
+                                           UserData()});
+    QCOMPARE(delta.added.size(), 3);
+    QVERIFY(delta.removed.empty());
+    QVERIFY(delta.modified.empty());
+    QCOMPARE(dir.count(), 3);
+    QCOMPARE(addedSpy.count(), 3);
+    QCOMPARE(countSpy.count(), 1);
+    QCOMPARE(syncSpy.count(), 1);
+    QCOMPARE(syncSpy.at(0).at(0).toInt(), 3);
+
+    UserData changed = createUser(QStringLiteral("user2"), QStringLiteral("Second User"));
+    changed.setEnabled(false);
+
+    delta = dir.sync({createUser(QStringLiteral("user1"), QStringLiteral("User 1")),
+                      changed,
+                      createUser(QStringLiteral("user4"), QStringLiteral("User 4"))});
+    QCOMPARE(delta.added.size(), 1);
+    QCOMPARE(delta.added.at(0).id(), QStringLiteral("user4"));
+    QCOMPARE(delta.removed.size(), 1);
+    QCOMPARE(delta.removed.at(0).id(), QStringLiteral("user3"));
+    QCOMPARE(delta.modified.size(), 1);
+    QCOMPARE(delta.modified.at(0).current.id(), QStringLiteral("user2"));
+    QCOMPARE(delta.modified.at(0).previous.displayname(), QStringLiteral("User 2"));
+    QCOMPARE(delta.modified.at(0).fields, User::DisplaynameField|User::EnabledField);
+    QCOMPARE(dir.count(), 3);
+    QCOMPARE(addedSpy.count(), 4);
+    QCOMPARE(removedSpy.count(), 1);
+    QCOMPARE(modifiedSpy.count(), 1);
+    QCOMPARE(syncSpy.count(), 2);
+    QCOMPARE(countSpy.count(), 1);
+    QVERIFY(!dir.contains(QStringLiteral("user3")));
+    QCOMPARE(dir.user(QStringLiteral("user2")).displayname(), QStringLiteral("Second User"));
+    QCOMPARE(dir.lastDelta().modified.size(), 1);
+}
+
+void UserDirectoryTest::testUnchangedSync()
+{
+    UserDirectory dir;
+    QVector<UserData> users;
+    for (int i = 0; i < 100; ++i) {
+        users << createUser(QStringLiteral("user%1").arg(i), QStringLiteral("User %1").arg(i));
+    }
+    dir.sync(users);
+
+    QSignalSpy addedSpy(&dir, &UserDirectory::userAdded);
+    QSignalSpy removedSpy(&dir, &UserDirectory::userRemoved);
+    QSignalSpy modifiedSpy(&dir, &UserDirectory::userModified);
+
+    // equal content in new objects has to be detected as unchanged
+    QVector<UserData> copies;
+    for (int i = 0; i < 100; ++i) {
+        copies << createUser(QStringLiteral("user%1").arg(i), QStringLiteral("User %1").arg(i));
+    }
+    const UserDirectory::Delta delta = dir.sync(copies);
+    QVERIFY(delta.isEmpty());
+    QCOMPARE(addedSpy.count(), 0);
+    QCOMPARE(removedSpy.count(), 0);
+    QCOMPARE(modifiedSpy.count(), 0);
+    QCOMPARE(dir.count(), 100);
+}
+
+void UserDirectoryTest::testClear()
+{
+    UserDirectory dir;
+    dir.sync({createUser(QStringLiteral("user1"), QStringLiteral("User 1"))});
+    QSignalSpy countSpy(&dir, &UserDirectory::countChanged);
+    dir.clear();
+    QCOMPARE(dir.count(), 0);
+    QCOMPARE(countSpy.count(), 1);
+    QVERIFY(dir.lastDelta().isEmpty());
+
+    // after clearing, all users are new again
+    const UserDirectory::Delta delta = dir.sync({createUser(QStringLiteral("user1"), QStringLiteral("User 1"))});
+    QCOMPARE(delta.added.size(), 1);
+}
+
+QTEST_MAIN(UserDirectoryTest)
+
+#include "testuserdirectory.moc"
@@ -0,0 +1,167 @@
+/*
+ * SPDX-FileCopyrightText: (C) 2021 Matthias Fehring / www.huessenbergnetz.de
+ * SPDX-License-Identifier: LGPL-3.0-or-later
+ */
+
+#include <QTest>
+#include <QObject>
+#include <QSignalSpy>
+#include <Wolkanlin/UserListModel>
+#include <Wolkanlin/UserData>
+
+using namespace Wolkanlin;
+
+class UserListModelTest : public QObject
+{
+    Q_OBJECT
+public:
+    UserListModelTest(QObject *parent = nullptr);
+    ~UserListModelTest() override;
+
+private slots:
+    void testDefaultConstructor();
+    void testRoleNames();
+    void testFetchMore();
+    void testUnloadedData();
+    void testRetryFailedRows();
+};
+
+UserListModelTest::UserListModelTest(QObject *parent) : QObject(parent)
+{
+
+}
+
+UserListModelTest::~UserListModelTest() = default;
+
+void UserListModelTest::testDefaultConstructor()
+{
+    UserListModel model;
+    QCOMPARE(model.rowCount(), 0);
+    QCOMPARE(model.totalCount(), 0);
+    QCOMPARE(model.pageSize(), 100);
+    QCOMPARE(model.prefetchWindow(), 50);
+    QCOMPARE(model.maxConcurrentRequests(), 6);
+    QVERIFY(!model.isLoading());
+    QVERIFY(!model.canFetchMore(QModelIndex()));
+    QVERIFY(!model.configuration());
+}
+
+void UserListModelTest::testRoleNames()
+{
+    UserListModel model;
+    const QHash<int, QByteArray> roles = model.roleNames();
+    QCOMPARE(roles.value(Qt::DisplayRole), QByteArrayLiteral("display"));
+    QCOMPARE(roles.value(UserListModel::IdRole), QByteArrayLiteral("id"));
+    QCOMPARE(roles.value(UserListModel::EnabledRole), QByteArrayLiteral("enabled"));
+    QCOMPARE(roles.value(UserListModel::StorageLocationRole), QByteArrayLiteral("storageLocation"));
+    QCOMPARE(roles.value(UserListModel::LastLoginRole), QByteArrayLiteral("lastLogin"));
+    QCOMPARE(roles.value(UserListModel::BackendRole), QByteArrayLiteral("backend"));
+    QCOMPARE(roles.value(UserListModel::SubadminRole), QByteArrayLiteral("subadmin"));
+    QCOMPARE(roles.value(UserListModel::QuotaRole), QByteArrayLiteral("quota"));
+    QCOMPARE(roles.value(UserListModel::EmailRole), QByteArrayLiteral("email"));
+    QCOMPARE(roles.value(UserListModel::DisplaynameRole), QByteArrayLiteral("displayname"));
+    QCOMPARE(roles.value(UserListModel::PhoneRole), QByteArrayLiteral("phone"));
+    QCOMPARE(roles.value(UserListModel::AddressRole), QByteArrayLiteral("address"));
+    QCOMPARE(roles.value(UserListModel::WebsiteRole), QByteArrayLiteral("website"));
+    QCOMPARE(roles.value(UserListModel::TwitterRole), QByteArrayLiteral("twitter"));
+    QCOMPARE(roles.value(UserListModel::GroupsRole), QByteArrayLiteral("groups"));
+    QCOMPARE(roles.value(UserListModel::LanguageRole), QByteArrayLiteral("language"));
+    QCOMPARE(roles.value(UserListModel::LocaleRole), QByteArrayLiteral("locale"));
+    QCOMPARE(roles.value(UserListModel::BackendCapabilitiesRole), QByteArrayLiteral("backendCapabilities"));
+    QCOMPARE(roles.value(UserListModel::IsLoadedRole), QByteArrayLiteral("isLoaded"));
+    QCOMPARE(roles.value(UserListModel::UserDataRole), QByteArrayLiteral("userData"));
+}
+
+void UserListModelTest::testFetchMore()
+{
+    QStringList ids;
+    ids.reserve(250);
+    for (int i = 0; i < 250; ++i) {
+        ids << QStringLiteral("user%1").arg(i);
+    }
+
+    UserListModel model;
+    QSignalSpy totalCountSpy(&model, &UserListModel::totalCountChanged);
+    QSignalSpy rowsInsertedSpy(&model, &QAbstractItemModel::rowsInserted);
+
+    model.setUserIds(ids);
+    QCOMPARE(totalCountSpy.count(), 1);
+    QCOMPARE(model.totalCount(), 250);
+    QCOMPARE(model.rowCount(), 0);
+
+    QVERIFY(model.canFetchMore(QModelIndex()));
+    model.fetchMore(QModelIndex());
+    QCOMPARE(model.rowCount(), 100);
+    model.fetchMore(QModelIndex());
+    QCOMPARE(model.rowCount(), 200);
+    QVERIFY(model.canFetchMore(QModelIndex()));
+    model.fetchMore(QModelIndex());
+    QCOMPARE(model.rowCount(), 250);
+    QVERIFY(!model.canFetchMore(QModelIndex()));
+    QCOMPARE(rowsInsertedSpy.count(), 3);
+
+    model.setPageSize(0);
+    QCOMPARE(model.pageSize(), 1);
+
+    model.setUserIds(QStringList());
+    QCOMPARE(model.rowCount(), 0);
+    QCOMPARE(model.totalCount(), 0);
+    QCOMPARE(totalCountSpy.count(), 2);
+}
+
+void UserListModelTest::testUnloadedData()
+{
+    UserListModel model;
+    model.setUserIds({QStringLiteral("alice"), QStringLiteral("bob")});
+    model.fetchMore(QModelIndex());
+    QCOMPARE(model.rowCount(), 2);
+
+    const QModelIndex idx = model.index(1);
+    QCOMPARE(model.data(idx, UserListModel::IdRole).toString(), QStringLiteral("bob"));
+    QCOMPARE(model.data(idx, Qt::DisplayRole).toString(), QStringLiteral("bob"));
+    QVERIFY(!model.data(idx, UserListModel::IsLoadedRole).toBool());
+    QVERIFY(model.data(idx, UserListModel::UserDataRole).value<UserData>().isEmpty());
+    QVERIFY(model.userData(1).isEmpty());
+    QVERIFY(model.userData(5).isEmpty());
+    QVERIFY(!model.data(model.index(5), UserListModel::IdRole).isValid());
+}
+
+void UserListModelTest::testRetryFailedRows()
+{
+    // without a configuration every request fails
+    UserListModel model;
+    model.setPrefetchWindow(0);
+    QSignalSpy dataChangedSpy(&model, &QAbstractItemModel::dataChanged);
+    QSignalSpy loadingSpy(&model, &UserListModel::isLoadingChanged);
+    model.setUserIds({QStringLiteral("u0"), QStringLiteral("u1"), QStringLiteral("u2"), QStringLiteral("u3"), QStringLiteral("u4")});
+    model.fetchMore(QModelIndex());
+    QTRY_COMPARE(dataChangedSpy.count(), 5);
+    QTRY_VERIFY(!model.isLoading());
+    const int loadingChanges = loadingSpy.count();
+
+    // reading the data does not start any request
+    for (int row = 0; row < model.rowCount(); ++row) {
+        QVERIFY(!model.data(model.index(row), UserListModel::IsLoadedRole).toBool());
+    }
+    QTest::qWait(50);
+    QCOMPARE(loadingSpy.count(), loadingChanges);
+
+    // failed rows that are still visible are not requested again
+    model.setVisibleRange(0, 1);
+    QTest::qWait(50);
+    QCOMPARE(loadingSpy.count(), loadingChanges);
+    QCOMPARE(dataChangedSpy.count(), 5);
+
+    // rows that left the visible range are requested again when they become visible
+    model.setVisibleRange(3, 4);
+    QTRY_COMPARE(dataChangedSpy.count(), 7);
+    QTRY_VERIFY(!model.isLoading());
+    QVERIFY(loadingSpy.count() > loadingChanges);
+
+    model.setVisibleRange(0, 1);
+    QTRY_COMPARE(dataChangedSpy.count(), 9);
+}
+
+QTEST_MAIN(UserListModelTest)
+
+#include "testuserlistmodel.moc"
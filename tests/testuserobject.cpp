@@ -9,7 +9,9 @@
 #include <QJsonObject>
 #include <QJsonDocument>
 #include <QJsonParseError>
+#include <QSignalSpy>
 #include <Wolkanlin/User>
+#include <Wolkanlin/UserData>
 
 using namespace Wolkanlin;
 
@@ -26,6 +28,7 @@ private slots:
     void testDefaultConstructor();
     void testJsonConverters();
     void testDatastreamConverters();
+    void testSetUserData();
 
 private:
     QJsonDocument m_json;
@@ -144,6 +147,48 @@ void UserObjectTest::testDatastreamConverters()
     QCOMPARE(u1->backendCapabilities(), u2->backendCapabilities());
 }
 
+void UserObjectTest::testSetUserData()
+{
+    User user;
+    const UserData data = UserData::fromJson(m_json);
+
+    QStringList emitted;
+    connect(&user, &User::changed, this, [&emitted](){ emitted << QStringLiteral("changed"); });
+    connect(&user, &User::displaynameChanged, this, [&emitted](){ emitted << QStringLiteral("displayname"); });
+
+    QSignalSpy changedSpy(&user, &User::changed);
+    QSignalSpy idSpy(&user, &User::idChanged);
+    QSignalSpy displaynameSpy(&user, &User::displaynameChanged);
+    QSignalSpy phoneSpy(&user, &User::phoneChanged);
+
+    // all fields are changed at once
+    user.setUserData(data);
+    QCOMPARE(user.userData(), data);
+    QCOMPARE(changedSpy.count(), 1);
+    QVERIFY(changedSpy.at(0).at(0).value<User::Fields>().testFlag(User::IdField));
+    QCOMPARE(idSpy.count(), 1);
+    QCOMPARE(displaynameSpy.count(), 1);
+    QCOMPARE(emitted, QStringList({QStringLiteral("changed"), QStringLiteral("displayname")}));
+
+    // nothing changed, nothing emitted
+    user.setUserData(UserData::fromJson(m_json));
+    QCOMPARE(changedSpy.count(), 1);
+    QCOMPARE(idSpy.count(), 1);
+
+    // only the changed properties are notified
+    UserData changedData = data;
+    changedData.setDisplayname(QStringLiteral("Other Name"));
+    changedData.setPhone(QStringLiteral("+49987654321"));
+    user.setUserData(changedData);
+    QCOMPARE(changedSpy.count(), 2);
+    QCOMPARE(changedSpy.at(1).at(0).value<User::Fields>(), User::DisplaynameField|User::PhoneField);
+    QCOMPARE(idSpy.count(), 1);
+    QCOMPARE(displaynameSpy.count(), 2);
+    QCOMPARE(displaynameSpy.at(1).at(0).toString(), QStringLiteral("Other Name"));
+    QCOMPARE(phoneSpy.count(), 2);
+    QCOMPARE(user.displayname(), QStringLiteral("Other Name"));
+}
+
 QTEST_MAIN(UserObjectTest)
 
 #include "testuserobject.moc"
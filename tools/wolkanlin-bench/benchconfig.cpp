@@ -0,0 +1,99 @@
+/*
+ * SPDX-FileCopyrightText: (C) 2021 Matthias Fehring / www.huessenbergnetz.de
+ * SPDX-License-Identifier: LGPL-3.0-or-later
+ */
+
+#include "benchconfig.h"
+
+BenchConfig::BenchConfig(QObject *parent)
+    : Wolkanlin::AbstractConfiguration(parent)
+{
+    // all setters notify their changes
+    setSnapshotCachingEnabled(true);
+}
+
+BenchConfig::~BenchConfig() = default;
+
+QString BenchConfig::username() const
+{
+    return m_username;
+}
+
+void BenchConfig::setUsername(const QString &username)
+{
+    m_username = username;
+    notifyCredentialsChanged();
+}
+
+QString BenchConfig::password() const
+{
+    return m_password;
+}
+
+void BenchConfig::setPassword(const QString &password)
+{
+    m_password = password;
+    notifyCredentialsChanged();
+}
+
+QString BenchConfig::host() const
+{
+    return m_host;
+}
+
+void BenchConfig::setHost(const QString &host)
+{
+    m_host = host;
+    notifyEndpointChanged();
+}
+
+int BenchConfig::port() const
+{
+    return m_port;
+}
+
+void BenchConfig::setPort(int port)
+{
+    m_port = port;
+    notifyEndpointChanged();
+}
+
+QString BenchConfig::installPath() const
+{
+    return m_installPath;
+}
+
+void BenchConfig::setInstallPath(const QString &installPath)
+{
+    m_installPath = installPath;
+    notifyEndpointChanged();
+}
+
+bool BenchConfig::useSsl() const
+{
+    return m_useSsl;
+}
+
+void BenchConfig::setUseSsl(bool useSsl)
+{
+    m_useSsl = useSsl;
+    notifyEndpointChanged();
+}
+
+bool BenchConfig::ignoreSslErrors() const
+{
+    return m_ignoreSslErrors;
+}
+
+void BenchConfig::setIgnoreSslErrors(bool ignoreSslErrors)
+{
+    m_ignoreSslErrors = ignoreSslErrors;
+    invalidateSnapshot();
+}
+
+QString BenchConfig::userAgent() const
+{
+    return QStringLiteral("wolkanlin-bench");
+}
+
+#include "moc_benchconfig.cpp"
@@ -0,0 +1,52 @@
+/*
+ * SPDX-FileCopyrightText: (C) 2021 Matthias Fehring / www.huessenbergnetz.de
+ * SPDX-License-Identifier: LGPL-3.0-or-later
+ */
+
+#ifndef WOLKANLINBENCH_BENCHCONFIG_H
+#define WOLKANLINBENCH_BENCHCONFIG_H
+
+#include <Wolkanlin/AbstractConfiguration>
+
+class BenchConfig : public Wolkanlin::AbstractConfiguration
+{
+    Q_OBJECT
+public:
+    explicit BenchConfig(QObject *parent = nullptr);
+    ~BenchConfig() override;
+
+    QString username() const override;
+    void setUsername(const QString &username) override;
+
+    QString password() const override;
+    void setPassword(const QString &password) override;
+
+    QString host() const override;
+    void setHost(const QString &host) override;
+
+    int port() const override;
+    void setPort(int port) override;
+
+    QString installPath() const override;
+    void setInstallPath(const QString &installPath) override;
+
+    bool useSsl() const override;
+    void setUseSsl(bool useSsl) override;
+
+    bool ignoreSslErrors() const override;
+    void setIgnoreSslErrors(bool ignoreSslErrors) override;
+
+    QString userAgent() const override;
+
+private:
+    QString m_username;
+    QString m_password;
+    QString m_host;
+    QString m_installPath;
+    int m_port = 0;
+    bool m_useSsl = true;
+    bool m_ignoreSslErrors = false;
+    Q_DISABLE_COPY(BenchConfig)
+};
+
+#endif // WOLKANLINBENCH_BENCHCONFIG_H
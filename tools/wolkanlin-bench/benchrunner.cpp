@@ -0,0 +1,308 @@
+/*
+ * SPDX-FileCopyrightText: (C) 2021 Matthias Fehring / www.huessenbergnetz.de
+ * SPDX-License-Identifier: LGPL-3.0-or-later
+ */
+
+#include "benchrunner.h"
+#include <Wolkanlin/AbstractConfiguration>
+#include <Wolkanlin/GetUserJob>
+#include <Wolkanlin/GetUserListJob>
+#include <Wolkanlin/GetServerStatusJob>
+#include <QNetworkAccessManager>
+#include <QTimer>
+#include <QTextStream>
+#include <QJsonArray>
+#include <algorithm>
+#include <cmath>
+
+using namespace Wolkanlin;
+
+BenchRunner::BenchRunner(AbstractConfiguration *config, const Options &options, QObject *parent)
+    : QObject(parent), m_options(options), m_config(config)
+{
+    m_options.concurrency = qMax(m_options.concurrency, 1);
+    m_options.duration = qMax(m_options.duration, 1);
+    m_options.users = qMax(m_options.users, 1);
+    m_options.pageSize = qMax(m_options.pageSize, 1);
+    if (m_options.reuseConnections) {
+        m_nam = new QNetworkAccessManager(this);
+    }
+}
+
+BenchRunner::~BenchRunner() = default;
+
+bool BenchRunner::workloadFromString(const QString &str, Workload *workload)
+{
+    if (str == QLatin1String("users")) {
+        *workload = Users;
+    } else if (str == QLatin1String("status")) {
+        *workload = Status;
+    } else if (str == QLatin1String("paging")) {
+        *workload = Paging;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+QString BenchRunner::workloadToString(Workload workload)
+{
+    switch (workload) {
+    case Users:
+        return QStringLiteral("users");
+    case Status:
+        return QStringLiteral("status");
+    case Paging:
+        return QStringLiteral("paging");
+    }
+    return QString();
+}
+
+void BenchRunner::start()
+{
+    m_timer.start();
+
+    if (m_options.workload == Users) {
+        fetchIds();
+    } else {
+        run();
+    }
+}
+
+void BenchRunner::fetchIds()
+{
+    auto job = new GetUserListJob(this);
+    job->setConfiguration(m_config);
+    job->setNetworkAccessManager(m_nam ? m_nam : new QNetworkAccessManager(job));
+    job->setLimit(m_options.users);
+
+    connect(job, &WJob::result, this, [this, job](){
+        if (job->error() != WJob::NoError) {
+            qCritical("Failed to request the list of user IDs: %s", qUtf8Printable(job->errorString()));
+            m_finished = true;
+            Q_EMIT finished(false);
+            return;
+        }
+
+        m_ids = job->ids();
+        if (m_ids.empty()) {
+            qCritical("%s", "The server returned an empty list of user IDs.");
+            m_finished = true;
+            Q_EMIT finished(false);
+            return;
+        }
+
+        run();
+    });
+
+    job->start();
+}
+
+void BenchRunner::run()
+{
+    m_runStarted = m_timer.nsecsElapsed();
+
+    QTimer::singleShot(m_options.duration * 1000, this, &BenchRunner::stop);
+
+    if (m_options.rate > 0.0) {
+        // the interval timer has millisecond resolution, higher rates launch several operations per tick
+        const double interval = 1000.0 / m_options.rate;
+        const int tickInterval = qMax(static_cast<int>(interval), 1);
+        const int perTick = qMax(static_cast<int>(std::round(static_cast<double>(tickInterval) / interval)), 1);
+
+        m_rateTimer = new QTimer(this);
+        m_rateTimer->setTimerType(Qt::PreciseTimer);
+        m_rateTimer->setInterval(tickInterval);
+        connect(m_rateTimer, &QTimer::timeout, this, [this, perTick](){
+            for (int i = 0; i < perTick; ++i) {
+                if (m_running < m_options.concurrency) {
+                    launch();
+                } else {
+                    // the server can not keep up with the requested rate
+                    m_skipped++;
+                }
+            }
+        });
+        m_rateTimer->start();
+        launch();
+    } else {
+        fill();
+    }
+}
+
+void BenchRunner::fill()
+{
+    while (!m_stopping && m_running < m_options.concurrency) {
+        launch();
+    }
+}
+
+void BenchRunner::launch()
+{
+    Job *job = nullptr;
+
+    switch (m_options.workload) {
+    case Users:
+        job = new GetUserJob(m_ids.at(m_nextId), this);
+        m_nextId = (m_nextId + 1) % m_ids.size();
+        break;
+    case Status:
+        job = new GetServerStatusJob(this);
+        break;
+    case Paging:
+    {
+        auto j = new GetUserListJob(this);
+        j->setFetchAllPages(true);
+        j->setPageSize(m_options.pageSize);
+        job = j;
+    }
+        break;
+    }
+
+    job->setConfiguration(m_config);
+    // without connection reuse every operation gets its own network access manager
+    // and therefore its own connections
+    job->setNetworkAccessManager(m_nam ? m_nam : new QNetworkAccessManager(job));
+
+    const qint64 started = m_timer.nsecsElapsed();
+    connect(job, &WJob::result, this, [this, job, started](){
+        onOperationFinished(job, started);
+    });
+
+    m_running++;
+    m_started++;
+    job->start();
+}
+
+void BenchRunner::onOperationFinished(Job *job, qint64 started)
+{
+    m_running--;
+
+    const int error = job->error();
+    if (error == WJob::NoError) {
+        m_succeeded++;
+        m_latencies.append(m_timer.nsecsElapsed() - started);
+    } else {
+        m_failed++;
+        ErrorInfo &info = m_errors[error];
+        info.count++;
+        if (info.message.isEmpty()) {
+            info.message = job->errorString();
+        }
+    }
+
+    if (m_stopping) {
+        if (m_running == 0) {
+            finish();
+        }
+    } else if (!m_rateTimer) {
+        fill();
+    }
+}
+
+void BenchRunner::stop()
+{
+    m_stopping = true;
+    m_runFinished = m_timer.nsecsElapsed();
+
+    if (m_rateTimer) {
+        m_rateTimer->stop();
+    }
+
+    if (m_running == 0) {
+        finish();
+    }
+}
+
+void BenchRunner::finish()
+{
+    if (m_finished) {
+        return;
+    }
+    m_finished = true;
+    std::sort(m_latencies.begin(), m_latencies.end());
+    Q_EMIT finished(true);
+}
+
+qint64 BenchRunner::percentile(const QVector<qint64> &sorted, double p)
+{
+    if (sorted.empty()) {
+        return 0;
+    }
+    const int rank = static_cast<int>(std::ceil(p / 100.0 * static_cast<double>(sorted.size())));
+    return sorted.at(qBound(0, rank - 1, sorted.size() - 1));
+}
+
+QJsonObject BenchRunner::report() const
+{
+    // operations still running when the duration has elapsed are part of the counts,
+    // the throughput is calculated over the configured duration
+    const double seconds = static_cast<double>(qMax<qint64>(m_runFinished - m_runStarted, 1)) / 1e9;
+    const double toMs = 1e-6;
+
+    QJsonObject latency;
+    latency.insert(QStringLiteral("p50"), static_cast<double>(percentile(m_latencies, 50)) * toMs);
+    latency.insert(QStringLiteral("p95"), static_cast<double>(percentile(m_latencies, 95)) * toMs);
+    latency.insert(QStringLiteral("p99"), static_cast<double>(percentile(m_latencies, 99)) * toMs);
+    latency.insert(QStringLiteral("max"), m_latencies.empty() ? 0.0 : static_cast<double>(m_latencies.last()) * toMs);
+
+    QJsonArray errors;
+    for (auto it = m_errors.cbegin(); it != m_errors.cend(); ++it) {
+        QJsonObject e;
+        e.insert(QStringLiteral("code"), it.key());
+        e.insert(QStringLiteral("count"), it.value().count);
+        e.insert(QStringLiteral("message"), it.value().message);
+        errors.append(e);
+    }
+
+    QJsonObject o;
+    o.insert(QStringLiteral("workload"), workloadToString(m_options.workload));
+    o.insert(QStringLiteral("concurrency"), m_options.concurrency);
+    o.insert(QStringLiteral("rate"), m_options.rate);
+    o.insert(QStringLiteral("connectionReuse"), m_options.reuseConnections);
+    o.insert(QStringLiteral("duration"), seconds);
+    o.insert(QStringLiteral("operations"), m_started);
+    o.insert(QStringLiteral("succeeded"), m_succeeded);
+    o.insert(QStringLiteral("failed"), m_failed);
+    o.insert(QStringLiteral("skipped"), m_skipped);
+    o.insert(QStringLiteral("throughput"), static_cast<double>(m_succeeded) / seconds);
+    o.insert(QStringLiteral("latencyMs"), latency);
+    o.insert(QStringLiteral("errors"), errors);
+    return o;
+}
+
+void BenchRunner::printReport(QTextStream &out) const
+{
+    const QJsonObject r = report();
+    const QJsonObject latency = r.value(QStringLiteral("latencyMs")).toObject();
+
+    out << "Workload:          " << r.value(QStringLiteral("workload")).toString() << '\n';
+    out << "Concurrency:       " << m_options.concurrency << '\n';
+    if (m_options.rate > 0.0) {
+        out << "Rate:              " << m_options.rate << " ops/s\n";
+    }
+    out << "Connection reuse:  " << (m_options.reuseConnections ? "on" : "off") << '\n';
+    out << "Duration:          " << r.value(QStringLiteral("duration")).toDouble() << " s\n";
+    out << "Operations:        " << m_started << '\n';
+    out << "Succeeded:         " << m_succeeded << '\n';
+    out << "Failed:            " << m_failed << '\n';
+    if (m_skipped > 0) {
+        out << "Skipped:           " << m_skipped << '\n';
+    }
+    out << "Throughput:        " << r.value(QStringLiteral("throughput")).toDouble() << " ops/s\n";
+    out << "Latency p50:       " << latency.value(QStringLiteral("p50")).toDouble() << " ms\n";
+    out << "Latency p95:       " << latency.value(QStringLiteral("p95")).toDouble() << " ms\n";
+    out << "Latency p99:       " << latency.value(QStringLiteral("p99")).toDouble() << " ms\n";
+    out << "Latency max:       " << latency.value(QStringLiteral("max")).toDouble() << " ms\n";
+
+    if (!m_errors.empty()) {
+        out << "Errors:\n";
+        for (auto it = m_errors.cbegin(); it != m_errors.cend(); ++it) {
+            out << "  " << it.key() << ": " << it.value().count << " (" << it.value().message << ")\n";
+        }
+    }
+
+    out.flush();
+}
+
+#include "moc_benchrunner.cpp"
@@ -0,0 +1,95 @@
+/*
+ * SPDX-FileCopyrightText: (C) 2021 Matthias Fehring / www.huessenbergnetz.de
+ * SPDX-License-Identifier: LGPL-3.0-or-later
+ */
+
+#ifndef WOLKANLINBENCH_BENCHRUNNER_H
+#define WOLKANLINBENCH_BENCHRUNNER_H
+
+#include <QObject>
+#include <QElapsedTimer>
+#include <QStringList>
+#include <QVector>
+#include <QMap>
+#include <QJsonObject>
+
+class QNetworkAccessManager;
+class QTimer;
+class QTextStream;
+
+namespace Wolkanlin {
+class AbstractConfiguration;
+class Job;
+}
+
+class BenchRunner : public QObject
+{
+    Q_OBJECT
+public:
+    enum Workload {
+        Users,
+        Status,
+        Paging
+    };
+
+    struct Options {
+        Workload workload = Users;
+        int users = 100;            // number of users fetched by the users workload
+        double rate = 0.0;          // operations per second, 0 runs as fast as the concurrency allows
+        int pageSize = 100;         // page size of the paging workload
+        int concurrency = 4;        // maximum number of concurrently running operations
+        int duration = 10;          // duration in seconds
+        bool reuseConnections = true;
+    };
+
+    struct ErrorInfo {
+        int count = 0;
+        QString message;
+    };
+
+    BenchRunner(Wolkanlin::AbstractConfiguration *config, const Options &options, QObject *parent = nullptr);
+    ~BenchRunner() override;
+
+    void start();
+
+    QJsonObject report() const;
+    void printReport(QTextStream &out) const;
+
+    static bool workloadFromString(const QString &str, Workload *workload);
+    static QString workloadToString(Workload workload);
+
+Q_SIGNALS:
+    void finished(bool ok);
+
+private:
+    void fetchIds();
+    void run();
+    void fill();
+    void launch();
+    void onOperationFinished(Wolkanlin::Job *job, qint64 started);
+    void stop();
+    void finish();
+
+    static qint64 percentile(const QVector<qint64> &sorted, double p);
+
+    Options m_options;
+    QElapsedTimer m_timer;
+    QStringList m_ids;
+    QVector<qint64> m_latencies;
+    QMap<int, ErrorInfo> m_errors;
+    Wolkanlin::AbstractConfiguration *m_config = nullptr;
+    QNetworkAccessManager *m_nam = nullptr;
+    QTimer *m_rateTimer = nullptr;
+    qint64 m_runStarted = 0;
+    qint64 m_runFinished = 0;
+    int m_running = 0;
+    int m_started = 0;
+    int m_succeeded = 0;
+    int m_failed = 0;
+    int m_skipped = 0;
+    int m_nextId = 0;
+    bool m_stopping = false;
+    bool m_finished = false;
+};
+
+#endif // WOLKANLINBENCH_BENCHRUNNER_H
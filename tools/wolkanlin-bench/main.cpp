@@ -0,0 +1,125 @@
+/*
+ * SPDX-FileCopyrightText: (C) 2021 Matthias Fehring / www.huessenbergnetz.de
+ * SPDX-License-Identifier: LGPL-3.0-or-later
+ */
+
+#include "benchconfig.h"
+#include "benchrunner.h"
+#include "mockserver.h"
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QTextStream>
+#include <QJsonDocument>
+#include <cstdio>
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    app.setApplicationName(QStringLiteral("wolkanlin-bench"));
+    app.setApplicationVersion(QStringLiteral(WOLKANLIN_VERSION));
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription(QStringLiteral("Load generator for the Nextcloud API jobs of libwolkanlin."));
+    parser.addHelpOption();
+    parser.addVersionOption();
+
+    const QCommandLineOption urlOption({QStringLiteral("u"), QStringLiteral("url")}, QStringLiteral("URL of the Nextcloud server."), QStringLiteral("url"));
+    const QCommandLineOption userOption(QStringLiteral("user"), QStringLiteral("User name used for authentication."), QStringLiteral("name"));
+    const QCommandLineOption passwordOption(QStringLiteral("password"), QStringLiteral("Password used for authentication. Can also be set via the WOLKANLIN_BENCH_PASSWORD environment variable."), QStringLiteral("password"));
+    const QCommandLineOption ignoreSslOption(QStringLiteral("ignore-ssl-errors"), QStringLiteral("Ignore SSL errors."));
+    const QCommandLineOption workloadOption({QStringLiteral("w"), QStringLiteral("workload")}, QStringLiteral("Workload to run: users, status or paging. Default: users"), QStringLiteral("workload"), QStringLiteral("users"));
+    const QCommandLineOption usersOption(QStringLiteral("users"), QStringLiteral("Number of distinct users fetched by the users workload. Default: 100"), QStringLiteral("count"), QStringLiteral("100"));
+    const QCommandLineOption rateOption(QStringLiteral("rate"), QStringLiteral("Operations per second, 0 runs as fast as possible. Default: 0"), QStringLiteral("rate"), QStringLiteral("0"));
+    const QCommandLineOption pageSizeOption(QStringLiteral("page-size"), QStringLiteral("Page size used by the paging workload. Default: 100"), QStringLiteral("size"), QStringLiteral("100"));
+    const QCommandLineOption concurrencyOption({QStringLiteral("c"), QStringLiteral("concurrency")}, QStringLiteral("Maximum number of concurrent operations. Default: 4"), QStringLiteral("count"), QStringLiteral("4"));
+    const QCommandLineOption durationOption({QStringLiteral("d"), QStringLiteral("duration")}, QStringLiteral("Duration in seconds. Default: 10"), QStringLiteral("seconds"), QStringLiteral("10"));
+    const QCommandLineOption noReuseOption(QStringLiteral("no-reuse"), QStringLiteral("Use a new connection for every operation."));
+    const QCommandLineOption jsonOption(QStringLiteral("json"), QStringLiteral("Print the report as JSON."));
+    const QCommandLineOption mockOption(QStringLiteral("mock"), QStringLiteral("Run against a local mock server instead of a real server."));
+    const QCommandLineOption mockUsersOption(QStringLiteral("mock-users"), QStringLiteral("Number of users on the mock server. Default: 1000"), QStringLiteral("count"), QStringLiteral("1000"));
+    const QCommandLineOption mockLatencyOption(QStringLiteral("mock-latency"), QStringLiteral("Latency of the mock server in milliseconds. Default: 0"), QStringLiteral("ms"), QStringLiteral("0"));
+    const QCommandLineOption mockJitterOption(QStringLiteral("mock-jitter"), QStringLiteral("Maximum additional random latency of the mock server in milliseconds. Default: 0"), QStringLiteral("ms"), QStringLiteral("0"));
+    const QCommandLineOption mockFailOption(QStringLiteral("mock-fail-every"), QStringLiteral("Let every nth request to the mock server fail. Default: 0"), QStringLiteral("n"), QStringLiteral("0"));
+
+    parser.addOptions({urlOption, userOption, passwordOption, ignoreSslOption, workloadOption, usersOption, rateOption, pageSizeOption, concurrencyOption, durationOption, noReuseOption, jsonOption, mockOption, mockUsersOption, mockLatencyOption, mockJitterOption, mockFailOption});
+
+    parser.process(app);
+
+    BenchRunner::Options options;
+    if (!BenchRunner::workloadFromString(parser.value(workloadOption), &options.workload)) {
+        std::fprintf(stderr, "Invalid workload: %s\n", qUtf8Printable(parser.value(workloadOption)));
+        return 1;
+    }
+    options.users = parser.value(usersOption).toInt();
+    options.rate = parser.value(rateOption).toDouble();
+    options.pageSize = parser.value(pageSizeOption).toInt();
+    options.concurrency = parser.value(concurrencyOption).toInt();
+    options.duration = parser.value(durationOption).toInt();
+    options.reuseConnections = !parser.isSet(noReuseOption);
+
+    BenchConfig config;
+    QString password = parser.value(passwordOption);
+    if (password.isEmpty()) {
+        password = QString::fromLocal8Bit(qgetenv("WOLKANLIN_BENCH_PASSWORD"));
+    }
+    config.setUsername(parser.value(userOption));
+    config.setPassword(password);
+    config.setIgnoreSslErrors(parser.isSet(ignoreSslOption));
+
+    MockServer *mock = nullptr;
+    if (parser.isSet(mockOption)) {
+        mock = new MockServer(&app);
+        if (!mock->start()) {
+            return 2;
+        }
+        if (config.username().isEmpty()) {
+            config.setUsername(QStringLiteral("admin"));
+        }
+        if (config.password().isEmpty()) {
+            config.setPassword(QStringLiteral("admin"));
+        }
+        mock->setCredentials(config.username(), config.password());
+        mock->setUserCount(parser.value(mockUsersOption).toInt());
+        mock->setLatency(parser.value(mockLatencyOption).toInt(), parser.value(mockJitterOption).toInt());
+        mock->setFailEveryNthRequest(parser.value(mockFailOption).toInt());
+        config.setHost(QStringLiteral("127.0.0.1"));
+        config.setPort(mock->serverPort());
+        config.setUseSsl(false);
+    } else {
+        if (!parser.isSet(urlOption)) {
+            std::fprintf(stderr, "%s\n", "Either --url or --mock is required.");
+            return 1;
+        }
+        if (!config.setServerUrl(parser.value(urlOption))) {
+            return 1;
+        }
+    }
+
+    if (options.workload != BenchRunner::Status && (config.username().isEmpty() || config.password().isEmpty())) {
+        std::fprintf(stderr, "%s\n", "The users and paging workloads require --user and --password.");
+        return 1;
+    }
+
+    BenchRunner runner(&config, options);
+
+    int exitCode = 0;
+    QObject::connect(&runner, &BenchRunner::finished, &app, [&](bool ok){
+        if (ok) {
+            QTextStream out(stdout);
+            if (parser.isSet(jsonOption)) {
+                out << QJsonDocument(runner.report()).toJson(QJsonDocument::Indented);
+                out.flush();
+            } else {
+                runner.printReport(out);
+            }
+        } else {
+            exitCode = 3;
+        }
+        app.quit();
+    });
+
+    runner.start();
+
+    const int ret = app.exec();
+    return exitCode != 0 ? exitCode : ret;
+}